@@ -0,0 +1,390 @@
+#include "schoof_cli.h"
+
+/********************/
+/* ETAT DES THREADS */
+/********************/
+
+void cli_state_init(cli_state_t state, const slong num_threads, const int ordered, const schoof_opt_t opt, FILE* out) {
+    pthread_mutex_init(&state->mutex, NULL);
+    pthread_cond_init(&state->job_ready, NULL);
+    pthread_cond_init(&state->space_ready, NULL);
+
+    state->jobs_cap = CLI_QUEUE_FACTOR * num_threads;
+    state->jobs = (cli_job_struct*)malloc(state->jobs_cap * sizeof(cli_job_struct));
+    state->jobs_head = 0;
+    state->jobs_len = 0;
+    state->done = 0;
+
+    state->ordered = ordered;
+    state->window = state->jobs_cap;
+    state->slots = (char**)calloc(state->window, sizeof(char*));
+    state->next_out = 0;
+
+    *state->opt = *opt;
+    state->cache = NULL;
+    state->out = out;
+}
+
+void cli_state_clear(cli_state_t state) {
+    pthread_mutex_destroy(&state->mutex);
+    pthread_cond_destroy(&state->job_ready);
+    pthread_cond_destroy(&state->space_ready);
+
+    free(state->jobs);
+    free(state->slots);
+}
+
+/**************************/
+/* TRAITEMENT D'UNE LIGNE */
+/**************************/
+
+/**
+ * Compte les points de la courbe décrite par line ("p a b") et renvoie la ligne de résultat "p,a,b,N\n",
+ * allouée avec malloc(). Si la ligne est mal formée, si p n'est pas un nombre premier supérieur à 3 ou si la
+ * courbe est singulière, N est remplacé par "error", et par "timeout" si le calcul dépasse
+ * state->opt->deadline. Si state->cache n'est pas NULL, le résultat y est cherché avant d'être calculé, puis
+ * enregistré.
+ */
+char* cli_process_line(const char* line, cli_state_t state) {
+    char* copy = strdup(line);
+    char* fields[3];
+    int num_fields = 0;
+    char* save;
+
+    // Découpage en champs, on en garde au plus 3 mais on compte les autres
+    for (char* tok = strtok_r(copy, " \t,\r\n", &save); tok != NULL; tok = strtok_r(NULL, " \t,\r\n", &save)) {
+        if (num_fields < 3) fields[num_fields] = tok;
+        num_fields++;
+    }
+
+    fmpz_t p, a, b, res;
+    fmpz_init(p);
+    fmpz_init(a);
+    fmpz_init(b);
+    fmpz_init(res);
+
+    char* count = NULL;
+    const char* failure = "error";
+
+    if (num_fields == 3 && fmpz_set_str(p, fields[0], 10) == 0 && fmpz_set_str(a, fields[1], 10) == 0
+        && fmpz_set_str(b, fields[2], 10) == 0 && fmpz_cmp_ui(p, 3) > 0 && fmpz_is_probabprime(p)) {
+        fq_ctx_t ctx;
+        fq_ctx_init(ctx, p, 1, "a");
+
+        fq_t fq_a, fq_b;
+        fq_init(fq_a, ctx);
+        fq_init(fq_b, ctx);
+        fq_set_fmpz(fq_a, a, ctx);
+        fq_set_fmpz(fq_b, b, ctx);
+
+        if (state->cache != NULL && curve_cache_lookup(res, state->cache, fq_a, fq_b, ctx)) {
+            count = fmpz_get_str(NULL, 10, res);
+        } else {
+            schoof_partial_t partial;
+            schoof_partial_init(partial);
+
+            if (schoof_interruptible(res, partial, fq_a, fq_b, state->opt, ctx) == EXIT_SUCCESS) {
+                count = fmpz_get_str(NULL, 10, res);
+
+                // curve_cache_insert() ne verrouille qu'entre processus, le mutex sérialise les threads
+                if (state->cache != NULL) {
+                    pthread_mutex_lock(&state->mutex);
+                    curve_cache_insert(state->cache, fq_a, fq_b, res, ctx);
+                    pthread_mutex_unlock(&state->mutex);
+                }
+            } else if (partial->interrupted) {
+                failure = "timeout";
+            }
+
+            schoof_partial_clear(partial);
+        }
+
+        fq_clear(fq_a, ctx);
+        fq_clear(fq_b, ctx);
+        fq_ctx_clear(ctx);
+    }
+
+    // Ligne de résultat : les champs lus tels quels, puis N, "error" ou "timeout"
+    size_t len = strlen(line) + strlen((count != NULL) ? count : failure) + 4;
+    char* out = (char*)malloc(len);
+    out[0] = '\0';
+
+    for (int i = 0; i < FLINT_MIN(num_fields, 3); i++) {
+        strcat(out, fields[i]);
+        strcat(out, ",");
+    }
+    strcat(out, (count != NULL) ? count : failure);
+    strcat(out, "\n");
+
+    if (count != NULL) flint_free(count);
+    free(copy);
+    fmpz_clear(p);
+    fmpz_clear(a);
+    fmpz_clear(b);
+    fmpz_clear(res);
+    return out;
+}
+
+/******************************/
+/* FILE DES COURBES A TRAITER */
+/******************************/
+
+/**
+ * Ajoute la ligne line (numéro index) à la file, en attendant qu'il y ait de la place. En mode ordonné, on
+ * attend aussi que le résultat de numéro index - window soit écrit, ce qui borne la mémoire utilisée même si
+ * une courbe est beaucoup plus longue que les suivantes.
+ */
+void cli_push(cli_state_t state, const ulong index, char* line) {
+    pthread_mutex_lock(&state->mutex);
+
+    while (state->jobs_len == state->jobs_cap || (state->ordered && index >= state->next_out + state->window)) {
+        pthread_cond_wait(&state->space_ready, &state->mutex);
+    }
+
+    cli_job_struct* job = state->jobs + (state->jobs_head + state->jobs_len) % state->jobs_cap;
+    job->index = index;
+    job->line = line;
+    state->jobs_len++;
+
+    pthread_cond_signal(&state->job_ready);
+    pthread_mutex_unlock(&state->mutex);
+}
+
+/**
+ * Transmet le résultat out de la courbe numéro index. En mode ordonné, il est mis de côté puis tous les
+ * résultats consécutifs disponibles sont écrits. Sinon il est écrit directement, préfixé par index.
+ */
+void cli_output(cli_state_t state, const ulong index, char* out) {
+    pthread_mutex_lock(&state->mutex);
+
+    if (state->ordered) {
+        state->slots[index % state->window] = out;
+
+        while (state->slots[state->next_out % state->window] != NULL) {
+            char** slot = state->slots + state->next_out % state->window;
+            fputs(*slot, state->out);
+            free(*slot);
+            *slot = NULL;
+            state->next_out++;
+        }
+
+        pthread_cond_broadcast(&state->space_ready);
+    } else {
+        fprintf(state->out, "%lu,%s", index, out);
+        free(out);
+    }
+
+    pthread_mutex_unlock(&state->mutex);
+}
+
+/**
+ * Boucle d'un thread de calcul : prend une courbe dans la file, la compte et transmet le résultat, jusqu'à ce
+ * que la file soit vide et l'entrée terminée.
+ */
+void* cli_worker(void* arg) {
+    cli_state_struct* state = (cli_state_struct*)arg;
+    cli_job_struct job;
+
+    while (1) {
+        pthread_mutex_lock(&state->mutex);
+
+        while (state->jobs_len == 0 && !state->done) {
+            pthread_cond_wait(&state->job_ready, &state->mutex);
+        }
+
+        if (state->jobs_len == 0) { // Entrée terminée
+            pthread_mutex_unlock(&state->mutex);
+            break;
+        }
+
+        job = state->jobs[state->jobs_head];
+        state->jobs_head = (state->jobs_head + 1) % state->jobs_cap;
+        state->jobs_len--;
+
+        pthread_cond_signal(&state->space_ready);
+        pthread_mutex_unlock(&state->mutex);
+
+        char* out = cli_process_line(job.line, state);
+        free(job.line);
+        cli_output(state, job.index, out);
+    }
+
+    flint_cleanup(); // Libère les caches propres au thread
+    return NULL;
+}
+
+/*************/
+/* PROGRAMME */
+/*************/
+
+/**
+ * Lit dans *res l'entier décimal str, qui doit être entre min et max sans caractère en trop. Renvoie 0, ou -1
+ * (*res inchangé) si str n'est pas un tel entier.
+ */
+int cli_parse_slong(slong* res, const char* str, const slong min, const slong max) {
+    char* end;
+    errno = 0;
+    long value = strtol(str, &end, 10);
+    if (end == str || *end != '\0' || errno == ERANGE || value < min || value > max) return -1;
+
+    *res = value;
+    return 0;
+}
+
+/**
+ * Même chose que cli_parse_slong() pour un nombre décimal, NaN et les infinis étant refusés.
+ */
+int cli_parse_double(double* res, const char* str, const double min, const double max) {
+    char* end;
+    errno = 0;
+    double value = strtod(str, &end);
+    if (end == str || *end != '\0' || errno == ERANGE || !(value >= min && value <= max)) return -1;
+
+    *res = value;
+    return 0;
+}
+
+void cli_usage(const char* name) {
+    fprintf(stderr, "Usage : %s [-j threads (0 = tous les coeurs)] [-i fichier] [-u] [-b frob_block] [-a] [-m] [-k] [-s] [-x] [-r] [-R] [-p threads_psi] [-P avance_psi] [-t threads_produits] [-T secondes] [-c cache]\n", name);
+    fprintf(stderr, "Lit des lignes \"p a b\" et écrit \"p,a,b,N\" où N est le nombre de points de y^2 = x^3 + a*x + b sur F_p.\n");
+    fprintf(stderr, "Les options entières sont entre 0 et %d.\n", CLI_MAX_COUNT);
+}
+
+int main(int argc, char** argv) {
+    slong num_threads = 1;
+    int ordered = 1;
+    FILE* in = stdin;
+    const char* cache_path = NULL;
+
+    schoof_opt_t opt;
+    schoof_opt_init(opt);
+
+    int c;
+    while ((c = getopt(argc, argv, "j:i:ub:amksxrRp:P:t:T:c:h")) != -1) {
+        int valid = 1;
+        switch (c) {
+            case 'j':
+                valid = (cli_parse_slong(&num_threads, optarg, 0, CLI_MAX_COUNT) == 0);
+                if (num_threads == 0) num_threads = FLINT_MAX(sysconf(_SC_NPROCESSORS_ONLN), 1);
+                break;
+            case 'i':
+                in = fopen(optarg, "r");
+                if (in == NULL) {
+                    fprintf(stderr, "Impossible d'ouvrir %s\n", optarg);
+                    return EXIT_FAILURE;
+                }
+                break;
+            case 'u':
+                ordered = 0;
+                break;
+            case 'b':
+                valid = (cli_parse_slong(&opt->frob_block, optarg, 0, CLI_MAX_COUNT) == 0);
+                break;
+            case 'a':
+                opt->affine = 1;
+                break;
+            case 'm':
+                opt->low_memory = 1;
+                break;
+            case 'k':
+                opt->prime_powers = 1;
+                break;
+            case 's':
+                opt->bsgs = 1;
+                break;
+            case 'x':
+                opt->match_sort = 1;
+                break;
+            case 'r':
+                opt->arena = 1;
+                break;
+            case 'R':
+                opt->arena = 1;
+                opt->arena_log = stderr;
+                break;
+            case 'p':
+                valid = (cli_parse_slong(&opt->psi_threads, optarg, 0, CLI_MAX_COUNT) == 0);
+                break;
+            case 'P':
+                valid = (cli_parse_slong(&opt->psi_ahead, optarg, 0, CLI_MAX_COUNT) == 0);
+                break;
+            case 't':
+                valid = (cli_parse_slong(&opt->mul_threads, optarg, 0, CLI_MAX_COUNT) == 0);
+                break;
+            case 'T':
+                valid = (cli_parse_double(&opt->deadline, optarg, 0, DBL_MAX) == 0);
+                break;
+            case 'c':
+                cache_path = optarg;
+                break;
+            default:
+                cli_usage(argv[0]);
+                return (c == 'h') ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+
+        if (!valid) {
+            fprintf(stderr, "Valeur invalide pour -%c : %s\n", c, optarg);
+            cli_usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    setvbuf(stdout, NULL, _IOFBF, CLI_OUT_BUFFER);
+
+    cli_state_t state;
+    cli_state_init(state, num_threads, ordered, opt, stdout);
+
+    curve_cache_t cache;
+    if (cache_path != NULL) {
+        if (curve_cache_open(cache, cache_path, CLI_CACHE_CAPACITY) != 0) {
+            fprintf(stderr, "Impossible d'ouvrir le cache %s\n", cache_path);
+            return EXIT_FAILURE;
+        }
+        state->cache = cache;
+    }
+
+    // Seuls les threads effectivement créés sont attendus, il en faut au moins un pour vider la file
+    pthread_t* threads = (pthread_t*)malloc(num_threads * sizeof(pthread_t));
+    slong num_created = 0;
+    for (slong i = 0; i < num_threads; i++) {
+        if (pthread_create(threads + num_created, NULL, cli_worker, state) == 0) num_created++;
+    }
+    if (num_created == 0) {
+        fprintf(stderr, "Impossible de créer les threads de calcul\n");
+        free(threads);
+        cli_state_clear(state);
+        if (cache_path != NULL) curve_cache_close(cache);
+        if (in != stdin) fclose(in);
+        return EXIT_FAILURE;
+    }
+
+    // Lecture de l'entrée, les lignes vides et les commentaires sont ignorés
+    char* line = NULL;
+    size_t cap = 0;
+    ulong index = 0;
+
+    while (getline(&line, &cap, in) != -1) {
+        size_t skip = strspn(line, " \t,\r\n");
+        if (line[skip] == '\0' || line[skip] == '#') continue;
+
+        cli_push(state, index++, strdup(line));
+    }
+    free(line);
+
+    pthread_mutex_lock(&state->mutex);
+    state->done = 1;
+    pthread_cond_broadcast(&state->job_ready);
+    pthread_mutex_unlock(&state->mutex);
+
+    for (slong i = 0; i < num_created; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    fflush(stdout);
+
+    free(threads);
+    cli_state_clear(state);
+    if (cache_path != NULL) curve_cache_close(cache);
+    if (in != stdin) fclose(in);
+    return EXIT_SUCCESS;
+}
\ No newline at end of file
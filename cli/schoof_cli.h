@@ -0,0 +1,74 @@
+#ifndef SCHOOF_CLI_H
+#define SCHOOF_CLI_H
+
+#define _POSIX_C_SOURCE 200809L // getline() et getopt()
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <float.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <flint/flint.h>
+#include <flint/fmpz.h>
+#include <flint/fq.h>
+#include "schoof.h"
+#include "curve_cache.h"
+
+/**
+ * Outil en ligne de commande : lit des courbes "p a b" (une par ligne, champs séparés par des espaces ou des
+ * virgules, lignes vides et commentaires commençant par # ignorés) sur l'entrée standard ou dans un fichier,
+ * les compte avec plusieurs threads et écrit les résultats "p,a,b,N" sur la sortie standard au fil de l'eau.
+ *
+ * Par défaut les résultats sortent dans l'ordre de l'entrée. Avec -u, ils sortent dès qu'ils sont prêts et
+ * sont préfixés par le numéro de la courbe dans l'entrée (à partir de 0). Une courbe invalide donne "error" à la place de N.
+ * Seuls les corps premiers F_p sont gérés.
+ */
+
+#define CLI_QUEUE_FACTOR 4 // Nombre de courbes en attente ou en cours par thread
+#define CLI_OUT_BUFFER (1 << 16) // Taille du tampon de la sortie standard
+#define CLI_CACHE_CAPACITY (1 << 18) // Nombre d'entrées d'un nouveau fichier de cache
+#define CLI_MAX_COUNT 1024 // Valeur maximale des options entières -j, -b, -p, -P et -t
+
+// Une ligne d'entrée à traiter
+typedef struct {
+    ulong index; // Numéro de l'enregistrement dans l'entrée
+    char* line;
+} cli_job_struct;
+
+// État partagé entre le thread de lecture et les threads de calcul
+typedef struct {
+    pthread_mutex_t mutex;
+    pthread_cond_t job_ready; // Une courbe a été ajoutée à la file, ou l'entrée est terminée
+    pthread_cond_t space_ready; // De la place s'est libérée dans la file ou dans la fenêtre de réordonnancement
+
+    cli_job_struct* jobs; // File circulaire des courbes à traiter
+    slong jobs_cap;
+    slong jobs_head;
+    slong jobs_len;
+    int done; // L'entrée est entièrement lue
+
+    int ordered; // Résultats dans l'ordre de l'entrée
+    char** slots; // Résultats en attente d'écriture, indexés modulo window
+    slong window;
+    ulong next_out; // Numéro du prochain résultat à écrire
+
+    schoof_opt_t opt;
+    curve_cache_struct* cache; // Cache des résultats (c.f curve_cache.h), NULL si non utilisé
+    FILE* out;
+} cli_state_struct;
+
+typedef cli_state_struct cli_state_t[1]; // On adopte la convention de FLINT sur les nouveaux types
+
+void cli_state_init(cli_state_t, const slong, const int, const schoof_opt_t, FILE*);
+void cli_state_clear(cli_state_t);
+char* cli_process_line(const char*, cli_state_t);
+void cli_push(cli_state_t, const ulong, char*);
+void cli_output(cli_state_t, const ulong, char*);
+void* cli_worker(void*);
+int cli_parse_slong(slong*, const char*, const slong, const slong);
+int cli_parse_double(double*, const char*, const double, const double);
+void cli_usage(const char*);
+int main(int, char**);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,88 @@
+#include "schoof_range.h"
+
+int main(int argc, char** argv) {
+    ulong p_min = 5;
+    range_stats_struct stats;
+
+    range_opt_t ropt;
+    range_opt_init(ropt);
+    ropt->stats = &stats;
+
+    schoof_opt_t opt;
+    schoof_opt_init(opt);
+
+    int c;
+    while ((c = getopt(argc, argv, "j:m:n:BZsrh")) != -1) {
+        switch (c) {
+            case 'j':
+                ropt->threads = atol(optarg);
+                if (ropt->threads <= 0) ropt->threads = sysconf(_SC_NPROCESSORS_ONLN);
+                break;
+            case 'm':
+                p_min = strtoul(optarg, NULL, 10);
+                break;
+            case 'n':
+                ropt->naive_max = strtoul(optarg, NULL, 10);
+                break;
+            case 'B':
+                ropt->bsgs = 0;
+                break;
+            case 'Z':
+                ropt->share_psi = 0;
+                break;
+            case 's':
+                opt->bsgs = 1;
+                break;
+            case 'r':
+                opt->arena = 1;
+                break;
+            default:
+                fprintf(stderr, "Usage : %s [-j threads (0 = tous les coeurs)] [-m p_min] [-n p_max_somme] [-B] [-Z] [-s] [-r] [--] a b p_max\n", argv[0]);
+                fprintf(stderr, "Écrit \"p,a_p\" pour chaque premier p_min <= p <= p_max de bonne réduction de y^2 = x^3 + a*x + b sur Q.\n");
+                fprintf(stderr, "-B : jamais de pas de bébé-pas de géant, -Z : ψ_m recalculés pour chaque p au lieu d'être réduits depuis Z\n");
+                return (c == 'h') ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+
+    fmpz_t a, b, disc;
+    fmpz_init(a);
+    fmpz_init(b);
+    fmpz_init(disc);
+
+    char* end = NULL;
+    ulong p_max = (optind + 2 < argc) ? strtoul(argv[optind + 2], &end, 10) : 0;
+    if (optind + 2 >= argc || fmpz_set_str(a, argv[optind], 10) != 0 || fmpz_set_str(b, argv[optind + 1], 10) != 0 || *end != '\0' || p_max >= (UWORD(1) << (FLINT_BITS - 1))) {
+        fprintf(stderr, "a et b doivent être des entiers et p_max un entier inférieur à 2^%d\n", FLINT_BITS - 1);
+        fmpz_clear(a);
+        fmpz_clear(b);
+        fmpz_clear(disc);
+        return EXIT_FAILURE;
+    }
+
+    // La courbe doit être lisse sur Q : 4*a^3 + 27*b^2 != 0
+    fmpz_t temp;
+    fmpz_init(temp);
+    fmpz_pow_ui(disc, a, 3);
+    fmpz_mul_ui(disc, disc, 4);
+    fmpz_mul(temp, b, b);
+    fmpz_addmul_ui(disc, temp, 27);
+    int smooth = !fmpz_is_zero(disc);
+
+    if (smooth) {
+        double start = tors_stop_now();
+        range_traces(stdout, a, b, p_min, p_max, ropt, opt);
+        double elapsed = tors_stop_now() - start;
+
+        ulong done = stats.naive + stats.bsgs + stats.schoof;
+        fprintf(stderr, "%lu premiers en %.3f s (%.1f premiers/s) : %lu par somme de caractères, %lu par pas de bébé-pas de géant, %lu par Schoof, %lu sautés\n",
+                done, elapsed, (elapsed > 0) ? done / elapsed : 0.0, stats.naive, stats.bsgs, stats.schoof, stats.bad);
+    } else {
+        fprintf(stderr, "La courbe est singulière (4*a^3 + 27*b^2 = 0)\n");
+    }
+
+    fmpz_clear(a);
+    fmpz_clear(b);
+    fmpz_clear(disc);
+    fmpz_clear(temp);
+    return smooth ? EXIT_SUCCESS : EXIT_FAILURE;
+}
\ No newline at end of file
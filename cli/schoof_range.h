@@ -0,0 +1,21 @@
+#ifndef SCHOOF_RANGE_H
+#define SCHOOF_RANGE_H
+
+#define _POSIX_C_SOURCE 200809L // getopt() et sysconf()
+
+#include <stdio.h>
+#include <unistd.h>
+#include <flint/flint.h>
+#include <flint/fmpz.h>
+#include "schoof.h"
+#include "range.h"
+
+/**
+ * Outil de calcul des traces de Frobenius d'une courbe fixée sur Q pour tous les premiers d'un intervalle
+ * (c.f range.h) : écrit une ligne "p,a_p" par premier sur la sortie standard, au fur et à mesure, puis le débit
+ * (premiers par seconde) et la répartition entre les méthodes sur la sortie d'erreur.
+ */
+
+int main(int, char**);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,91 @@
+#include "schoof_search.h"
+
+int main(int argc, char** argv) {
+    slong wanted = 1;
+    ulong tried = 0, filtered = 0;
+
+    search_opt_t sopt;
+    search_opt_init(sopt);
+    sopt->tried = &tried;
+    sopt->filtered = &filtered;
+
+    schoof_opt_t opt;
+    schoof_opt_init(opt);
+
+    int c;
+    while ((c = getopt(argc, argv, "j:n:c:l:S:srh")) != -1) {
+        switch (c) {
+            case 'j':
+                sopt->threads = atol(optarg);
+                if (sopt->threads <= 0) sopt->threads = sysconf(_SC_NPROCESSORS_ONLN);
+                break;
+            case 'n':
+                wanted = FLINT_MAX(atol(optarg), 1);
+                break;
+            case 'c':
+                sopt->max_cofactor = FLINT_MAX(strtoul(optarg, NULL, 10), 1);
+                break;
+            case 'l':
+                sopt->max_candidates = strtoul(optarg, NULL, 10);
+                break;
+            case 'S':
+                sopt->seed = strtoul(optarg, NULL, 10);
+                break;
+            case 's':
+                opt->bsgs = 1;
+                break;
+            case 'r':
+                opt->arena = 1;
+                break;
+            default:
+                fprintf(stderr, "Usage : %s [-j threads (0 = tous les coeurs)] [-n courbes] [-c cofacteur] [-l max_essais] [-S graine] [-s] [-r] p\n", argv[0]);
+                fprintf(stderr, "Cherche des courbes y^2 = x^3 + a*x + b sur F_p d'ordre N = h*r, r premier, et écrit \"p,a,b,N,h,N_tordue\".\n");
+                return (c == 'h') ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+
+    fmpz_t p;
+    fmpz_init(p);
+    if (optind >= argc || fmpz_set_str(p, argv[optind], 10) != 0 || fmpz_cmp_ui(p, 3) <= 0 || !fmpz_is_probabprime(p)) {
+        fprintf(stderr, "p doit être un nombre premier supérieur à 3\n");
+        fmpz_clear(p);
+        return EXIT_FAILURE;
+    }
+
+    fq_ctx_t ctx;
+    fq_ctx_init(ctx, p, 1, "a");
+
+    search_curve_struct* found = (search_curve_struct*)malloc(wanted * sizeof(search_curve_struct));
+    for (slong i = 0; i < wanted; i++) search_curve_init(found + i, ctx);
+
+    slong num_found = search_curves(found, wanted, sopt, opt, ctx);
+
+    fmpz_t a, b;
+    fmpz_init(a);
+    fmpz_init(b);
+    for (slong i = 0; i < num_found; i++) {
+        fq_get_fmpz(a, found[i].a, ctx);
+        fq_get_fmpz(b, found[i].b, ctx);
+        fmpz_print(p);
+        printf(",");
+        fmpz_print(a);
+        printf(",");
+        fmpz_print(b);
+        printf(",");
+        fmpz_print(found[i].order);
+        printf(",");
+        fmpz_print(found[i].cofactor);
+        printf(",");
+        fmpz_print(found[i].twist_order);
+        printf("\n");
+    }
+    fprintf(stderr, "%ld courbes trouvées sur %lu essayées, %lu écartées avant la fin de l'algorithme de Schoof\n", num_found, tried, filtered);
+
+    for (slong i = 0; i < wanted; i++) search_curve_clear(found + i, ctx);
+    free(found);
+    fmpz_clear(a);
+    fmpz_clear(b);
+    fmpz_clear(p);
+    fq_ctx_clear(ctx);
+    return (num_found == wanted) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
\ No newline at end of file
@@ -0,0 +1,22 @@
+#ifndef SCHOOF_SEARCH_H
+#define SCHOOF_SEARCH_H
+
+#define _POSIX_C_SOURCE 200809L // getopt() et sysconf()
+
+#include <stdio.h>
+#include <unistd.h>
+#include <flint/flint.h>
+#include <flint/fmpz.h>
+#include <flint/fq.h>
+#include "schoof.h"
+#include "search.h"
+
+/**
+ * Outil de recherche de courbes d'ordre premier (ou de petit cofacteur) sur F_p (c.f search.h) : écrit une ligne
+ * "p,a,b,N,h,N_tordue" par courbe trouvée sur la sortie standard, puis le nombre de courbes essayées et écartées
+ * en cours de route sur la sortie d'erreur.
+ */
+
+int main(int, char**);
+
+#endif
\ No newline at end of file
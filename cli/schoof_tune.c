@@ -0,0 +1,348 @@
+#include "schoof_tune.h"
+
+void tuner_ctx_init(fq_ctx_t ctx, const slong bits, tuner_t tuner) {
+    fmpz_t p;
+    fmpz_init(p);
+    fmpz_randprime(p, tuner->state, bits, 0);
+    fq_ctx_init(ctx, p, 1, "a");
+    fmpz_clear(p);
+}
+
+/**
+ * Longueur suivante de la suite 4, 6, 8, 12, 16, 24, ... des longueurs de psi essayées.
+ */
+slong tuner_next_len(const slong len) {
+    return ((len & (len - 1)) == 0) ? len + len / 2 : len + len / 3;
+}
+
+/**
+ * Durée moyenne (secondes) d'un produit modulo un psi aléatoire de longueur len, selon le chemin que choisissent
+ * les seuils de tune_profile : tors_poly_mul_pre() si pre est non nul, tors_poly_mul() sinon. Le produit est
+ * répété jusqu'à ce que la mesure dure au moins tuner->min_time.
+ */
+double tuner_time_mul(const slong len, const int pre, const fq_ctx_t ctx, tuner_t tuner) {
+    ell_curve_t E;
+    ell_curve_init(E, ctx);
+
+    fq_t a, b;
+    fq_init(a, ctx);
+    fq_init(b, ctx);
+    fq_rand(a, tuner->state, ctx);
+    fq_rand(b, tuner->state, ctx);
+    ell_curve_set(E, a, b, ctx); // Une courbe singulière ne change rien au coût des produits
+
+    fq_poly_t psi, op1, op2, res;
+    fq_poly_init(psi, ctx);
+    fq_poly_init(op1, ctx);
+    fq_poly_init(op2, ctx);
+    fq_poly_init(res, ctx);
+    fq_poly_randtest_monic(psi, tuner->state, len, ctx);
+    fq_poly_randtest(op1, tuner->state, len - 1, ctx);
+    fq_poly_randtest(op2, tuner->state, len - 1, ctx);
+
+    tors_ring_t tors_ring;
+    tors_ring_init(tors_ring, ctx);
+    tors_ring_set(tors_ring, E, psi, ctx);
+    tors_ring_set_threads(tors_ring, tuner->threads, ctx);
+
+    tors_pre_t pre_op;
+    tors_pre_init(pre_op, ctx);
+    if (pre) tors_pre_set(pre_op, op2, tors_ring, ctx);
+
+    double elapsed = 0;
+    slong reps = 1;
+    for (slong n = 1; elapsed < tuner->min_time; n *= 2) {
+        double start = tors_stop_now();
+        for (slong i = 0; i < n; i++) {
+            if (pre) {
+                tors_poly_mul_pre(res, op1, pre_op, tors_ring, ctx);
+            } else {
+                tors_poly_mul(res, op1, op2, tors_ring, ctx);
+            }
+        }
+        elapsed = tors_stop_now() - start;
+        reps = n;
+    }
+
+    tors_pre_clear(pre_op, ctx);
+    tors_ring_clear(tors_ring, ctx);
+    ell_curve_clear(E, ctx);
+    fq_clear(a, ctx);
+    fq_clear(b, ctx);
+    fq_poly_clear(psi, ctx);
+    fq_poly_clear(op1, ctx);
+    fq_poly_clear(op2, ctx);
+    fq_poly_clear(res, ctx);
+    return elapsed / reps;
+}
+
+/**
+ * Rapport des durées d'un produit (c.f tuner_time_mul()) quand le seuil *field vaut on et quand il vaut off.
+ * *field est remis à sa valeur d'origine.
+ */
+double tuner_ratio(slong* field, const slong on, const slong off, const slong len, const int pre, const fq_ctx_t ctx, tuner_t tuner) {
+    slong old = *field;
+
+    *field = on;
+    double time_on = tuner_time_mul(len, pre, ctx, tuner);
+    *field = off;
+    double time_off = tuner_time_mul(len, pre, ctx, tuner);
+
+    *field = old;
+    return time_on / time_off;
+}
+
+/**
+ * Longueur maximale de psi jusqu'à laquelle les noyaux dont fields[i] est le seuil battent FLINT, pour chacune des
+ * num tailles de q (en bits) de bits : la plus grande longueur essayée avant la première défaite, rangée dans
+ * fields[i].
+ */
+void tuner_max_len(const char* name, slong* fields, const slong* bits, const slong num, tuner_t tuner) {
+    for (slong i = 0; i < num; i++) {
+        fq_ctx_t ctx;
+        tuner_ctx_init(ctx, bits[i], tuner);
+
+        slong cross = 0;
+        for (slong len = 4; len <= tuner->max_len; len = tuner_next_len(len)) {
+            double ratio = tuner_ratio(fields + i, TUNER_INFINITY, 0, len, 0, ctx, tuner);
+            printf("%s : %ld bits, longueur %ld, noyau/FLINT %.2f\n", name, bits[i], len, ratio);
+            fflush(stdout);
+
+            if (ratio >= 1) break;
+            cross = len;
+        }
+        fields[i] = cross;
+
+        fq_ctx_clear(ctx);
+    }
+}
+
+/**
+ * Règle pre_fft_min_limbs et pre_fft_min_len : plus petite taille de q (en limbs) pour laquelle précalculer la
+ * transformée d'un opérande fixe rend le produit plus rapide, et première longueur de psi à partir de laquelle
+ * c'est le cas (deux longueurs consécutives gagnantes d'au moins TUNER_MARGIN, pour ne pas retenir une mesure
+ * isolée).
+ */
+void tuner_pre_fft(tuner_t tuner) {
+    slong min_limbs = TUNER_INFINITY, min_len = TUNER_INFINITY;
+
+    // Les produits passent par FLINT, seul chemin où la transformée est précalculée
+    slong mont_max_len[TUNE_MONT_SIZES];
+    for (slong i = 0; i < TUNE_MONT_SIZES; i++) {
+        mont_max_len[i] = tune_profile.mont_max_len[i];
+        tune_profile.mont_max_len[i] = 0;
+    }
+    tune_profile.pre_fft_min_len = 0;
+
+    for (slong limbs = 2; limbs <= TUNER_PRE_FFT_MAX_LIMBS && min_limbs == TUNER_INFINITY; limbs++) {
+        fq_ctx_t ctx;
+        tuner_ctx_init(ctx, limbs * FLINT_BITS, tuner);
+
+        slong first = 0; // Première longueur de la série de victoires en cours
+        for (slong len = 4; len <= tuner->max_len; len = tuner_next_len(len)) {
+            double ratio = tuner_ratio(&tune_profile.pre_fft_min_limbs, 0, TUNER_INFINITY, len, 1, ctx, tuner);
+            printf("pre_fft : %ld limbs, longueur %ld, précalculé/ordinaire %.2f\n", limbs, len, ratio);
+            fflush(stdout);
+
+            if (ratio >= TUNER_MARGIN) {
+                first = 0;
+            } else if (first == 0) {
+                first = len;
+            } else {
+                min_limbs = limbs;
+                min_len = first;
+                break;
+            }
+        }
+
+        fq_ctx_clear(ctx);
+    }
+
+    for (slong i = 0; i < TUNE_MONT_SIZES; i++) tune_profile.mont_max_len[i] = mont_max_len[i];
+    tune_profile.pre_fft_min_limbs = min_limbs;
+    tune_profile.pre_fft_min_len = min_len;
+}
+
+/**
+ * Règle threads_min_len : première longueur de psi (deux longueurs consécutives gagnantes) à partir de laquelle
+ * un produit sur tuner->threads threads bat le même produit sur un seul, pour q de 4 limbs.
+ */
+void tuner_threads(tuner_t tuner) {
+    if (tuner->threads < 2) {
+        printf("threads_min_len : un seul thread, valeur par défaut conservée\n");
+        return;
+    }
+
+    fq_ctx_t ctx;
+    tuner_ctx_init(ctx, 4 * FLINT_BITS, tuner);
+
+    slong min_len = TUNER_INFINITY;
+    slong first = 0;
+    for (slong len = 64; len <= tuner->threads_max_len; len *= 2) {
+        double ratio = tuner_ratio(&tune_profile.threads_min_len, 0, TUNER_INFINITY, len, 0, ctx, tuner);
+        printf("threads_min_len : %ld threads, longueur %ld, parallèle/séquentiel %.2f\n", tuner->threads, len, ratio);
+        fflush(stdout);
+
+        if (ratio >= TUNER_MARGIN) {
+            first = 0;
+        } else if (first == 0) {
+            first = len;
+        } else {
+            min_len = first;
+            break;
+        }
+    }
+    tune_profile.threads_min_len = min_len;
+
+    fq_ctx_clear(ctx);
+}
+
+/**
+ * Règle bsgs_weight sur une courbe aléatoire : on chronomètre schoof_bsgs() avec environ TUNER_BSGS_CANDIDATES
+ * candidats et schoof_mod_l() pour le premier l qu'il remplacerait, et on compare le rapport des durées à celui
+ * des modèles (c.f schoof_bsgs_cost() et schoof_cost()).
+ */
+void tuner_bsgs(tuner_t tuner) {
+    fq_ctx_t ctx;
+    tuner_ctx_init(ctx, tuner->bsgs_bits, tuner);
+
+    ell_curve_t E;
+    ell_curve_init(E, ctx);
+
+    fq_t a, b;
+    fq_init(a, ctx);
+    fq_init(b, ctx);
+    do {
+        fq_rand(a, tuner->state, ctx);
+        fq_rand(b, tuner->state, ctx);
+    } while (ell_curve_set(E, a, b, ctx) != EXIT_SUCCESS);
+
+    schoof_opt_t opt;
+    schoof_opt_init(opt);
+
+    fmpz_t q, N, N_A, A, res;
+    fmpz_init(q);
+    fmpz_init(N);
+    fmpz_init(N_A);
+    fmpz_init(A);
+    fmpz_init(res);
+    fq_ctx_order(q, ctx);
+    ell_schoof(N, E, opt, ctx);
+
+    // A = 3*5*7*... jusqu'à ce qu'il reste au plus TUNER_BSGS_CANDIDATES candidats, l est le module suivant
+    double bound = 4 * sqrt(fmpz_get_d(q));
+    ulong l = 3;
+    fmpz_one(A);
+    for (; bound / fmpz_get_d(A) > TUNER_BSGS_CANDIDATES; l = n_nextprime(l, 1)) {
+        if (!fmpz_equal_ui(q, l)) fmpz_mul_ui(A, A, l);
+    }
+    fmpz_mod(N_A, N, A);
+    double K = bound / fmpz_get_d(A) + 1;
+
+    double weight = tune_profile.bsgs_weight;
+    tune_profile.bsgs_weight = 1;
+    double cost_bsgs = schoof_bsgs_cost(K, ctx);
+    double cost_l = schoof_cost((l*l - 1) / 2.0, l, ctx);
+    tune_profile.bsgs_weight = weight;
+
+    double time_bsgs = 0;
+    slong reps = 1;
+    for (slong n = 1; time_bsgs < tuner->min_time; n *= 2) {
+        double start = tors_stop_now();
+        for (slong i = 0; i < n; i++) schoof_bsgs(res, N_A, A, E, ctx);
+        time_bsgs = tors_stop_now() - start;
+        reps = n;
+    }
+    time_bsgs /= reps;
+
+    list_fq_poly_t list_psi;
+    list_fq_poly_init(list_psi);
+    update_list_div_poly(list_psi, E, l, ctx);
+
+    double time_l = 0;
+    for (slong n = 1; time_l < tuner->min_time; n *= 2) {
+        double start = tors_stop_now();
+        for (slong i = 0; i < n; i++) schoof_mod_l(l, PSI(l), NULL, NULL, 0, E, opt, ctx);
+        time_l = tors_stop_now() - start;
+        reps = n;
+    }
+    time_l /= reps;
+
+    tune_profile.bsgs_weight = (time_bsgs / cost_bsgs) / (time_l / cost_l);
+    printf("bsgs_weight : %ld bits, %.0f candidats en %.3g s, l = %lu en %.3g s\n", tuner->bsgs_bits, K, time_bsgs, l, time_l);
+
+    list_fq_poly_clear(list_psi, ctx);
+    ell_curve_clear(E, ctx);
+    fq_clear(a, ctx);
+    fq_clear(b, ctx);
+    fmpz_clear(q);
+    fmpz_clear(N);
+    fmpz_clear(N_A);
+    fmpz_clear(A);
+    fmpz_clear(res);
+    fq_ctx_clear(ctx);
+}
+
+int main(int argc, char** argv) {
+    const char* path = "schoof.tune";
+
+    tuner_t tuner;
+    tuner->min_time = TUNER_MIN_TIME;
+    tuner->max_len = TUNER_MAX_LEN;
+    tuner->threads_max_len = TUNER_THREADS_MAX_LEN;
+    tuner->threads = FLINT_MIN(sysconf(_SC_NPROCESSORS_ONLN), TUNER_MAX_THREADS);
+    tuner->bsgs_bits = TUNER_BSGS_BITS;
+
+    int c;
+    while ((c = getopt(argc, argv, "o:j:qh")) != -1) {
+        switch (c) {
+            case 'o':
+                path = optarg;
+                break;
+            case 'j':
+                tuner->threads = FLINT_MAX(atol(optarg), 1);
+                break;
+            case 'q':
+                tuner->min_time /= 4;
+                tuner->max_len /= 2;
+                tuner->threads_max_len /= 2;
+                tuner->bsgs_bits /= 2;
+                break;
+            default:
+                fprintf(stderr, "Usage : %s [-o fichier] [-j threads] [-q]\n", argv[0]);
+                fprintf(stderr, "Mesure les seuils des algorithmes sur cette machine et écrit le profil à désigner par %s.\n", TUNE_ENV);
+                return (c == 'h') ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+
+    flint_randinit(tuner->state);
+
+    // Les mesures partent des valeurs par défaut, même si un profil est déjà chargé
+    tune_get();
+    tune_set_default(&tune_profile);
+
+    // Les produits sur plusieurs threads ne doivent pas fausser les autres mesures
+    slong threads_min_len = tune_profile.threads_min_len;
+    tune_profile.threads_min_len = TUNER_INFINITY;
+
+    // Une mesure par entrée des tables, au plus grand q de chaque taille
+    slong mont_bits[TUNE_MONT_SIZES], simd_bits[TUNE_SIMD_SIZES];
+    for (slong i = 0; i < TUNE_MONT_SIZES; i++) mont_bits[i] = tune_mont_limbs[i] * FLINT_BITS;
+    for (slong i = 0; i < TUNE_SIMD_SIZES; i++) simd_bits[i] = FLINT_MIN(tune_simd_bits[i], SIMD_MAX_BITS - 1);
+    tuner_max_len("mont_max_len", tune_profile.mont_max_len, mont_bits, TUNE_MONT_SIZES, tuner);
+    tuner_max_len("simd_max_len", tune_profile.simd_max_len, simd_bits, TUNE_SIMD_SIZES, tuner);
+    tuner_pre_fft(tuner);
+
+    tune_profile.threads_min_len = threads_min_len;
+    tuner_threads(tuner);
+    tuner_bsgs(tuner);
+
+    flint_randclear(tuner->state);
+
+    if (tune_save(&tune_profile, path) != 0) {
+        fprintf(stderr, "Impossible d'écrire %s\n", path);
+        return EXIT_FAILURE;
+    }
+    printf("Profil écrit dans %s, à charger avec %s=%s\n", path, TUNE_ENV, path);
+    return EXIT_SUCCESS;
+}
\ No newline at end of file
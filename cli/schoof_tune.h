@@ -0,0 +1,62 @@
+#ifndef SCHOOF_TUNE_H
+#define SCHOOF_TUNE_H
+
+#define _POSIX_C_SOURCE 200809L // getopt() et sysconf()
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <flint/flint.h>
+#include <flint/fmpz.h>
+#include <flint/fq.h>
+#include <flint/fq_poly.h>
+#include "schoof.h"
+#include "tors_ring.h"
+#include "tune.h"
+
+/**
+ * Réglage des seuils sur la machine (c.f tune.h). Chaque seuil est mesuré en chronométrant les deux chemins
+ * qu'il sépare, avec les vrais noyaux de tors_ring.h, sur des ψ aléatoires de longueur croissante et pour
+ * plusieurs tailles de q :
+ *  - mont_max_len et simd_max_len : noyaux naïfs de Montgomery (q de 2, 4 et 8 limbs) ou vectorisés (q de 32 et
+ *    49 bits) contre la multiplication de FLINT, une longueur de croisement par taille de q (c.f tune.h) ;
+ *  - pre_fft_min_limbs et pre_fft_min_len : produit par un opérande dont la transformée est précalculée
+ *    (c.f tors_poly_mul_pre()) contre le produit ordinaire, pour q de 2 à TUNER_PRE_FFT_MAX_LIMBS limbs ;
+ *  - threads_min_len : produit sur plusieurs threads (c.f tors_poly_mul_threads()) contre un seul thread ;
+ *  - bsgs_weight : temps mesuré de schoof_bsgs() et de schoof_mod_l() rapportés à leurs modèles de coût.
+ * Le profil obtenu est écrit dans un fichier, à désigner ensuite par la variable d'environnement TUNE_ENV.
+ */
+
+#define TUNER_INFINITY (WORD_MAX / 4) // Seuil jamais atteint, sans débordement dans 2*seuil + 2 (c.f tors_poly_reduce_threads())
+#define TUNER_MIN_TIME 0.02 // Durée minimale (secondes) d'une mesure, répétée jusqu'à l'atteindre
+#define TUNER_MARGIN 0.95 // Un précalcul ou des threads ne sont retenus que s'ils font gagner au moins 5%
+#define TUNER_MAX_LEN 512 // Longueur maximale de psi essayée pour les noyaux et les transformées précalculées
+#define TUNER_PRE_FFT_MAX_LIMBS 16 // Taille maximale de q (en limbs) essayée pour les transformées précalculées
+#define TUNER_THREADS_MAX_LEN 4096 // Longueur maximale de psi essayée pour les produits sur plusieurs threads
+#define TUNER_MAX_THREADS 4 // Nombre maximal de threads des produits mesurés
+#define TUNER_BSGS_BITS 64 // Taille de q pour bsgs_weight
+#define TUNER_BSGS_CANDIDATES 1024 // Nombre approximatif de candidats départagés par schoof_bsgs() pour bsgs_weight
+
+// Paramètres des mesures, divisés par -q pour un réglage rapide
+typedef struct {
+    double min_time;
+    slong max_len;
+    slong threads_max_len;
+    slong threads; // Threads des produits, le réglage de threads_min_len est sauté s'il vaut 1
+    slong bsgs_bits;
+    flint_rand_t state;
+} tuner_struct;
+
+typedef tuner_struct tuner_t[1]; // On adopte la convention de FLINT sur les nouveaux types
+
+void tuner_ctx_init(fq_ctx_t, const slong, tuner_t);
+slong tuner_next_len(const slong);
+double tuner_time_mul(const slong, const int, const fq_ctx_t, tuner_t);
+double tuner_ratio(slong*, const slong, const slong, const slong, const int, const fq_ctx_t, tuner_t);
+void tuner_max_len(const char*, slong*, const slong*, const slong, tuner_t);
+void tuner_pre_fft(tuner_t);
+void tuner_threads(tuner_t);
+void tuner_bsgs(tuner_t);
+int main(int, char**);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,87 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <gmp.h>
+#include <flint/flint.h>
+
+/**
+ * Allocateur par arène pour les allocations de FLINT (et de GMP) pendant le traitement d'un nombre premier l.
+ *
+ * Les fonctions mémoire de FLINT et de GMP sont remplacées tant qu'au moins une arène est ouverte, dans n'importe
+ * quel thread (c.f arena_install() et arena_restore()). Tant qu'un thread a une arène courante (entre
+ * arena_begin() et arena_end()), ses allocations sont prises par incrément d'un pointeur dans de grands blocs,
+ * ses libérations ne coûtent rien, et tout est rendu d'un coup par arena_end(). Les autres threads, et les blocs
+ * alloués hors de l'arène, passent par les fonctions d'origine.
+ * Rien de ce qui est alloué dans l'arène ne doit lui survivre ni changer de thread, sauf les caches de FLINT
+ * propres au thread, que arena_end() vide s'ils y ont pris de la place.
+ */
+
+#define ARENA_CHUNK_MIN (1 << 20) // Taille minimale d'un bloc demandé au système
+#define ARENA_ALIGN 16 // Alignement des allocations, aussi taille de l'en-tête qui conserve leur taille
+
+typedef struct arena_chunk_struct {
+    struct arena_chunk_struct* next;
+    size_t size; // Capacité du bloc, en-tête de bloc non compris
+    size_t used;
+} arena_chunk_struct;
+
+typedef struct {
+    arena_chunk_struct* chunks; // Bloc courant en tête
+    size_t reserved; // Octets demandés au système
+    size_t used; // Octets occupés dans les blocs
+    size_t allocated; // Octets alloués depuis arena_begin(), libérations comprises
+    size_t peak; // Maximum de used depuis arena_begin()
+    slong live; // Allocations pas encore libérées depuis arena_begin()
+    void* prev; // Arène courante avant arena_begin()
+} arena_struct;
+
+typedef arena_struct arena_t[1]; // On adopte la convention de FLINT sur les nouveaux types
+
+// Fonctions mémoire de FLINT et de GMP en place avant arena_install()
+typedef struct {
+    void* (*alloc_func)(size_t);
+    void* (*calloc_func)(size_t, size_t);
+    void* (*realloc_func)(void*, size_t);
+    void (*free_func)(void*);
+    void* (*gmp_alloc_func)(size_t);
+    void* (*gmp_realloc_func)(void*, size_t, size_t);
+    void (*gmp_free_func)(void*, size_t);
+} arena_hooks_struct;
+
+extern arena_hooks_struct arena_hooks;
+extern pthread_mutex_t arena_mutex; // Protège les trois variables suivantes
+extern slong arena_active; // Nombre d'arènes ouvertes, tous threads confondus
+extern int arena_saved; // Non nul une fois arena_hooks lues
+
+// Arène courante du thread, NULL en dehors de arena_begin() et arena_end()
+extern _Thread_local arena_struct* arena_current;
+
+/**************/
+/* PRIMITIVES */
+/**************/
+
+void arena_init(arena_t);
+void arena_clear(arena_t);
+void arena_install(void);
+void arena_restore(void);
+void arena_begin(arena_t);
+void arena_end(arena_t);
+int arena_owns(const arena_t, const void*);
+
+/*********************/
+/* FONCTIONS MEMOIRE */
+/*********************/
+
+void* arena_alloc(arena_t, size_t);
+void* arena_malloc(size_t);
+void* arena_calloc(size_t, size_t);
+void* arena_realloc(void*, size_t);
+void arena_free(void*);
+void* arena_gmp_alloc(size_t);
+void* arena_gmp_realloc(void*, size_t, size_t);
+void arena_gmp_free(void*, size_t);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,107 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <stdlib.h>
+#include <string.h>
+#include <flint/flint.h>
+#include <flint/fmpz.h>
+#include <flint/fq.h>
+#include <flint/fq_poly.h>
+#include "simd.h"
+#include "ell_curve.h"
+#include "ell_cpoint.h"
+#include "tors_ring.h"
+#include "list.h"
+#include "schoof.h"
+
+/**
+ * Algorithme de Schoof par lots : plusieurs courbes sur le même corps premier F_p (p < 2^SIMD_MAX_BITS) sont
+ * traitées en même temps, chacune dans une voie.
+ *
+ * Pour un l donné, le déroulement de schoof_mod_l() ne dépend de la courbe que par les tests d'égalité : les
+ * exposants (q, (q-1)/2, q mod l) et les degrés de ψ_l sont les mêmes pour toutes. On entrelace donc les
+ * polynômes des différentes courbes (c.f simd_lanes_mul()) et chaque opération sur les coefficients traite
+ * toutes les voies d'une seule instruction vectorielle. Les voies qui ont déjà trouvé a_q modulo l sont
+ * masquées dans la boucle sur t, qui s'arrête quand toutes ont conclu. Les rares additions et duplications
+ * exceptionnelles (point à l'infini, H = 0, Y = 0) sont refaites voie par voie avec ell_cpoint.h.
+ */
+
+#define BATCH_MAX_LANES 16 // Nombre maximal de courbes traitées ensemble
+
+typedef struct {
+    slong num; // Nombre de courbes
+    slong lanes; // num arrondi au multiple supérieur de simd_lanes(), les voies en trop répètent la première courbe
+    simd_ctx_t simd;
+    ell_curve_struct* curves; // Courbe de chaque voie
+    double* a; // a de chaque voie
+    double* W; // W = x^3 + a*x + b de chaque voie, entrelacés (4 coefficients)
+    tors_ring_struct* rings; // Anneau de torsion de chaque voie, pour les opérations exceptionnelles
+    double* psi; // ψ_l unitaire de chaque voie, entrelacés
+    slong len_psi; // Longueur commune des ψ_l
+} batch_struct;
+
+typedef batch_struct batch_t[1]; // On adopte la convention de FLINT sur les nouveaux types
+
+// Point compact (c.f ell_cpoint_struct) de chaque voie, coordonnées entrelacées de len_psi-1 coefficients
+typedef struct {
+    double* X;
+    double* Y;
+    double* Z;
+} batch_point_struct;
+
+typedef batch_point_struct batch_point_t[1]; // On adopte la convention de FLINT sur les nouveaux types
+
+/**************/
+/* PRIMITIVES */
+/**************/
+
+void batch_init(batch_t, const ell_curve_struct*, const slong, const fq_ctx_t);
+void batch_clear(batch_t, const fq_ctx_t);
+void batch_set_psi(batch_t, fq_poly_struct* const*, const fq_ctx_t);
+ulong batch_all(const batch_t);
+
+/************************/
+/* POLYNOMES ENTRELACES */
+/************************/
+
+void batch_poly_set_lane(double*, const fq_poly_t, const slong, const slong, const batch_t, const fq_ctx_t);
+void batch_poly_get_lane(fq_poly_t, const double*, const slong, const slong, const batch_t, const fq_ctx_t);
+void batch_poly_add(double*, const double*, const double*, const slong, const batch_t);
+void batch_poly_sub(double*, const double*, const double*, const slong, const batch_t);
+void batch_poly_scalar_mul_ui(double*, const double*, const ulong, const slong, const batch_t);
+void batch_poly_mul_a(double*, const double*, const slong, const batch_t);
+void batch_poly_mul(double*, const double*, const slong, const double*, const slong, const batch_t);
+void batch_poly_reduce(double*, double*, const slong, const batch_t);
+void batch_poly_mulmod(double*, const double*, const slong, const double*, const slong, const batch_t);
+void batch_poly_pow(double*, const double*, const slong, const fmpz_t, const batch_t);
+ulong batch_poly_is_zero(const double*, const slong, const batch_t);
+ulong batch_poly_is_one(const double*, const slong, const batch_t);
+ulong batch_poly_equal(const double*, const double*, const slong, const batch_t);
+
+/**********/
+/* POINTS */
+/**********/
+
+void batch_point_init(batch_point_t, const batch_t);
+void batch_point_clear(batch_point_t);
+void batch_point_set_infinity(batch_point_t, const batch_t);
+void batch_point_set_x_y(batch_point_t, const batch_t);
+void batch_point_copy(batch_point_t, const batch_point_t, const batch_t);
+void batch_point_swap(batch_point_t, batch_point_t);
+void batch_point_set_lane(batch_point_t, const ell_cpoint_t, const slong, const batch_t, const fq_ctx_t);
+void batch_point_get_lane(ell_cpoint_t, const batch_point_t, const slong, const batch_t, const fq_ctx_t);
+ulong batch_point_is_infinity(const batch_point_t, const batch_t);
+ulong batch_point_equal(const batch_point_t, const batch_point_t, const batch_t);
+void batch_point_double(batch_point_t, const batch_point_t, const ulong, const batch_t, const fq_ctx_t);
+void batch_point_add(batch_point_t, const batch_point_t, const batch_point_t, const ulong, const batch_t, const fq_ctx_t);
+void batch_point_mul(batch_point_t, const batch_point_t, const ulong, const batch_t, const fq_ctx_t);
+
+/*******************/
+/* SCHOOF PAR LOTS */
+/*******************/
+
+void batch_schoof_mod_l(ulong*, const ulong, const batch_t, const fq_ctx_t);
+void batch_schoof_curves(fmpz*, const ell_curve_struct*, const slong, const fq_ctx_t);
+int batch_schoof(fmpz*, const fq_struct*, const fq_struct*, const slong, const fq_ctx_t);
+
+#endif
\ No newline at end of file
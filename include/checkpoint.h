@@ -0,0 +1,51 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <stdio.h>
+#include <flint/flint.h>
+#include <flint/fmpz.h>
+#include <flint/fq.h>
+#include <flint/fq_poly.h>
+#include "ell_curve.h"
+#include "list.h"
+
+/**
+ * Points de reprise de l'algorithme de Schoof.
+ *
+ * Le fichier de reprise contient la courbe, le corps de base et les couples (l, a_q mod l) déjà calculés :
+ *
+ *     schoof-checkpoint 1
+ *     p <p>
+ *     a <a>
+ *     b <b>
+ *     <nombre de couples>
+ *     <l> <t>
+ *     ...
+ *     end
+ *
+ * Il est réécrit en entier après chaque nombre premier dans un fichier temporaire, puis renommé et son répertoire
+ * vidé sur le disque : une interruption laisse donc toujours l'ancienne ou la nouvelle version, jamais un fichier
+ * tronqué.
+ *
+ * Les polynômes de division peuvent aussi être conservés dans <chemin>.psi, où ils sont ajoutés à la fin au
+ * fur et à mesure sous forme d'enregistrements "psi <m> <longueur>", coefficients, "end <m>". À la lecture,
+ * on s'arrête au premier enregistrement incomplet et on le coupe du fichier.
+ *
+ * Seuls les corps premiers sont gérés (a et b sont écrits comme des entiers modulo p).
+ */
+
+#define CHECKPOINT_PSI_SUFFIX ".psi"
+
+char* checkpoint_path_cat(const char*, const char*);
+void checkpoint_fprint_fq(FILE*, const fq_t, const fq_ctx_t);
+int checkpoint_expect(FILE*, const char*);
+int checkpoint_close_sync(FILE*);
+int checkpoint_sync_dir(const char*);
+ulong checkpoint_max_pairs(const fq_ctx_t);
+int checkpoint_save(const char*, const ell_curve_t, const list_ulong_t, const list_ulong_t, const fq_ctx_t);
+int checkpoint_load(list_ulong_t, list_ulong_t, const char*, const ell_curve_t, const fq_ctx_t);
+int checkpoint_read_curve(fmpz_t, fmpz_t, fmpz_t, const char*);
+int checkpoint_psi_load(list_fq_poly_t, const char*, const fq_ctx_t);
+int checkpoint_psi_append(const char*, const list_fq_poly_t, const ulong, const fq_ctx_t);
+
+#endif
\ No newline at end of file
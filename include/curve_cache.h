@@ -0,0 +1,81 @@
+#ifndef CURVE_CACHE_H
+#define CURVE_CACHE_H
+
+#include <stdlib.h>
+#include <flint/flint.h>
+#include <flint/fmpz.h>
+#include <flint/fq.h>
+#include "schoof.h"
+
+/**
+ * Cache persistant des nombres de points, indexé par classe d'isomorphisme.
+ *
+ * Sur F_p (p > 3), y^2 = x^3 + a*x + b et y^2 = x^3 + u^4*a*x + u^6*b sont isomorphes. Une classe est
+ * déterminée par j = 1728*4*a^3/(4*a^3 + 27*b^2) et par la classe de twist w :
+ *    - si j != 0, 1728 : w = (b/a)^{(p-1)/2}, car b/a est multiplié par u^2,
+ *    - si j = 0 (a = 0) : w = b^{(p-1)/g} avec g = pgcd(6, p-1),
+ *    - si j = 1728 (b = 0) : w = a^{(p-1)/g} avec g = pgcd(4, p-1).
+ * Dans tous les cas le twist quadratique a pour classe -w et 2*p + 2 - #E points : un calcul remplit donc
+ * deux entrées.
+ *
+ * Le cache est une table de hachage à adressage ouvert de taille fixe dans un fichier projeté en mémoire par
+ * mmap(). Les insertions sont verrouillées entre processus par fcntl(), mais pas entre threads d'un même
+ * processus : l'appelant doit les sérialiser lui-même. Les lectures ne prennent pas de verrou : une entrée est
+ * remplie avant que son état ne passe à CURVE_CACHE_FULL et n'est plus jamais modifiée ensuite.
+ *
+ * Seuls les corps premiers avec p < 2^(64*CURVE_CACHE_LIMBS - 2) sont gérés, les autres ne sont jamais dans le
+ * cache.
+ */
+
+#define CURVE_CACHE_MAGIC "SCHCACHE"
+#define CURVE_CACHE_VERSION 1
+#define CURVE_CACHE_LIMBS 8 // Nombre de mots pour chaque entier stocké
+#define CURVE_CACHE_EMPTY 0
+#define CURVE_CACHE_FULL 1
+
+typedef struct {
+    char magic[8];
+    ulong version;
+    ulong capacity; // Nombre d'entrées de la table
+    ulong count; // Nombre d'entrées remplies
+} curve_cache_header_struct;
+
+typedef struct {
+    ulong state; // CURVE_CACHE_EMPTY ou CURVE_CACHE_FULL, écrit en dernier
+    ulong hash;
+    ulong p[CURVE_CACHE_LIMBS];
+    ulong j[CURVE_CACHE_LIMBS];
+    ulong w[CURVE_CACHE_LIMBS];
+    ulong n[CURVE_CACHE_LIMBS]; // Nombre de points
+} curve_cache_entry_struct;
+
+typedef struct {
+    int fd;
+    size_t size; // Taille du fichier projeté
+    curve_cache_header_struct* header;
+    curve_cache_entry_struct* entries;
+} curve_cache_struct;
+
+typedef curve_cache_struct curve_cache_t[1]; // On adopte la convention de FLINT sur les nouveaux types
+
+/**************/
+/* PRIMITIVES */
+/**************/
+
+size_t curve_cache_size(const ulong);
+int curve_cache_open(curve_cache_t, const char*, const ulong);
+void curve_cache_close(curve_cache_t);
+int curve_cache_lock(const curve_cache_t, const int);
+
+/**************************/
+/* CLASSES D'ISOMORPHISME */
+/**************************/
+
+int curve_cache_invariants(fmpz_t, fmpz_t, const fq_t, const fq_t, const fq_ctx_t);
+ulong curve_cache_hash(const ulong*, const ulong*, const ulong*);
+curve_cache_entry_struct* curve_cache_find(const curve_cache_t, const ulong*, const ulong*, const ulong*, const ulong, int*);
+int curve_cache_lookup(fmpz_t, const curve_cache_t, const fq_t, const fq_t, const fq_ctx_t);
+int curve_cache_insert(curve_cache_t, const fq_t, const fq_t, const fmpz_t, const fq_ctx_t);
+int schoof_cached(fmpz_t, curve_cache_t, const fq_t, const fq_t, const schoof_opt_t, const fq_ctx_t);
+
+#endif
\ No newline at end of file
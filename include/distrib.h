@@ -0,0 +1,67 @@
+#ifndef DISTRIB_H
+#define DISTRIB_H
+
+#include <sys/types.h>
+#include <flint/flint.h>
+#include <flint/fmpz.h>
+#include <flint/fq.h>
+#include "ell_curve.h"
+#include "list.h"
+#include "schoof.h"
+
+/**
+ * Algorithme de Schoof réparti sur plusieurs processus.
+ *
+ * Un coordinateur répartit les nombres premiers l entre des processus de calcul reliés chacun par une socket
+ * (socketpair() pour les processus locaux créés par fork()), puis retrouve a_q par le théorème des restes
+ * chinois. Le protocole est textuel, une commande par ligne :
+ *
+ *     coordinateur -> processus : "l <l>"       calculer a_q mod l
+ *                                 "quit"        terminer
+ *     processus -> coordinateur : "t <l> <t>"   a_q = t mod l
+ *
+ * distrib_worker() ne dépend que du descripteur de fichier : un processus distant peut donc servir de
+ * processus de calcul si l'on relie son entrée et sa sortie à une socket du coordinateur.
+ *
+ * Si un processus meurt (fin de fichier sur sa socket), le nombre premier qu'il traitait est redonné à un
+ * nouveau processus. Un nombre premier dont le calcul a tué DISTRIB_MAX_ATTEMPTS processus fait échouer le
+ * calcul.
+ */
+
+#define DISTRIB_MAX_ATTEMPTS 3
+#define DISTRIB_BUFFER 128 // Taille maximale d'une ligne du protocole
+
+// Un processus de calcul vu par le coordinateur
+typedef struct {
+    pid_t pid; // -1 si le processus n'existe pas
+    int fd; // Socket vers le processus
+    slong job; // Indice du nombre premier en cours de calcul, -1 si le processus est libre
+    char buf[DISTRIB_BUFFER]; // Ligne en cours de réception
+    slong buf_len;
+} distrib_worker_struct;
+
+// Nombres premiers l à traiter et leur état
+typedef struct {
+    ulong* primes;
+    ulong* ts;
+    int* state; // 0 : à faire, 1 : en cours, 2 : fait
+    int* attempts; // Nombre de processus auxquels l a été confié
+    slong len;
+    slong num_done;
+} distrib_jobs_struct;
+
+typedef distrib_jobs_struct distrib_jobs_t[1]; // On adopte la convention de FLINT sur les nouveaux types
+
+void distrib_jobs_init(distrib_jobs_t, const fq_ctx_t);
+void distrib_jobs_clear(distrib_jobs_t);
+slong distrib_jobs_find(const distrib_jobs_t, const ulong);
+void distrib_jobs_get_lists(list_ulong_t, list_ulong_t, const distrib_jobs_t);
+void distrib_worker(int, const ell_curve_t, const schoof_opt_t, const fq_ctx_t);
+int distrib_spawn(distrib_worker_struct*, const slong, const slong, const ell_curve_t, const schoof_opt_t, const fq_ctx_t);
+void distrib_kill(distrib_worker_struct*, const int);
+int distrib_send(distrib_worker_struct*, const char*, const ulong);
+int distrib_receive(distrib_worker_struct*, distrib_jobs_t);
+int distrib_supported(const schoof_opt_t);
+int ell_schoof_distrib(fmpz_t, const ell_curve_t, const schoof_opt_t, const fq_ctx_t);
+
+#endif
\ No newline at end of file
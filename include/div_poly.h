@@ -0,0 +1,53 @@
+#ifndef DIV_POLY_H
+#define DIV_POLY_H
+
+#include <pthread.h>
+#include <flint/flint.h>
+#include <flint/fmpz.h>
+#include <flint/fmpz_poly.h>
+#include <flint/fq.h>
+#include <flint/fq_poly.h>
+#include "ell_curve.h"
+#include "list.h"
+#include "schoof.h"
+
+/**
+ * Construction des polynômes de division sur plusieurs threads.
+ *
+ * ψ_m ne dépend que des ψ_k avec m/2 - 2 <= k <= m/2 + 2. Si ψ_0, ..., ψ_{n-1} sont connus, tous les ψ_m avec
+ * n <= m <= 2*n - 5 peuvent donc être calculés en même temps : la récurrence avance par niveaux dont la taille
+ * double à chaque fois, et les ψ_m d'un même niveau sont répartis entre les threads d'un groupe créé une fois
+ * pour toutes. Le thread appelant participe au calcul puis ajoute les ψ_m du niveau, dans l'ordre, à la liste.
+ *
+ * Pour une courbe définie sur Q (a et b entiers), la même récurrence sur Z donne des ψ_m dont la réduction
+ * modulo p est celle des ψ_m de la courbe réduite : ils ne sont calculés qu'une fois pour tous les p (c.f range.h).
+ */
+
+// Groupe de threads de update_list_div_poly_threads(), qui se partagent les ψ_m du niveau en cours
+typedef struct {
+    pthread_mutex_t mutex;
+    pthread_cond_t work_ready; // Un nouveau niveau (ou l'arrêt) est disponible
+    pthread_cond_t work_done; // Tous les threads ont fini le niveau
+    ulong level; // Numéro du niveau en cours, 0 avant le premier
+    ulong next; // Prochain m à calculer
+    ulong last; // Dernier m du niveau
+    slong busy; // Threads (hors appelant) qui n'ont pas fini le niveau
+    int stop;
+    fq_poly_struct** psi; // psi[m] = ψ_m, pour tous les m déjà calculés ou du niveau en cours
+    const fq_poly_struct* W2; // (x^3 + a*x + b)^2
+    const fq_struct* inv2; // 2^{-1} dans F_q
+    const fq_ctx_struct* ctx;
+} div_poly_pool_struct;
+
+typedef div_poly_pool_struct div_poly_pool_t[1]; // On adopte la convention de FLINT sur les nouveaux types
+
+void div_poly_step(fq_poly_t, const ulong, fq_poly_struct* const*, const fq_poly_t, const fq_t, const fq_ctx_t);
+void div_poly_pool_run(div_poly_pool_t);
+void* div_poly_pool_worker(void*);
+void update_list_div_poly_threads(list_fq_poly_t, const ell_curve_t, const ulong, const slong, const fq_ctx_t);
+void div_poly_fmpz_step(fmpz_poly_t, const ulong, const fmpz_poly_struct*, const fmpz_poly_t);
+void div_poly_fmpz(fmpz_poly_struct*, const ulong, const fmpz_t, const fmpz_t);
+void div_poly_reduce(fq_poly_t, const fmpz_poly_t, const fq_ctx_t);
+void update_list_div_poly_reduce(list_fq_poly_t, const fmpz_poly_struct*, const ulong, const fq_ctx_t);
+
+#endif
\ No newline at end of file
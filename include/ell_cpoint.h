@@ -0,0 +1,85 @@
+#ifndef ELL_CPOINT_H
+#define ELL_CPOINT_H
+
+#include <flint/flint.h>
+#include <flint/fq.h>
+#include <flint/fq_poly.h>
+#include "ell_curve.h"
+#include "tors_ring.h"
+
+/**
+ * Représentation compacte des points de E(R_{E,l}) utilisés dans l'algorithme de Schoof.
+ *
+ * Tous les points rencontrés (multiples de (x,y), images par le Frobenius et leurs sommes) ont une abscisse
+ * dans F_q[x] et une ordonnée dans y*F_q[x]. En coordonnées jacobiennes, on peut toujours se ramener à
+ * X, Z dans F_q[x] et Y dans y*F_q[x] : le point représenté est (X/Z^2, y*Y/Z^3). On ne stocke donc qu'un
+ * polynôme en x par coordonnée, le facteur y de Y étant implicite, et y^2 = x^3 + a*x + b est replié dans
+ * les formules.
+ */
+
+typedef struct {
+    fq_poly_t X;
+    fq_poly_t Y; // Le point a pour ordonnée jacobienne y*Y
+    fq_poly_t Z;
+} ell_cpoint_struct;
+
+typedef ell_cpoint_struct ell_cpoint_t[1]; // On adopte la convention de FLINT sur les nouveaux types
+
+// Point fixe d'une boucle, dont les coordonnées sont préparées pour tors_poly_mul_pre() (c.f tors_pre_t)
+typedef struct {
+    ell_cpoint_t P;
+    tors_pre_t X;
+    tors_pre_t Y;
+    tors_pre_t Z2; // Z^2
+    tors_pre_t Z3; // Z^3
+} ell_cpoint_pre_struct;
+
+typedef ell_cpoint_pre_struct ell_cpoint_pre_t[1]; // On adopte la convention de FLINT sur les nouveaux types
+
+/**************/
+/* PRIMITIVES */
+/**************/
+
+void ell_cpoint_init(ell_cpoint_t, const fq_ctx_t);
+void ell_cpoint_clear(ell_cpoint_t, const fq_ctx_t);
+void ell_cpoint_set_infinity(ell_cpoint_t, const fq_ctx_t);
+void ell_cpoint_set_x_y(ell_cpoint_t, const fq_ctx_t);
+void ell_cpoint_copy(ell_cpoint_t, const ell_cpoint_t, const fq_ctx_t);
+void ell_cpoint_swap(ell_cpoint_t, ell_cpoint_t, const fq_ctx_t);
+int ell_cpoint_is_infinity(const ell_cpoint_t, const fq_ctx_t);
+int ell_cpoint_equal(const ell_cpoint_t, const ell_cpoint_t, const tors_ring_t, const fq_ctx_t);
+int ell_cpoint_equal_x(const ell_cpoint_t, const ell_cpoint_t, const tors_ring_t, const fq_ctx_t);
+
+/******************************************/
+/* OPERATIONS SUR LES COURBES ELLIPTIQUES */
+/******************************************/
+
+void ell_cpoint_neg(ell_cpoint_t, const ell_cpoint_t, const fq_ctx_t);
+void ell_cpoint_double(ell_cpoint_t, const ell_cpoint_t, const tors_ring_t, const fq_ctx_t);
+void ell_cpoint_add(ell_cpoint_t, const ell_cpoint_t, const ell_cpoint_t, const tors_ring_t, const fq_ctx_t);
+void _ell_cpoint_add(ell_cpoint_t, const ell_cpoint_t, const ell_cpoint_t, fq_poly_t, fq_poly_t, fq_poly_t, fq_poly_t, const tors_ring_t, const fq_ctx_t);
+void ell_cpoint_mul(ell_cpoint_t, const ell_cpoint_t, const fmpz_t, const tors_ring_t, const fq_ctx_t);
+
+/****************/
+/* POINTS FIXES */
+/****************/
+
+void ell_cpoint_pre_init(ell_cpoint_pre_t, const fq_ctx_t);
+void ell_cpoint_pre_clear(ell_cpoint_pre_t, const fq_ctx_t);
+void ell_cpoint_pre_set(ell_cpoint_pre_t, const ell_cpoint_t, const tors_ring_t, const fq_ctx_t);
+void ell_cpoint_add_pre(ell_cpoint_t, const ell_cpoint_t, const ell_cpoint_pre_t, const tors_ring_t, const fq_ctx_t);
+int ell_cpoint_equal_pre(const ell_cpoint_t, const ell_cpoint_pre_t, const tors_ring_t, const fq_ctx_t);
+int ell_cpoint_equal_x_pre(const ell_cpoint_t, const ell_cpoint_pre_t, const tors_ring_t, const fq_ctx_t);
+
+/***************************************************************/
+/* ARITHMETIQUE AFFINE AVEC REDUCTION OPPORTUNISTE DE L'ANNEAU */
+/***************************************************************/
+
+void ell_cpoint_reduce(ell_cpoint_t, const tors_ring_t, const fq_ctx_t);
+int ell_cpoint_equal_aff(const ell_cpoint_t, const ell_cpoint_t, const tors_ring_t, const fq_ctx_t);
+int ell_cpoint_equal_x_aff(const ell_cpoint_t, const ell_cpoint_t, const tors_ring_t, const fq_ctx_t);
+void ell_cpoint_double_aff(ell_cpoint_t, const ell_cpoint_t, tors_ring_t, const fq_ctx_t);
+void ell_cpoint_add_aff(ell_cpoint_t, const ell_cpoint_t, const ell_cpoint_t, tors_ring_t, const fq_ctx_t);
+void ell_cpoint_mul_aff(ell_cpoint_t, const ell_cpoint_t, const fmpz_t, tors_ring_t, const fq_ctx_t);
+
+#endif
\ No newline at end of file
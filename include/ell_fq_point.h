@@ -0,0 +1,52 @@
+#ifndef ELL_FQ_POINT_H
+#define ELL_FQ_POINT_H
+
+#include <flint/flint.h>
+#include <flint/fmpz.h>
+#include <flint/fq.h>
+#include <flint/ulong_extras.h>
+#include "ell_curve.h"
+
+/**
+ * Points rationnels de E(F_q) en coordonnées affines. Contrairement à ell_point.h et ell_cpoint.h qui travaillent
+ * dans E(R_{E,l}), ils servent à départager les derniers candidats pour a_q à l'aide de l'ordre de points
+ * aléatoires (c.f schoof_bsgs()).
+ */
+
+typedef struct {
+    fq_t x;
+    fq_t y;
+    int infinity; // 1 pour le point à l'infini, x et y sont alors sans signification
+} ell_fq_point_struct;
+
+typedef ell_fq_point_struct ell_fq_point_t[1]; // On adopte la convention de FLINT sur les nouveaux types
+
+/**************/
+/* PRIMITIVES */
+/**************/
+
+void ell_fq_point_init(ell_fq_point_t, const fq_ctx_t);
+void ell_fq_point_clear(ell_fq_point_t, const fq_ctx_t);
+void ell_fq_point_set_infinity(ell_fq_point_t, const fq_ctx_t);
+void ell_fq_point_copy(ell_fq_point_t, const ell_fq_point_t, const fq_ctx_t);
+void ell_fq_point_swap(ell_fq_point_t, ell_fq_point_t, const fq_ctx_t);
+int ell_fq_point_equal(const ell_fq_point_t, const ell_fq_point_t, const fq_ctx_t);
+ulong ell_fq_point_hash(const ell_fq_point_t, const fq_ctx_t);
+void ell_fq_point_random(ell_fq_point_t, const ell_curve_t, flint_rand_t, const fq_ctx_t);
+
+/******************************************/
+/* OPERATIONS SUR LES COURBES ELLIPTIQUES */
+/******************************************/
+
+void ell_fq_point_neg(ell_fq_point_t, const ell_fq_point_t, const fq_ctx_t);
+void ell_fq_point_double(ell_fq_point_t, const ell_fq_point_t, const ell_curve_t, const fq_ctx_t);
+void ell_fq_point_add(ell_fq_point_t, const ell_fq_point_t, const ell_fq_point_t, const ell_curve_t, const fq_ctx_t);
+void ell_fq_point_mul(ell_fq_point_t, const ell_fq_point_t, const fmpz_t, const ell_curve_t, const fq_ctx_t);
+
+/*****************************/
+/* PAS DE BEBE, PAS DE GEANT */
+/*****************************/
+
+slong ell_fq_point_bsgs(ulong*, const slong, const ell_fq_point_t, const ell_fq_point_t, const ulong, const ell_curve_t, const fq_ctx_t);
+
+#endif
\ No newline at end of file
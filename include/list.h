@@ -33,6 +33,8 @@ void list_ulong_clear(list_ulong_t);
 ulong list_ulong_len(const list_ulong_t);
 void list_ulong_add(list_ulong_t, const ulong);
 void list_ulong_get_tab(ulong*, const list_ulong_t, const ulong);
+cell_ulong_t* list_ulong_get_cell(const list_ulong_t, const ulong);
+cell_ulong_t* list_ulong_find_multiple(const list_ulong_t, const ulong);
 
 /***************************************************/
 /* DEFINITION ET PRIMITIVES DU TYPE list_fq_poly_t */
@@ -41,12 +43,18 @@ void list_ulong_get_tab(ulong*, const list_ulong_t, const ulong);
 typedef struct cell_fq_poly_struct {
     ulong index; // Numéro de la cellule
     fq_poly_t poly;
+    int evicted; // 1 si poly a été libéré par list_fq_poly_evict()
     struct cell_fq_poly_struct* next;
 } cell_fq_poly_t;
 
 typedef struct {
     cell_fq_poly_t* head;
     cell_fq_poly_t* tail; // Fin de la liste, beaucoup plus efficace pour rajouter des éléments en fin de liste.
+    slong bytes; // Estimation de la mémoire occupée par les coefficients des éléments
+    slong peak_bytes; // Maximum atteint par bytes
+    cell_fq_poly_t* evict_low; // Première cellule que evict_list_div_poly() n'a pas encore vue passer sous k_min
+    cell_fq_poly_t* evict_seen; // Dernière cellule déjà examinée par evict_list_div_poly() à son arrivée
+    ulong evict_l_min; // l_min du dernier appel à evict_list_div_poly()
 } list_fq_poly_struct;
 
 typedef list_fq_poly_struct list_fq_poly_t[1]; // On adopte la convention de FLINT sur les nouveaux types
@@ -56,5 +64,8 @@ void list_fq_poly_clear(list_fq_poly_t, const fq_ctx_t);
 ulong list_fq_poly_len(const list_fq_poly_t);
 void list_fq_poly_add(list_fq_poly_t, fq_poly_t, const fq_ctx_t ctx);
 fq_poly_struct* list_fq_poly_get(const list_fq_poly_t, const ulong);
+slong list_fq_poly_bytes(const fq_poly_t, const fq_ctx_t);
+void list_fq_poly_evict(list_fq_poly_t, cell_fq_poly_t*, const fq_ctx_t);
+int list_fq_poly_is_evicted(const list_fq_poly_t, const ulong);
 
 #endif
\ No newline at end of file
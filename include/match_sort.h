@@ -0,0 +1,66 @@
+#ifndef MATCH_SORT_H
+#define MATCH_SORT_H
+
+#include <stdlib.h>
+#include <flint/flint.h>
+#include <flint/fmpz.h>
+#include <flint/fmpz_vec.h>
+#include <flint/fq.h>
+#include "ell_curve.h"
+#include "ell_fq_point.h"
+
+/**
+ * Combinaison par "match and sort" d'Atkin : on connaît a_q modulo m_1 et seulement un ensemble de classes
+ * possibles modulo d'autres modules m_i premiers entre eux (c.f schoof_mod_l() avec up_to_sign). Les modules
+ * candidats sont répartis en deux groupes B et G, et pour un point aléatoire P de E(F_q) on cherche les
+ * combinaisons vérifiant [q + 1 - c - g]P = [b]P, où g parcourt les combinaisons de G et b celles de B (plus les
+ * multiples de M = m_1 * prod m_i utiles pour rester dans l'intervalle de Hasse). Les [b]P sont rangés dans une
+ * table de hachage de taille bornée par MATCH_SORT_MAX_TABLE, les [g]P sont parcourus sans être stockés.
+ */
+
+#define MATCH_SORT_MAX_TABLE (1 << 16) // Nombre maximal de points du côté B stockés dans la table
+#define MATCH_SORT_MAX_MATCHES 16 // Au-delà, le point aléatoire est d'ordre trop petit pour être utile
+#define MATCH_SORT_POINTS 8 // Nombre maximal de points aléatoires essayés par match_sort()
+
+// Classes possibles de a_q modulo un module
+typedef struct {
+    ulong modulus;
+    slong num; // Nombre de classes possibles
+    ulong* residues;
+} match_sort_cand_struct;
+
+typedef match_sort_cand_struct match_sort_cand_t[1]; // On adopte la convention de FLINT sur les nouveaux types
+
+// Précalculs liés à un point P : idempotents du théorème des restes chinois et sauts entre classes consécutives
+typedef struct {
+    fmpz_t M; // m_1 * prod m_i
+    fmpz_t c; // t_1*e_1 mod M, contribution de la classe exacte t_1 modulo m_1
+    fmpz* start_val; // start_val[i] = r_{i,0}*e_i mod M
+    fmpz** delta_val; // delta_val[i][j] = (r_{i,j+1} - r_{i,j})*e_i mod M, le dernier saut revenant à r_{i,0}
+    ell_fq_point_struct** delta; // delta[i][j] = [delta_val[i][j]]P
+    ell_fq_point_t MP; // [M]P
+    slong* nums; // Nombre de classes de chaque module candidat
+    slong num_cands;
+} match_sort_steps_struct;
+
+typedef match_sort_steps_struct match_sort_steps_t[1]; // On adopte la convention de FLINT sur les nouveaux types
+
+/**************/
+/* PRIMITIVES */
+/**************/
+
+void match_sort_cand_init(match_sort_cand_t, const ulong, const ulong*, const slong);
+void match_sort_cand_clear(match_sort_cand_t);
+void match_sort_steps_init(match_sort_steps_t, const fmpz_t, const fmpz_t, const match_sort_cand_struct*, const slong, const ell_fq_point_t, const ell_curve_t, const fq_ctx_t);
+void match_sort_steps_clear(match_sort_steps_t, const fq_ctx_t);
+void match_sort_first(slong*, fmpz_t, ell_fq_point_t, const slong*, const slong, const match_sort_steps_t, const ell_fq_point_t, const ell_curve_t, const fq_ctx_t);
+int match_sort_next(slong*, fmpz_t, ell_fq_point_t, const slong*, const slong, const match_sort_steps_t, const ell_curve_t, const fq_ctx_t);
+
+/******************/
+/* MATCH AND SORT */
+/******************/
+
+slong match_sort_point(fmpz*, const slong, const fmpz_t, const fmpz_t, const match_sort_cand_struct*, const slong, const ell_fq_point_t, const ell_curve_t, const fq_ctx_t);
+int match_sort(fmpz_t, const fmpz_t, const fmpz_t, const match_sort_cand_struct*, const slong, const ell_curve_t, const fq_ctx_t);
+
+#endif
\ No newline at end of file
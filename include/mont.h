@@ -0,0 +1,67 @@
+#ifndef MONT_H
+#define MONT_H
+
+#include <stdlib.h>
+#include <string.h>
+#include <flint/flint.h>
+#include <flint/fmpz.h>
+#include <flint/fq.h>
+#include <flint/fq_poly.h>
+#include <flint/longlong.h>
+
+/**
+ * Arithmétique de Montgomery à largeur fixe dans F_p, pour p premier de 2, 4 ou 8 limbs (de 65 à 512 bits).
+ *
+ * Un élément a de F_p est stocké sous la forme a*R mod p avec R = 2^(FLINT_BITS*N), dans un tableau de N limbs
+ * (poids faibles en premier), et un polynôme de longueur len est un tableau contigu de len*N limbs : aucun objet
+ * n'est alloué par coefficient. Les fonctions de chaque largeur N sont générées par MONT_DECLARE(N) et
+ * MONT_DEFINE(N), leurs boucles ont donc une borne connue à la compilation et sont entièrement déroulées.
+ * Les fonctions mont_poly_* choisissent la largeur une fois pour toutes d'après le contexte.
+ */
+
+#define MONT_MAX_LIMBS 8
+
+typedef struct {
+    slong limbs; // 2, 4 ou 8, 0 si p n'est pas pris en charge
+    ulong p[MONT_MAX_LIMBS];
+    ulong p_inv; // -p^(-1) modulo 2^FLINT_BITS
+    ulong r2[MONT_MAX_LIMBS]; // R^2 mod p, pour passer en représentation de Montgomery
+} mont_ctx_struct;
+
+typedef mont_ctx_struct mont_ctx_t[1]; // On adopte la convention de FLINT sur les nouveaux types
+
+/**************/
+/* PRIMITIVES */
+/**************/
+
+void mont_ctx_init(mont_ctx_t, const fq_ctx_t);
+void mont_set_fmpz(ulong*, const fmpz_t, const mont_ctx_t);
+void mont_get_fmpz(fmpz_t, const ulong*, const mont_ctx_t);
+
+/****************************/
+/* ARITHMETIQUE PAR LARGEUR */
+/****************************/
+
+#define MONT_DECLARE(N) \
+    void mont##N##_add(ulong*, const ulong*, const ulong*, const mont_ctx_t); \
+    void mont##N##_sub(ulong*, const ulong*, const ulong*, const mont_ctx_t); \
+    void mont##N##_mul(ulong*, const ulong*, const ulong*, const mont_ctx_t); \
+    void _mont##N##_poly_mul(ulong*, const ulong*, const slong, const ulong*, const slong, const mont_ctx_t); \
+    void _mont##N##_poly_sqr(ulong*, const ulong*, const slong, const mont_ctx_t); \
+    void _mont##N##_poly_rem(ulong*, const slong, const ulong*, const slong, const mont_ctx_t);
+
+MONT_DECLARE(2)
+MONT_DECLARE(4)
+MONT_DECLARE(8)
+
+/***************************/
+/* POLYNOMES DE MONTGOMERY */
+/***************************/
+
+void mont_poly_set_fq_poly(ulong*, const fq_poly_t, const slong, const mont_ctx_t, const fq_ctx_t);
+void mont_poly_get_fq_poly(fq_poly_t, const ulong*, const slong, const mont_ctx_t, const fq_ctx_t);
+void mont_poly_mul(ulong*, const ulong*, const slong, const ulong*, const slong, const mont_ctx_t);
+void mont_poly_rem(ulong*, const slong, const ulong*, const slong, const mont_ctx_t);
+void mont_poly_mulmod(ulong*, const ulong*, const slong, const ulong*, const slong, const ulong*, const slong, const mont_ctx_t);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,31 @@
+#ifndef PROD_TREE_H
+#define PROD_TREE_H
+
+#include <stdlib.h>
+#include <flint/flint.h>
+#include <flint/fq.h>
+#include <flint/fq_poly.h>
+#include "tors_ring.h"
+
+/**
+ * Arbre des produits d'une famille de polynômes m_0, ..., m_{n-1} : le niveau 0 contient les m_i et le niveau
+ * k+1 les produits deux à deux des polynômes du niveau k (le dernier est recopié si le niveau est de taille
+ * impaire). La racine est le produit M de tous les m_i.
+ * Il permet de réduire un polynôme modulo M une seule fois puis de redescendre l'arbre (arbre des restes)
+ * pour obtenir ses réductions modulo chacun des m_i.
+ */
+
+typedef struct {
+    fq_poly_struct** levels; // levels[k] est un tableau de len[k] polynômes
+    slong* len;
+    slong depth; // Nombre de niveaux
+} prod_tree_struct;
+
+typedef prod_tree_struct prod_tree_t[1]; // On adopte la convention de FLINT sur les nouveaux types
+
+void prod_tree_init(prod_tree_t, fq_poly_struct* const*, const slong, const fq_ctx_t);
+void prod_tree_clear(prod_tree_t, const fq_ctx_t);
+fq_poly_struct* prod_tree_root(const prod_tree_t);
+int prod_tree_rem(fq_poly_struct*, const fq_poly_t, const prod_tree_t, tors_stop_struct*, const fq_ctx_t);
+
+#endif
\ No newline at end of file
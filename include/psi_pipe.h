@@ -0,0 +1,62 @@
+#ifndef PSI_PIPE_H
+#define PSI_PIPE_H
+
+#include <pthread.h>
+#include <flint/flint.h>
+#include <flint/fmpz.h>
+#include <flint/fq.h>
+#include <flint/fq_poly.h>
+#include <flint/ulong_extras.h>
+#include "ell_curve.h"
+#include "list.h"
+#include "schoof.h"
+#include "div_poly.h"
+
+/**
+ * Production des ψ_l à l'avance, en parallèle de la boucle de ell_schoof().
+ *
+ * Un thread producteur construit ses propres ψ_m dans l'ordre et, pour chaque premier impair l différent de la
+ * caractéristique et au plus égal à schoof_max_prime(), dépose ψ_l dans une file de capacité bornée. Il attend
+ * dès qu'elle est pleine : il n'a jamais plus de depth nombres premiers d'avance. Un ψ_m déjà calculé n'est plus
+ * jamais modifié, ell_schoof() peut donc le lire pendant que le producteur continue. Pendant que ell_schoof()
+ * calcule a_q modulo l, le producteur avance donc sur les ψ des l suivants, et ell_schoof() n'a plus qu'à retirer
+ * ψ_l de la file (c.f psi_pipe_pop()).
+ * Comme en mode économe en mémoire, le producteur libère au fur et à mesure ses ψ_m inutiles (c.f
+ * evict_list_div_poly()) : il ne garde que ceux dont dépendent les prochains ψ_m et les ψ_l que ell_schoof() n'a
+ * pas encore fini d'utiliser (c.f psi_pipe_trim()).
+ */
+
+// File de ψ_l entre le producteur et ell_schoof()
+typedef struct {
+    pthread_t thread;
+    pthread_mutex_t mutex;
+    pthread_cond_t not_empty; // Un ψ_l a été déposé, ou le producteur a fini
+    pthread_cond_t not_full; // Un ψ_l a été retiré, ou l'arrêt est demandé
+    ulong* primes; // l de chaque élément de la file (circulaire)
+    const fq_poly_struct** polys; // ψ_l de chaque élément de la file, pris dans list_psi
+    slong depth; // Capacité de la file
+    slong head; // Indice du premier élément
+    slong len; // Nombre d'éléments
+    int stop; // Arrêt demandé par psi_pipe_stop()
+    int done; // Le producteur a fini
+    int running; // Le thread producteur a été créé et n'a pas encore été attendu
+    ulong l_max; // Plus grand l produit
+    ulong l_used; // Dernier l demandé par psi_pipe_pop(), les ψ des premiers plus petits ne servent plus
+    slong threads; // Threads qui calculent les ψ_m (c.f update_list_div_poly_threads())
+    list_fq_poly_t list_psi; // ψ_m du producteur
+    const ell_curve_struct* E;
+    const fq_ctx_struct* ctx;
+} psi_pipe_struct;
+
+typedef psi_pipe_struct psi_pipe_t[1]; // On adopte la convention de FLINT sur les nouveaux types
+
+void psi_pipe_init(psi_pipe_t, const ell_curve_t, const ulong, const slong, const slong, const fq_ctx_t);
+void psi_pipe_clear(psi_pipe_t, const fq_ctx_t);
+int psi_pipe_stopped(psi_pipe_t);
+void psi_pipe_trim(psi_pipe_t);
+int psi_pipe_extend(psi_pipe_t, const ulong);
+void* psi_pipe_producer(void*);
+const fq_poly_struct* psi_pipe_pop(psi_pipe_t, const ulong);
+void psi_pipe_stop(psi_pipe_t);
+
+#endif
\ No newline at end of file
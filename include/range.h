@@ -0,0 +1,98 @@
+#ifndef RANGE_H
+#define RANGE_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <pthread.h>
+#include <flint/flint.h>
+#include <flint/fmpz.h>
+#include <flint/fmpz_poly.h>
+#include <flint/fq.h>
+#include <flint/ulong_extras.h>
+#include "ell_curve.h"
+#include "list.h"
+#include "schoof.h"
+#include "div_poly.h"
+
+/**
+ * Traces de Frobenius a_p = p + 1 - #E(F_p) d'une courbe y^2 = x^3 + a*x + b fixée sur Q (a et b entiers) pour
+ * tous les premiers p d'un intervalle.
+ *
+ * Chaque p est traité par la méthode la moins coûteuse : une somme de caractères a_p = -Σ_x ((x^3 + a*x + b)/p)
+ * pour les très petits p, le pas de bébé-pas de géant sur tout l'intervalle de Hasse quand son coût est inférieur
+ * à celui de l'algorithme de Schoof (c.f schoof_bsgs_cost() et schoof_finish_cost()), l'algorithme de Schoof
+ * au-delà. Ce dernier réduit modulo p les ψ_m de la courbe sur Z, calculés une seule fois pour tout l'intervalle
+ * (c.f div_poly_fmpz()) au lieu de refaire la récurrence pour chaque p.
+ *
+ * Les p sont distribués aux threads par paquets de RANGE_CHUNK premiers consécutifs, et les lignes "p,a_p" sont
+ * écrites au fur et à mesure dans l'ordre croissant des p. Les p <= 3 et ceux de mauvaise réduction (p divise
+ * 4*a^3 + 27*b^2) sont sautés.
+ */
+
+#define RANGE_NAIVE_MAX 1024 // p maximal par défaut pour la somme de caractères
+#define RANGE_NAIVE_LIMIT (1 << 20) // Borne sur naive_max, la somme de caractères utilisant une table de p octets
+#define RANGE_CHUNK 64 // Nombre de premiers consécutifs pris d'un coup par un thread
+#define RANGE_WINDOW 4 // Paquets en cours ou en attente d'écriture, par thread
+#define RANGE_LINE_MAX 48 // Longueur maximale d'une ligne "p,a_p\n"
+
+// Méthode utilisée pour un p, renvoyée par range_a_p()
+#define RANGE_BAD 0
+#define RANGE_NAIVE 1
+#define RANGE_BSGS 2
+#define RANGE_SCHOOF 3
+
+// Nombre de p traités par chaque méthode
+typedef struct {
+    ulong bad; // p <= 3 ou de mauvaise réduction, sautés
+    ulong naive;
+    ulong bsgs;
+    ulong schoof;
+} range_stats_struct;
+
+// Options de range_traces(), range_opt_init() leur donne leurs valeurs par défaut
+typedef struct {
+    slong threads; // Nombre de threads (dont le thread appelant), 1 par défaut
+    ulong naive_max; // p maximal pour la somme de caractères (au plus RANGE_NAIVE_LIMIT), RANGE_NAIVE_MAX par défaut
+    int bsgs; // Pas de bébé-pas de géant quand il est moins coûteux que l'algorithme de Schoof, 1 par défaut
+    int share_psi; // ψ_m sur Z partagés par tous les p (c.f schoof_opt_struct.int_psi), 1 par défaut
+    range_stats_struct* stats; // Si non NULL, reçoit le nombre de p traités par chaque méthode
+} range_opt_struct;
+
+typedef range_opt_struct range_opt_t[1]; // On adopte la convention de FLINT sur les nouveaux types
+
+// État partagé entre les threads de range_traces()
+typedef struct {
+    pthread_mutex_t mutex;
+    pthread_cond_t space_ready; // Un paquet a été écrit, la fenêtre a de la place
+    ulong next_p; // Prochain entier à partir duquel chercher des premiers, > p_max quand tout est distribué
+    ulong p_max;
+    ulong next_chunk; // Numéro du prochain paquet distribué
+    ulong next_out; // Numéro du prochain paquet à écrire
+    char** slots; // Paquets calculés pas encore écrits, slots[i % window] pour le paquet i
+    slong window;
+    FILE* out;
+    range_stats_struct stats;
+    fmpz_t a;
+    fmpz_t b;
+    fmpz_t disc; // 4*a^3 + 27*b^2
+    pthread_mutex_t psi_mutex; // Protège le calcul des ψ_m sur Z, fait au premier p qui en a besoin
+    fmpz_poly_struct* psi;
+    ulong psi_len;
+    const range_opt_struct* ropt;
+    const schoof_opt_struct* opt;
+} range_struct;
+
+typedef range_struct range_t[1]; // On adopte la convention de FLINT sur les nouveaux types
+
+void range_opt_init(range_opt_t);
+ulong range_max_prime(const ulong);
+const fmpz_poly_struct* range_psi(range_t);
+slong range_naive(const ulong, const ulong, const ulong);
+int range_a_p(slong*, const ulong, range_t);
+void range_output(range_t, const ulong, char*, const range_stats_struct*);
+void range_run(range_t);
+void* range_worker(void*);
+void range_traces(FILE*, const fmpz_t, const fmpz_t, const ulong, const ulong, const range_opt_t, const schoof_opt_t);
+
+#endif
\ No newline at end of file
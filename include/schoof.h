@@ -3,12 +3,18 @@
 
 #include <flint/flint.h>
 #include <flint/fmpz.h>
+#include <flint/fmpz_poly.h>
 #include <flint/fq.h>
 #include <flint/ulong_extras.h>
 #include "tors_ring.h"
 #include "ell_curve.h"
-#include "ell_point.h"
+#include "ell_cpoint.h"
+#include "ell_fq_point.h"
+#include "match_sort.h"
 #include "list.h"
+#include "prod_tree.h"
+#include "checkpoint.h"
+#include "arena.h"
 
 /**
  * Section 5.5 du rapport
@@ -16,8 +22,83 @@
 
 #define PSI(n) list_fq_poly_get(list_psi, n)
 
+#define SCHOOF_BSGS_MAX_CANDIDATES (1 << 20) // Nombre maximal de candidats pour a_q départagés par schoof_bsgs()
+#define SCHOOF_BSGS_MAX_MATCHES 16 // Au-delà, le point aléatoire est d'ordre trop petit pour être utile
+#define SCHOOF_BSGS_POINTS 8 // Nombre maximal de points aléatoires essayés par schoof_bsgs()
+#define SCHOOF_INTERRUPTED UWORD_MAX // Renvoyé par schoof_mod_l() quand le calcul a été interrompu (c.f tors_stop_t)
+
+// Avancement de ell_schoof(), transmis à opt->progress après chaque module
+typedef struct {
+    ulong l; // Module qui vient d'être traité (nombre premier ou puissance d'un nombre premier)
+    ulong t; // a_q modulo l (au signe près si opt->match_sort)
+    const fmpz* A; // Produit des modules traités
+    const fmpz* A_max; // 4*sqrt(q) : a_q est déterminé dès que A le dépasse
+    double elapsed; // Secondes écoulées depuis le début du calcul
+} schoof_progress_struct;
+
+typedef void (*schoof_progress_func)(const schoof_progress_struct*, void*);
+
+// Classes de a_q obtenues par ell_schoof(), en particulier quand le calcul est interrompu (c.f schoof_interruptible())
+typedef struct {
+    list_ulong_t moduli; // Modules traités, hors classes connues seulement au signe près (opt->match_sort)
+    list_ulong_t residues; // a_q modulo chacun d'eux
+    int interrupted; // Le calcul a été interrompu par opt->deadline ou opt->cancel
+} schoof_partial_struct;
+
+typedef schoof_partial_struct schoof_partial_t[1]; // On adopte la convention de FLINT sur les nouveaux types
+
+// Options de l'algorithme de Schoof, schoof_opt_init() leur donne leurs valeurs par défaut
+typedef struct {
+    int affine; // Arithmétique affine avec réduction opportuniste de psi_l (c.f ell_cpoint_add_aff())
+    slong frob_block; // Si > 1, nombre de premiers l consécutifs dont on calcule le Frobenius ensemble (c.f frobenius_block())
+    const char* checkpoint; // Si non NULL, fichier de reprise lu au début et réécrit après chaque l (c.f checkpoint.h)
+    int checkpoint_psi; // Conserve aussi les polynômes de division à côté du fichier de reprise (sauf si low_memory)
+    slong workers; // Si > 0, nombre de processus de calcul entre lesquels répartir les l (c.f distrib.h), sans progress, deadline, cancel, partial, bsgs, match_sort, prime_powers ni frob_block (EXIT_FAILURE sinon, c.f distrib_supported())
+    int low_memory; // Libère au fur et à mesure les ψ_m qui ne serviront plus (c.f evict_list_div_poly())
+    slong psi_threads; // Si > 1, nombre de threads qui calculent les ψ_m (c.f update_list_div_poly_threads(), sauf si low_memory)
+    slong psi_ahead; // Si > 0, un thread calcule les ψ_l avec jusqu'à psi_ahead premiers d'avance (c.f psi_pipe.h)
+    slong mul_threads; // Si > 1, nombre de threads de chaque produit modulo un ψ_l de grand degré (c.f tors_poly_mul_threads())
+    slong* peak_bytes; // Si non NULL, reçoit une estimation du pic de mémoire des coefficients des ψ_m (c.f list_fq_poly_bytes()), pas la mémoire résidente
+    int prime_powers; // Utilise aussi les modules l^k quand ils sont moins coûteux (c.f schoof_next_power(), sauf si low_memory)
+    int bsgs; // Termine par pas de bébé-pas de géant dès que peu de candidats pour a_q subsistent (c.f schoof_bsgs())
+    int match_sort; // Ne calcule a_q modulo l qu'au signe près et combine les classes par match_sort()
+    const fmpz_poly_struct* int_psi; // Si non NULL, ψ_m sur Z de la courbe relevée, réduits au lieu d'être recalculés (c.f div_poly_fmpz(), sauf si low_memory)
+    ulong int_psi_len; // Nombre de ψ_m dans int_psi
+    int arena; // Alloue dans une arène tout ce qui sert au calcul de a_q modulo chaque l (c.f arena.h)
+    FILE* arena_log; // Si non NULL (et si arena), reçoit pour chaque l une ligne "arena l octets_alloués pic_octets"
+    schoof_progress_func progress; // Si non NULL, appelée après chaque module avec progress_data
+    void* progress_data;
+    double deadline; // Si > 0, durée maximale du calcul en secondes, au-delà de laquelle il est interrompu
+    const int* cancel; // Si non NULL, le calcul est interrompu dès que *cancel est non nul, à écrire par __atomic_store_n()
+    schoof_partial_struct* partial; // Si non NULL, reçoit les classes de a_q calculées et l'éventuelle interruption
+    tors_stop_struct* stop; // Interruption en cours, partagée par les appels imbriqués (fixée par ell_schoof())
+} schoof_opt_struct;
+
+typedef schoof_opt_struct schoof_opt_t[1]; // On adopte la convention de FLINT sur les nouveaux types
+
+void schoof_opt_init(schoof_opt_t);
+void schoof_partial_init(schoof_partial_t);
+void schoof_partial_clear(schoof_partial_t);
 void update_list_div_poly(list_fq_poly_t, const ell_curve_t, const ulong, const fq_ctx_t);
-void ell_schoof(fmpz_t, const ell_curve_t, const fq_ctx_t);
+ulong schoof_max_prime(const fq_ctx_t);
+void evict_list_div_poly(list_fq_poly_t, const ulong, const ulong, const fq_ctx_t);
+void update_list_div_poly_low_memory(list_fq_poly_t, const ell_curve_t, const ulong, const ulong, const ulong, const fq_ctx_t);
+int frobenius_block(fq_poly_struct*, fq_poly_struct*, const ulong*, const slong, const list_fq_poly_t, const ell_curve_t, tors_stop_struct*, const fq_ctx_t);
+ulong schoof_mod_l(const ulong, const fq_poly_t, fq_poly_t, fq_poly_t, const int, const ell_curve_t, const schoof_opt_t, const fq_ctx_t);
+ulong schoof_mod_power(const ulong, const ulong, const ulong, const list_fq_poly_t, const ell_curve_t, tors_stop_struct*, const fq_ctx_t);
+ulong schoof_power_base(const ulong);
+double schoof_cost(const double, const ulong, const fq_ctx_t);
+double schoof_finish_cost(const list_ulong_t, const ulong, const double, const fq_ctx_t);
+cell_ulong_t* schoof_next_power(const list_ulong_t, const ulong, const double, const fq_ctx_t);
+void schoof_crt(fmpz_t, const list_ulong_t, const list_ulong_t, const fq_ctx_t);
+double schoof_bsgs_cost(const double, const fq_ctx_t);
+int schoof_bsgs(fmpz_t, const fmpz_t, const fmpz_t, const ell_curve_t, const fq_ctx_t);
+void schoof_arena_end(arena_t, const ulong, const schoof_opt_t);
+int schoof_exact_classes(list_ulong_t, list_ulong_t, const match_sort_cand_struct*, const slong, const ell_curve_t, const schoof_opt_t, const fq_ctx_t);
+void ell_schoof(fmpz_t, const ell_curve_t, const schoof_opt_t, const fq_ctx_t);
 int schoof(fmpz_t, const fq_t, const fq_t, const fq_ctx_t);
+int schoof_with_opt(fmpz_t, const fq_t, const fq_t, const schoof_opt_t, const fq_ctx_t);
+int schoof_interruptible(fmpz_t, schoof_partial_t, const fq_t, const fq_t, const schoof_opt_t, const fq_ctx_t);
+int schoof_resume(fmpz_t, const char*, const schoof_opt_t);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,91 @@
+#ifndef SEARCH_H
+#define SEARCH_H
+
+#include <stdlib.h>
+#include <pthread.h>
+#include <flint/flint.h>
+#include <flint/fmpz.h>
+#include <flint/fq.h>
+#include <flint/fq_poly.h>
+#include "ell_curve.h"
+#include "ell_fq_point.h"
+#include "schoof.h"
+
+/**
+ * Recherche de courbes d'ordre premier (ou de petit cofacteur) sur F_q : N = #E(F_q) = h*r avec r premier et
+ * h <= max_cofactor.
+ *
+ * Plusieurs courbes aléatoires sont comptées en même temps, une par thread. Chaque candidate est écartée le plus
+ * tôt possible : d'abord si E a un point d'ordre 2 (pgcd(x^q - x, x^3 + a*x + b) != 1, sans Schoof), puis pendant
+ * l'algorithme de Schoof dès qu'un petit l divise N = q + 1 - a_q (c.f search_filter(), appelée après chaque l,
+ * qui interrompt le calcul). Dès que le nombre de courbes demandé est atteint, les candidates encore en cours
+ * sont interrompues. Chaque courbe retenue est vérifiée : r passe un test de primalité, r > 4*sqrt(q) et un
+ * point aléatoire P vérifie [N]P = 0 et [h]P != 0, donc [h]P est d'ordre r et N est le seul multiple de r dans
+ * l'intervalle de Hasse.
+ */
+
+#define SEARCH_POINT_TRIES 8 // Points aléatoires essayés par search_verify() avant de renoncer
+
+// Courbe trouvée par search_curves()
+typedef struct {
+    fq_t a;
+    fq_t b;
+    fmpz_t order; // N = #E(F_q)
+    fmpz_t cofactor; // h, avec N = h*r et r premier
+    fmpz_t twist_order; // 2*q + 2 - N, ordre de la tordue quadratique
+} search_curve_struct;
+
+typedef search_curve_struct search_curve_t[1]; // On adopte la convention de FLINT sur les nouveaux types
+
+// Options de search_curves(), search_opt_init() leur donne leurs valeurs par défaut
+typedef struct {
+    slong threads; // Nombre de courbes candidates comptées en même temps (dont le thread appelant), 1 par défaut
+    ulong max_cofactor; // Cofacteur h maximal, 1 par défaut (ordre premier)
+    ulong max_candidates; // Si > 0, nombre maximal de courbes essayées
+    ulong seed; // Si non nul, graine du tirage des courbes
+    ulong* tried; // Si non NULL, reçoit le nombre de courbes essayées
+    ulong* filtered; // Si non NULL, reçoit le nombre de courbes écartées avant la fin de l'algorithme de Schoof
+} search_opt_struct;
+
+typedef search_opt_struct search_opt_t[1]; // On adopte la convention de FLINT sur les nouveaux types
+
+// État partagé entre les threads de search_curves()
+typedef struct {
+    pthread_mutex_t mutex;
+    search_curve_struct* found;
+    slong wanted;
+    slong num_found;
+    int* cancel; // Drapeau d'interruption de la candidate de chaque thread, accédé atomiquement (c.f schoof_opt_struct)
+    slong next_thread; // Numéro du prochain thread à démarrer
+    ulong tried;
+    ulong filtered;
+    flint_rand_t state; // Tirage des courbes, sous mutex
+    const search_opt_struct* sopt;
+    const schoof_opt_struct* opt;
+    const fq_ctx_struct* ctx;
+} search_struct;
+
+typedef search_struct search_t[1]; // On adopte la convention de FLINT sur les nouveaux types
+
+// Filtre d'une candidate par les petits l (c.f search_filter())
+typedef struct {
+    const fmpz* q;
+    ulong max_cofactor;
+    ulong known; // Produit des petits l qui divisent N
+    int rejected;
+    int* cancel;
+} search_filter_struct;
+
+void search_opt_init(search_opt_t);
+void search_curve_init(search_curve_t, const fq_ctx_t);
+void search_curve_clear(search_curve_t, const fq_ctx_t);
+int search_two_torsion(const ell_curve_t, const fq_ctx_t);
+int search_below_hasse(const fmpz_t, const ulong);
+void search_filter(const schoof_progress_struct*, void*);
+int search_verify(fmpz_t, const fmpz_t, const ell_curve_t, const ulong, flint_rand_t, const fq_ctx_t);
+int search_candidate(search_curve_t, const fq_t, const fq_t, int*, search_t, flint_rand_t);
+void search_run(search_t);
+void* search_worker(void*);
+slong search_curves(search_curve_struct*, const slong, const search_opt_t, const schoof_opt_t, const fq_ctx_t);
+
+#endif
\ No newline at end of file
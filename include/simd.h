@@ -0,0 +1,89 @@
+#ifndef SIMD_H
+#define SIMD_H
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <flint/flint.h>
+#include <flint/fmpz.h>
+#include <flint/fq.h>
+#include <flint/fq_poly.h>
+
+/**
+ * Noyaux vectorisés de multiplication et de réduction de polynômes sur F_p, pour p premier de moins de
+ * SIMD_MAX_BITS bits.
+ *
+ * Les coefficients sont stockés comme des doubles, exacts car p < 2^50, et a*b mod p est calculé avec des FMA :
+ * h = a*b arrondi, l = fma(a, b, -h) est l'erreur d'arrondi exacte, k = floor(h/p) à une unité près, puis
+ * r = fma(-k, p, h) + l = a*b - k*p est exact et ramené dans [0, p-1]. Le résultat ne dépend donc pas des
+ * noyaux : AVX-512, AVX2 et scalaire donnent les mêmes coefficients que FLINT.
+ * Le jeu d'instructions est choisi à l'exécution (c.f simd_ctx_init()).
+ */
+
+#define SIMD_MAX_BITS 50
+
+// Jeux d'instructions disponibles, du moins au plus rapide
+#define SIMD_NONE 0 // p n'est pas pris en charge
+#define SIMD_SCALAR 1
+#define SIMD_AVX2 2
+#define SIMD_AVX512 3
+
+typedef struct {
+    int level; // Un des SIMD_*
+    double p;
+    double p_inv; // 1/p arrondi
+} simd_ctx_struct;
+
+typedef simd_ctx_struct simd_ctx_t[1]; // On adopte la convention de FLINT sur les nouveaux types
+
+/**************/
+/* PRIMITIVES */
+/**************/
+
+void simd_ctx_init(simd_ctx_t, const fq_ctx_t);
+double simd_addmod(const double, const double, const simd_ctx_t);
+double simd_submod(const double, const double, const simd_ctx_t);
+double simd_mulmod(const double, const double, const simd_ctx_t);
+
+/***************************/
+/* NOYAUX PAR INSTRUCTIONS */
+/***************************/
+
+void _simd_poly_mul_scalar(double*, const double*, const slong, const double*, const slong, const simd_ctx_t);
+void _simd_poly_rem_scalar(double*, const slong, const double*, const slong, const simd_ctx_t);
+void _simd_poly_mul_avx2(double*, const double*, const slong, const double*, const slong, const simd_ctx_t);
+void _simd_poly_rem_avx2(double*, const slong, const double*, const slong, const simd_ctx_t);
+void _simd_poly_mul_avx512(double*, const double*, const slong, const double*, const slong, const simd_ctx_t);
+void _simd_poly_rem_avx512(double*, const slong, const double*, const slong, const simd_ctx_t);
+void _simd_lanes_mul_scalar(double*, const double*, const slong, const double*, const slong, const slong, const simd_ctx_t);
+void _simd_lanes_rem_scalar(double*, const slong, const double*, const slong, const slong, const simd_ctx_t);
+void _simd_lanes_mul_avx2(double*, const double*, const slong, const double*, const slong, const slong, const simd_ctx_t);
+void _simd_lanes_rem_avx2(double*, const slong, const double*, const slong, const slong, const simd_ctx_t);
+void _simd_lanes_mul_avx512(double*, const double*, const slong, const double*, const slong, const slong, const simd_ctx_t);
+void _simd_lanes_rem_avx512(double*, const slong, const double*, const slong, const slong, const simd_ctx_t);
+
+/************************/
+/* POLYNOMES VECTORISES */
+/************************/
+
+void simd_poly_set_fq_poly(double*, const fq_poly_t, const slong, const fq_ctx_t);
+void simd_poly_get_fq_poly(fq_poly_t, const double*, const slong, const fq_ctx_t);
+void simd_poly_mul(double*, const double*, const slong, const double*, const slong, const simd_ctx_t);
+void simd_poly_rem(double*, const slong, const double*, const slong, const simd_ctx_t);
+void simd_poly_mulmod(double*, const double*, const slong, const double*, const slong, const double*, const slong, const simd_ctx_t);
+
+/************************/
+/* POLYNOMES ENTRELACES */
+/************************/
+
+/**
+ * lanes polynômes de même longueur len sont entrelacés dans un tableau de len*lanes doubles : le coefficient i
+ * du polynôme k est en i*lanes + k. Une instruction vectorielle traite alors le même coefficient de plusieurs
+ * polynômes, sans diffusion ni masque, et lanes doit être un multiple de simd_lanes().
+ */
+
+slong simd_lanes(const simd_ctx_t);
+void simd_lanes_mul(double*, const double*, const slong, const double*, const slong, const slong, const simd_ctx_t);
+void simd_lanes_rem(double*, const slong, const double*, const slong, const slong, const simd_ctx_t);
+
+#endif
\ No newline at end of file
@@ -3,21 +3,60 @@
 
 #include <stdlib.h>
 #include <stdarg.h>
+#include <pthread.h>
 #include <flint/flint.h>
 #include <flint/fq.h>
 #include <flint/fq_poly.h>
 #include <flint/fmpz.h>
+#include <flint/fmpz_vec.h>
+#include <flint/fmpz_poly.h>
 #include <flint/longlong.h>
 #include "ell_curve.h"
+#include "mont.h"
+#include "simd.h"
+#include "tune.h"
 
 /**
  * Section 4.1 du rapport.
  */
 
+// Valeurs par défaut des seuils, remplacées par celles du profil de réglage s'il y en a un (c.f tune.h)
+#define TORS_MONT_MAX_LEN 64 // Longueur maximale de psi pour les multiplications en représentation de Montgomery
+#define TORS_SIMD_MAX_LEN 128 // Longueur maximale de psi pour les multiplications vectorisées
+#define TORS_PRE_FFT_MIN_LEN 16 // Longueur minimale de psi pour précalculer la transformée d'un opérande fixe
+#define TORS_PRE_FFT_MIN_LIMBS 5 // Taille minimale de q (en limbs) pour laquelle FLINT multiplie par FFT plutôt que par KS
+#define TORS_THREADS_MIN_LEN 512 // Longueur minimale des opérandes pour répartir un produit entre plusieurs threads
+
+/**
+ * Demande d'interruption des calculs longs (puissances, recherche de a_q modulo l) : délai dépassé ou drapeau
+ * d'annulation levé par un autre thread. Les boucles qui la constatent s'arrêtent en laissant un résultat
+ * non défini, que l'appelant doit ignorer (c.f tors_ring_stopped()).
+ */
+typedef struct {
+    const int* cancel; // Si non NULL, on s'arrête dès que *cancel est non nul (lu atomiquement)
+    double deadline; // Si > 0, instant (c.f tors_stop_now()) au-delà duquel on s'arrête
+    int stopped; // Non nul dès que l'une des deux conditions a été constatée
+} tors_stop_struct;
+
+typedef tors_stop_struct tors_stop_t[1]; // On adopte la convention de FLINT sur les nouveaux types
+
 // Représente l'anneau quotient F_q[x,y]/(psi(x), y^2-x^3-ax-b)) si y^2 = x^3+ax+b définit curve
 typedef struct {
     ell_curve_t curve;
     fq_poly_t psi;
+    fq_poly_t W; // W = x^3 + a*x + b, précalculé pour ne pas le reconstruire à chaque multiplication
+    mont_ctx_t mont; // Arithmétique de Montgomery de F_q si q est premier de 2, 4 ou 8 limbs (c.f mont.h)
+    simd_ctx_t simd; // Noyaux vectorisés si q est premier de moins de SIMD_MAX_BITS bits (c.f simd.h)
+    ulong* mont_psi; // psi rendu unitaire en représentation de Montgomery, NULL si elle n'est pas utilisée
+    double* simd_psi; // psi rendu unitaire pour les noyaux vectorisés, NULL s'ils ne sont pas utilisés
+    slong psi_len; // Longueur de psi
+    slong mont_max_len; // Seuils du profil pour la taille de q (c.f tune_mont_max_len() et tune_simd_max_len())
+    slong simd_max_len;
+    slong threads; // Nombre de threads des produits et réductions longs (c.f tors_ring_set_threads()), 1 par défaut
+    struct tors_pool_struct* pool; // Threads qui les exécutent avec le thread appelant, NULL si threads vaut 1
+    fq_poly_t psi_inv; // Inverse de psi renversé modulo x^psi_len, nul s'il ne sert pas (c.f tors_poly_rem_threads())
+    tors_stop_struct* stop; // Interruption constatée par les puissances (c.f tors_ring_stopped()), NULL par défaut
+    const tune_struct* tune; // Seuils entre les multiplications (c.f tune_get())
 } tors_ring_struct;
 
 typedef tors_ring_struct tors_ring_t[1]; // On adopte la convention de FLINT sur les nouveaux types
@@ -30,6 +69,68 @@ typedef struct {
 
 typedef tors_elem_struct tors_elem_t[1]; // On adopte la convention de FLINT sur les nouveaux types
 
+/**
+ * Opérande fixe d'une suite de produits dans F_q[x]/(psi) (c.f tors_poly_mul_pre()), conservé sous la forme
+ * qu'utilise la multiplication : image pour les noyaux vectorisés ou de Montgomery, sinon transformée de
+ * Schönhage-Strassen précalculée par FLINT. Chaque produit ne convertit alors que l'autre opérande.
+ * Il reste valable tant que psi ne change pas.
+ */
+typedef struct {
+    fq_poly_t poly;
+    double* simd; // NULL si les noyaux vectorisés ne sont pas utilisés
+    ulong* mont; // NULL si la représentation de Montgomery n'est pas utilisée
+    fmpz_poly_mul_precache_t fft;
+    int has_fft;
+} tors_pre_struct;
+
+typedef tors_pre_struct tors_pre_t[1]; // On adopte la convention de FLINT sur les nouveaux types
+
+/**
+ * Produit (op2 non NULL) ou réduction modulo psi (op2 NULL) confié à un thread par tors_tasks_run(). rop doit
+ * être un polynôme vide propre à la tâche : il est alloué par le thread qui l'exécute (le thread appelant ou un
+ * thread de la réserve, hors de toute arène, c.f arena.h), et peut ensuite être échangé avec un polynôme du thread
+ * appelant.
+ */
+typedef struct {
+    fq_poly_struct* rop;
+    const fq_poly_struct* op1;
+    const fq_poly_struct* op2;
+    slong threads; // Threads dont dispose la tâche elle-même, fixé par tors_tasks_run()
+    struct tors_pool_struct* pool; // Réserve de ses propres produits répartis, fixée par tors_tasks_run()
+    const tors_ring_struct* tors_ring;
+    const tune_struct* tune; // Seuils du produit, ceux de tors_ring s'il n'est pas NULL
+    const fq_ctx_struct* ctx;
+} tors_task_struct;
+
+// Tâches d'un appel à tors_tasks_run(), que se partagent le thread appelant et ceux de la réserve
+typedef struct tors_tasks_struct {
+    tors_task_struct* tasks;
+    slong num;
+    slong next; // Prochaine tâche à prendre
+    slong done; // Tâches terminées
+    struct tors_tasks_struct* link; // Appel suivant dont il reste des tâches à prendre
+} tors_tasks_struct;
+
+typedef tors_tasks_struct tors_tasks_t[1]; // On adopte la convention de FLINT sur les nouveaux types
+
+/**
+ * Réserve de threads des produits répartis d'un anneau, créée par tors_ring_set_threads() et gardée jusqu'à
+ * tors_ring_clear() : les threads ne sont pas recréés à chaque produit et conservent leurs caches FLINT.
+ * Les appels à tors_tasks_run() en cours, y compris ceux des tâches elles-mêmes, y sont chaînés. Un thread de la
+ * réserve prend n'importe quelle tâche, le thread appelant seulement les siennes en attendant qu'elles soient
+ * toutes terminées : il n'exécute jamais une tâche dont le résultat est destiné à un autre thread.
+ */
+typedef struct tors_pool_struct {
+    pthread_mutex_t mutex;
+    pthread_cond_t cond; // Signalée à chaque appel ajouté, à chaque tâche terminée et à l'arrêt
+    tors_tasks_struct* queue; // Appels dont il reste des tâches à prendre, le plus récent en tête
+    pthread_t* workers;
+    slong num_workers;
+    int stop; // Non nul quand les threads doivent s'arrêter (c.f tors_pool_clear())
+} tors_pool_struct;
+
+typedef tors_pool_struct tors_pool_t[1]; // On adopte la convention de FLINT sur les nouveaux types
+
 /*********************************/
 /* PRIMITIVES ANNEAUX DE TORSION */
 /*********************************/
@@ -37,6 +138,18 @@ typedef tors_elem_struct tors_elem_t[1]; // On adopte la convention de FLINT sur
 void tors_ring_init(tors_ring_t, const fq_ctx_t);
 void tors_ring_clear(tors_ring_t, const fq_ctx_t);
 void tors_ring_set(tors_ring_t, const ell_curve_t, const fq_poly_t, const fq_ctx_t);
+void tors_ring_split(tors_ring_t, const fq_poly_t, const fq_ctx_t);
+void tors_ring_set_kernels(tors_ring_t, const fq_ctx_t);
+void tors_ring_set_threads(tors_ring_t, const slong, const fq_ctx_t);
+int tors_ring_stopped(const tors_ring_t);
+
+/****************/
+/* INTERRUPTION */
+/****************/
+
+double tors_stop_now(void);
+void tors_stop_init(tors_stop_t, const int*, const double);
+int tors_stop_check(tors_stop_t);
 
 /**********************************************/
 /* PRIMITIVES ELEMENTS D'UN ANNEAU DE TORSION */
@@ -65,9 +178,54 @@ void tors_elem_neg(tors_elem_t, const tors_elem_t, const fq_ctx_t);
 void tors_elem_add(tors_elem_t, const tors_elem_t, const tors_elem_t, const fq_ctx_t);
 void tors_elem_sub(tors_elem_t, const tors_elem_t, const tors_elem_t, const fq_ctx_t);
 void tors_elem_mul(tors_elem_t, const tors_elem_t, const tors_elem_t, const tors_ring_t, const fq_ctx_t);
+void tors_elem_mul_unreduced(tors_elem_t, const tors_elem_t, const tors_elem_t, const tors_ring_t, const fq_ctx_t);
+void tors_elem_reduce(tors_elem_t, const tors_elem_t, const tors_ring_t, const fq_ctx_t);
 void tors_elem_mul_fq(tors_elem_t, const tors_elem_t, const fq_t, const fq_ctx_t);
 void tors_elem_mul_sl(tors_elem_t, const tors_elem_t, const slong, const fq_ctx_t);
 void tors_elem_pow(tors_elem_t, const tors_elem_t, const fmpz_t, const tors_ring_t, const fq_ctx_t);
 void tors_elem_pow_ul(tors_elem_t, const tors_elem_t, const ulong, const tors_ring_t, const fq_ctx_t);
 
+/**********************************/
+/* ARITHMETIQUE DANS F_q[x]/(psi) */
+/**********************************/
+
+void tors_poly_mul(fq_poly_t, const fq_poly_t, const fq_poly_t, const tors_ring_t, const fq_ctx_t);
+void tors_poly_sqr(fq_poly_t, const fq_poly_t, const tors_ring_t, const fq_ctx_t);
+void tors_poly_mul_unreduced(fq_poly_t, const fq_poly_t, const fq_poly_t, const tors_ring_t, const fq_ctx_t);
+void tors_poly_sqr_unreduced(fq_poly_t, const fq_poly_t, const tors_ring_t, const fq_ctx_t);
+void tors_poly_reduce(fq_poly_t, const fq_poly_t, const tors_ring_t, const fq_ctx_t);
+void tors_poly_mul_mont(fq_poly_t, const fq_poly_t, const fq_poly_t, const int, const tors_ring_t, const fq_ctx_t);
+void tors_poly_rem_mont(fq_poly_t, const fq_poly_t, const tors_ring_t, const fq_ctx_t);
+void tors_poly_mul_simd(fq_poly_t, const fq_poly_t, const fq_poly_t, const int, const tors_ring_t, const fq_ctx_t);
+void tors_poly_rem_simd(fq_poly_t, const fq_poly_t, const tors_ring_t, const fq_ctx_t);
+void tors_poly_mul_sl(fq_poly_t, const fq_poly_t, const slong, const fq_ctx_t);
+void tors_poly_mul_W(fq_poly_t, const fq_poly_t, const tors_ring_t, const fq_ctx_t);
+void tors_poly_pow(fq_poly_t, const fq_poly_t, const fmpz_t, const tors_ring_t, const fq_ctx_t);
+int tors_poly_inv(fq_poly_t, const fq_poly_t, tors_ring_t, const fq_ctx_t);
+
+/*******************/
+/* OPERANDES FIXES */
+/*******************/
+
+void tors_pre_init(tors_pre_t, const fq_ctx_t);
+void tors_pre_clear(tors_pre_t, const fq_ctx_t);
+void tors_pre_set(tors_pre_t, const fq_poly_t, const tors_ring_t, const fq_ctx_t);
+void tors_poly_mul_pre(fq_poly_t, const fq_poly_t, const tors_pre_t, const tors_ring_t, const fq_ctx_t);
+
+/**********************************/
+/* PRODUITS SUR PLUSIEURS THREADS */
+/**********************************/
+
+void tors_pool_init(tors_pool_t, const slong);
+void tors_pool_clear(tors_pool_t);
+void tors_pool_unlink(tors_pool_t, tors_tasks_t);
+void* tors_pool_worker(void*);
+void tors_task_exec(tors_task_struct*);
+void tors_tasks_run(tors_pool_struct*, tors_task_struct*, const slong, const slong);
+void tors_poly_mul_threads(fq_poly_t, const fq_poly_t, const fq_poly_t, const slong, tors_pool_struct*, const tune_struct*, const fq_ctx_t);
+void tors_poly_rem_threads(fq_poly_t, const fq_poly_t, const slong, const tors_ring_t, const fq_ctx_t);
+void tors_poly_reduce_threads(fq_poly_t, const fq_poly_t, const slong, const tors_ring_t, const fq_ctx_t);
+void tors_elem_mul_unreduced_threads(tors_elem_t, const tors_elem_t, const tors_elem_t, const tors_ring_t, const fq_ctx_t);
+void tors_elem_reduce_threads(tors_elem_t, const tors_elem_t, const tors_ring_t, const fq_ctx_t);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,56 @@
+#ifndef TUNE_H
+#define TUNE_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <flint/flint.h>
+
+/**
+ * Profil de réglage : seuils entre les algorithmes de multiplication de tors_ring.h et poids du modèle de coût
+ * de schoof_bsgs(). Les constantes de tors_ring.h n'en sont que les valeurs par défaut, les seuils réels
+ * dépendent du processeur. bin/schoof_tune les mesure sur la machine avec les vrais noyaux et écrit un profil,
+ * que la bibliothèque charge au premier besoin depuis le fichier désigné par la variable d'environnement
+ * TUNE_ENV (c.f tune_get()).
+ *
+ * Le profil est un fichier texte de lignes "clé valeur", les lignes vides, les commentaires commençant par #
+ * et les clés inconnues sont ignorés, les clés absentes gardent leur valeur par défaut.
+ *
+ * Les seuils des noyaux naïfs dépendent de la taille de q : ils forment une table par taille, lue sous les clés
+ * mont_max_len_<limbs> et simd_max_len_<bits> (c.f tune_mont_limbs et tune_simd_bits). Une clé mont_max_len ou
+ * simd_max_len sans suffixe donne la même valeur à toute la table.
+ */
+
+#define TUNE_ENV "SCHOOF_TUNE" // Variable d'environnement donnant le chemin du profil
+#define TUNE_MAX_KEY 64 // Longueur maximale d'une clé du profil
+#define TUNE_MONT_SIZES 3 // Nombre de tailles de q des noyaux de Montgomery (c.f tune_mont_limbs)
+#define TUNE_SIMD_SIZES 2 // Nombre de tailles de q des noyaux vectorisés (c.f tune_simd_bits)
+
+typedef struct {
+    slong mont_max_len[TUNE_MONT_SIZES]; // c.f TORS_MONT_MAX_LEN, pour q de tune_mont_limbs[i] limbs
+    slong simd_max_len[TUNE_SIMD_SIZES]; // c.f TORS_SIMD_MAX_LEN, pour q d'au plus tune_simd_bits[i] bits (et plus de tune_simd_bits[i-1])
+    slong pre_fft_min_len; // c.f TORS_PRE_FFT_MIN_LEN
+    slong pre_fft_min_limbs; // c.f TORS_PRE_FFT_MIN_LIMBS
+    slong threads_min_len; // c.f TORS_THREADS_MIN_LEN
+    double bsgs_weight; // Facteur appliqué à schoof_bsgs_cost() pour le comparer à schoof_cost() sur cette machine
+} tune_struct;
+
+typedef tune_struct tune_t[1]; // On adopte la convention de FLINT sur les nouveaux types
+
+// Profil en vigueur, chargé une seule fois (c.f tune_get()), modifiable par bin/schoof_tune pendant ses mesures
+extern tune_struct tune_profile;
+extern pthread_once_t tune_once;
+
+extern const slong tune_mont_limbs[TUNE_MONT_SIZES]; // Tailles de q (en limbs) des tables mont_max_len : 2, 4 et 8
+extern const slong tune_simd_bits[TUNE_SIMD_SIZES]; // Tailles maximales de q (en bits) des tables simd_max_len
+
+void tune_set_default(tune_t);
+int tune_load(tune_t, const char*);
+int tune_save(const tune_t, const char*);
+const tune_struct* tune_get(void);
+void tune_load_once(void);
+slong tune_mont_max_len(const tune_struct*, const slong);
+slong tune_simd_max_len(const tune_struct*, const flint_bitcnt_t);
+
+#endif
\ No newline at end of file
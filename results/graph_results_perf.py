@@ -20,7 +20,7 @@ with open(CSV_FILE, newline='') as csvfile:
         if len(row) < 4:
             continue
 
-        q_str, a_str, b_str, time_str = row
+        q_str, a_str, b_str, time_str = row[:4]
 
         try:
             q = int(q_str)
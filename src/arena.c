@@ -0,0 +1,245 @@
+#include "arena.h"
+
+arena_hooks_struct arena_hooks;
+pthread_mutex_t arena_mutex = PTHREAD_MUTEX_INITIALIZER;
+slong arena_active = 0;
+int arena_saved = 0;
+_Thread_local arena_struct* arena_current = NULL;
+
+// Les données d'un bloc commencent après son en-tête, arrondi pour garder l'alignement
+#define ARENA_CHUNK_HEADER (((sizeof(arena_chunk_struct) + ARENA_ALIGN - 1) / ARENA_ALIGN) * ARENA_ALIGN)
+#define ARENA_CHUNK_DATA(c) ((char*)(c) + ARENA_CHUNK_HEADER)
+
+/**************/
+/* PRIMITIVES */
+/**************/
+
+void arena_init(arena_t arena) {
+    arena->chunks = NULL;
+    arena->reserved = 0;
+    arena->used = 0;
+    arena->allocated = 0;
+    arena->peak = 0;
+    arena->live = 0;
+    arena->prev = NULL;
+}
+
+void arena_clear(arena_t arena) {
+    while (arena->chunks != NULL) {
+        arena_chunk_struct* next = arena->chunks->next;
+        arena_hooks.free_func(arena->chunks);
+        arena->chunks = next;
+    }
+    arena->reserved = 0;
+    arena->used = 0;
+}
+
+/**
+ * Remplace les fonctions mémoire de FLINT et de GMP par celles de l'arène, en conservant les précédentes (lues au
+ * premier appel) pour les threads sans arène courante. Appelée avec arena_mutex pris quand la première arène
+ * ouvre.
+ */
+void arena_install(void) {
+    if (!arena_saved) {
+        __flint_get_memory_functions(&arena_hooks.alloc_func, &arena_hooks.calloc_func, &arena_hooks.realloc_func, &arena_hooks.free_func);
+        mp_get_memory_functions(&arena_hooks.gmp_alloc_func, &arena_hooks.gmp_realloc_func, &arena_hooks.gmp_free_func);
+        arena_saved = 1;
+    }
+
+    __flint_set_memory_functions(arena_malloc, arena_calloc, arena_realloc, arena_free);
+    mp_set_memory_functions(arena_gmp_alloc, arena_gmp_realloc, arena_gmp_free);
+}
+
+/**
+ * Remet en place les fonctions mémoire conservées par arena_install(). Appelée avec arena_mutex pris quand la
+ * dernière arène ferme : plus aucun bloc d'arène n'est alors vivant, et ceux alloués par les threads sans arène
+ * viennent déjà des fonctions d'origine.
+ */
+void arena_restore(void) {
+    __flint_set_memory_functions(arena_hooks.alloc_func, arena_hooks.calloc_func, arena_hooks.realloc_func, arena_hooks.free_func);
+    mp_set_memory_functions(arena_hooks.gmp_alloc_func, arena_hooks.gmp_realloc_func, arena_hooks.gmp_free_func);
+}
+
+/**
+ * Fait de arena l'arène courante du thread, ses statistiques repartent de zéro.
+ */
+void arena_begin(arena_t arena) {
+    pthread_mutex_lock(&arena_mutex);
+    if (arena_active++ == 0) arena_install();
+    pthread_mutex_unlock(&arena_mutex);
+
+    arena->allocated = 0;
+    arena->peak = arena->used;
+    arena->prev = arena_current;
+    arena_current = arena;
+}
+
+/**
+ * Rend d'un coup tout ce qui a été alloué depuis arena_begin(). Le calcul libère tout ce qu'il alloue : une
+ * allocation encore vivante ne peut venir que d'un cache de FLINT propre au thread, et ces caches ne sont vidés
+ * que dans ce cas. On ne garde que le plus grand bloc, vide, pour le prochain nombre premier.
+ */
+void arena_end(arena_t arena) {
+    if (arena->live > 0) flint_cleanup();
+    arena_current = (arena_struct*)arena->prev;
+
+    arena_chunk_struct* largest = NULL;
+    while (arena->chunks != NULL) {
+        arena_chunk_struct* next = arena->chunks->next;
+        if (largest == NULL || arena->chunks->size > largest->size) {
+            if (largest != NULL) arena_hooks.free_func(largest);
+            largest = arena->chunks;
+        } else {
+            arena_hooks.free_func(arena->chunks);
+        }
+        arena->chunks = next;
+    }
+
+    arena->chunks = largest;
+    arena->reserved = 0;
+    if (largest != NULL) {
+        largest->next = NULL;
+        largest->used = 0;
+        arena->reserved = largest->size;
+    }
+    arena->used = 0;
+    arena->live = 0;
+
+    pthread_mutex_lock(&arena_mutex);
+    if (--arena_active == 0) arena_restore();
+    pthread_mutex_unlock(&arena_mutex);
+}
+
+/**
+ * Renvoie 1 si ptr a été alloué dans un bloc de arena, 0 sinon.
+ */
+int arena_owns(const arena_t arena, const void* ptr) {
+    for (arena_chunk_struct* c = arena->chunks; c != NULL; c = c->next) {
+        if ((const char*)ptr >= ARENA_CHUNK_DATA(c) && (const char*)ptr < ARENA_CHUNK_DATA(c) + c->size) return 1;
+    }
+    return 0;
+}
+
+/*********************/
+/* FONCTIONS MEMOIRE */
+/*********************/
+
+/**
+ * Alloue size octets dans arena. Chaque allocation est précédée d'un en-tête de ARENA_ALIGN octets qui conserve
+ * sa taille, pour arena_realloc(). Quand le bloc courant est plein, on en demande un nouveau au moins deux fois
+ * plus grand que ce qui est déjà réservé.
+ */
+void* arena_alloc(arena_t arena, size_t size) {
+    size_t need = ((size + ARENA_ALIGN - 1) / ARENA_ALIGN) * ARENA_ALIGN + ARENA_ALIGN;
+    arena_chunk_struct* c = arena->chunks;
+
+    if (c == NULL || c->size - c->used < need) {
+        size_t chunk_size = FLINT_MAX(FLINT_MAX((size_t)ARENA_CHUNK_MIN, need), arena->reserved);
+        c = (arena_chunk_struct*)arena_hooks.alloc_func(ARENA_CHUNK_HEADER + chunk_size);
+        c->size = chunk_size;
+        c->used = 0;
+        c->next = arena->chunks;
+        arena->chunks = c;
+        arena->reserved += chunk_size;
+    }
+
+    char* block = ARENA_CHUNK_DATA(c) + c->used;
+    *(size_t*)block = size;
+    c->used += need;
+
+    arena->used += need;
+    arena->allocated += size;
+    arena->live++;
+    if (arena->used > arena->peak) arena->peak = arena->used;
+
+    return block + ARENA_ALIGN;
+}
+
+void* arena_malloc(size_t size) {
+    if (arena_current == NULL) return arena_hooks.alloc_func(size);
+    return arena_alloc(arena_current, size);
+}
+
+void* arena_calloc(size_t num, size_t size) {
+    if (arena_current == NULL) return arena_hooks.calloc_func(num, size);
+
+    void* ptr = arena_alloc(arena_current, num * size);
+    memset(ptr, 0, num * size);
+    return ptr;
+}
+
+/**
+ * Si ptr est la dernière allocation du bloc courant, elle est agrandie ou réduite sur place. Sinon on en alloue une
+ * nouvelle, l'ancienne n'étant rendue qu'à la fin.
+ */
+void* arena_realloc(void* ptr, size_t size) {
+    arena_struct* arena = arena_current;
+
+    if (ptr == NULL) return arena_malloc(size);
+    if (arena == NULL || !arena_owns(arena, ptr)) return arena_hooks.realloc_func(ptr, size);
+
+    char* block = (char*)ptr - ARENA_ALIGN;
+    size_t old_size = *(size_t*)block;
+    size_t old_need = ((old_size + ARENA_ALIGN - 1) / ARENA_ALIGN) * ARENA_ALIGN + ARENA_ALIGN;
+    size_t need = ((size + ARENA_ALIGN - 1) / ARENA_ALIGN) * ARENA_ALIGN + ARENA_ALIGN;
+    arena_chunk_struct* c = arena->chunks;
+
+    if (block + old_need == ARENA_CHUNK_DATA(c) + c->used && c->used - old_need + need <= c->size) {
+        c->used = c->used - old_need + need;
+        arena->used = arena->used - old_need + need;
+        if (size > old_size) arena->allocated += size - old_size;
+        if (arena->used > arena->peak) arena->peak = arena->used;
+        *(size_t*)block = size;
+        return ptr;
+    }
+
+    void* res = arena_alloc(arena, size);
+    memcpy(res, ptr, FLINT_MIN(old_size, size));
+    arena->live--; // L'ancienne allocation est abandonnée
+    return res;
+}
+
+/**
+ * Ne rend la place que si ptr est la dernière allocation du bloc courant, c'est le cas des variables temporaires
+ * libérées dans l'ordre inverse de leur allocation.
+ */
+void arena_free(void* ptr) {
+    arena_struct* arena = arena_current;
+
+    if (ptr == NULL) return;
+    if (arena == NULL || !arena_owns(arena, ptr)) {
+        arena_hooks.free_func(ptr);
+        return;
+    }
+
+    char* block = (char*)ptr - ARENA_ALIGN;
+    size_t need = ((*(size_t*)block + ARENA_ALIGN - 1) / ARENA_ALIGN) * ARENA_ALIGN + ARENA_ALIGN;
+    arena_chunk_struct* c = arena->chunks;
+    arena->live--;
+
+    if (block + need == ARENA_CHUNK_DATA(c) + c->used) {
+        c->used -= need;
+        arena->used -= need;
+    }
+}
+
+/**
+ * Mêmes fonctions pour GMP, dont les blocs hors arène sont rendus à ses propres fonctions.
+ */
+void* arena_gmp_alloc(size_t size) {
+    if (arena_current == NULL) return arena_hooks.gmp_alloc_func(size);
+    return arena_alloc(arena_current, size);
+}
+
+void* arena_gmp_realloc(void* ptr, size_t old_size, size_t size) {
+    if (arena_current == NULL || !arena_owns(arena_current, ptr)) return arena_hooks.gmp_realloc_func(ptr, old_size, size);
+    return arena_realloc(ptr, size);
+}
+
+void arena_gmp_free(void* ptr, size_t size) {
+    if (arena_current == NULL || !arena_owns(arena_current, ptr)) {
+        arena_hooks.gmp_free_func(ptr, size);
+        return;
+    }
+    arena_free(ptr);
+}
\ No newline at end of file
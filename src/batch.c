@@ -0,0 +1,759 @@
+#include "batch.h"
+
+/**************/
+/* PRIMITIVES */
+/**************/
+
+/**
+ * Prépare le traitement des num courbes (elliptiques) de curves, avec 1 <= num <= BATCH_MAX_LANES et q premier
+ * pris en charge par simd.h. ψ_l est choisi ensuite par batch_set_psi().
+ */
+void batch_init(batch_t batch, const ell_curve_struct* curves, const slong num, const fq_ctx_t ctx) {
+    simd_ctx_init(batch->simd, ctx);
+
+    slong width = simd_lanes(batch->simd);
+    slong lanes = (num + width - 1) / width * width;
+
+    batch->num = num;
+    batch->lanes = lanes;
+    batch->curves = (ell_curve_struct*)flint_malloc(lanes * sizeof(ell_curve_struct));
+    batch->rings = (tors_ring_struct*)flint_malloc(lanes * sizeof(tors_ring_struct));
+    batch->a = (double*)flint_malloc(lanes * sizeof(double));
+    batch->W = (double*)flint_malloc(4 * lanes * sizeof(double));
+    batch->psi = NULL;
+    batch->len_psi = 0;
+
+    fmpz_t c;
+    fmpz_init(c);
+
+    for (slong k = 0; k < lanes; k++) {
+        const ell_curve_struct* E = curves + ((k < num) ? k : 0);
+
+        ell_curve_init(batch->curves + k, ctx);
+        ell_curve_set(batch->curves + k, E->a, E->b, ctx);
+        tors_ring_init(batch->rings + k, ctx);
+
+        // W = x^3 + a*x + b
+        fq_get_fmpz(c, E->a, ctx);
+        batch->a[k] = (double)fmpz_get_ui(c);
+        batch->W[lanes + k] = batch->a[k];
+
+        fq_get_fmpz(c, E->b, ctx);
+        batch->W[k] = (double)fmpz_get_ui(c);
+        batch->W[2 * lanes + k] = 0;
+        batch->W[3 * lanes + k] = 1;
+    }
+
+    fmpz_clear(c);
+}
+
+void batch_clear(batch_t batch, const fq_ctx_t ctx) {
+    for (slong k = 0; k < batch->lanes; k++) {
+        ell_curve_clear(batch->curves + k, ctx);
+        tors_ring_clear(batch->rings + k, ctx);
+    }
+
+    flint_free(batch->curves);
+    flint_free(batch->rings);
+    flint_free(batch->a);
+    flint_free(batch->W);
+    flint_free(batch->psi);
+}
+
+/**
+ * Choisit ψ_l pour chaque courbe, psi[k] étant celui de la k-ème courbe. Tous doivent avoir le même degré, ce
+ * qui est le cas des polynômes de division d'un même indice l impair premier avec p.
+ */
+void batch_set_psi(batch_t batch, fq_poly_struct* const* psi, const fq_ctx_t ctx) {
+    fq_poly_t monic;
+    fq_poly_init(monic, ctx);
+
+    batch->len_psi = fq_poly_length(psi[0], ctx);
+    batch->psi = (double*)flint_realloc(batch->psi, batch->len_psi * batch->lanes * sizeof(double));
+
+    for (slong k = 0; k < batch->lanes; k++) {
+        const fq_poly_struct* psi_k = psi[(k < batch->num) ? k : 0];
+
+        tors_ring_set(batch->rings + k, batch->curves + k, psi_k, ctx);
+        fq_poly_make_monic(monic, psi_k, ctx);
+        batch_poly_set_lane(batch->psi, monic, batch->len_psi, k, batch, ctx);
+    }
+
+    fq_poly_clear(monic, ctx);
+}
+
+/**
+ * Masque de toutes les voies : la voie k correspond au bit k des masques renvoyés par ce fichier.
+ */
+ulong batch_all(const batch_t batch) {
+    return (UWORD(1) << batch->lanes) - 1;
+}
+
+/************************/
+/* POLYNOMES ENTRELACES */
+/************************/
+
+/**
+ * Écrit les len premiers coefficients de op (complétés par des zéros) dans la voie k de rop.
+ */
+void batch_poly_set_lane(double* rop, const fq_poly_t op, const slong len, const slong k, const batch_t batch, const fq_ctx_t ctx) {
+    fmpz_t c;
+    fmpz_init(c);
+
+    slong len_op = FLINT_MIN(len, fq_poly_length(op, ctx));
+    for (slong i = 0; i < len_op; i++) {
+        fq_get_fmpz(c, op->coeffs + i, ctx);
+        rop[i * batch->lanes + k] = (double)fmpz_get_ui(c);
+    }
+    for (slong i = len_op; i < len; i++) rop[i * batch->lanes + k] = 0;
+
+    fmpz_clear(c);
+}
+
+void batch_poly_get_lane(fq_poly_t rop, const double* op, const slong len, const slong k, const batch_t batch, const fq_ctx_t ctx) {
+    fmpz_t c;
+    fmpz_init(c);
+
+    fq_poly_fit_length(rop, len, ctx);
+    for (slong i = 0; i < len; i++) {
+        fmpz_set_ui(c, (ulong)op[i * batch->lanes + k]);
+        fq_set_fmpz(rop->coeffs + i, c, ctx);
+    }
+    for (slong i = len; i < fq_poly_length(rop, ctx); i++) fq_zero(rop->coeffs + i, ctx);
+    _fq_poly_set_length(rop, len, ctx);
+    _fq_poly_normalise(rop, ctx);
+
+    fmpz_clear(c);
+}
+
+/**
+ * Opérations coefficient par coefficient sur les len premiers coefficients de chaque voie, rop pouvant recouvrir
+ * les opérandes.
+ */
+void batch_poly_add(double* rop, const double* op1, const double* op2, const slong len, const batch_t batch) {
+    for (slong i = 0; i < len * batch->lanes; i++) rop[i] = simd_addmod(op1[i], op2[i], batch->simd);
+}
+
+void batch_poly_sub(double* rop, const double* op1, const double* op2, const slong len, const batch_t batch) {
+    for (slong i = 0; i < len * batch->lanes; i++) rop[i] = simd_submod(op1[i], op2[i], batch->simd);
+}
+
+void batch_poly_scalar_mul_ui(double* rop, const double* op, const ulong c, const slong len, const batch_t batch) {
+    const double c_mod = (double)(c % (ulong)batch->simd->p);
+    for (slong i = 0; i < len * batch->lanes; i++) rop[i] = simd_mulmod(op[i], c_mod, batch->simd);
+}
+
+// Produit de chaque voie par le a de sa courbe
+void batch_poly_mul_a(double* rop, const double* op, const slong len, const batch_t batch) {
+    for (slong i = 0; i < len; i++) {
+        for (slong k = 0; k < batch->lanes; k++) {
+            rop[i * batch->lanes + k] = simd_mulmod(op[i * batch->lanes + k], batch->a[k], batch->simd);
+        }
+    }
+}
+
+/**
+ * rop = op1*op2 voie par voie, sans réduction : rop reçoit len1+len2-1 coefficients et ne doit pas recouvrir
+ * les opérandes.
+ */
+void batch_poly_mul(double* rop, const double* op1, const slong len1, const double* op2, const slong len2, const batch_t batch) {
+    simd_lanes_mul(rop, op1, len1, op2, len2, batch->lanes, batch->simd);
+}
+
+/**
+ * Réduit op, de longueur len, modulo ψ_l (op sert d'espace de travail) et écrit le reste, de len_psi-1
+ * coefficients, dans rop qui peut être op.
+ */
+void batch_poly_reduce(double* rop, double* op, const slong len, const batch_t batch) {
+    slong d = batch->len_psi - 1;
+    slong len_res = FLINT_MIN(len, d);
+
+    simd_lanes_rem(op, len, batch->psi, batch->len_psi, batch->lanes, batch->simd);
+
+    memmove(rop, op, len_res * batch->lanes * sizeof(double));
+    memset(rop + len_res * batch->lanes, 0, (d - len_res) * batch->lanes * sizeof(double));
+}
+
+/**
+ * rop = op1*op2 mod ψ_l, rop reçoit len_psi-1 coefficients et peut recouvrir op1 ou op2.
+ */
+void batch_poly_mulmod(double* rop, const double* op1, const slong len1, const double* op2, const slong len2, const batch_t batch) {
+    slong len = len1 + len2 - 1;
+    double* prod = (double*)flint_malloc(len * batch->lanes * sizeof(double));
+
+    batch_poly_mul(prod, op1, len1, op2, len2, batch);
+    batch_poly_reduce(rop, prod, len, batch);
+
+    flint_free(prod);
+}
+
+/**
+ * rop = op^e mod ψ_l, op étant réduit et de longueur len >= 1. L'exposant est le même pour toutes les voies, qui
+ * suivent donc exactement les mêmes étapes. rop peut recouvrir op.
+ */
+void batch_poly_pow(double* rop, const double* op, const slong len, const fmpz_t e, const batch_t batch) {
+    slong d = batch->len_psi - 1;
+    double* res = (double*)flint_malloc(d * batch->lanes * sizeof(double));
+    double* base = (double*)flint_malloc(len * batch->lanes * sizeof(double));
+
+    memcpy(base, op, len * batch->lanes * sizeof(double));
+    memset(res, 0, d * batch->lanes * sizeof(double));
+
+    if (fmpz_is_zero(e)) {
+        for (slong k = 0; k < batch->lanes; k++) res[k] = 1;
+    } else {
+        memcpy(res, base, len * batch->lanes * sizeof(double));
+
+        for (slong i = fmpz_bits(e) - 2; i >= 0; i--) {
+            batch_poly_mulmod(res, res, d, res, d, batch);
+            if (fmpz_tstbit(e, i)) batch_poly_mulmod(res, res, d, base, len, batch);
+        }
+    }
+
+    memcpy(rop, res, d * batch->lanes * sizeof(double));
+
+    flint_free(res);
+    flint_free(base);
+}
+
+/**
+ * Masques des voies où op (de longueur len) est nul, vaut 1, ou est égal à op2.
+ */
+ulong batch_poly_is_zero(const double* op, const slong len, const batch_t batch) {
+    ulong mask = batch_all(batch);
+
+    for (slong i = 0; i < len && mask != 0; i++) {
+        for (slong k = 0; k < batch->lanes; k++) {
+            if (op[i * batch->lanes + k] != 0) mask &= ~(UWORD(1) << k);
+        }
+    }
+
+    return mask;
+}
+
+ulong batch_poly_is_one(const double* op, const slong len, const batch_t batch) {
+    ulong mask = batch_poly_is_zero(op + batch->lanes, len - 1, batch);
+
+    for (slong k = 0; k < batch->lanes; k++) {
+        if (op[k] != 1) mask &= ~(UWORD(1) << k);
+    }
+
+    return mask;
+}
+
+ulong batch_poly_equal(const double* op1, const double* op2, const slong len, const batch_t batch) {
+    ulong mask = batch_all(batch);
+
+    for (slong i = 0; i < len && mask != 0; i++) {
+        for (slong k = 0; k < batch->lanes; k++) {
+            if (op1[i * batch->lanes + k] != op2[i * batch->lanes + k]) mask &= ~(UWORD(1) << k);
+        }
+    }
+
+    return mask;
+}
+
+/**********/
+/* POINTS */
+/**********/
+
+/**
+ * Les coordonnées ont len_psi-1 coefficients : ψ_l doit donc être choisi avant batch_point_init().
+ */
+void batch_point_init(batch_point_t P, const batch_t batch) {
+    slong n = (batch->len_psi - 1) * batch->lanes;
+
+    P->X = (double*)flint_malloc(3 * n * sizeof(double));
+    P->Y = P->X + n;
+    P->Z = P->Y + n;
+}
+
+void batch_point_clear(batch_point_t P) {
+    flint_free(P->X);
+}
+
+void batch_point_set_infinity(batch_point_t P, const batch_t batch) {
+    slong n = (batch->len_psi - 1) * batch->lanes;
+
+    memset(P->X, 0, 3 * n * sizeof(double));
+    for (slong k = 0; k < batch->lanes; k++) {
+        P->X[k] = 1;
+        P->Y[k] = 1;
+    }
+}
+
+/**
+ * Affecte à chaque voie de P le point (x,y), c'est-à-dire X = x, Y = 1 et Z = 1 (c.f ell_cpoint_set_x_y()).
+ */
+void batch_point_set_x_y(batch_point_t P, const batch_t batch) {
+    slong n = (batch->len_psi - 1) * batch->lanes;
+
+    memset(P->X, 0, 3 * n * sizeof(double));
+    for (slong k = 0; k < batch->lanes; k++) {
+        P->X[batch->lanes + k] = 1;
+        P->Y[k] = 1;
+        P->Z[k] = 1;
+    }
+}
+
+void batch_point_copy(batch_point_t rop, const batch_point_t op, const batch_t batch) {
+    slong n = (batch->len_psi - 1) * batch->lanes;
+    memcpy(rop->X, op->X, 3 * n * sizeof(double));
+}
+
+void batch_point_swap(batch_point_t op1, batch_point_t op2) {
+    batch_point_struct temp = *op1;
+    *op1 = *op2;
+    *op2 = temp;
+}
+
+void batch_point_set_lane(batch_point_t rop, const ell_cpoint_t op, const slong k, const batch_t batch, const fq_ctx_t ctx) {
+    batch_poly_set_lane(rop->X, op->X, batch->len_psi - 1, k, batch, ctx);
+    batch_poly_set_lane(rop->Y, op->Y, batch->len_psi - 1, k, batch, ctx);
+    batch_poly_set_lane(rop->Z, op->Z, batch->len_psi - 1, k, batch, ctx);
+}
+
+void batch_point_get_lane(ell_cpoint_t rop, const batch_point_t op, const slong k, const batch_t batch, const fq_ctx_t ctx) {
+    batch_poly_get_lane(rop->X, op->X, batch->len_psi - 1, k, batch, ctx);
+    batch_poly_get_lane(rop->Y, op->Y, batch->len_psi - 1, k, batch, ctx);
+    batch_poly_get_lane(rop->Z, op->Z, batch->len_psi - 1, k, batch, ctx);
+}
+
+ulong batch_point_is_infinity(const batch_point_t op, const batch_t batch) {
+    return batch_poly_is_zero(op->Z, batch->len_psi - 1, batch);
+}
+
+/**
+ * Masque des voies où op1 = op2 (c.f ell_cpoint_equal()). Les ordonnées ne sont comparées que si au moins une
+ * voie a des abscisses égales.
+ */
+ulong batch_point_equal(const batch_point_t op1, const batch_point_t op2, const batch_t batch) {
+    slong d = batch->len_psi - 1;
+    slong n = d * batch->lanes;
+
+    ulong inf1 = batch_point_is_infinity(op1, batch);
+    ulong inf2 = batch_point_is_infinity(op2, batch);
+
+    double* Z1_2 = (double*)flint_malloc(4 * n * sizeof(double));
+    double* Z2_2 = Z1_2 + n;
+    double* temp1 = Z2_2 + n;
+    double* temp2 = temp1 + n;
+
+    batch_poly_mulmod(Z2_2, op2->Z, d, op2->Z, d, batch);
+    batch_poly_mulmod(temp1, op1->X, d, Z2_2, d, batch);
+
+    batch_poly_mulmod(Z1_2, op1->Z, d, op1->Z, d, batch);
+    batch_poly_mulmod(temp2, op2->X, d, Z1_2, d, batch);
+
+    ulong equal = batch_poly_equal(temp1, temp2, d, batch) & ~inf1 & ~inf2;
+
+    if (equal != 0) {
+        batch_poly_mulmod(temp1, Z2_2, d, op2->Z, d, batch);
+        batch_poly_mulmod(temp1, temp1, d, op1->Y, d, batch);
+
+        batch_poly_mulmod(temp2, Z1_2, d, op1->Z, d, batch);
+        batch_poly_mulmod(temp2, temp2, d, op2->Y, d, batch);
+
+        equal &= batch_poly_equal(temp1, temp2, d, batch);
+    }
+
+    flint_free(Z1_2);
+
+    return equal | (inf1 & inf2);
+}
+
+/**
+ * Mêmes formules que ell_cpoint_double() dans toutes les voies. Celles de active où op est d'ordre 1 ou 2 sont
+ * recalculées par ell_cpoint_double(), les autres voies hors de active peuvent recevoir n'importe quel point.
+ */
+void batch_point_double(batch_point_t rop, const batch_point_t op, const ulong active, const batch_t batch, const fq_ctx_t ctx) {
+    slong d = batch->len_psi - 1;
+    slong n = d * batch->lanes;
+
+    ulong special = (batch_point_is_infinity(op, batch) | batch_poly_is_zero(op->Y, d, batch)) & active;
+
+    batch_point_t res;
+    batch_point_init(res, batch);
+
+    // A, B et C sont réduits, U et V reçoivent les produits non réduits (par W au plus)
+    double* A = (double*)flint_malloc(3 * n * sizeof(double));
+    double* B = A + n;
+    double* C = B + n;
+    double* U = (double*)flint_malloc(2 * (2 * d + 2) * batch->lanes * sizeof(double));
+    double* V = U + (2 * d + 2) * batch->lanes;
+
+    // A = (y*Y)^2 = W*Y^2
+    batch_poly_mul(U, op->Y, d, op->Y, d, batch);
+    batch_poly_mul(V, U, 2 * d - 1, batch->W, 4, batch);
+    batch_poly_reduce(A, V, 2 * d + 2, batch);
+
+    // B = 4*X*A
+    batch_poly_mulmod(B, op->X, d, A, d, batch);
+    batch_poly_scalar_mul_ui(B, B, 4, d, batch);
+
+    // C = 3*X^2 + a*Z^4
+    batch_poly_mulmod(C, op->Z, d, op->Z, d, batch);
+    batch_poly_mul(U, C, d, C, d, batch);
+    batch_poly_mul_a(U, U, 2 * d - 1, batch);
+    batch_poly_mul(V, op->X, d, op->X, d, batch);
+    batch_poly_scalar_mul_ui(V, V, 3, 2 * d - 1, batch);
+    batch_poly_add(U, U, V, 2 * d - 1, batch);
+    batch_poly_reduce(C, U, 2 * d - 1, batch);
+
+    // X_3 = C^2 - 2*B
+    batch_poly_mul(U, C, d, C, d, batch);
+    batch_poly_scalar_mul_ui(res->Y, B, 2, d, batch);
+    batch_poly_sub(U, U, res->Y, d, batch);
+    batch_poly_reduce(res->X, U, 2 * d - 1, batch);
+
+    // Y_3 = W*(C*(B - X_3) - 8*A^2)
+    batch_poly_sub(B, B, res->X, d, batch);
+    batch_poly_mul(U, C, d, B, d, batch);
+    batch_poly_mul(V, A, d, A, d, batch);
+    batch_poly_scalar_mul_ui(V, V, 8, 2 * d - 1, batch);
+    batch_poly_sub(U, U, V, 2 * d - 1, batch);
+    batch_poly_mul(V, U, 2 * d - 1, batch->W, 4, batch);
+    batch_poly_reduce(res->Y, V, 2 * d + 2, batch);
+
+    // Z_3 = 2*W*Y*Z
+    batch_poly_mul(U, op->Y, d, op->Z, d, batch);
+    batch_poly_scalar_mul_ui(U, U, 2, 2 * d - 1, batch);
+    batch_poly_mul(V, U, 2 * d - 1, batch->W, 4, batch);
+    batch_poly_reduce(res->Z, V, 2 * d + 2, batch);
+
+    // X_3 = W*X_3
+    batch_poly_mul(V, res->X, d, batch->W, 4, batch);
+    batch_poly_reduce(res->X, V, d + 3, batch);
+
+    if (special != 0) {
+        ell_cpoint_t P;
+        ell_cpoint_init(P, ctx);
+
+        for (slong k = 0; k < batch->lanes; k++) {
+            if (!(special >> k & 1)) continue;
+
+            batch_point_get_lane(P, op, k, batch, ctx);
+            ell_cpoint_double(P, P, batch->rings + k, ctx);
+            batch_point_set_lane(res, P, k, batch, ctx);
+        }
+
+        ell_cpoint_clear(P, ctx);
+    }
+
+    batch_point_swap(rop, res);
+
+    flint_free(A);
+    flint_free(U);
+    batch_point_clear(res);
+}
+
+/**
+ * Mêmes formules que ell_cpoint_add() dans toutes les voies, avec addition mixte si op1 ou op2 est affine dans
+ * toutes les voies. Celles de active où l'un des points est à l'infini ou H = 0 (op1 = ±op2) sont recalculées par
+ * ell_cpoint_add(), les autres voies hors de active peuvent recevoir n'importe quel point.
+ */
+void batch_point_add(batch_point_t rop, const batch_point_t op1, const batch_point_t op2, const ulong active, const batch_t batch, const fq_ctx_t ctx) {
+    slong d = batch->len_psi - 1;
+    slong n = d * batch->lanes;
+
+    ulong inf = batch_point_is_infinity(op1, batch) | batch_point_is_infinity(op2, batch);
+    int aff1 = (batch_poly_is_one(op1->Z, d, batch) == batch_all(batch));
+    int aff2 = (batch_poly_is_one(op2->Z, d, batch) == batch_all(batch));
+
+    batch_point_t res;
+    batch_point_init(res, batch);
+
+    double* U1 = (double*)flint_malloc(7 * n * sizeof(double));
+    double* U2 = U1 + n;
+    double* S1 = U2 + n;
+    double* S2 = S1 + n;
+    double* H = S2 + n;
+    double* R = H + n;
+    double* temp = R + n;
+    double* U = (double*)flint_malloc(2 * (2 * d + 2) * batch->lanes * sizeof(double));
+    double* V = U + (2 * d + 2) * batch->lanes;
+
+    // U_1 et S_1
+    if (aff2) {
+        memcpy(U1, op1->X, n * sizeof(double));
+        memcpy(S1, op1->Y, n * sizeof(double));
+    } else {
+        batch_poly_mulmod(temp, op2->Z, d, op2->Z, d, batch);
+        batch_poly_mulmod(U1, op1->X, d, temp, d, batch);
+        batch_poly_mulmod(temp, temp, d, op2->Z, d, batch);
+        batch_poly_mulmod(S1, op1->Y, d, temp, d, batch);
+    }
+
+    // U_2 et S_2
+    if (aff1) {
+        memcpy(U2, op2->X, n * sizeof(double));
+        memcpy(S2, op2->Y, n * sizeof(double));
+    } else {
+        batch_poly_mulmod(temp, op1->Z, d, op1->Z, d, batch);
+        batch_poly_mulmod(U2, op2->X, d, temp, d, batch);
+        batch_poly_mulmod(temp, temp, d, op1->Z, d, batch);
+        batch_poly_mulmod(S2, op2->Y, d, temp, d, batch);
+    }
+
+    // H = U_2 - U_1 et R = S_2 - S_1
+    batch_poly_sub(H, U2, U1, d, batch);
+    batch_poly_sub(R, S2, S1, d, batch);
+
+    ulong special = (inf | batch_poly_is_zero(H, d, batch)) & active;
+
+    // U2 = H^2, S2 = H^3, U1 = U_1*H^2
+    batch_poly_mulmod(U2, H, d, H, d, batch);
+    batch_poly_mulmod(S2, U2, d, H, d, batch);
+    batch_poly_mulmod(U1, U1, d, U2, d, batch);
+
+    // X_3 = W*R^2 - H^3 - 2*U_1*H^2
+    batch_poly_mul(U, R, d, R, d, batch);
+    batch_poly_mul(V, U, 2 * d - 1, batch->W, 4, batch);
+    batch_poly_scalar_mul_ui(temp, U1, 2, d, batch);
+    batch_poly_add(temp, S2, temp, d, batch);
+    batch_poly_sub(V, V, temp, d, batch);
+    batch_poly_reduce(res->X, V, 2 * d + 2, batch);
+
+    // Y_3 = R*(U_1*H^2 - X_3) - S_1*H^3
+    batch_poly_sub(temp, U1, res->X, d, batch);
+    batch_poly_mul(U, R, d, temp, d, batch);
+    batch_poly_mul(V, S1, d, S2, d, batch);
+    batch_poly_sub(U, U, V, 2 * d - 1, batch);
+    batch_poly_reduce(res->Y, U, 2 * d - 1, batch);
+
+    // Z_3 = Z_1*Z_2*H
+    if (aff1 && aff2) {
+        memcpy(res->Z, H, n * sizeof(double));
+    } else if (aff1) {
+        batch_poly_mulmod(res->Z, op2->Z, d, H, d, batch);
+    } else if (aff2) {
+        batch_poly_mulmod(res->Z, op1->Z, d, H, d, batch);
+    } else {
+        batch_poly_mulmod(res->Z, op1->Z, d, op2->Z, d, batch);
+        batch_poly_mulmod(res->Z, res->Z, d, H, d, batch);
+    }
+
+    if (special != 0) {
+        ell_cpoint_t P1, P2;
+        ell_cpoint_init(P1, ctx);
+        ell_cpoint_init(P2, ctx);
+
+        for (slong k = 0; k < batch->lanes; k++) {
+            if (!(special >> k & 1)) continue;
+
+            batch_point_get_lane(P1, op1, k, batch, ctx);
+            batch_point_get_lane(P2, op2, k, batch, ctx);
+            ell_cpoint_add(P1, P1, P2, batch->rings + k, ctx);
+            batch_point_set_lane(res, P1, k, batch, ctx);
+        }
+
+        ell_cpoint_clear(P1, ctx);
+        ell_cpoint_clear(P2, ctx);
+    }
+
+    batch_point_swap(rop, res);
+
+    flint_free(U1);
+    flint_free(U);
+    batch_point_clear(res);
+}
+
+/**
+ * rop = [n]op dans toutes les voies, pour n >= 1, par doublements et additions.
+ */
+void batch_point_mul(batch_point_t rop, const batch_point_t op, const ulong n, const batch_t batch, const fq_ctx_t ctx) {
+    batch_point_t res;
+    batch_point_init(res, batch);
+    batch_point_copy(res, op, batch);
+
+    for (slong i = FLINT_BIT_COUNT(n) - 2; i >= 0; i--) {
+        batch_point_double(res, res, batch_all(batch), batch, ctx);
+        if ((n >> i) & 1) batch_point_add(res, res, op, batch_all(batch), batch, ctx);
+    }
+
+    batch_point_swap(rop, res);
+    batch_point_clear(res);
+}
+
+/*******************/
+/* SCHOOF PAR LOTS */
+/*******************/
+
+/**
+ * Calcule a_q modulo l pour chaque voie (c.f schoof_mod_l()), t[k] recevant celui de la k-ème courbe, ψ_l étant
+ * déjà choisi par batch_set_psi(). La boucle sur t s'arrête dès que toutes les voies ont trouvé leur classe.
+ */
+void batch_schoof_mod_l(ulong* t, const ulong l, const batch_t batch, const fq_ctx_t ctx) {
+    slong d = batch->len_psi - 1;
+
+    // Initialisation et définition de q, q mod l et (q-1)/2
+    fmpz_t q, q_1_2;
+    fmpz_init(q);
+    fmpz_init(q_1_2);
+    fq_ctx_order(q, ctx);
+    fmpz_sub_ui(q_1_2, q, 1);
+    fmpz_fdiv_q_2exp(q_1_2, q_1_2, 1);
+    ulong q_mod_l = fmpz_fdiv_ui(q, l);
+
+    batch_point_t P, Q, x_y, Frob_x_y, Frob2_x_y;
+    batch_point_init(P, batch);
+    batch_point_init(Q, batch);
+    batch_point_init(x_y, batch);
+    batch_point_init(Frob_x_y, batch);
+    batch_point_init(Frob2_x_y, batch);
+
+    // x_y = (x,y), Frob_x_y et Frob2_x_y seront affines
+    batch_point_set_x_y(x_y, batch);
+    batch_point_set_x_y(Frob_x_y, batch);
+    batch_point_set_x_y(Frob2_x_y, batch);
+
+    // Frob_x_y = (x^q, y*W^{(q-1)/2})
+    batch_poly_pow(Frob_x_y->X, x_y->X, 2, q, batch);
+    batch_poly_pow(Frob_x_y->Y, batch->W, FLINT_MIN(4, d), q_1_2, batch);
+
+    // Frob2_x_y = (x^{q^2}, y*W^{(q-1)/2}*(W^{(q-1)/2})^q)
+    batch_poly_pow(Frob2_x_y->X, Frob_x_y->X, d, q, batch);
+    batch_poly_pow(Frob2_x_y->Y, Frob_x_y->Y, d, q, batch);
+    batch_poly_mulmod(Frob2_x_y->Y, Frob2_x_y->Y, d, Frob_x_y->Y, d, batch);
+
+    // P = (x^{q^2}, y^{q^2}) + [q](x,y), q mod l est non nul car l != p
+    batch_point_mul(P, x_y, q_mod_l, batch, ctx);
+    batch_point_add(P, Frob2_x_y, P, batch_all(batch), batch, ctx);
+
+    // Voies dont la classe de a_q est trouvée, qui ne sont plus recalculées en cas d'addition exceptionnelle
+    ulong done = 0;
+    for (slong k = 0; k < batch->lanes; k++) t[k] = l;
+
+    for (ulong s = 0; s < l && done != batch_all(batch); s++) {
+        // Q = [s](x^q,y^q)
+        if (s == 0) {
+            batch_point_set_infinity(Q, batch);
+        } else if (s == 1) {
+            batch_point_copy(Q, Frob_x_y, batch);
+        } else {
+            batch_point_add(Q, Q, Frob_x_y, batch_all(batch) & ~done, batch, ctx);
+        }
+
+        ulong found = batch_point_equal(Q, P, batch) & ~done;
+        for (slong k = 0; k < batch->lanes; k++) {
+            if (found >> k & 1) t[k] = s;
+        }
+        done |= found;
+    }
+
+    // Libération de la mémoire
+    fmpz_clear(q);
+    fmpz_clear(q_1_2);
+
+    batch_point_clear(P);
+    batch_point_clear(Q);
+    batch_point_clear(x_y);
+    batch_point_clear(Frob_x_y);
+    batch_point_clear(Frob2_x_y);
+}
+
+/**
+ * Calcule le nombre de points des num courbes de curves (1 <= num <= BATCH_MAX_LANES), comme ell_schoof() avec
+ * les options par défaut : mêmes nombres premiers l, mêmes ψ_l (calculés courbe par courbe) et même recombinaison.
+ */
+void batch_schoof_curves(fmpz* res, const ell_curve_struct* curves, const slong num, const fq_ctx_t ctx) {
+    batch_t batch;
+    batch_init(batch, curves, num, ctx);
+
+    // A_max = 4*sqrt(q)
+    fmpz_t q, A, A_max;
+    fmpz_init(q);
+    fmpz_init_set_ui(A, 1);
+    fmpz_init(A_max);
+    fq_ctx_order(q, ctx);
+    fmpz_sqrt(A_max, q);
+    fmpz_mul_ui(A_max, A_max, 4);
+
+    list_fq_poly_struct* list_psi = (list_fq_poly_struct*)flint_malloc(num * sizeof(list_fq_poly_struct));
+    list_ulong_struct* list_ts = (list_ulong_struct*)flint_malloc(num * sizeof(list_ulong_struct));
+    fq_poly_struct** psi = (fq_poly_struct**)flint_malloc(num * sizeof(fq_poly_struct*));
+    ulong* t = (ulong*)flint_malloc(batch->lanes * sizeof(ulong));
+
+    list_ulong_t list_primes;
+    list_ulong_init(list_primes);
+    for (slong k = 0; k < num; k++) {
+        list_fq_poly_init(list_psi + k);
+        list_ulong_init(list_ts + k);
+    }
+
+    for (ulong l = 3; fmpz_cmp(A, A_max) <= 0; l = n_nextprime(l, 1)) {
+        if (fmpz_equal_ui(q, l)) continue;
+
+        for (slong k = 0; k < num; k++) {
+            update_list_div_poly(list_psi + k, curves + k, l, ctx);
+            psi[k] = list_fq_poly_get(list_psi + k, l);
+        }
+        batch_set_psi(batch, psi, ctx);
+
+        batch_schoof_mod_l(t, l, batch, ctx);
+
+        list_ulong_add(list_primes, l);
+        for (slong k = 0; k < num; k++) list_ulong_add(list_ts + k, t[k]);
+        fmpz_mul_ui(A, A, l);
+    }
+
+    // On utilise le théorème des restes chinois pour retrouver chaque a_q
+    for (slong k = 0; k < num; k++) schoof_crt(res + k, list_primes, list_ts + k, ctx);
+
+    // Libération de la mémoire
+    for (slong k = 0; k < num; k++) {
+        list_fq_poly_clear(list_psi + k, ctx);
+        list_ulong_clear(list_ts + k);
+    }
+    list_ulong_clear(list_primes);
+    flint_free(list_psi);
+    flint_free(list_ts);
+    flint_free(psi);
+    flint_free(t);
+
+    fmpz_clear(q);
+    fmpz_clear(A);
+    fmpz_clear(A_max);
+    batch_clear(batch, ctx);
+}
+
+/**
+ * Exécute l'algorithme de Schoof sur les num courbes y^2 = x^3 + a[k]*x + b[k] d'un même corps et écrit leurs
+ * nombres de points dans res[0], ..., res[num-1]. Les courbes sont traitées par lots de BATCH_MAX_LANES au plus
+ * si q est un nombre premier pris en charge par simd.h, une par une par ell_schoof() sinon.
+ *
+ * Renvoie EXIT_FAILURE et laisse res inchangé si la caractéristique vaut 2 ou 3 ou si l'une des courbes n'est
+ * pas elliptique, EXIT_SUCCESS sinon.
+ */
+int batch_schoof(fmpz* res, const fq_struct* a, const fq_struct* b, const slong num, const fq_ctx_t ctx) {
+    const fmpz* p = fq_ctx_prime(ctx);
+    if (fmpz_equal_ui(p, 2) || fmpz_equal_ui(p, 3)) return EXIT_FAILURE;
+
+    ell_curve_struct* curves = (ell_curve_struct*)flint_malloc(num * sizeof(ell_curve_struct));
+    int success = EXIT_SUCCESS;
+
+    for (slong k = 0; k < num; k++) {
+        ell_curve_init(curves + k, ctx);
+        if (ell_curve_set(curves + k, a + k, b + k, ctx) == EXIT_FAILURE) success = EXIT_FAILURE;
+    }
+
+    if (success == EXIT_SUCCESS) {
+        simd_ctx_t simd;
+        simd_ctx_init(simd, ctx);
+
+        if (simd->level == SIMD_NONE) {
+            schoof_opt_t opt;
+            schoof_opt_init(opt);
+            for (slong k = 0; k < num; k++) ell_schoof(res + k, curves + k, opt, ctx);
+        } else {
+            for (slong k = 0; k < num; k += BATCH_MAX_LANES) {
+                batch_schoof_curves(res + k, curves + k, FLINT_MIN(num - k, BATCH_MAX_LANES), ctx);
+            }
+        }
+    }
+
+    for (slong k = 0; k < num; k++) ell_curve_clear(curves + k, ctx);
+    flint_free(curves);
+
+    return success;
+}
\ No newline at end of file
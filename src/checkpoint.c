@@ -0,0 +1,302 @@
+#define _POSIX_C_SOURCE 200809L // fsync(), fileno(), truncate() et open()
+
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include "checkpoint.h"
+#include "schoof.h"
+
+/*************************/
+/* FONCTIONS AUXILIAIRES */
+/*************************/
+
+/**
+ * Renvoie une copie allouée de path suivie de suffix, à libérer avec free().
+ */
+char* checkpoint_path_cat(const char* path, const char* suffix) {
+    char* res = (char*)malloc(strlen(path) + strlen(suffix) + 1);
+    strcpy(res, path);
+    strcat(res, suffix);
+    return res;
+}
+
+/**
+ * Écrit l'élément op du corps premier F_p comme un entier de [0, p-1].
+ */
+void checkpoint_fprint_fq(FILE* file, const fq_t op, const fq_ctx_t ctx) {
+    fmpz_t temp;
+    fmpz_init(temp);
+    fq_get_fmpz(temp, op, ctx);
+    fmpz_fprint(file, temp);
+    fmpz_clear(temp);
+}
+
+/**
+ * Lit un mot et vérifie qu'il vaut word. Renvoie 1 si c'est le cas, 0 sinon.
+ */
+int checkpoint_expect(FILE* file, const char* word) {
+    char buf[32];
+    return fscanf(file, "%31s", buf) == 1 && strcmp(buf, word) == 0;
+}
+
+/**
+ * Vide les tampons de file jusqu'au disque puis le ferme. Renvoie 0 si tout s'est bien passé, -1 sinon.
+ */
+int checkpoint_close_sync(FILE* file) {
+    int err = (fflush(file) != 0);
+    err |= (fsync(fileno(file)) != 0);
+    err |= (fclose(file) != 0);
+    return err ? -1 : 0;
+}
+
+/**
+ * Vide jusqu'au disque le répertoire qui contient path, pour qu'un renommage vers path survive à une coupure.
+ * Renvoie 0 si tout s'est bien passé, -1 sinon.
+ */
+int checkpoint_sync_dir(const char* path) {
+    const char* slash = strrchr(path, '/');
+    char* dir = checkpoint_path_cat((slash == NULL) ? "." : path, "");
+    if (slash != NULL) dir[(slash == path) ? 1 : slash - path] = '\0';
+
+    int fd = open(dir, O_RDONLY);
+    free(dir);
+    if (fd < 0) return -1;
+
+    int err = (fsync(fd) != 0);
+    err |= (close(fd) != 0);
+    return err ? -1 : 0;
+}
+
+/**************************/
+/* COUPLES (l, a_q MOD l) */
+/**************************/
+
+/**
+ * Écrit le fichier de reprise path pour la courbe E avec les couples (l, t) de list_primes et list_ts.
+ * Renvoie 0 en cas de succès, -1 sinon (l'éventuel fichier précédent est alors conservé, sauf si seul le vidage
+ * du répertoire a échoué).
+ */
+int checkpoint_save(const char* path, const ell_curve_t E, const list_ulong_t list_primes, const list_ulong_t list_ts, const fq_ctx_t ctx) {
+    char* tmp_path = checkpoint_path_cat(path, ".tmp");
+    FILE* file = fopen(tmp_path, "w");
+
+    if (file == NULL) {
+        free(tmp_path);
+        return -1;
+    }
+
+    fprintf(file, "schoof-checkpoint 1\np ");
+    fmpz_fprint(file, fq_ctx_prime(ctx));
+    fprintf(file, "\na ");
+    checkpoint_fprint_fq(file, E->a, ctx);
+    fprintf(file, "\nb ");
+    checkpoint_fprint_fq(file, E->b, ctx);
+    fprintf(file, "\n%lu\n", list_ulong_len(list_primes));
+
+    cell_ulong_t* ptr_l = list_primes->head;
+    cell_ulong_t* ptr_t = list_ts->head;
+    for (; ptr_l != NULL && ptr_t != NULL; ptr_l = ptr_l->next, ptr_t = ptr_t->next) {
+        fprintf(file, "%lu %lu\n", ptr_l->t, ptr_t->t);
+    }
+    fprintf(file, "end\n");
+
+    int err = ferror(file) ? -1 : 0;
+    if (checkpoint_close_sync(file) != 0) err = -1;
+
+    // Le renommage est atomique : le fichier path est soit l'ancien soit le nouveau, et il n'est durable qu'une
+    // fois le répertoire vidé sur le disque
+    if (err == 0 && rename(tmp_path, path) != 0) err = -1;
+    if (err == 0 && checkpoint_sync_dir(path) != 0) err = -1;
+    if (err != 0) remove(tmp_path);
+
+    free(tmp_path);
+    return err;
+}
+
+/**
+ * Lit dans path la caractéristique p et les coefficients a, b de la courbe. Renvoie 0 en cas de succès, -1
+ * si le fichier est absent ou mal formé.
+ */
+int checkpoint_read_curve(fmpz_t p, fmpz_t a, fmpz_t b, const char* path) {
+    FILE* file = fopen(path, "r");
+    if (file == NULL) return -1;
+
+    int ok = checkpoint_expect(file, "schoof-checkpoint") && checkpoint_expect(file, "1")
+          && checkpoint_expect(file, "p") && fmpz_fread(file, p) > 0
+          && checkpoint_expect(file, "a") && fmpz_fread(file, a) > 0
+          && checkpoint_expect(file, "b") && fmpz_fread(file, b) > 0;
+
+    fclose(file);
+    return ok ? 0 : -1;
+}
+
+/**
+ * Renvoie le nombre maximal de couples d'un fichier de reprise sur F_q : un par premier impair différent de la
+ * caractéristique et au plus égal à schoof_max_prime() (une puissance l^k remplace le couple de l).
+ */
+ulong checkpoint_max_pairs(const fq_ctx_t ctx) {
+    ulong l_max = schoof_max_prime(ctx), n = 0;
+    for (ulong l = 3; l <= l_max; l = n_nextprime(l, 1)) {
+        if (!fmpz_equal_ui(fq_ctx_prime(ctx), l)) n++;
+    }
+    return n;
+}
+
+/**
+ * Ajoute à list_primes et list_ts les couples (l, t) du fichier de reprise path, à condition qu'il soit
+ * complet et qu'il corresponde à la courbe E sur F_q. Renvoie le nombre de couples lus, ou -1 si le fichier
+ * est absent, mal formé, annonce plus de checkpoint_max_pairs() couples ou concerne une autre courbe (les listes
+ * sont alors laissées inchangées).
+ */
+int checkpoint_load(list_ulong_t list_primes, list_ulong_t list_ts, const char* path, const ell_curve_t E, const fq_ctx_t ctx) {
+    fmpz_t p, a, b, temp;
+    fmpz_init(p);
+    fmpz_init(a);
+    fmpz_init(b);
+    fmpz_init(temp);
+
+    int res = -1;
+    ulong n = 0;
+    ulong* tab = NULL;
+    FILE* file = NULL;
+
+    if (checkpoint_read_curve(p, a, b, path) != 0 || !fmpz_equal(p, fq_ctx_prime(ctx))) goto fin;
+
+    fq_get_fmpz(temp, E->a, ctx);
+    if (!fmpz_equal(a, temp)) goto fin;
+    fq_get_fmpz(temp, E->b, ctx);
+    if (!fmpz_equal(b, temp)) goto fin;
+
+    // On relit le fichier jusqu'aux couples, en-tête déjà vérifié
+    file = fopen(path, "r");
+    if (file == NULL) goto fin;
+    for (int i = 0; i < 8; i++) {
+        if (fscanf(file, "%*s") != 0) goto fin;
+    }
+    if (fscanf(file, "%lu", &n) != 1 || n > checkpoint_max_pairs(ctx)) goto fin;
+
+    // Les couples ne sont ajoutés qu'une fois le marqueur de fin lu
+    tab = (ulong*)malloc(2 * (n + 1) * sizeof(ulong));
+    if (tab == NULL) goto fin;
+    for (ulong i = 0; i < n; i++) {
+        if (fscanf(file, "%lu %lu", tab + 2*i, tab + 2*i + 1) != 2 || tab[2*i + 1] >= tab[2*i]) goto fin;
+    }
+    if (!checkpoint_expect(file, "end")) goto fin;
+
+    for (ulong i = 0; i < n; i++) {
+        list_ulong_add(list_primes, tab[2*i]);
+        list_ulong_add(list_ts, tab[2*i + 1]);
+    }
+    res = (int)n;
+
+fin:
+    if (file != NULL) fclose(file);
+    free(tab);
+    fmpz_clear(p);
+    fmpz_clear(a);
+    fmpz_clear(b);
+    fmpz_clear(temp);
+    return res;
+}
+
+/*************************/
+/* POLYNOMES DE DIVISION */
+/*************************/
+
+/**
+ * Complète list_psi avec les polynômes de division conservés dans path (suivi de CHECKPOINT_PSI_SUFFIX).
+ * Les enregistrements doivent se suivre à partir de l'indice list_fq_poly_len(list_psi). Le premier
+ * enregistrement incomplet ou incohérent, et tout ce qui le suit, est supprimé du fichier.
+ * Renvoie la nouvelle longueur de list_psi.
+ */
+int checkpoint_psi_load(list_fq_poly_t list_psi, const char* path, const fq_ctx_t ctx) {
+    char* psi_path = checkpoint_path_cat(path, CHECKPOINT_PSI_SUFFIX);
+    FILE* file = fopen(psi_path, "r");
+
+    if (file == NULL) {
+        free(psi_path);
+        return (int)list_fq_poly_len(list_psi);
+    }
+
+    fq_poly_t poly;
+    fq_poly_init(poly, ctx);
+
+    fq_t coeff;
+    fq_init(coeff, ctx);
+
+    fmpz_t temp;
+    fmpz_init(temp);
+
+    long valid = 0; // Position de la fin du dernier enregistrement valide
+    ulong m, m_end;
+    slong len;
+    int ok = 1;
+
+    while (ok) {
+        if (fscanf(file, " psi %lu %ld", &m, &len) != 2) break;
+        ok = (m == list_fq_poly_len(list_psi) && len >= 0);
+
+        fq_poly_zero(poly, ctx);
+        for (slong i = 0; ok && i < len; i++) {
+            ok = (fmpz_fread(file, temp) > 0 && fmpz_sgn(temp) >= 0 && fmpz_cmp(temp, fq_ctx_prime(ctx)) < 0);
+            if (ok) {
+                fq_set_fmpz(coeff, temp, ctx);
+                fq_poly_set_coeff(poly, i, coeff, ctx);
+            }
+        }
+
+        ok = ok && checkpoint_expect(file, "end") && fscanf(file, "%lu", &m_end) == 1 && m_end == m;
+        if (ok) {
+            list_fq_poly_add(list_psi, poly, ctx);
+            valid = ftell(file);
+        }
+    }
+
+    // On coupe ce qui suit le dernier enregistrement valide (écriture interrompue)
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fclose(file);
+    if (size > valid && truncate(psi_path, valid) != 0) remove(psi_path);
+
+    fq_poly_clear(poly, ctx);
+    fq_clear(coeff, ctx);
+    fmpz_clear(temp);
+    free(psi_path);
+    return (int)list_fq_poly_len(list_psi);
+}
+
+/**
+ * Ajoute à la fin de path (suivi de CHECKPOINT_PSI_SUFFIX) les polynômes de division ψ_m de list_psi pour
+ * m >= from. Si from vaut 0, le fichier est recréé. Renvoie 0 en cas de succès, -1 sinon.
+ */
+int checkpoint_psi_append(const char* path, const list_fq_poly_t list_psi, const ulong from, const fq_ctx_t ctx) {
+    ulong len = list_fq_poly_len(list_psi);
+    if (from != 0 && from >= len) return 0;
+
+    char* psi_path = checkpoint_path_cat(path, CHECKPOINT_PSI_SUFFIX);
+    FILE* file = fopen(psi_path, (from == 0) ? "w" : "a");
+    free(psi_path);
+    if (file == NULL) return -1;
+
+    fq_t coeff;
+    fq_init(coeff, ctx);
+
+    for (ulong m = from; m < len; m++) {
+        fq_poly_struct* poly = list_fq_poly_get(list_psi, m);
+        slong poly_len = fq_poly_length(poly, ctx);
+
+        fprintf(file, "psi %lu %ld\n", m, poly_len);
+        for (slong i = 0; i < poly_len; i++) {
+            fq_poly_get_coeff(coeff, poly, i, ctx);
+            checkpoint_fprint_fq(file, coeff, ctx);
+            fputc((i + 1 == poly_len) ? '\n' : ' ', file);
+        }
+        fprintf(file, "end %lu\n", m);
+    }
+
+    int err = ferror(file) ? -1 : 0;
+    if (checkpoint_close_sync(file) != 0) err = -1;
+
+    fq_clear(coeff, ctx);
+    return err;
+}
\ No newline at end of file
@@ -0,0 +1,310 @@
+#define _POSIX_C_SOURCE 200809L // ftruncate() et fcntl()
+
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "curve_cache.h"
+
+/**************/
+/* PRIMITIVES */
+/**************/
+
+/**
+ * Taille du fichier d'un cache de capacity entrées, ou 0 si capacity est nulle ou si la taille ne tient pas
+ * dans un off_t.
+ */
+size_t curve_cache_size(const ulong capacity) {
+    if (capacity == 0 || capacity > (WORD_MAX - sizeof(curve_cache_header_struct)) / sizeof(curve_cache_entry_struct)) return 0;
+    return sizeof(curve_cache_header_struct) + capacity * sizeof(curve_cache_entry_struct);
+}
+
+/**
+ * Ouvre le cache du fichier path, en le créant avec capacity entrées s'il n'existe pas (la capacité d'un
+ * fichier existant est conservée). Renvoie 0 en cas de succès, -1 sinon (en particulier si la capacité est
+ * nulle ou trop grande, c.f curve_cache_size()).
+ */
+int curve_cache_open(curve_cache_t cache, const char* path, const ulong capacity) {
+    cache->fd = open(path, O_RDWR | O_CREAT, 0644);
+    cache->header = NULL;
+    cache->entries = NULL;
+    cache->size = 0;
+
+    if (cache->fd < 0) return -1;
+
+    // Verrou pour que deux processus ne créent pas le fichier en même temps
+    if (curve_cache_lock(cache, F_WRLCK) != 0) {
+        close(cache->fd);
+        return -1;
+    }
+
+    struct stat st;
+    int err = (fstat(cache->fd, &st) != 0);
+
+    curve_cache_header_struct header;
+    if (!err && st.st_size == 0) {
+        memcpy(header.magic, CURVE_CACHE_MAGIC, 8);
+        header.version = CURVE_CACHE_VERSION;
+        header.capacity = capacity;
+        header.count = 0;
+
+        cache->size = curve_cache_size(header.capacity);
+        err = (cache->size == 0 || ftruncate(cache->fd, cache->size) != 0 || pwrite(cache->fd, &header, sizeof(header), 0) != sizeof(header));
+    } else if (!err) {
+        err = (pread(cache->fd, &header, sizeof(header), 0) != sizeof(header) || memcmp(header.magic, CURVE_CACHE_MAGIC, 8) != 0
+               || header.version != CURVE_CACHE_VERSION);
+
+        cache->size = err ? 0 : curve_cache_size(header.capacity);
+        err = err || cache->size == 0 || ((size_t)st.st_size != cache->size);
+    }
+
+    if (!err) {
+        void* map = mmap(NULL, cache->size, PROT_READ | PROT_WRITE, MAP_SHARED, cache->fd, 0);
+
+        if (map == MAP_FAILED) {
+            err = 1;
+        } else {
+            cache->header = (curve_cache_header_struct*)map;
+            cache->entries = (curve_cache_entry_struct*)((char*)map + sizeof(curve_cache_header_struct));
+        }
+    }
+
+    curve_cache_lock(cache, F_UNLCK);
+
+    if (err) {
+        close(cache->fd);
+        cache->fd = -1;
+        return -1;
+    }
+
+    return 0;
+}
+
+void curve_cache_close(curve_cache_t cache) {
+    if (cache->header != NULL) munmap(cache->header, cache->size);
+    if (cache->fd >= 0) close(cache->fd);
+
+    cache->header = NULL;
+    cache->entries = NULL;
+    cache->fd = -1;
+}
+
+/**
+ * Pose (type = F_WRLCK) ou lève (type = F_UNLCK) le verrou du fichier de cache, en attendant s'il est pris
+ * par un autre processus. Renvoie 0 en cas de succès, -1 sinon.
+ */
+int curve_cache_lock(const curve_cache_t cache, const int type) {
+    struct flock fl;
+    memset(&fl, 0, sizeof(fl));
+    fl.l_type = type;
+    fl.l_whence = SEEK_SET;
+
+    return (fcntl(cache->fd, F_SETLKW, &fl) == 0) ? 0 : -1;
+}
+
+/**************************/
+/* CLASSES D'ISOMORPHISME */
+/**************************/
+
+/**
+ * Calcule le j-invariant j et la classe de twist w (c.f curve_cache.h) de y^2 = x^3 + a*x + b, sous forme
+ * d'entiers de [0, p-1]. Renvoie 1 si la courbe peut être mise en cache (corps premier assez petit, courbe
+ * lisse), 0 sinon.
+ */
+int curve_cache_invariants(fmpz_t j, fmpz_t w, const fq_t a, const fq_t b, const fq_ctx_t ctx) {
+    const fmpz* p = fq_ctx_prime(ctx);
+    if (fq_ctx_degree(ctx) != 1 || fmpz_bits(p) > 64*CURVE_CACHE_LIMBS - 2) return 0;
+
+    fq_t a3, b2, den, temp;
+    fq_init(a3, ctx);
+    fq_init(b2, ctx);
+    fq_init(den, ctx);
+    fq_init(temp, ctx);
+
+    fmpz_t e, g;
+    fmpz_init(e);
+    fmpz_init(g);
+
+    // j = 1728*4*a^3/(4*a^3 + 27*b^2)
+    fq_pow_ui(a3, a, 3, ctx);
+    fq_mul_ui(a3, a3, 4, ctx);
+    fq_sqr(b2, b, ctx);
+    fq_mul_ui(b2, b2, 27, ctx);
+    fq_add(den, a3, b2, ctx);
+
+    int res = !fq_is_zero(den, ctx);
+
+    if (res) {
+        fq_inv(den, den, ctx);
+        fq_mul(temp, a3, den, ctx);
+        fq_mul_ui(temp, temp, 1728, ctx);
+        fq_get_fmpz(j, temp, ctx);
+
+        // w = x^{(p-1)/g} où x = b/a et g = 2, x = b et g = pgcd(6, p-1) ou x = a et g = pgcd(4, p-1)
+        fmpz_sub_ui(e, p, 1);
+
+        if (fq_is_zero(a, ctx)) {
+            fmpz_set_ui(g, 6);
+            fq_set(temp, b, ctx);
+        } else if (fq_is_zero(b, ctx)) {
+            fmpz_set_ui(g, 4);
+            fq_set(temp, a, ctx);
+        } else {
+            fmpz_set_ui(g, 2);
+            fq_inv(temp, a, ctx);
+            fq_mul(temp, temp, b, ctx);
+        }
+
+        fmpz_gcd(g, g, e);
+        fmpz_divexact(e, e, g);
+        fq_pow(temp, temp, e, ctx);
+        fq_get_fmpz(w, temp, ctx);
+    }
+
+    fq_clear(a3, ctx);
+    fq_clear(b2, ctx);
+    fq_clear(den, ctx);
+    fq_clear(temp, ctx);
+    fmpz_clear(e);
+    fmpz_clear(g);
+    return res;
+}
+
+ulong curve_cache_hash(const ulong* p, const ulong* j, const ulong* w) {
+    ulong h = UWORD(0xcbf29ce484222325);
+    const ulong* keys[3] = {p, j, w};
+
+    for (int k = 0; k < 3; k++) {
+        for (int i = 0; i < CURVE_CACHE_LIMBS; i++) {
+            h ^= keys[k][i];
+            h *= UWORD(0x9e3779b97f4a7c15);
+            h ^= h >> 29;
+        }
+    }
+
+    return h;
+}
+
+/**
+ * Cherche la clé (p, j, w) de hachage hash par sondage linéaire. Renvoie son entrée avec *found = 1 si elle
+ * est présente, sinon la première entrée vide rencontrée avec *found = 0, ou NULL si la table est pleine.
+ */
+curve_cache_entry_struct* curve_cache_find(const curve_cache_t cache, const ulong* p, const ulong* j, const ulong* w, const ulong hash, int* found) {
+    ulong capacity = cache->header->capacity;
+    size_t key_size = CURVE_CACHE_LIMBS * sizeof(ulong);
+    *found = 0;
+
+    for (ulong i = 0; i < capacity; i++) {
+        curve_cache_entry_struct* entry = cache->entries + (hash + i) % capacity;
+
+        if (__atomic_load_n(&entry->state, __ATOMIC_ACQUIRE) != CURVE_CACHE_FULL) return entry;
+
+        if (entry->hash == hash && memcmp(entry->p, p, key_size) == 0 && memcmp(entry->j, j, key_size) == 0
+            && memcmp(entry->w, w, key_size) == 0) {
+            *found = 1;
+            return entry;
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * Cherche dans le cache le nombre de points de y^2 = x^3 + a*x + b. Renvoie 1 et l'affecte à res si la classe
+ * de la courbe y est, renvoie 0 sans modifier res sinon.
+ */
+int curve_cache_lookup(fmpz_t res, const curve_cache_t cache, const fq_t a, const fq_t b, const fq_ctx_t ctx) {
+    fmpz_t j, w;
+    fmpz_init(j);
+    fmpz_init(w);
+
+    int hit = 0;
+
+    if (cache->header != NULL && curve_cache_invariants(j, w, a, b, ctx)) {
+        ulong key_p[CURVE_CACHE_LIMBS], key_j[CURVE_CACHE_LIMBS], key_w[CURVE_CACHE_LIMBS];
+        fmpz_get_ui_array(key_p, CURVE_CACHE_LIMBS, fq_ctx_prime(ctx));
+        fmpz_get_ui_array(key_j, CURVE_CACHE_LIMBS, j);
+        fmpz_get_ui_array(key_w, CURVE_CACHE_LIMBS, w);
+
+        curve_cache_entry_struct* entry = curve_cache_find(cache, key_p, key_j, key_w, curve_cache_hash(key_p, key_j, key_w), &hit);
+        if (hit) fmpz_set_ui_array(res, entry->n, CURVE_CACHE_LIMBS);
+    }
+
+    fmpz_clear(j);
+    fmpz_clear(w);
+    return hit;
+}
+
+/**
+ * Enregistre que y^2 = x^3 + a*x + b a n points, ainsi que son twist quadratique (2*p + 2 - n points).
+ * Renvoie le nombre d'entrées ajoutées, ou -1 si la courbe ne peut pas être mise en cache ou si la table est
+ * pleine (on garde toujours un quart de la table vide pour que les recherches restent rapides).
+ */
+int curve_cache_insert(curve_cache_t cache, const fq_t a, const fq_t b, const fmpz_t n, const fq_ctx_t ctx) {
+    fmpz_t j, w, n_twist;
+    fmpz_init(j);
+    fmpz_init(w);
+    fmpz_init(n_twist);
+
+    int res = -1;
+
+    if (cache->header != NULL && curve_cache_invariants(j, w, a, b, ctx) && curve_cache_lock(cache, F_WRLCK) == 0) {
+        const fmpz* p = fq_ctx_prime(ctx);
+        res = 0;
+
+        // Twist : classe -w et 2*p + 2 - n points
+        fmpz_mul_2exp(n_twist, p, 1);
+        fmpz_add_ui(n_twist, n_twist, 2);
+        fmpz_sub(n_twist, n_twist, n);
+
+        for (int twist = 0; twist < 2 && res >= 0; twist++) {
+            if (twist == 1 && !fmpz_is_zero(w)) fmpz_sub(w, p, w);
+
+            ulong key_p[CURVE_CACHE_LIMBS], key_j[CURVE_CACHE_LIMBS], key_w[CURVE_CACHE_LIMBS];
+            fmpz_get_ui_array(key_p, CURVE_CACHE_LIMBS, p);
+            fmpz_get_ui_array(key_j, CURVE_CACHE_LIMBS, j);
+            fmpz_get_ui_array(key_w, CURVE_CACHE_LIMBS, w);
+            ulong hash = curve_cache_hash(key_p, key_j, key_w);
+
+            int found;
+            curve_cache_entry_struct* entry = curve_cache_find(cache, key_p, key_j, key_w, hash, &found);
+            if (found) continue;
+
+            if (entry == NULL || 4 * (cache->header->count + 1) > 3 * cache->header->capacity) {
+                res = -1;
+                break;
+            }
+
+            entry->hash = hash;
+            memcpy(entry->p, key_p, sizeof(key_p));
+            memcpy(entry->j, key_j, sizeof(key_j));
+            memcpy(entry->w, key_w, sizeof(key_w));
+            fmpz_get_ui_array(entry->n, CURVE_CACHE_LIMBS, (twist == 0) ? n : n_twist);
+            __atomic_store_n(&entry->state, CURVE_CACHE_FULL, __ATOMIC_RELEASE);
+
+            cache->header->count++;
+            res++;
+        }
+
+        curve_cache_lock(cache, F_UNLCK);
+    }
+
+    fmpz_clear(j);
+    fmpz_clear(w);
+    fmpz_clear(n_twist);
+    return res;
+}
+
+/**
+ * Identique à schoof_with_opt(), mais cherche d'abord la classe de la courbe dans cache et y enregistre le
+ * résultat (et celui du twist) s'il a fallu le calculer.
+ */
+int schoof_cached(fmpz_t res, curve_cache_t cache, const fq_t a, const fq_t b, const schoof_opt_t opt, const fq_ctx_t ctx) {
+    if (curve_cache_lookup(res, cache, a, b, ctx)) return EXIT_SUCCESS;
+
+    int success = schoof_with_opt(res, a, b, opt, ctx);
+    if (success == EXIT_SUCCESS) curve_cache_insert(cache, a, b, res, ctx);
+
+    return success;
+}
\ No newline at end of file
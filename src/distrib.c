@@ -0,0 +1,403 @@
+#define _POSIX_C_SOURCE 200809L // socketpair(), kill() et MSG_NOSIGNAL
+
+#include <errno.h>
+#include <poll.h>
+#include <signal.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include "distrib.h"
+#include "div_poly.h"
+
+/******************************/
+/* NOMBRES PREMIERS A TRAITER */
+/******************************/
+
+/**
+ * Initialise jobs avec les nombres premiers l utilisés par ell_schoof() : les premiers impairs différents de
+ * la caractéristique, jusqu'à ce que leur produit dépasse 4*sqrt(q).
+ */
+void distrib_jobs_init(distrib_jobs_t jobs, const fq_ctx_t ctx) {
+    fmpz_t q, A, A_max;
+    fmpz_init(q);
+    fmpz_init_set_ui(A, 1);
+    fmpz_init(A_max);
+    fq_ctx_order(q, ctx);
+    fmpz_sqrt(A_max, q);
+    fmpz_mul_ui(A_max, A_max, 4);
+
+    slong cap = 16;
+    jobs->primes = (ulong*)malloc(cap * sizeof(ulong));
+    jobs->len = 0;
+
+    for (ulong l = 3; fmpz_cmp(A, A_max) <= 0; l = n_nextprime(l, 1)) {
+        if (fmpz_equal_ui(fq_ctx_prime(ctx), l)) continue;
+
+        if (jobs->len == cap) {
+            cap *= 2;
+            jobs->primes = (ulong*)realloc(jobs->primes, cap * sizeof(ulong));
+        }
+
+        jobs->primes[jobs->len++] = l;
+        fmpz_mul_ui(A, A, l);
+    }
+
+    jobs->ts = (ulong*)calloc(jobs->len, sizeof(ulong));
+    jobs->state = (int*)calloc(jobs->len, sizeof(int));
+    jobs->attempts = (int*)calloc(jobs->len, sizeof(int));
+    jobs->num_done = 0;
+
+    fmpz_clear(q);
+    fmpz_clear(A);
+    fmpz_clear(A_max);
+}
+
+void distrib_jobs_clear(distrib_jobs_t jobs) {
+    free(jobs->primes);
+    free(jobs->ts);
+    free(jobs->state);
+    free(jobs->attempts);
+}
+
+/**
+ * Renvoie l'indice de l dans jobs, -1 s'il n'y est pas.
+ */
+slong distrib_jobs_find(const distrib_jobs_t jobs, const ulong l) {
+    for (slong i = 0; i < jobs->len; i++) {
+        if (jobs->primes[i] == l) return i;
+    }
+
+    return -1;
+}
+
+/**
+ * Ajoute à list_primes et list_ts les couples (l, t) déjà calculés.
+ */
+void distrib_jobs_get_lists(list_ulong_t list_primes, list_ulong_t list_ts, const distrib_jobs_t jobs) {
+    for (slong i = 0; i < jobs->len; i++) {
+        if (jobs->state[i] == 2) {
+            list_ulong_add(list_primes, jobs->primes[i]);
+            list_ulong_add(list_ts, jobs->ts[i]);
+        }
+    }
+}
+
+/***********************/
+/* PROCESSUS DE CALCUL */
+/***********************/
+
+/**
+ * Boucle d'un processus de calcul : lit des commandes "l <l>" sur fd et y répond "t <l> <t>", jusqu'à "quit"
+ * ou la fin du fichier. Les polynômes de division sont conservés d'une commande à l'autre.
+ */
+void distrib_worker(int fd, const ell_curve_t E, const schoof_opt_t opt, const fq_ctx_t ctx) {
+    FILE* in = fdopen(fd, "r");
+    FILE* out = fdopen(dup(fd), "w");
+
+    list_fq_poly_t list_psi;
+    list_fq_poly_init(list_psi);
+
+    ulong l_max = opt->low_memory ? schoof_max_prime(ctx) : 0;
+
+    arena_t arena;
+    arena_init(arena);
+
+    char cmd[16];
+    ulong l, t;
+
+    while (fscanf(in, "%15s", cmd) == 1 && strcmp(cmd, "l") == 0 && fscanf(in, "%lu", &l) == 1) {
+        // En mode économe en mémoire, un l repris d'un processus mort peut avoir un ψ_l déjà libéré
+        if (opt->low_memory) {
+            if (list_fq_poly_is_evicted(list_psi, l)) list_fq_poly_clear(list_psi, ctx);
+            update_list_div_poly_low_memory(list_psi, E, l, l, l_max, ctx);
+        } else {
+            update_list_div_poly_threads(list_psi, E, l, opt->psi_threads, ctx);
+        }
+
+        if (opt->arena) arena_begin(arena);
+        t = schoof_mod_l(l, PSI(l), NULL, NULL, 0, E, opt, ctx);
+        if (opt->arena) schoof_arena_end(arena, l, opt);
+        if (opt->low_memory) evict_list_div_poly(list_psi, l + 1, l_max, ctx);
+
+        fprintf(out, "t %lu %lu\n", l, t);
+        if (fflush(out) != 0) break; // Coordinateur disparu
+    }
+
+    list_fq_poly_clear(list_psi, ctx);
+    arena_clear(arena);
+    fclose(in);
+    fclose(out);
+}
+
+/**
+ * Crée par fork() le processus de calcul numéro i de workers (qui en compte num_workers), relié au
+ * coordinateur par une socketpair(). Renvoie 0 en cas de succès, -1 sinon (workers[i].pid vaut alors -1).
+ */
+int distrib_spawn(distrib_worker_struct* workers, const slong i, const slong num_workers, const ell_curve_t E, const schoof_opt_t opt, const fq_ctx_t ctx) {
+    distrib_worker_struct* w = workers + i;
+    w->pid = -1;
+    w->fd = -1;
+    w->job = -1;
+    w->buf_len = 0;
+
+    int sv[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, sv) != 0) return -1;
+
+    pid_t pid = fork();
+
+    if (pid < 0) {
+        close(sv[0]);
+        close(sv[1]);
+        return -1;
+    }
+
+    if (pid == 0) {
+        // On ferme les sockets des autres processus, pour qu'ils voient la fin du fichier si le coordinateur meurt
+        close(sv[0]);
+        for (slong j = 0; j < num_workers; j++) {
+            if (j != i && workers[j].fd >= 0) close(workers[j].fd);
+        }
+
+        distrib_worker(sv[1], E, opt, ctx);
+        _exit(EXIT_SUCCESS);
+    }
+
+    close(sv[1]);
+    w->pid = pid;
+    w->fd = sv[0];
+    return 0;
+}
+
+/**
+ * Ferme la socket du processus w et attend sa fin. Si force est non nul, le processus est d'abord tué.
+ */
+void distrib_kill(distrib_worker_struct* w, const int force) {
+    if (w->fd >= 0) close(w->fd);
+    if (w->pid > 0) {
+        if (force) kill(w->pid, SIGKILL);
+        waitpid(w->pid, NULL, 0);
+    }
+
+    w->pid = -1;
+    w->fd = -1;
+    w->job = -1;
+    w->buf_len = 0;
+}
+
+/**
+ * Envoie la commande cmd au processus w ("l" est suivi de l). Renvoie 0 en cas de succès, -1 si le processus
+ * n'est plus joignable.
+ */
+int distrib_send(distrib_worker_struct* w, const char* cmd, const ulong l) {
+    char line[DISTRIB_BUFFER];
+    int len = (strcmp(cmd, "l") == 0) ? snprintf(line, DISTRIB_BUFFER, "l %lu\n", l) : snprintf(line, DISTRIB_BUFFER, "%s\n", cmd);
+
+    // MSG_NOSIGNAL : un processus mort ne doit pas tuer le coordinateur par SIGPIPE
+    for (int sent = 0; sent < len; ) {
+        ssize_t n = send(w->fd, line + sent, len - sent, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return -1;
+        sent += n;
+    }
+
+    return 0;
+}
+
+/**
+ * Lit ce que le processus w a envoyé et enregistre dans jobs les résultats complets. Renvoie le nombre de
+ * résultats reçus, ou -1 si le processus est mort ou ne respecte pas le protocole.
+ */
+int distrib_receive(distrib_worker_struct* w, distrib_jobs_t jobs) {
+    ssize_t n = read(w->fd, w->buf + w->buf_len, DISTRIB_BUFFER - 1 - w->buf_len);
+    if (n < 0 && errno == EINTR) return 0;
+    if (n <= 0) return -1;
+
+    w->buf_len += n;
+    w->buf[w->buf_len] = '\0';
+
+    int res = 0;
+    char* end;
+
+    while ((end = strchr(w->buf, '\n')) != NULL) {
+        *end = '\0';
+
+        ulong l, t;
+        if (sscanf(w->buf, "t %lu %lu", &l, &t) != 2) return -1;
+
+        slong i = distrib_jobs_find(jobs, l);
+        if (i < 0 || i != w->job || t >= l) return -1;
+
+        if (jobs->state[i] != 2) {
+            jobs->ts[i] = t;
+            jobs->state[i] = 2;
+            jobs->num_done++;
+            res++;
+        }
+        w->job = -1;
+
+        // On décale la suite du tampon
+        w->buf_len -= end + 1 - w->buf;
+        memmove(w->buf, end + 1, w->buf_len + 1);
+    }
+
+    // Une ligne plus longue que le tampon ne peut pas venir du protocole
+    if (w->buf_len == DISTRIB_BUFFER - 1) return -1;
+
+    return res;
+}
+
+/****************/
+/* COORDINATEUR */
+/****************/
+
+/**
+ * Renvoie 1 si le calcul réparti prend en charge les options opt, 0 sinon. Les processus de calcul ne rendent
+ * que a_q modulo des nombres premiers l : le suivi et l'interruption (progress, deadline, cancel, partial) et les
+ * options qui changent les modules ou la fin du calcul (bsgs, match_sort, prime_powers, frob_block) ne sont pas
+ * transmis.
+ */
+int distrib_supported(const schoof_opt_t opt) {
+    return opt->progress == NULL && opt->deadline <= 0 && opt->cancel == NULL && opt->partial == NULL && !opt->bsgs
+        && !opt->match_sort && !opt->prime_powers && opt->frob_block <= 1;
+}
+
+/**
+ * Algorithme de Schoof réparti sur opt->workers processus de calcul locaux (c.f distrib.h). Comme
+ * ell_schoof(), tient compte du fichier de reprise opt->checkpoint, mis à jour à chaque résultat reçu.
+ *
+ * Renvoie EXIT_SUCCESS et affecte à res le nombre de points de E en cas de succès. Renvoie EXIT_FAILURE sans
+ * modifier res si opt contient des options non prises en charge (c.f distrib_supported()), si le fichier de
+ * reprise contient des modules qui ne sont pas des nombres premiers à traiter (puissances l^k de
+ * opt->prime_powers, qui seraient perdues à la réécriture), si aucun processus ne peut être créé ou si un même l
+ * a fait mourir DISTRIB_MAX_ATTEMPTS processus.
+ */
+int ell_schoof_distrib(fmpz_t res, const ell_curve_t E, const schoof_opt_t opt, const fq_ctx_t ctx) {
+    if (!distrib_supported(opt)) return EXIT_FAILURE;
+
+    distrib_jobs_t jobs;
+    distrib_jobs_init(jobs, ctx);
+
+    list_ulong_t list_primes, list_ts;
+    list_ulong_init(list_primes);
+    list_ulong_init(list_ts);
+
+    // Reprise d'un calcul interrompu
+    int foreign = 0;
+    if (opt->checkpoint != NULL && checkpoint_load(list_primes, list_ts, opt->checkpoint, E, ctx) >= 0) {
+        cell_ulong_t* ptr_l = list_primes->head;
+        cell_ulong_t* ptr_t = list_ts->head;
+
+        for (; ptr_l != NULL && ptr_t != NULL; ptr_l = ptr_l->next, ptr_t = ptr_t->next) {
+            slong i = distrib_jobs_find(jobs, ptr_l->t);
+            if (i < 0) {
+                foreign = 1;
+            } else if (jobs->state[i] != 2) {
+                jobs->ts[i] = ptr_t->t;
+                jobs->state[i] = 2;
+                jobs->num_done++;
+            }
+        }
+
+        list_ulong_clear(list_primes);
+        list_ulong_clear(list_ts);
+    }
+
+    if (foreign) {
+        distrib_jobs_clear(jobs);
+        return EXIT_FAILURE;
+    }
+
+    slong num_workers = FLINT_MIN(FLINT_MAX(opt->workers, 1), jobs->len - jobs->num_done);
+    distrib_worker_struct* workers = (distrib_worker_struct*)malloc(FLINT_MAX(num_workers, 1) * sizeof(distrib_worker_struct));
+    struct pollfd* fds = (struct pollfd*)malloc(FLINT_MAX(num_workers, 1) * sizeof(struct pollfd));
+
+    for (slong i = 0; i < num_workers; i++) {
+        workers[i].fd = -1;
+    }
+    for (slong i = 0; i < num_workers; i++) {
+        distrib_spawn(workers, i, num_workers, E, opt, ctx);
+    }
+
+    int success = EXIT_SUCCESS;
+
+    while (success == EXIT_SUCCESS && jobs->num_done < jobs->len) {
+        // On donne les plus petits l restants aux processus libres
+        slong next = 0;
+        for (slong i = 0; i < num_workers; i++) {
+            if (workers[i].pid < 0 || workers[i].job >= 0) continue;
+
+            while (next < jobs->len && jobs->state[next] != 0) next++;
+            if (next == jobs->len) break;
+
+            if (distrib_send(workers + i, "l", jobs->primes[next]) == 0) {
+                jobs->state[next] = 1;
+                jobs->attempts[next]++;
+                workers[i].job = next;
+            } // Sinon, la mort du processus sera détectée par poll()
+        }
+
+        // On attend des résultats
+        slong num_alive = 0;
+        for (slong i = 0; i < num_workers; i++) {
+            fds[i].fd = workers[i].fd; // Ignoré par poll() si négatif
+            fds[i].events = POLLIN;
+            fds[i].revents = 0;
+            if (workers[i].fd >= 0) num_alive++;
+        }
+
+        if (num_alive == 0) {
+            success = EXIT_FAILURE;
+            break;
+        }
+
+        if (poll(fds, num_workers, -1) < 0) {
+            if (errno != EINTR) success = EXIT_FAILURE;
+            continue;
+        }
+
+        for (slong i = 0; i < num_workers; i++) {
+            if (fds[i].fd < 0 || !(fds[i].revents & (POLLIN | POLLHUP | POLLERR))) continue;
+
+            int received = distrib_receive(workers + i, jobs);
+
+            if (received < 0) {
+                // Processus mort : son nombre premier est redonné à un nouveau processus
+                slong job = workers[i].job;
+                distrib_kill(workers + i, 1);
+
+                if (job >= 0 && jobs->state[job] == 1) {
+                    jobs->state[job] = 0;
+                    if (jobs->attempts[job] >= DISTRIB_MAX_ATTEMPTS) success = EXIT_FAILURE;
+                }
+
+                if (success == EXIT_SUCCESS) distrib_spawn(workers, i, num_workers, E, opt, ctx);
+            } else if (received > 0 && opt->checkpoint != NULL) {
+                distrib_jobs_get_lists(list_primes, list_ts, jobs);
+                checkpoint_save(opt->checkpoint, E, list_primes, list_ts, ctx);
+                list_ulong_clear(list_primes);
+                list_ulong_clear(list_ts);
+            }
+        }
+    }
+
+    // Fin des processus de calcul
+    for (slong i = 0; i < num_workers; i++) {
+        if (workers[i].pid < 0) continue;
+        if (success == EXIT_SUCCESS) distrib_send(workers + i, "quit", 0);
+        distrib_kill(workers + i, success != EXIT_SUCCESS);
+    }
+
+    // On utilise le théorème des restes chinois pour retrouver a_q
+    if (success == EXIT_SUCCESS) {
+        distrib_jobs_get_lists(list_primes, list_ts, jobs);
+        schoof_crt(res, list_primes, list_ts, ctx);
+    }
+
+    list_ulong_clear(list_primes);
+    list_ulong_clear(list_ts);
+    distrib_jobs_clear(jobs);
+    free(workers);
+    free(fds);
+    return success;
+}
\ No newline at end of file
@@ -0,0 +1,318 @@
+#include "div_poly.h"
+
+/**
+ * Calcule ψ_m, m >= 5, à partir de near[i] = ψ_{j-2+i} pour 0 <= i <= 4, où j = m/2 (c.f update_list_div_poly()).
+ * W2 = (x^3 + a*x + b)^2 et inv2 = 2^{-1}. psi_m ne doit recouvrir aucun des near[i].
+ */
+void div_poly_step(fq_poly_t psi_m, const ulong m, fq_poly_struct* const* near, const fq_poly_t W2, const fq_t inv2, const fq_ctx_t ctx) {
+    ulong j = m / 2;
+    slong odd = j % 2;
+    fq_poly_struct* const* psi_j = near + 2; // psi_j[i] = ψ_{j+i}
+
+    fq_poly_t temp_poly;
+    fq_poly_init(temp_poly, ctx);
+
+    if (m % 2 == 0) {
+        // ψ_{2j} = ψ_j*(ψ_{j+2}*ψ_{j-1}^2 - ψ_{j-2}*ψ_{j+1}^2)/2
+        fq_poly_pow(psi_m, psi_j[-1], 2, ctx);
+        fq_poly_mul(psi_m, psi_j[2], psi_m, ctx);
+
+        fq_poly_pow(temp_poly, psi_j[1], 2, ctx);
+        fq_poly_mul(temp_poly, psi_j[-2], temp_poly, ctx);
+
+        fq_poly_sub(psi_m, psi_m, temp_poly, ctx);
+        fq_poly_mul(psi_m, psi_j[0], psi_m, ctx);
+
+        fq_poly_scalar_mul_fq(psi_m, psi_m, inv2, ctx);
+    } else {
+        // ψ_{2j+1} = ψ_{j+2}*ψ_j^3 - ψ_{j-1}*ψ_{j+1}^3, avec y^4 = W^2 replié sur le terme où il apparaît
+        fq_poly_pow(psi_m, psi_j[odd], 3, ctx);
+        fq_poly_mul(psi_m, psi_j[2 - 3 * odd], psi_m, ctx);
+        fq_poly_mul(psi_m, psi_m, W2, ctx);
+
+        fq_poly_pow(temp_poly, psi_j[1 - odd], 3, ctx);
+        fq_poly_mul(temp_poly, psi_j[-1 + 3 * odd], temp_poly, ctx);
+
+        if (j % 2 == 0) {
+            fq_poly_sub(psi_m, psi_m, temp_poly, ctx);
+        } else {
+            fq_poly_sub(psi_m, temp_poly, psi_m, ctx);
+        }
+    }
+
+    fq_poly_clear(temp_poly, ctx);
+}
+
+/**
+ * Calcule les ψ_m du niveau en cours qui n'ont pas encore été pris par un autre thread. Appelée avec le mutex
+ * du groupe verrouillé, elle le rend verrouillé.
+ */
+void div_poly_pool_run(div_poly_pool_t pool) {
+    while (pool->next <= pool->last) {
+        ulong m = pool->next++;
+        pthread_mutex_unlock(&pool->mutex);
+
+        div_poly_step(pool->psi[m], m, pool->psi + m / 2 - 2, pool->W2, pool->inv2, pool->ctx);
+
+        pthread_mutex_lock(&pool->mutex);
+    }
+}
+
+void* div_poly_pool_worker(void* arg) {
+    div_poly_pool_struct* pool = (div_poly_pool_struct*)arg;
+    ulong level = 0;
+
+    pthread_mutex_lock(&pool->mutex);
+    for (;;) {
+        while (!pool->stop && pool->level == level) pthread_cond_wait(&pool->work_ready, &pool->mutex);
+        if (pool->stop) break;
+
+        level = pool->level;
+        div_poly_pool_run(pool);
+
+        if (--pool->busy == 0) pthread_cond_signal(&pool->work_done);
+    }
+    pthread_mutex_unlock(&pool->mutex);
+
+    flint_cleanup(); // Libère les caches propres au thread
+    return NULL;
+}
+
+/**
+ * Identique à update_list_div_poly(), mais les ψ_m sont calculés par threads threads (dont le thread appelant),
+ * niveau par niveau. Si threads <= 1, appelle simplement update_list_div_poly().
+ */
+void update_list_div_poly_threads(list_fq_poly_t list_psi, const ell_curve_t E, const ulong n, const slong threads, const fq_ctx_t ctx) {
+    // ψ_0, ..., ψ_4 sont donnés par des formules explicites
+    update_list_div_poly(list_psi, E, FLINT_MIN(n, 4), ctx);
+
+    ulong len = list_fq_poly_len(list_psi);
+    if (threads <= 1 || n < len) {
+        update_list_div_poly(list_psi, E, n, ctx);
+        return;
+    }
+
+    div_poly_pool_t pool;
+    pthread_mutex_init(&pool->mutex, NULL);
+    pthread_cond_init(&pool->work_ready, NULL);
+    pthread_cond_init(&pool->work_done, NULL);
+    pool->level = 0;
+    pool->next = 1;
+    pool->last = 0;
+    pool->busy = 0;
+    pool->stop = 0;
+    pool->ctx = ctx;
+
+    // Les ψ_m déjà calculés restent dans la liste, les nouveaux sont calculés hors de la liste puis y sont déplacés
+    pool->psi = (fq_poly_struct**)malloc((n + 1) * sizeof(fq_poly_struct*));
+    for (cell_fq_poly_t* ptr = list_psi->head; ptr != NULL; ptr = ptr->next) pool->psi[ptr->index] = ptr->poly;
+
+    fq_poly_struct* level_psi = (fq_poly_struct*)malloc((n + 1 - len) * sizeof(fq_poly_struct));
+    ulong first = len;
+    for (ulong m = first; m <= n; m++) {
+        fq_poly_init(level_psi + m - first, ctx);
+        pool->psi[m] = level_psi + m - first;
+    }
+
+    fq_t inv2, temp;
+    fq_init(inv2, ctx);
+    fq_init(temp, ctx);
+    fq_set_ui(inv2, 2, ctx);
+    fq_inv(inv2, inv2, ctx);
+    pool->inv2 = inv2;
+
+    fq_poly_t W2;
+    fq_poly_init(W2, ctx);
+    fq_one(temp, ctx);
+    fq_poly_set_coeff(W2, 3, temp, ctx);
+    fq_poly_set_coeff(W2, 1, E->a, ctx);
+    fq_poly_set_coeff(W2, 0, E->b, ctx);
+    fq_poly_mul(W2, W2, W2, ctx);
+    pool->W2 = W2;
+
+    pthread_t* workers = (pthread_t*)malloc((threads - 1) * sizeof(pthread_t));
+    slong num_workers = 0;
+    for (slong i = 0; i < threads - 1; i++) {
+        if (pthread_create(workers + num_workers, NULL, div_poly_pool_worker, pool) == 0) num_workers++;
+    }
+
+    // Niveau [len, min(n, 2*len - 5)] : ψ_m n'utilise que des ψ_k avec k <= m/2 + 2 <= len - 1
+    while (len <= n) {
+        ulong last = FLINT_MIN(n, 2 * len - 5);
+
+        pthread_mutex_lock(&pool->mutex);
+        pool->next = len;
+        pool->last = last;
+        pool->busy = num_workers;
+        pool->level++;
+        pthread_cond_broadcast(&pool->work_ready);
+
+        div_poly_pool_run(pool);
+        while (pool->busy > 0) pthread_cond_wait(&pool->work_done, &pool->mutex);
+        pthread_mutex_unlock(&pool->mutex);
+
+        for (ulong m = len; m <= last; m++) {
+            list_fq_poly_add(list_psi, pool->psi[m], ctx);
+            pool->psi[m] = list_psi->tail->poly;
+        }
+        len = last + 1;
+    }
+
+    pthread_mutex_lock(&pool->mutex);
+    pool->stop = 1;
+    pthread_cond_broadcast(&pool->work_ready);
+    pthread_mutex_unlock(&pool->mutex);
+    for (slong i = 0; i < num_workers; i++) pthread_join(workers[i], NULL);
+
+    // Libération de la mémoire (les ψ_m ont été échangés avec des polynômes vides par list_fq_poly_add())
+    for (ulong m = first; m <= n; m++) fq_poly_clear(level_psi + m - first, ctx);
+    free(level_psi);
+    free(workers);
+    free(pool->psi);
+    fq_clear(inv2, ctx);
+    fq_clear(temp, ctx);
+    fq_poly_clear(W2, ctx);
+    pthread_mutex_destroy(&pool->mutex);
+    pthread_cond_destroy(&pool->work_ready);
+    pthread_cond_destroy(&pool->work_done);
+}
+
+/**
+ * Identique à div_poly_step() sur Z : calcule ψ_m, m >= 5, à partir de psi[k] = ψ_k pour m/2 - 2 <= k <= m/2 + 2.
+ * W2 = (x^3 + a*x + b)^2. Pour m pair, la division par 2 est exacte.
+ */
+void div_poly_fmpz_step(fmpz_poly_t psi_m, const ulong m, const fmpz_poly_struct* psi, const fmpz_poly_t W2) {
+    ulong j = m / 2;
+    slong odd = j % 2;
+    const fmpz_poly_struct* psi_j = psi + j; // psi_j[i] = ψ_{j+i}
+
+    fmpz_poly_t temp_poly;
+    fmpz_poly_init(temp_poly);
+
+    if (m % 2 == 0) {
+        // ψ_{2j} = ψ_j*(ψ_{j+2}*ψ_{j-1}^2 - ψ_{j-2}*ψ_{j+1}^2)/2
+        fmpz_poly_sqr(psi_m, psi_j - 1);
+        fmpz_poly_mul(psi_m, psi_j + 2, psi_m);
+
+        fmpz_poly_sqr(temp_poly, psi_j + 1);
+        fmpz_poly_mul(temp_poly, psi_j - 2, temp_poly);
+
+        fmpz_poly_sub(psi_m, psi_m, temp_poly);
+        fmpz_poly_mul(psi_m, psi_j, psi_m);
+
+        fmpz_poly_scalar_divexact_ui(psi_m, psi_m, 2);
+    } else {
+        // ψ_{2j+1} = ψ_{j+2}*ψ_j^3 - ψ_{j-1}*ψ_{j+1}^3, avec y^4 = W^2 replié sur le terme où il apparaît
+        fmpz_poly_pow(psi_m, psi_j + odd, 3);
+        fmpz_poly_mul(psi_m, psi_j + 2 - 3 * odd, psi_m);
+        fmpz_poly_mul(psi_m, psi_m, W2);
+
+        fmpz_poly_pow(temp_poly, psi_j + 1 - odd, 3);
+        fmpz_poly_mul(temp_poly, psi_j - 1 + 3 * odd, temp_poly);
+
+        if (j % 2 == 0) {
+            fmpz_poly_sub(psi_m, psi_m, temp_poly);
+        } else {
+            fmpz_poly_sub(psi_m, temp_poly, psi_m);
+        }
+    }
+
+    fmpz_poly_clear(temp_poly);
+}
+
+/**
+ * Calcule psi[m] = ψ_m pour 0 <= m <= n, pour la courbe y^2 = x^3 + a*x + b sur Q, avec les conventions de
+ * update_list_div_poly() (f_m, ψ_m divisé par y pour m pair). psi doit contenir n+1 polynômes initialisés.
+ */
+void div_poly_fmpz(fmpz_poly_struct* psi, const ulong n, const fmpz_t a, const fmpz_t b) {
+    fmpz_t temp;
+    fmpz_init(temp);
+
+    // ψ_0 = 0, ψ_1 = 1, ψ_2 = 2*y
+    fmpz_poly_zero(psi);
+    if (n >= 1) fmpz_poly_one(psi + 1);
+    if (n >= 2) {
+        fmpz_poly_zero(psi + 2);
+        fmpz_poly_set_coeff_si(psi + 2, 0, 2);
+    }
+
+    // ψ_3 = 3*x^4 + 6*a*x^2 + 12*b*x - a^2
+    if (n >= 3) {
+        fmpz_poly_zero(psi + 3);
+        fmpz_poly_set_coeff_si(psi + 3, 4, 3);
+        fmpz_mul_ui(temp, a, 6);
+        fmpz_poly_set_coeff_fmpz(psi + 3, 2, temp);
+        fmpz_mul_ui(temp, b, 12);
+        fmpz_poly_set_coeff_fmpz(psi + 3, 1, temp);
+        fmpz_mul(temp, a, a);
+        fmpz_neg(temp, temp);
+        fmpz_poly_set_coeff_fmpz(psi + 3, 0, temp);
+    }
+
+    // ψ_4 = 4*y*(x^6 + 5*a*x^4 + 20*b*x^3 - 5*a^2*x^2 - 4*a*b*x - 8*b^2 - a^3)
+    if (n >= 4) {
+        fmpz_poly_zero(psi + 4);
+        fmpz_poly_set_coeff_si(psi + 4, 6, 4);
+        fmpz_mul_ui(temp, a, 20);
+        fmpz_poly_set_coeff_fmpz(psi + 4, 4, temp);
+        fmpz_mul_ui(temp, b, 80);
+        fmpz_poly_set_coeff_fmpz(psi + 4, 3, temp);
+        fmpz_mul(temp, a, a);
+        fmpz_mul_si(temp, temp, -20);
+        fmpz_poly_set_coeff_fmpz(psi + 4, 2, temp);
+        fmpz_mul(temp, a, b);
+        fmpz_mul_si(temp, temp, -16);
+        fmpz_poly_set_coeff_fmpz(psi + 4, 1, temp);
+
+        // -32*b^2 - 4*a^3
+        fmpz_t temp2;
+        fmpz_init(temp2);
+        fmpz_mul(temp, b, b);
+        fmpz_mul_si(temp, temp, -32);
+        fmpz_pow_ui(temp2, a, 3);
+        fmpz_submul_ui(temp, temp2, 4);
+        fmpz_poly_set_coeff_fmpz(psi + 4, 0, temp);
+        fmpz_clear(temp2);
+    }
+
+    // W2 = (x^3 + a*x + b)^2
+    fmpz_poly_t W2;
+    fmpz_poly_init(W2);
+    fmpz_poly_set_coeff_si(W2, 3, 1);
+    fmpz_poly_set_coeff_fmpz(W2, 1, a);
+    fmpz_poly_set_coeff_fmpz(W2, 0, b);
+    fmpz_poly_sqr(W2, W2);
+
+    for (ulong m = 5; m <= n; m++) div_poly_fmpz_step(psi + m, m, psi, W2);
+
+    fmpz_clear(temp);
+    fmpz_poly_clear(W2);
+}
+
+/**
+ * Affecte à rop la réduction de op modulo la caractéristique de F_q.
+ */
+void div_poly_reduce(fq_poly_t rop, const fmpz_poly_t op, const fq_ctx_t ctx) {
+    slong len = fmpz_poly_length(op);
+
+    fq_poly_fit_length(rop, len, ctx);
+    for (slong i = 0; i < len; i++) fq_set_fmpz(rop->coeffs + i, op->coeffs + i, ctx);
+    _fq_poly_set_length(rop, len, ctx);
+    _fq_poly_normalise(rop, ctx);
+}
+
+/**
+ * Complète list_psi jusqu'à ψ_n en réduisant les ψ_m sur Z de psi (c.f div_poly_fmpz()), qui doit en contenir au
+ * moins n+1. Ne fait rien si list_psi contient déjà ψ_n.
+ */
+void update_list_div_poly_reduce(list_fq_poly_t list_psi, const fmpz_poly_struct* psi, const ulong n, const fq_ctx_t ctx) {
+    fq_poly_t temp_poly;
+    fq_poly_init(temp_poly, ctx);
+
+    for (ulong m = list_fq_poly_len(list_psi); m <= n; m++) {
+        div_poly_reduce(temp_poly, psi + m, ctx);
+        list_fq_poly_add(list_psi, temp_poly, ctx);
+    }
+
+    fq_poly_clear(temp_poly, ctx);
+}
\ No newline at end of file
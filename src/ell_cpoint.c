@@ -0,0 +1,748 @@
+#include "ell_cpoint.h"
+
+/**************/
+/* PRIMITIVES */
+/**************/
+
+void ell_cpoint_init(ell_cpoint_t P, const fq_ctx_t ctx) {
+    fq_poly_init(P->X, ctx);
+    fq_poly_init(P->Y, ctx);
+    fq_poly_init(P->Z, ctx);
+}
+
+void ell_cpoint_clear(ell_cpoint_t P, const fq_ctx_t ctx) {
+    fq_poly_clear(P->X, ctx);
+    fq_poly_clear(P->Y, ctx);
+    fq_poly_clear(P->Z, ctx);
+}
+
+void ell_cpoint_set_infinity(ell_cpoint_t P, const fq_ctx_t ctx) {
+    fq_poly_one(P->X, ctx);
+    fq_poly_one(P->Y, ctx);
+    fq_poly_zero(P->Z, ctx);
+}
+
+/**
+ * Affecte à P le point (x,y), c'est-à-dire X = x, Y = 1 (car l'ordonnée est y*Y) et Z = 1.
+ */
+void ell_cpoint_set_x_y(ell_cpoint_t P, const fq_ctx_t ctx) {
+    fq_poly_gen(P->X, ctx);
+    fq_poly_one(P->Y, ctx);
+    fq_poly_one(P->Z, ctx);
+}
+
+void ell_cpoint_copy(ell_cpoint_t rop, const ell_cpoint_t op, const fq_ctx_t ctx) {
+    fq_poly_set(rop->X, op->X, ctx);
+    fq_poly_set(rop->Y, op->Y, ctx);
+    fq_poly_set(rop->Z, op->Z, ctx);
+}
+
+void ell_cpoint_swap(ell_cpoint_t op1, ell_cpoint_t op2, const fq_ctx_t ctx) {
+    fq_poly_swap(op1->X, op2->X, ctx);
+    fq_poly_swap(op1->Y, op2->Y, ctx);
+    fq_poly_swap(op1->Z, op2->Z, ctx);
+}
+
+/**
+ * Vérifie si un point d'une courbe elliptique est le point à l'infini. Renvoie 1 si c'est le cas, 0 sinon.
+ */
+int ell_cpoint_is_infinity(const ell_cpoint_t op, const fq_ctx_t ctx) {
+    return fq_poly_is_zero(op->Z, ctx);
+}
+
+/**
+ * Vérifie si deux points d'une courbe elliptique sont égaux. Renvoie 1 si c'est la cas, 0 sinon.
+ * Comme R_{E,l} est un F_q[x]/(psi)-module libre de base (1,y), on peut simplifier par y dans la comparaison
+ * des ordonnées. c.f Proposition 4.9 du rapport.
+ */
+int ell_cpoint_equal(const ell_cpoint_t op1, const ell_cpoint_t op2, const tors_ring_t tors_ring, const fq_ctx_t ctx) {
+    if (ell_cpoint_is_infinity(op1, ctx)) {
+        return ell_cpoint_is_infinity(op2, ctx);
+    }
+
+    if (ell_cpoint_is_infinity(op2, ctx)) return 0;
+
+    fq_poly_t Z1_2, Z2_2, temp1, temp2;
+    fq_poly_init(Z1_2, ctx);
+    fq_poly_init(Z2_2, ctx);
+    fq_poly_init(temp1, ctx);
+    fq_poly_init(temp2, ctx);
+
+    int success;
+
+    tors_poly_sqr(Z2_2, op2->Z, tors_ring, ctx);
+    tors_poly_mul(temp1, op1->X, Z2_2, tors_ring, ctx);
+
+    tors_poly_sqr(Z1_2, op1->Z, tors_ring, ctx);
+    tors_poly_mul(temp2, op2->X, Z1_2, tors_ring, ctx);
+
+    success = fq_poly_equal(temp1, temp2, ctx);
+
+    if (success) {
+        tors_poly_mul(temp1, Z2_2, op2->Z, tors_ring, ctx);
+        tors_poly_mul(temp1, temp1, op1->Y, tors_ring, ctx);
+
+        tors_poly_mul(temp2, Z1_2, op1->Z, tors_ring, ctx);
+        tors_poly_mul(temp2, temp2, op2->Y, tors_ring, ctx);
+
+        success = fq_poly_equal(temp1, temp2, ctx);
+    }
+
+    fq_poly_clear(Z1_2, ctx);
+    fq_poly_clear(Z2_2, ctx);
+    fq_poly_clear(temp1, ctx);
+    fq_poly_clear(temp2, ctx);
+
+    return success;
+}
+
+/**
+ * Vérifie si deux points ont la même abscisse, c'est-à-dire s'ils sont égaux au signe près. Renvoie 1 si c'est
+ * le cas, 0 sinon.
+ */
+int ell_cpoint_equal_x(const ell_cpoint_t op1, const ell_cpoint_t op2, const tors_ring_t tors_ring, const fq_ctx_t ctx) {
+    if (ell_cpoint_is_infinity(op1, ctx)) {
+        return ell_cpoint_is_infinity(op2, ctx);
+    }
+
+    if (ell_cpoint_is_infinity(op2, ctx)) return 0;
+
+    fq_poly_t temp1, temp2;
+    fq_poly_init(temp1, ctx);
+    fq_poly_init(temp2, ctx);
+
+    tors_poly_sqr(temp1, op2->Z, tors_ring, ctx);
+    tors_poly_mul(temp1, op1->X, temp1, tors_ring, ctx);
+
+    tors_poly_sqr(temp2, op1->Z, tors_ring, ctx);
+    tors_poly_mul(temp2, op2->X, temp2, tors_ring, ctx);
+
+    int success = fq_poly_equal(temp1, temp2, ctx);
+
+    fq_poly_clear(temp1, ctx);
+    fq_poly_clear(temp2, ctx);
+
+    return success;
+}
+
+/******************************************/
+/* OPERATIONS SUR LES COURBES ELLIPTIQUES */
+/******************************************/
+
+void ell_cpoint_neg(ell_cpoint_t rop, const ell_cpoint_t op, const fq_ctx_t ctx) {
+    ell_cpoint_copy(rop, op, ctx);
+    fq_poly_neg(rop->Y, rop->Y, ctx);
+}
+
+/**
+ * Mêmes formules que ell_point_double() avec Y remplacé par y*Y. Le Z obtenu est alors dans y*F_q[x], on
+ * multiplie donc (X_3 : Y_3 : Z_3) par y (i.e X_3 et Y_3 par y^2 = W, Z_3 par y) pour revenir à la forme
+ * compacte, ce qui ne coûte que des produits par W de coût linéaire.
+ * Les sommes de produits (et leurs produits par W) ne sont réduites qu'une fois modulo psi (c.f
+ * tors_poly_mul_unreduced()).
+ */
+void ell_cpoint_double(ell_cpoint_t rop, const ell_cpoint_t op, const tors_ring_t tors_ring, const fq_ctx_t ctx) {
+    // On teste si op est d'ordre 1 ou 2
+    if (ell_cpoint_is_infinity(op, ctx) || fq_poly_is_zero(op->Y, ctx)) {
+        ell_cpoint_set_infinity(rop, ctx);
+        return;
+    }
+
+    ell_cpoint_t res;
+    ell_cpoint_init(res, ctx);
+
+    fq_poly_t A, B, C, D;
+    fq_poly_init(A, ctx);
+    fq_poly_init(B, ctx);
+    fq_poly_init(C, ctx);
+    fq_poly_init(D, ctx);
+
+    // A = (y*Y)^2 = W*Y^2
+    tors_poly_sqr_unreduced(A, op->Y, tors_ring, ctx);
+    fq_poly_mul(A, A, tors_ring->W, ctx);
+    tors_poly_reduce(A, A, tors_ring, ctx);
+
+    // B = 4*X*A
+    tors_poly_mul(B, op->X, A, tors_ring, ctx);
+    tors_poly_mul_sl(B, B, 4, ctx);
+
+    // C = 3*X^2 + a*Z^4
+    tors_poly_sqr(D, op->Z, tors_ring, ctx);
+    tors_poly_sqr_unreduced(D, D, tors_ring, ctx);
+    fq_poly_scalar_mul_fq(D, D, tors_ring->curve->a, ctx);
+
+    tors_poly_sqr_unreduced(C, op->X, tors_ring, ctx);
+    tors_poly_mul_sl(C, C, 3, ctx);
+
+    fq_poly_add(C, D, C, ctx);
+    tors_poly_reduce(C, C, tors_ring, ctx);
+
+    // X_3 = C^2 - 2*B
+    tors_poly_sqr_unreduced(res->X, C, tors_ring, ctx);
+    tors_poly_mul_sl(D, B, 2, ctx);
+    fq_poly_sub(res->X, res->X, D, ctx);
+    tors_poly_reduce(res->X, res->X, tors_ring, ctx);
+
+    // Y_3 = W*(C*(B - X_3) - 8*A^2), multiplié par y^2 = W avant l'unique réduction
+    fq_poly_sub(res->Y, B, res->X, ctx);
+    tors_poly_mul_unreduced(res->Y, C, res->Y, tors_ring, ctx);
+    tors_poly_sqr_unreduced(D, A, tors_ring, ctx);
+    tors_poly_mul_sl(D, D, 8, ctx);
+    fq_poly_sub(res->Y, res->Y, D, ctx);
+    fq_poly_mul(res->Y, res->Y, tors_ring->W, ctx);
+    tors_poly_reduce(res->Y, res->Y, tors_ring, ctx);
+
+    // Z_3 = 2*(y*Y)*Z*y = 2*W*Y*Z
+    tors_poly_mul_unreduced(res->Z, op->Y, op->Z, tors_ring, ctx);
+    tors_poly_mul_sl(res->Z, res->Z, 2, ctx);
+    fq_poly_mul(res->Z, res->Z, tors_ring->W, ctx);
+    tors_poly_reduce(res->Z, res->Z, tors_ring, ctx);
+
+    tors_poly_mul_W(res->X, res->X, tors_ring, ctx);
+
+    ell_cpoint_swap(rop, res, ctx);
+
+    fq_poly_clear(A, ctx);
+    fq_poly_clear(B, ctx);
+    fq_poly_clear(C, ctx);
+    fq_poly_clear(D, ctx);
+    ell_cpoint_clear(res, ctx);
+}
+
+/**
+ * Addition en coordonnées jacobiennes : U_1 = X_1*Z_2^2, U_2 = X_2*Z_1^2, S_1 = Y_1*Z_2^3, S_2 = Y_2*Z_1^3.
+ * Les tests op1 = op2 et op1 = -op2 réutilisent ces quantités, et si l'un des points est affine on économise
+ * les produits par son Z (addition mixte, c'est le cas de toutes les additions de l'algorithme de Schoof).
+ */
+void ell_cpoint_add(ell_cpoint_t rop, const ell_cpoint_t op1, const ell_cpoint_t op2, const tors_ring_t tors_ring, const fq_ctx_t ctx) {
+    // On teste si op1 ou op2 est le point à l'infini
+    if (ell_cpoint_is_infinity(op1, ctx)) {
+        ell_cpoint_copy(rop, op2, ctx);
+        return;
+    }
+    if (ell_cpoint_is_infinity(op2, ctx)) {
+        ell_cpoint_copy(rop, op1, ctx);
+        return;
+    }
+
+    fq_poly_t U1, U2, S1, S2, temp;
+    fq_poly_init(U1, ctx);
+    fq_poly_init(U2, ctx);
+    fq_poly_init(S1, ctx);
+    fq_poly_init(S2, ctx);
+    fq_poly_init(temp, ctx);
+
+    int aff1 = fq_poly_is_one(op1->Z, ctx);
+    int aff2 = fq_poly_is_one(op2->Z, ctx);
+
+    // U_1 et S_1
+    if (aff2) {
+        fq_poly_set(U1, op1->X, ctx);
+        fq_poly_set(S1, op1->Y, ctx);
+    } else {
+        tors_poly_sqr(temp, op2->Z, tors_ring, ctx);
+        tors_poly_mul(U1, op1->X, temp, tors_ring, ctx);
+        tors_poly_mul(temp, temp, op2->Z, tors_ring, ctx);
+        tors_poly_mul(S1, op1->Y, temp, tors_ring, ctx);
+    }
+
+    // U_2 et S_2
+    if (aff1) {
+        fq_poly_set(U2, op2->X, ctx);
+        fq_poly_set(S2, op2->Y, ctx);
+    } else {
+        tors_poly_sqr(temp, op1->Z, tors_ring, ctx);
+        tors_poly_mul(U2, op2->X, temp, tors_ring, ctx);
+        tors_poly_mul(temp, temp, op1->Z, tors_ring, ctx);
+        tors_poly_mul(S2, op2->Y, temp, tors_ring, ctx);
+    }
+
+    _ell_cpoint_add(rop, op1, op2, U1, U2, S1, S2, tors_ring, ctx);
+
+    fq_poly_clear(U1, ctx);
+    fq_poly_clear(U2, ctx);
+    fq_poly_clear(S1, ctx);
+    fq_poly_clear(S2, ctx);
+    fq_poly_clear(temp, ctx);
+}
+
+/**
+ * Fin de l'addition connaissant U_1, U_2, S_1 et S_2 (qui servent ensuite de variables temporaires), op1 et op2
+ * n'étant pas le point à l'infini. c.f ell_cpoint_add() et ell_cpoint_add_pre().
+ */
+void _ell_cpoint_add(ell_cpoint_t rop, const ell_cpoint_t op1, const ell_cpoint_t op2, fq_poly_t U1, fq_poly_t U2, fq_poly_t S1, fq_poly_t S2, const tors_ring_t tors_ring, const fq_ctx_t ctx) {
+    fq_poly_t H, R, temp;
+    fq_poly_init(H, ctx);
+    fq_poly_init(R, ctx);
+    fq_poly_init(temp, ctx);
+
+    int aff1 = fq_poly_is_one(op1->Z, ctx);
+    int aff2 = fq_poly_is_one(op2->Z, ctx);
+
+    // H = U_2 - U_1 et R = S_2 - S_1
+    fq_poly_sub(H, U2, U1, ctx);
+    fq_poly_sub(R, S2, S1, ctx);
+
+    // Si H = 0, on teste si op1 = op2 (R = 0) ou op1 = -op2 (S_1 + S_2 = 0)
+    int opposite = 0;
+    if (fq_poly_is_zero(H, ctx)) {
+        fq_poly_add(temp, S1, S2, ctx);
+        opposite = fq_poly_is_zero(temp, ctx);
+    }
+
+    if (fq_poly_is_zero(H, ctx) && fq_poly_is_zero(R, ctx)) {
+        ell_cpoint_double(rop, op1, tors_ring, ctx);
+    } else if (opposite) {
+        ell_cpoint_set_infinity(rop, ctx);
+    } else {
+        ell_cpoint_t res;
+        ell_cpoint_init(res, ctx);
+
+        // U2 = H^2, S2 = H^3, U1 = U_1*H^2
+        tors_poly_sqr(U2, H, tors_ring, ctx);
+        tors_poly_mul(S2, U2, H, tors_ring, ctx);
+        tors_poly_mul(U1, U1, U2, tors_ring, ctx);
+
+        // X_3 = W*R^2 - H^3 - 2*U_1*H^2, réduit une seule fois
+        tors_poly_sqr_unreduced(res->X, R, tors_ring, ctx);
+        fq_poly_mul(res->X, res->X, tors_ring->W, ctx);
+        tors_poly_mul_sl(temp, U1, 2, ctx);
+        fq_poly_add(temp, S2, temp, ctx);
+        fq_poly_sub(res->X, res->X, temp, ctx);
+        tors_poly_reduce(res->X, res->X, tors_ring, ctx);
+
+        // Y_3 = R*(U_1*H^2 - X_3) - S_1*H^3, réduit une seule fois
+        fq_poly_sub(res->Y, U1, res->X, ctx);
+        tors_poly_mul_unreduced(res->Y, R, res->Y, tors_ring, ctx);
+        tors_poly_mul_unreduced(temp, S1, S2, tors_ring, ctx);
+        fq_poly_sub(res->Y, res->Y, temp, ctx);
+        tors_poly_reduce(res->Y, res->Y, tors_ring, ctx);
+
+        // Z_3 = Z_1*Z_2*H
+        if (aff1 && aff2) {
+            fq_poly_set(res->Z, H, ctx);
+        } else if (aff1) {
+            tors_poly_mul(res->Z, op2->Z, H, tors_ring, ctx);
+        } else if (aff2) {
+            tors_poly_mul(res->Z, op1->Z, H, tors_ring, ctx);
+        } else {
+            tors_poly_mul(res->Z, op1->Z, op2->Z, tors_ring, ctx);
+            tors_poly_mul(res->Z, res->Z, H, tors_ring, ctx);
+        }
+
+        ell_cpoint_swap(rop, res, ctx);
+        ell_cpoint_clear(res, ctx);
+    }
+
+    fq_poly_clear(H, ctx);
+    fq_poly_clear(R, ctx);
+    fq_poly_clear(temp, ctx);
+}
+
+/**
+ * Additions itérées d'un point d'une courbe elliptique via Double & Add en lisant les bits de gauche à droite.
+ */
+void ell_cpoint_mul(ell_cpoint_t rop, const ell_cpoint_t op, const fmpz_t n, const tors_ring_t tors_ring, const fq_ctx_t ctx) {
+    if (fmpz_sgn(n) < 0) {
+        ell_cpoint_t op_neg;
+        fmpz_t n_neg;
+
+        fmpz_init(n_neg);
+        fmpz_neg(n_neg, n);
+
+        ell_cpoint_init(op_neg, ctx);
+        ell_cpoint_neg(op_neg, op, ctx);
+        ell_cpoint_mul(rop, op_neg, n_neg, tors_ring, ctx);
+
+        ell_cpoint_clear(op_neg, ctx);
+        fmpz_clear(n_neg);
+        return;
+    }
+
+    ell_cpoint_t res;
+    ell_cpoint_init(res, ctx);
+    ell_cpoint_set_infinity(res, ctx);
+
+    for (slong i = fmpz_bits(n) - 1; i >= 0; i--) {
+        ell_cpoint_double(res, res, tors_ring, ctx);
+        if (fmpz_tstbit(n, i)) ell_cpoint_add(res, res, op, tors_ring, ctx);
+    }
+
+    ell_cpoint_swap(res, rop, ctx);
+    ell_cpoint_clear(res, ctx);
+}
+
+/****************/
+/* POINTS FIXES */
+/****************/
+
+void ell_cpoint_pre_init(ell_cpoint_pre_t pre, const fq_ctx_t ctx) {
+    ell_cpoint_init(pre->P, ctx);
+    tors_pre_init(pre->X, ctx);
+    tors_pre_init(pre->Y, ctx);
+    tors_pre_init(pre->Z2, ctx);
+    tors_pre_init(pre->Z3, ctx);
+}
+
+void ell_cpoint_pre_clear(ell_cpoint_pre_t pre, const fq_ctx_t ctx) {
+    ell_cpoint_clear(pre->P, ctx);
+    tors_pre_clear(pre->X, ctx);
+    tors_pre_clear(pre->Y, ctx);
+    tors_pre_clear(pre->Z2, ctx);
+    tors_pre_clear(pre->Z3, ctx);
+}
+
+/**
+ * Prépare P pour les additions et comparaisons d'une boucle où il ne change pas (c.f schoof_mod_l()). Le
+ * précalcul reste valable tant que psi ne change pas, il ne sert donc pas en mode affine.
+ */
+void ell_cpoint_pre_set(ell_cpoint_pre_t pre, const ell_cpoint_t P, const tors_ring_t tors_ring, const fq_ctx_t ctx) {
+    fq_poly_t temp;
+    fq_poly_init(temp, ctx);
+
+    ell_cpoint_copy(pre->P, P, ctx);
+    tors_pre_set(pre->X, P->X, tors_ring, ctx);
+    tors_pre_set(pre->Y, P->Y, tors_ring, ctx);
+
+    tors_poly_sqr(temp, P->Z, tors_ring, ctx);
+    tors_pre_set(pre->Z2, temp, tors_ring, ctx);
+    tors_poly_mul(temp, temp, P->Z, tors_ring, ctx);
+    tors_pre_set(pre->Z3, temp, tors_ring, ctx);
+
+    fq_poly_clear(temp, ctx);
+}
+
+/**
+ * rop = op + pre->P, même calcul que ell_cpoint_add() où les produits par une coordonnée de pre->P passent par
+ * tors_poly_mul_pre().
+ */
+void ell_cpoint_add_pre(ell_cpoint_t rop, const ell_cpoint_t op, const ell_cpoint_pre_t pre, const tors_ring_t tors_ring, const fq_ctx_t ctx) {
+    const ell_cpoint_struct* P = pre->P;
+
+    if (ell_cpoint_is_infinity(op, ctx)) {
+        ell_cpoint_copy(rop, P, ctx);
+        return;
+    }
+    if (ell_cpoint_is_infinity(P, ctx)) {
+        ell_cpoint_copy(rop, op, ctx);
+        return;
+    }
+
+    fq_poly_t U1, U2, S1, S2, temp;
+    fq_poly_init(U1, ctx);
+    fq_poly_init(U2, ctx);
+    fq_poly_init(S1, ctx);
+    fq_poly_init(S2, ctx);
+    fq_poly_init(temp, ctx);
+
+    // U_1 = X_1*Z_2^2 et S_1 = Y_1*Z_2^3
+    if (fq_poly_is_one(P->Z, ctx)) {
+        fq_poly_set(U1, op->X, ctx);
+        fq_poly_set(S1, op->Y, ctx);
+    } else {
+        tors_poly_mul_pre(U1, op->X, pre->Z2, tors_ring, ctx);
+        tors_poly_mul_pre(S1, op->Y, pre->Z3, tors_ring, ctx);
+    }
+
+    // U_2 = X_2*Z_1^2 et S_2 = Y_2*Z_1^3
+    if (fq_poly_is_one(op->Z, ctx)) {
+        fq_poly_set(U2, P->X, ctx);
+        fq_poly_set(S2, P->Y, ctx);
+    } else {
+        tors_poly_sqr(temp, op->Z, tors_ring, ctx);
+        tors_poly_mul_pre(U2, temp, pre->X, tors_ring, ctx);
+        tors_poly_mul(temp, temp, op->Z, tors_ring, ctx);
+        tors_poly_mul_pre(S2, temp, pre->Y, tors_ring, ctx);
+    }
+
+    _ell_cpoint_add(rop, op, P, U1, U2, S1, S2, tors_ring, ctx);
+
+    fq_poly_clear(U1, ctx);
+    fq_poly_clear(U2, ctx);
+    fq_poly_clear(S1, ctx);
+    fq_poly_clear(S2, ctx);
+    fq_poly_clear(temp, ctx);
+}
+
+/**
+ * Même test que ell_cpoint_equal(pre->P, op), sans recalculer Z^2 et Z^3 pour pre->P.
+ */
+int ell_cpoint_equal_pre(const ell_cpoint_t op, const ell_cpoint_pre_t pre, const tors_ring_t tors_ring, const fq_ctx_t ctx) {
+    if (ell_cpoint_is_infinity(pre->P, ctx)) {
+        return ell_cpoint_is_infinity(op, ctx);
+    }
+
+    if (ell_cpoint_is_infinity(op, ctx)) return 0;
+
+    fq_poly_t Z_2, temp1, temp2;
+    fq_poly_init(Z_2, ctx);
+    fq_poly_init(temp1, ctx);
+    fq_poly_init(temp2, ctx);
+
+    int success;
+
+    tors_poly_sqr(Z_2, op->Z, tors_ring, ctx);
+    tors_poly_mul_pre(temp1, Z_2, pre->X, tors_ring, ctx);
+    tors_poly_mul_pre(temp2, op->X, pre->Z2, tors_ring, ctx);
+
+    success = fq_poly_equal(temp1, temp2, ctx);
+
+    if (success) {
+        tors_poly_mul(temp1, Z_2, op->Z, tors_ring, ctx);
+        tors_poly_mul_pre(temp1, temp1, pre->Y, tors_ring, ctx);
+        tors_poly_mul_pre(temp2, op->Y, pre->Z3, tors_ring, ctx);
+
+        success = fq_poly_equal(temp1, temp2, ctx);
+    }
+
+    fq_poly_clear(Z_2, ctx);
+    fq_poly_clear(temp1, ctx);
+    fq_poly_clear(temp2, ctx);
+
+    return success;
+}
+
+/**
+ * Même test que ell_cpoint_equal_x(pre->P, op).
+ */
+int ell_cpoint_equal_x_pre(const ell_cpoint_t op, const ell_cpoint_pre_t pre, const tors_ring_t tors_ring, const fq_ctx_t ctx) {
+    if (ell_cpoint_is_infinity(pre->P, ctx)) {
+        return ell_cpoint_is_infinity(op, ctx);
+    }
+
+    if (ell_cpoint_is_infinity(op, ctx)) return 0;
+
+    fq_poly_t temp1, temp2;
+    fq_poly_init(temp1, ctx);
+    fq_poly_init(temp2, ctx);
+
+    tors_poly_sqr(temp1, op->Z, tors_ring, ctx);
+    tors_poly_mul_pre(temp1, temp1, pre->X, tors_ring, ctx);
+    tors_poly_mul_pre(temp2, op->X, pre->Z2, tors_ring, ctx);
+
+    int success = fq_poly_equal(temp1, temp2, ctx);
+
+    fq_poly_clear(temp1, ctx);
+    fq_poly_clear(temp2, ctx);
+
+    return success;
+}
+
+/***************************************************************/
+/* ARITHMETIQUE AFFINE AVEC REDUCTION OPPORTUNISTE DE L'ANNEAU */
+/***************************************************************/
+
+/**
+ * Dans ce mode, les points sont affines (Z = 1) ou le point à l'infini (Z = 0). Chaque opération inverse
+ * un dénominateur via tors_poly_inv(), qui peut remplacer psi par un de ses facteurs : les coordonnées
+ * calculées auparavant restent valables mais ne sont plus réduites, d'où ell_cpoint_reduce().
+ */
+void ell_cpoint_reduce(ell_cpoint_t P, const tors_ring_t tors_ring, const fq_ctx_t ctx) {
+    fq_poly_rem(P->X, P->X, tors_ring->psi, ctx);
+    fq_poly_rem(P->Y, P->Y, tors_ring->psi, ctx);
+}
+
+/**
+ * Vérifie si deux points affines sont égaux, il suffit de comparer directement les coordonnées (après
+ * réduction modulo le psi courant). Renvoie 1 si c'est le cas, 0 sinon.
+ */
+int ell_cpoint_equal_aff(const ell_cpoint_t op1, const ell_cpoint_t op2, const tors_ring_t tors_ring, const fq_ctx_t ctx) {
+    if (ell_cpoint_is_infinity(op1, ctx)) {
+        return ell_cpoint_is_infinity(op2, ctx);
+    }
+
+    if (ell_cpoint_is_infinity(op2, ctx)) return 0;
+
+    fq_poly_t temp;
+    fq_poly_init(temp, ctx);
+
+    fq_poly_sub(temp, op1->X, op2->X, ctx);
+    fq_poly_rem(temp, temp, tors_ring->psi, ctx);
+    int success = fq_poly_is_zero(temp, ctx);
+
+    if (success) {
+        fq_poly_sub(temp, op1->Y, op2->Y, ctx);
+        fq_poly_rem(temp, temp, tors_ring->psi, ctx);
+        success = fq_poly_is_zero(temp, ctx);
+    }
+
+    fq_poly_clear(temp, ctx);
+    return success;
+}
+
+/**
+ * Vérifie si deux points affines ont la même abscisse (après réduction modulo le psi courant). Renvoie 1 si
+ * c'est le cas, 0 sinon.
+ */
+int ell_cpoint_equal_x_aff(const ell_cpoint_t op1, const ell_cpoint_t op2, const tors_ring_t tors_ring, const fq_ctx_t ctx) {
+    if (ell_cpoint_is_infinity(op1, ctx)) {
+        return ell_cpoint_is_infinity(op2, ctx);
+    }
+
+    if (ell_cpoint_is_infinity(op2, ctx)) return 0;
+
+    fq_poly_t temp;
+    fq_poly_init(temp, ctx);
+
+    fq_poly_sub(temp, op1->X, op2->X, ctx);
+    fq_poly_rem(temp, temp, tors_ring->psi, ctx);
+    int success = fq_poly_is_zero(temp, ctx);
+
+    fq_poly_clear(temp, ctx);
+    return success;
+}
+
+/**
+ * Doublement affine : lambda = (3*X^2 + a)/(2*y*Y) = y*L avec L = (3*X^2 + a)/(2*W*Y),
+ * puis X_3 = W*L^2 - 2*X et Y_3 = L*(X - X_3) - Y.
+ */
+void ell_cpoint_double_aff(ell_cpoint_t rop, const ell_cpoint_t op, tors_ring_t tors_ring, const fq_ctx_t ctx) {
+    if (ell_cpoint_is_infinity(op, ctx)) {
+        ell_cpoint_set_infinity(rop, ctx);
+        return;
+    }
+
+    fq_poly_t L, temp;
+    fq_poly_init(L, ctx);
+    fq_poly_init(temp, ctx);
+
+    // temp = 2*W*Y, si temp est nul op est d'ordre 2
+    tors_poly_mul_W(temp, op->Y, tors_ring, ctx);
+    tors_poly_mul_sl(temp, temp, 2, ctx);
+
+    if (!tors_poly_inv(temp, temp, tors_ring, ctx)) {
+        ell_cpoint_set_infinity(rop, ctx);
+    } else {
+        ell_cpoint_t res;
+        ell_cpoint_init(res, ctx);
+
+        // L = (3*X^2 + a)/(2*W*Y)
+        tors_poly_sqr(L, op->X, tors_ring, ctx);
+        tors_poly_mul_sl(L, L, 3, ctx);
+        fq_poly_set_fq(res->X, tors_ring->curve->a, ctx);
+        fq_poly_add(L, L, res->X, ctx);
+        tors_poly_mul(L, L, temp, tors_ring, ctx);
+
+        // X_3 = W*L^2 - 2*X
+        tors_poly_sqr(res->X, L, tors_ring, ctx);
+        tors_poly_mul_W(res->X, res->X, tors_ring, ctx);
+        tors_poly_mul_sl(temp, op->X, 2, ctx);
+        fq_poly_sub(res->X, res->X, temp, ctx);
+        fq_poly_rem(res->X, res->X, tors_ring->psi, ctx);
+
+        // Y_3 = L*(X - X_3) - Y
+        fq_poly_sub(res->Y, op->X, res->X, ctx);
+        tors_poly_mul(res->Y, L, res->Y, tors_ring, ctx);
+        fq_poly_sub(res->Y, res->Y, op->Y, ctx);
+        fq_poly_rem(res->Y, res->Y, tors_ring->psi, ctx);
+
+        fq_poly_one(res->Z, ctx);
+
+        ell_cpoint_swap(rop, res, ctx);
+        ell_cpoint_clear(res, ctx);
+    }
+
+    fq_poly_clear(L, ctx);
+    fq_poly_clear(temp, ctx);
+}
+
+/**
+ * Addition affine : lambda = y*L avec L = (Y_2 - Y_1)/(X_2 - X_1), puis X_3 = W*L^2 - X_1 - X_2 et
+ * Y_3 = L*(X_1 - X_3) - Y_1. Si X_2 - X_1 est nul, on a op1 = op2 ou op1 = -op2, sauf si Y_2 - Y_1 est
+ * un diviseur de zéro (les deux cas se produisent sur des facteurs différents de psi) : on réduit alors
+ * l'anneau et on recommence.
+ */
+void ell_cpoint_add_aff(ell_cpoint_t rop, const ell_cpoint_t op1, const ell_cpoint_t op2, tors_ring_t tors_ring, const fq_ctx_t ctx) {
+    // On teste si op1 ou op2 est le point à l'infini
+    if (ell_cpoint_is_infinity(op1, ctx)) {
+        ell_cpoint_copy(rop, op2, ctx);
+        return;
+    }
+    if (ell_cpoint_is_infinity(op2, ctx)) {
+        ell_cpoint_copy(rop, op1, ctx);
+        return;
+    }
+
+    fq_poly_t L, temp;
+    fq_poly_init(L, ctx);
+    fq_poly_init(temp, ctx);
+
+    int invertible;
+
+    while (1) {
+        fq_poly_sub(temp, op2->X, op1->X, ctx);
+
+        if (tors_poly_inv(temp, temp, tors_ring, ctx)) {
+            invertible = 1;
+            break;
+        }
+
+        invertible = 0;
+
+        // X_1 = X_2 dans l'anneau courant
+        fq_poly_sub(temp, op2->Y, op1->Y, ctx);
+        fq_poly_rem(temp, temp, tors_ring->psi, ctx);
+
+        if (fq_poly_is_zero(temp, ctx)) {
+            ell_cpoint_double_aff(rop, op1, tors_ring, ctx);
+            break;
+        }
+
+        fq_poly_add(L, op2->Y, op1->Y, ctx);
+        fq_poly_rem(L, L, tors_ring->psi, ctx);
+
+        if (fq_poly_is_zero(L, ctx)) {
+            ell_cpoint_set_infinity(rop, ctx);
+            break;
+        }
+
+        tors_ring_split(tors_ring, temp, ctx);
+    }
+
+    if (invertible) {
+        ell_cpoint_t res;
+        ell_cpoint_init(res, ctx);
+
+        // L = (Y_2 - Y_1)/(X_2 - X_1)
+        fq_poly_sub(L, op2->Y, op1->Y, ctx);
+        tors_poly_mul(L, L, temp, tors_ring, ctx);
+
+        // X_3 = W*L^2 - X_1 - X_2
+        tors_poly_sqr(res->X, L, tors_ring, ctx);
+        tors_poly_mul_W(res->X, res->X, tors_ring, ctx);
+        fq_poly_add(temp, op1->X, op2->X, ctx);
+        fq_poly_sub(res->X, res->X, temp, ctx);
+        fq_poly_rem(res->X, res->X, tors_ring->psi, ctx);
+
+        // Y_3 = L*(X_1 - X_3) - Y_1
+        fq_poly_sub(res->Y, op1->X, res->X, ctx);
+        tors_poly_mul(res->Y, L, res->Y, tors_ring, ctx);
+        fq_poly_sub(res->Y, res->Y, op1->Y, ctx);
+        fq_poly_rem(res->Y, res->Y, tors_ring->psi, ctx);
+
+        fq_poly_one(res->Z, ctx);
+
+        ell_cpoint_swap(rop, res, ctx);
+        ell_cpoint_clear(res, ctx);
+    }
+
+    fq_poly_clear(L, ctx);
+    fq_poly_clear(temp, ctx);
+}
+
+/**
+ * Double & Add affine en lisant les bits de n de gauche à droite, n est supposé positif.
+ */
+void ell_cpoint_mul_aff(ell_cpoint_t rop, const ell_cpoint_t op, const fmpz_t n, tors_ring_t tors_ring, const fq_ctx_t ctx) {
+    ell_cpoint_t res;
+    ell_cpoint_init(res, ctx);
+    ell_cpoint_set_infinity(res, ctx);
+
+    for (slong i = fmpz_bits(n) - 1; i >= 0; i--) {
+        ell_cpoint_double_aff(res, res, tors_ring, ctx);
+        if (fmpz_tstbit(n, i)) ell_cpoint_add_aff(res, res, op, tors_ring, ctx);
+    }
+
+    ell_cpoint_swap(res, rop, ctx);
+    ell_cpoint_clear(res, ctx);
+}
\ No newline at end of file
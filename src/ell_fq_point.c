@@ -0,0 +1,284 @@
+#include "ell_fq_point.h"
+
+/**************/
+/* PRIMITIVES */
+/**************/
+
+void ell_fq_point_init(ell_fq_point_t P, const fq_ctx_t ctx) {
+    fq_init(P->x, ctx);
+    fq_init(P->y, ctx);
+    P->infinity = 1;
+}
+
+void ell_fq_point_clear(ell_fq_point_t P, const fq_ctx_t ctx) {
+    fq_clear(P->x, ctx);
+    fq_clear(P->y, ctx);
+}
+
+void ell_fq_point_set_infinity(ell_fq_point_t P, const fq_ctx_t ctx) {
+    fq_zero(P->x, ctx);
+    fq_one(P->y, ctx);
+    P->infinity = 1;
+}
+
+void ell_fq_point_copy(ell_fq_point_t rop, const ell_fq_point_t op, const fq_ctx_t ctx) {
+    fq_set(rop->x, op->x, ctx);
+    fq_set(rop->y, op->y, ctx);
+    rop->infinity = op->infinity;
+}
+
+void ell_fq_point_swap(ell_fq_point_t op1, ell_fq_point_t op2, const fq_ctx_t ctx) {
+    fq_swap(op1->x, op2->x, ctx);
+    fq_swap(op1->y, op2->y, ctx);
+    int temp = op1->infinity;
+    op1->infinity = op2->infinity;
+    op2->infinity = temp;
+}
+
+int ell_fq_point_equal(const ell_fq_point_t op1, const ell_fq_point_t op2, const fq_ctx_t ctx) {
+    if (op1->infinity || op2->infinity) return op1->infinity && op2->infinity;
+    return fq_equal(op1->x, op2->x, ctx) && fq_equal(op1->y, op2->y, ctx);
+}
+
+/**
+ * Hache un point par son abscisse. Seule la composante dans le sous-corps premier est utilisée, ce qui reste
+ * correct (mais moins efficace) sur une extension.
+ */
+ulong ell_fq_point_hash(const ell_fq_point_t P, const fq_ctx_t ctx) {
+    if (P->infinity) return 0;
+
+    fmpz_t x;
+    fmpz_init(x);
+    fq_get_fmpz(x, P->x, ctx);
+    ulong hash = fmpz_fdiv_ui(x, UWORD(4294967291)) + 1; // 4294967291 est le plus grand nombre premier sur 32 bits
+    fmpz_clear(x);
+
+    return hash;
+}
+
+/**
+ * Tire un point de E(F_q) différent du point à l'infini : on tire x jusqu'à ce que x^3 + a*x + b soit un carré.
+ */
+void ell_fq_point_random(ell_fq_point_t P, const ell_curve_t E, flint_rand_t state, const fq_ctx_t ctx) {
+    fq_t W;
+    fq_init(W, ctx);
+
+    do {
+        fq_rand(P->x, state, ctx);
+
+        // W = x^3 + a*x + b
+        fq_sqr(W, P->x, ctx);
+        fq_add(W, W, E->a, ctx);
+        fq_mul(W, W, P->x, ctx);
+        fq_add(W, W, E->b, ctx);
+    } while (!fq_is_square(W, ctx));
+
+    fq_sqrt(P->y, W, ctx);
+    P->infinity = 0;
+
+    fq_clear(W, ctx);
+}
+
+/******************************************/
+/* OPERATIONS SUR LES COURBES ELLIPTIQUES */
+/******************************************/
+
+void ell_fq_point_neg(ell_fq_point_t rop, const ell_fq_point_t op, const fq_ctx_t ctx) {
+    fq_set(rop->x, op->x, ctx);
+    fq_neg(rop->y, op->y, ctx);
+    rop->infinity = op->infinity;
+}
+
+/**
+ * Doublement affine : lambda = (3*x^2 + a)/(2*y), x_3 = lambda^2 - 2*x et y_3 = lambda*(x - x_3) - y.
+ */
+void ell_fq_point_double(ell_fq_point_t rop, const ell_fq_point_t op, const ell_curve_t E, const fq_ctx_t ctx) {
+    if (op->infinity || fq_is_zero(op->y, ctx)) {
+        ell_fq_point_set_infinity(rop, ctx);
+        return;
+    }
+
+    fq_t lambda, temp, x_3;
+    fq_init(lambda, ctx);
+    fq_init(temp, ctx);
+    fq_init(x_3, ctx);
+
+    // lambda = (3*x^2 + a)/(2*y)
+    fq_sqr(lambda, op->x, ctx);
+    fq_mul_ui(lambda, lambda, 3, ctx);
+    fq_add(lambda, lambda, E->a, ctx);
+    fq_add(temp, op->y, op->y, ctx);
+    fq_inv(temp, temp, ctx);
+    fq_mul(lambda, lambda, temp, ctx);
+
+    // x_3 = lambda^2 - 2*x
+    fq_sqr(x_3, lambda, ctx);
+    fq_sub(x_3, x_3, op->x, ctx);
+    fq_sub(x_3, x_3, op->x, ctx);
+
+    // y_3 = lambda*(x - x_3) - y
+    fq_sub(temp, op->x, x_3, ctx);
+    fq_mul(temp, temp, lambda, ctx);
+    fq_sub(rop->y, temp, op->y, ctx);
+    fq_swap(rop->x, x_3, ctx);
+    rop->infinity = 0;
+
+    fq_clear(lambda, ctx);
+    fq_clear(temp, ctx);
+    fq_clear(x_3, ctx);
+}
+
+/**
+ * Addition affine : lambda = (y_2 - y_1)/(x_2 - x_1), x_3 = lambda^2 - x_1 - x_2 et y_3 = lambda*(x_1 - x_3) - y_1.
+ */
+void ell_fq_point_add(ell_fq_point_t rop, const ell_fq_point_t op1, const ell_fq_point_t op2, const ell_curve_t E, const fq_ctx_t ctx) {
+    if (op1->infinity) {
+        ell_fq_point_copy(rop, op2, ctx);
+        return;
+    }
+
+    if (op2->infinity) {
+        ell_fq_point_copy(rop, op1, ctx);
+        return;
+    }
+
+    if (fq_equal(op1->x, op2->x, ctx)) {
+        if (fq_equal(op1->y, op2->y, ctx)) {
+            ell_fq_point_double(rop, op1, E, ctx);
+        } else {
+            ell_fq_point_set_infinity(rop, ctx);
+        }
+        return;
+    }
+
+    fq_t lambda, temp, x_3;
+    fq_init(lambda, ctx);
+    fq_init(temp, ctx);
+    fq_init(x_3, ctx);
+
+    // lambda = (y_2 - y_1)/(x_2 - x_1)
+    fq_sub(temp, op2->x, op1->x, ctx);
+    fq_inv(temp, temp, ctx);
+    fq_sub(lambda, op2->y, op1->y, ctx);
+    fq_mul(lambda, lambda, temp, ctx);
+
+    // x_3 = lambda^2 - x_1 - x_2
+    fq_sqr(x_3, lambda, ctx);
+    fq_sub(x_3, x_3, op1->x, ctx);
+    fq_sub(x_3, x_3, op2->x, ctx);
+
+    // y_3 = lambda*(x_1 - x_3) - y_1
+    fq_sub(temp, op1->x, x_3, ctx);
+    fq_mul(temp, temp, lambda, ctx);
+    fq_sub(rop->y, temp, op1->y, ctx);
+    fq_swap(rop->x, x_3, ctx);
+    rop->infinity = 0;
+
+    fq_clear(lambda, ctx);
+    fq_clear(temp, ctx);
+    fq_clear(x_3, ctx);
+}
+
+/**
+ * Additions itérées d'un point d'une courbe elliptique via Double & Add en lisant les bits de gauche à droite.
+ */
+void ell_fq_point_mul(ell_fq_point_t rop, const ell_fq_point_t op, const fmpz_t n, const ell_curve_t E, const fq_ctx_t ctx) {
+    ell_fq_point_t base, res;
+    ell_fq_point_init(base, ctx);
+    ell_fq_point_init(res, ctx);
+
+    // [n]op = [|n|](±op), fmpz_tstbit() lisant les entiers négatifs en complément à deux
+    fmpz_t abs_n;
+    fmpz_init(abs_n);
+    fmpz_abs(abs_n, n);
+
+    if (fmpz_sgn(n) < 0) {
+        ell_fq_point_neg(base, op, ctx);
+    } else {
+        ell_fq_point_copy(base, op, ctx);
+    }
+
+    for (slong i = fmpz_bits(abs_n) - 1; i >= 0; i--) {
+        ell_fq_point_double(res, res, E, ctx);
+        if (fmpz_tstbit(abs_n, i)) ell_fq_point_add(res, res, base, E, ctx);
+    }
+
+    ell_fq_point_swap(res, rop, ctx);
+    ell_fq_point_clear(base, ctx);
+    ell_fq_point_clear(res, ctx);
+    fmpz_clear(abs_n);
+}
+
+/*****************************/
+/* PAS DE BEBE, PAS DE GEANT */
+/*****************************/
+
+/**
+ * Cherche tous les j dans [0, K-1] tels que [j]G = R : les pas de bébé sont les [i]G pour 0 <= i < m avec
+ * m = ceil(sqrt(K)), rangés dans une table de hachage par abscisse (c.f ell_fq_point_hash()), les pas de géant
+ * les R - [g*m]G, soit O(sqrt(K)) opérations dans E(F_q). Les j trouvés sont écrits dans matches par ordre
+ * croissant.
+ * Renvoie leur nombre, ou -1 s'il y en a plus de max_matches (G est alors d'ordre trop petit pour conclure).
+ */
+slong ell_fq_point_bsgs(ulong* matches, const slong max_matches, const ell_fq_point_t R, const ell_fq_point_t G, const ulong K, const ell_curve_t E, const fq_ctx_t ctx) {
+    ulong m = n_sqrt(K);
+    if (m*m < K) m++;
+
+    // Pas de bébé
+    ell_fq_point_struct* baby = (ell_fq_point_struct*)malloc(m * sizeof(ell_fq_point_struct));
+    ell_fq_point_init(baby, ctx);
+    for (ulong i = 1; i < m; i++) {
+        ell_fq_point_init(baby + i, ctx);
+        ell_fq_point_add(baby + i, baby + i - 1, G, E, ctx);
+    }
+
+    // Table de hachage à adressage ouvert des pas de bébé
+    ulong table_size = 1;
+    while (table_size < 2*m) table_size <<= 1;
+    slong* table = (slong*)malloc(table_size * sizeof(slong));
+    for (ulong i = 0; i < table_size; i++) table[i] = -1;
+
+    for (ulong i = 0; i < m; i++) {
+        ulong h = ell_fq_point_hash(baby + i, ctx) & (table_size - 1);
+        while (table[h] != -1) h = (h + 1) & (table_size - 1);
+        table[h] = i;
+    }
+
+    // giant = -[m]G
+    ell_fq_point_t giant, T;
+    ell_fq_point_init(giant, ctx);
+    ell_fq_point_init(T, ctx);
+    ell_fq_point_add(giant, baby + m - 1, G, E, ctx);
+    ell_fq_point_neg(giant, giant, ctx);
+    ell_fq_point_copy(T, R, ctx);
+
+    // Pas de géant : T = R - [g*m]G
+    slong num_matches = 0;
+    for (ulong g = 0; g*m < K && num_matches >= 0; g++) {
+        slong first = num_matches; // Les j de ce pas de géant, rangés par insertion
+        ulong h = ell_fq_point_hash(T, ctx) & (table_size - 1);
+
+        for (; table[h] != -1; h = (h + 1) & (table_size - 1)) {
+            ulong j = g*m + table[h];
+            if (j >= K || !ell_fq_point_equal(baby + table[h], T, ctx)) continue;
+
+            if (num_matches == max_matches) {
+                num_matches = -1;
+                break;
+            }
+
+            slong k = num_matches++;
+            for (; k > first && matches[k - 1] > j; k--) matches[k] = matches[k - 1];
+            matches[k] = j;
+        }
+
+        ell_fq_point_add(T, T, giant, E, ctx);
+    }
+
+    for (ulong i = 0; i < m; i++) ell_fq_point_clear(baby + i, ctx);
+    free(baby);
+    free(table);
+    ell_fq_point_clear(giant, ctx);
+    ell_fq_point_clear(T, ctx);
+    return num_matches;
+}
\ No newline at end of file
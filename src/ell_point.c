@@ -109,28 +109,32 @@ void ell_point_double(ell_point_t rop, const ell_point_t op, const tors_ring_t t
     tors_elem_mul(B, op->X, A, tors_ring, ctx);
     tors_elem_mul_sl(B, B, 4, ctx);
 
-    // C = 3*X^2 + a*Z^4
-    tors_elem_pow_ul(D, op->Z, 4, tors_ring, ctx);
+    // C = 3*X^2 + a*Z^4, réduit une seule fois
+    tors_elem_pow_ul(D, op->Z, 2, tors_ring, ctx);
+    tors_elem_mul_unreduced(D, D, D, tors_ring, ctx);
     tors_elem_mul_fq(D, D, tors_ring->curve->a, ctx);
 
-    tors_elem_pow_ul(C, op->X, 2, tors_ring, ctx);
+    tors_elem_mul_unreduced(C, op->X, op->X, tors_ring, ctx);
     tors_elem_mul_sl(C, C, 3, ctx);
 
     tors_elem_add(C, D, C, ctx);
+    tors_elem_reduce(C, C, tors_ring, ctx);
 
-    // X_3 = C^2 - 2*B
-    tors_elem_pow_ul(res->X, C, 2, tors_ring, ctx);  
+    // X_3 = C^2 - 2*B, réduit une seule fois
+    tors_elem_mul_unreduced(res->X, C, C, tors_ring, ctx);
     tors_elem_mul_sl(D, B, 2, ctx);
     tors_elem_sub(res->X, res->X, D, ctx);
+    tors_elem_reduce(res->X, res->X, tors_ring, ctx);
 
     // D = 8*A^2
-    tors_elem_pow_ul(D, A, 2, tors_ring, ctx);
+    tors_elem_mul_unreduced(D, A, A, tors_ring, ctx);
     tors_elem_mul_sl(D, D, 8, ctx);
 
-    // Y_3 = C*(B - X_3) - D
+    // Y_3 = C*(B - X_3) - D, réduit une seule fois
     tors_elem_sub(res->Y, B, res->X, ctx);
-    tors_elem_mul(res->Y, C, res->Y, tors_ring, ctx);
+    tors_elem_mul_unreduced(res->Y, C, res->Y, tors_ring, ctx);
     tors_elem_sub(res->Y, res->Y, D, ctx);
+    tors_elem_reduce(res->Y, res->Y, tors_ring, ctx);
 
     // Z_3 = 2*Y*Z
     tors_elem_mul(res->Z, op->Y, op->Z, tors_ring, ctx);
@@ -232,18 +236,20 @@ void ell_point_add(ell_point_t rop, const ell_point_t op1, const ell_point_t op2
         // G = 2*F
         tors_elem_mul_sl(G, F, 2, ctx);
 
-        // X_3 = B^2 - E - G
-        tors_elem_pow_ul(res->X, B, 2, tors_ring, ctx);
+        // X_3 = B^2 - E - G, réduit une seule fois
+        tors_elem_mul_unreduced(res->X, B, B, tors_ring, ctx);
         tors_elem_sub(res->X, res->X, E, ctx);
         tors_elem_sub(res->X, res->X, G, ctx);
+        tors_elem_reduce(res->X, res->X, tors_ring, ctx);
 
-        // G = H - E
-        tors_elem_mul(G, H, E, tors_ring, ctx);
+        // G = H*E
+        tors_elem_mul_unreduced(G, H, E, tors_ring, ctx);
 
-        // Y_3 = B*(F - X_3) - G
+        // Y_3 = B*(F - X_3) - G, réduit une seule fois
         tors_elem_sub(res->Y, F, res->X, ctx);
-        tors_elem_mul(res->Y, B, res->Y, tors_ring, ctx);
+        tors_elem_mul_unreduced(res->Y, B, res->Y, tors_ring, ctx);
         tors_elem_sub(res->Y, res->Y, G, ctx);
+        tors_elem_reduce(res->Y, res->Y, tors_ring, ctx);
 
         // Z_3 = A*E
         tors_elem_mul(res->Z, A, E, tors_ring, ctx);
@@ -268,21 +274,23 @@ void ell_point_add(ell_point_t rop, const ell_point_t op1, const ell_point_t op2
         tors_elem_mul(H, G, E, tors_ring, ctx);
         tors_elem_mul(I, op_jac->X, G, tors_ring, ctx);
 
-        // Calcul de X_3
-        tors_elem_pow_ul(res->X, F, 2, tors_ring, ctx);
+        // Calcul de X_3 = F^2 - (H + 2*I), réduit une seule fois
+        tors_elem_mul_unreduced(res->X, F, F, tors_ring, ctx);
 
         tors_elem_mul_sl(temp, I, 2, ctx);
         tors_elem_add(temp, H, temp, ctx);
 
         tors_elem_sub(res->X, res->X, temp, ctx);
+        tors_elem_reduce(res->X, res->X, tors_ring, ctx);
 
-        // Calcul de Y_3
+        // Calcul de Y_3 = F*(I - X_3) - Y*H, réduit une seule fois
         tors_elem_sub(res->Y, I, res->X, ctx);
-        tors_elem_mul(res->Y, F, res->Y, tors_ring, ctx);
+        tors_elem_mul_unreduced(res->Y, F, res->Y, tors_ring, ctx);
 
-        tors_elem_mul(temp, op_jac->Y, H, tors_ring, ctx);
+        tors_elem_mul_unreduced(temp, op_jac->Y, H, tors_ring, ctx);
 
         tors_elem_sub(res->Y, res->Y, temp, ctx);
+        tors_elem_reduce(res->Y, res->Y, tors_ring, ctx);
 
         // Calcul de Z_3
         tors_elem_mul(res->Z, op_jac->Z, E, tors_ring, ctx);
@@ -56,6 +56,28 @@ void list_ulong_get_tab(ulong* tab, const list_ulong_t list, const ulong len) {
     }
 }
 
+/**
+ * Renvoie la cellule numéro index de la liste, NULL si la liste est trop courte.
+ */
+cell_ulong_t* list_ulong_get_cell(const list_ulong_t list, const ulong index) {
+    for (cell_ulong_t* ptr = list->head; ptr != NULL; ptr = ptr->next) {
+        if (ptr->index == index) return ptr;
+    }
+
+    return NULL;
+}
+
+/**
+ * Renvoie la première cellule de la liste dont l'élément est un multiple non nul de d, NULL s'il n'y en a pas.
+ */
+cell_ulong_t* list_ulong_find_multiple(const list_ulong_t list, const ulong d) {
+    for (cell_ulong_t* ptr = list->head; ptr != NULL; ptr = ptr->next) {
+        if (ptr->t != 0 && ptr->t % d == 0) return ptr;
+    }
+
+    return NULL;
+}
+
 /*************************************/
 /* PRIMITIVES DU TYPE list_fq_poly_t */
 /*************************************/
@@ -63,6 +85,11 @@ void list_ulong_get_tab(ulong* tab, const list_ulong_t list, const ulong len) {
 void list_fq_poly_init(list_fq_poly_t list) {
     list->head = NULL;
     list->tail = NULL;
+    list->bytes = 0;
+    list->peak_bytes = 0;
+    list->evict_low = NULL;
+    list->evict_seen = NULL;
+    list->evict_l_min = 0;
 }
 
 void list_fq_poly_clear(list_fq_poly_t list, const fq_ctx_t ctx) {
@@ -79,6 +106,7 @@ void list_fq_poly_clear(list_fq_poly_t list, const fq_ctx_t ctx) {
     
     list->head = NULL;
     list->tail = NULL;
+    list->bytes = 0;
 }
 
 ulong list_fq_poly_len(const list_fq_poly_t list) {
@@ -94,7 +122,11 @@ void list_fq_poly_add(list_fq_poly_t list, fq_poly_t poly, const fq_ctx_t ctx) {
     cell_fq_poly_t* ptr = (cell_fq_poly_t*)malloc(sizeof(cell_fq_poly_t));
     fq_poly_init(ptr->poly, ctx);
     fq_poly_swap(ptr->poly, poly, ctx);
+    ptr->evicted = 0;
     ptr->next = NULL;
+
+    list->bytes += list_fq_poly_bytes(ptr->poly, ctx);
+    list->peak_bytes = FLINT_MAX(list->peak_bytes, list->bytes);
     
     if (list->head == NULL) {
         ptr->index = 0;
@@ -108,7 +140,8 @@ void list_fq_poly_add(list_fq_poly_t list, fq_poly_t poly, const fq_ctx_t ctx) {
 }
 
 /**
- * Renvoie l'élément de list d'indice index. Si list est de taille inférieure à index, génère une erreur.
+ * Renvoie l'élément de list d'indice index. Si list est de taille inférieure à index ou si l'élément a été
+ * libéré par list_fq_poly_evict(), génère une erreur.
  */
 fq_poly_struct* list_fq_poly_get(const list_fq_poly_t list, const ulong index) {
     cell_fq_poly_t* ptr = list->head;
@@ -122,5 +155,42 @@ fq_poly_struct* list_fq_poly_get(const list_fq_poly_t list, const ulong index) {
         abort();
     }
 
+    if (ptr->evicted) {
+        fprintf(stderr, "Error: evicted index\n");
+        abort();
+    }
+
     return ptr->poly;
+}
+
+/**
+ * Estimation de la mémoire occupée par les coefficients de poly, en supposant F_q premier : chaque
+ * coefficient alloué coûte un fq_struct et les limbs d'un entier de la taille de p.
+ */
+slong list_fq_poly_bytes(const fq_poly_t poly, const fq_ctx_t ctx) {
+    return poly->alloc * (sizeof(fq_struct) + fmpz_size(fq_ctx_prime(ctx)) * sizeof(ulong));
+}
+
+/**
+ * Libère le polynôme de la cellule ptr de list (la cellule est conservée pour garder la numérotation). Il est
+ * ensuite interdit d'y accéder par list_fq_poly_get().
+ */
+void list_fq_poly_evict(list_fq_poly_t list, cell_fq_poly_t* ptr, const fq_ctx_t ctx) {
+    if (ptr->evicted) return;
+
+    list->bytes -= list_fq_poly_bytes(ptr->poly, ctx);
+    fq_poly_clear(ptr->poly, ctx);
+    fq_poly_init(ptr->poly, ctx);
+    ptr->evicted = 1;
+}
+
+/**
+ * Renvoie 1 si l'élément d'indice index existe et a été libéré par list_fq_poly_evict(), 0 sinon.
+ */
+int list_fq_poly_is_evicted(const list_fq_poly_t list, const ulong index) {
+    for (cell_fq_poly_t* ptr = list->head; ptr != NULL; ptr = ptr->next) {
+        if (ptr->index == index) return ptr->evicted;
+    }
+
+    return 0;
 }
\ No newline at end of file
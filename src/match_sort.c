@@ -0,0 +1,345 @@
+#include "match_sort.h"
+
+/**************/
+/* PRIMITIVES */
+/**************/
+
+void match_sort_cand_init(match_sort_cand_t cand, const ulong modulus, const ulong* residues, const slong num) {
+    cand->modulus = modulus;
+    cand->num = num;
+    cand->residues = (ulong*)malloc(num * sizeof(ulong));
+    for (slong j = 0; j < num; j++) cand->residues[j] = residues[j];
+}
+
+void match_sort_cand_clear(match_sort_cand_t cand) {
+    free(cand->residues);
+    cand->residues = NULL;
+    cand->num = 0;
+}
+
+/**
+ * Calcule M = m_1 * prod m_i, les idempotents e_i (e_i ≡ 1 modulo m_i et ≡ 0 modulo les autres modules), puis
+ * les sauts entre classes consécutives de chaque module candidat et leurs multiples de P.
+ */
+void match_sort_steps_init(match_sort_steps_t steps, const fmpz_t t_1, const fmpz_t m_1, const match_sort_cand_struct* cands, const slong num_cands, const ell_fq_point_t P, const ell_curve_t E, const fq_ctx_t ctx) {
+    fmpz_t e, temp, modulus;
+    fmpz_init(e);
+    fmpz_init(temp);
+    fmpz_init(modulus);
+
+    steps->num_cands = num_cands;
+    fmpz_init_set(steps->M, m_1);
+    for (slong i = 0; i < num_cands; i++) fmpz_mul_ui(steps->M, steps->M, cands[i].modulus);
+
+    // c = t_1*e_1 mod M
+    fmpz_init(steps->c);
+    if (!fmpz_is_one(m_1)) {
+        fmpz_divexact(e, steps->M, m_1);
+        fmpz_invmod(temp, e, m_1);
+        fmpz_mul(e, e, temp);
+        fmpz_mul(steps->c, t_1, e);
+        fmpz_mod(steps->c, steps->c, steps->M);
+    }
+
+    ell_fq_point_init(steps->MP, ctx);
+    ell_fq_point_mul(steps->MP, P, steps->M, E, ctx);
+
+    steps->nums = (slong*)malloc(num_cands * sizeof(slong));
+    steps->start_val = _fmpz_vec_init(num_cands);
+    steps->delta_val = (fmpz**)malloc(num_cands * sizeof(fmpz*));
+    steps->delta = (ell_fq_point_struct**)malloc(num_cands * sizeof(ell_fq_point_struct*));
+
+    for (slong i = 0; i < num_cands; i++) {
+        slong num = cands[i].num;
+        steps->nums[i] = num;
+
+        // e_i = (M/m_i) * ((M/m_i)^{-1} mod m_i)
+        fmpz_set_ui(modulus, cands[i].modulus);
+        fmpz_divexact(e, steps->M, modulus);
+        fmpz_invmod(temp, e, modulus);
+        fmpz_mul(e, e, temp);
+
+        fmpz_mul_ui(steps->start_val + i, e, cands[i].residues[0]);
+        fmpz_mod(steps->start_val + i, steps->start_val + i, steps->M);
+
+        steps->delta_val[i] = _fmpz_vec_init(num);
+        steps->delta[i] = (ell_fq_point_struct*)malloc(num * sizeof(ell_fq_point_struct));
+
+        for (slong j = 0; j < num; j++) {
+            fmpz_set_ui(temp, cands[i].residues[(j + 1) % num]);
+            fmpz_sub_ui(temp, temp, cands[i].residues[j]);
+            fmpz_mul(temp, temp, e);
+            fmpz_mod(steps->delta_val[i] + j, temp, steps->M);
+
+            ell_fq_point_init(steps->delta[i] + j, ctx);
+            ell_fq_point_mul(steps->delta[i] + j, P, steps->delta_val[i] + j, E, ctx);
+        }
+    }
+
+    fmpz_clear(e);
+    fmpz_clear(temp);
+    fmpz_clear(modulus);
+}
+
+void match_sort_steps_clear(match_sort_steps_t steps, const fq_ctx_t ctx) {
+    for (slong i = 0; i < steps->num_cands; i++) {
+        for (slong j = 0; j < steps->nums[i]; j++) ell_fq_point_clear(steps->delta[i] + j, ctx);
+        free(steps->delta[i]);
+        _fmpz_vec_clear(steps->delta_val[i], steps->nums[i]);
+    }
+
+    free(steps->delta);
+    free(steps->delta_val);
+    _fmpz_vec_clear(steps->start_val, steps->num_cands);
+    free(steps->nums);
+
+    fmpz_clear(steps->M);
+    fmpz_clear(steps->c);
+    ell_fq_point_clear(steps->MP, ctx);
+}
+
+/**
+ * Place le compteur digits sur la première combinaison des modules candidats group[0..len-1] : value reçoit
+ * la somme des r_{i,0}*e_i réduite modulo M et point reçoit [value]P.
+ */
+void match_sort_first(slong* digits, fmpz_t value, ell_fq_point_t point, const slong* group, const slong len, const match_sort_steps_t steps, const ell_fq_point_t P, const ell_curve_t E, const fq_ctx_t ctx) {
+    fmpz_zero(value);
+
+    for (slong k = 0; k < len; k++) {
+        digits[k] = 0;
+        fmpz_add(value, value, steps->start_val + group[k]);
+    }
+
+    fmpz_mod(value, value, steps->M);
+    ell_fq_point_mul(point, P, value, E, ctx);
+}
+
+/**
+ * Passe à la combinaison suivante comme un compteur kilométrique, en ajoutant à value et point le saut du
+ * chiffre incrémenté (et de ceux qui reviennent à zéro), soit en moyenne moins de deux additions de points.
+ * value reste dans [0, M). Renvoie 0 quand le compteur est revenu à la première combinaison, 1 sinon.
+ */
+int match_sort_next(slong* digits, fmpz_t value, ell_fq_point_t point, const slong* group, const slong len, const match_sort_steps_t steps, const ell_curve_t E, const fq_ctx_t ctx) {
+    ell_fq_point_t neg_MP;
+    ell_fq_point_init(neg_MP, ctx);
+    ell_fq_point_neg(neg_MP, steps->MP, ctx);
+
+    int carry = 1;
+    for (slong k = 0; k < len && carry; k++) {
+        slong i = group[k];
+
+        fmpz_add(value, value, steps->delta_val[i] + digits[k]);
+        ell_fq_point_add(point, point, steps->delta[i] + digits[k], E, ctx);
+        if (fmpz_cmp(value, steps->M) >= 0) {
+            fmpz_sub(value, value, steps->M);
+            ell_fq_point_add(point, point, neg_MP, E, ctx);
+        }
+
+        digits[k] = (digits[k] + 1) % steps->nums[i];
+        carry = (digits[k] == 0);
+    }
+
+    ell_fq_point_clear(neg_MP, ctx);
+    return !carry;
+}
+
+/******************/
+/* MATCH AND SORT */
+/******************/
+
+/**
+ * Cherche, pour le point P, tous les N dans l'intervalle de Hasse compatibles avec a_q ≡ t_1 modulo m_1 et les
+ * classes candidates de cands, tels que [N]P = 0. Les modules candidats sont répartis entre le côté B, stocké
+ * dans une table de hachage avec les multiples k*M utiles, et le côté G, parcouru. On remplit B tant que sa
+ * taille ne dépasse ni MATCH_SORT_MAX_TABLE ni la racine carrée du nombre total de combinaisons.
+ * Les N trouvés sont écrits dans matches (initialisés par l'appelant). Renvoie leur nombre, ou -1 s'il y en a
+ * plus de max_matches ou si la table ne peut pas contenir les multiples de M.
+ */
+slong match_sort_point(fmpz* matches, const slong max_matches, const fmpz_t t_1, const fmpz_t m_1, const match_sort_cand_struct* cands, const slong num_cands, const ell_fq_point_t P, const ell_curve_t E, const fq_ctx_t ctx) {
+    match_sort_steps_t steps;
+    match_sort_steps_init(steps, t_1, m_1, cands, num_cands, P, E, ctx);
+
+    fmpz_t q, t_max, k, k_max, temp, t;
+    fmpz_init(q);
+    fmpz_init(t_max);
+    fmpz_init(k);
+    fmpz_init(k_max);
+    fmpz_init(temp);
+    fmpz_init(t);
+    fq_ctx_order(q, ctx);
+    fmpz_mul_ui(t_max, q, 4);
+    fmpz_sqrt(t_max, t_max);
+
+    // a_q = c + g + b + k*M avec c + g + b dans [0, 3M), d'où -t_max - 3M < k*M <= t_max
+    fmpz_mul_ui(temp, steps->M, 3);
+    fmpz_add(temp, temp, t_max);
+    fmpz_neg(temp, temp);
+    fmpz_cdiv_q(k, temp, steps->M);
+    fmpz_fdiv_q(k_max, t_max, steps->M);
+    fmpz_sub(temp, k_max, k);
+    double num_k = fmpz_get_d(temp) + 1;
+
+    // Répartition des modules candidats entre les côtés B et G
+    double total = num_k;
+    for (slong i = 0; i < num_cands; i++) total *= cands[i].num;
+
+    slong* group_B = (slong*)malloc((num_cands + 1) * sizeof(slong));
+    slong* group_G = (slong*)malloc((num_cands + 1) * sizeof(slong));
+    slong len_B = 0, len_G = 0;
+    double size_B = num_k;
+
+    for (slong i = 0; i < num_cands; i++) {
+        double new_size = size_B * cands[i].num;
+        if (new_size <= MATCH_SORT_MAX_TABLE && new_size * new_size <= total) {
+            group_B[len_B++] = i;
+            size_B = new_size;
+        } else {
+            group_G[len_G++] = i;
+        }
+    }
+
+    slong num_matches = 0;
+
+    if (size_B > MATCH_SORT_MAX_TABLE) {
+        num_matches = -1;
+    } else {
+        slong n_B = (slong)size_B;
+        slong* digits = (slong*)malloc((num_cands + 1) * sizeof(slong));
+
+        fmpz_t value;
+        fmpz_init(value);
+
+        ell_fq_point_t point, kMP, T, Q_c;
+        ell_fq_point_init(point, ctx);
+        ell_fq_point_init(kMP, ctx);
+        ell_fq_point_init(T, ctx);
+        ell_fq_point_init(Q_c, ctx);
+
+        // Côté B : b = v + k*M et [b]P pour toutes les combinaisons v et tous les k
+        fmpz* vals_B = _fmpz_vec_init(n_B);
+        ell_fq_point_struct* points_B = (ell_fq_point_struct*)malloc(n_B * sizeof(ell_fq_point_struct));
+        slong pos = 0;
+
+        ell_fq_point_mul(kMP, P, k, E, ctx);
+        ell_fq_point_mul(kMP, kMP, steps->M, E, ctx);
+
+        for (; fmpz_cmp(k, k_max) <= 0; fmpz_add_ui(k, k, 1)) {
+            match_sort_first(digits, value, point, group_B, len_B, steps, P, E, ctx);
+            do {
+                fmpz_mul(vals_B + pos, k, steps->M);
+                fmpz_add(vals_B + pos, vals_B + pos, value);
+                ell_fq_point_init(points_B + pos, ctx);
+                ell_fq_point_add(points_B + pos, point, kMP, E, ctx);
+                pos++;
+            } while (match_sort_next(digits, value, point, group_B, len_B, steps, E, ctx));
+
+            ell_fq_point_add(kMP, kMP, steps->MP, E, ctx);
+        }
+
+        // Table de hachage à adressage ouvert des [b]P
+        slong table_size = 1;
+        while (table_size < 2*n_B) table_size <<= 1;
+        slong* table = (slong*)malloc(table_size * sizeof(slong));
+        for (slong i = 0; i < table_size; i++) table[i] = -1;
+
+        for (slong i = 0; i < n_B; i++) {
+            ulong h = ell_fq_point_hash(points_B + i, ctx) & (table_size - 1);
+            while (table[h] != -1) h = (h + 1) & (table_size - 1);
+            table[h] = i;
+        }
+
+        // Côté G : T = [q + 1 - c - g]P, comparé aux [b]P de même abscisse
+        fmpz_add_ui(temp, q, 1);
+        fmpz_sub(temp, temp, steps->c);
+        ell_fq_point_mul(Q_c, P, temp, E, ctx);
+
+        match_sort_first(digits, value, point, group_G, len_G, steps, P, E, ctx);
+        do {
+            ell_fq_point_neg(T, point, ctx);
+            ell_fq_point_add(T, T, Q_c, E, ctx);
+
+            ulong h = ell_fq_point_hash(T, ctx) & (table_size - 1);
+            for (; table[h] != -1 && num_matches >= 0; h = (h + 1) & (table_size - 1)) {
+                if (!ell_fq_point_equal(points_B + table[h], T, ctx)) continue;
+
+                // a_q = c + g + b, on ne garde que ceux de l'intervalle de Hasse
+                fmpz_add(t, steps->c, value);
+                fmpz_add(t, t, vals_B + table[h]);
+                fmpz_abs(temp, t);
+                if (fmpz_cmp(temp, t_max) > 0) continue;
+
+                if (num_matches == max_matches) {
+                    num_matches = -1;
+                } else {
+                    fmpz_add_ui(matches + num_matches, q, 1);
+                    fmpz_sub(matches + num_matches, matches + num_matches, t);
+                    num_matches++;
+                }
+            }
+        } while (num_matches >= 0 && match_sort_next(digits, value, point, group_G, len_G, steps, E, ctx));
+
+        for (slong i = 0; i < n_B; i++) ell_fq_point_clear(points_B + i, ctx);
+        free(points_B);
+        _fmpz_vec_clear(vals_B, n_B);
+        free(table);
+        free(digits);
+        fmpz_clear(value);
+        ell_fq_point_clear(point, ctx);
+        ell_fq_point_clear(kMP, ctx);
+        ell_fq_point_clear(T, ctx);
+        ell_fq_point_clear(Q_c, ctx);
+    }
+
+    free(group_B);
+    free(group_G);
+    match_sort_steps_clear(steps, ctx);
+    fmpz_clear(q);
+    fmpz_clear(t_max);
+    fmpz_clear(k);
+    fmpz_clear(k_max);
+    fmpz_clear(temp);
+    fmpz_clear(t);
+    return num_matches;
+}
+
+/**
+ * Retrouve le nombre de points N sachant a_q ≡ t_1 modulo m_1 et a_q modulo cands[i].modulus parmi
+ * cands[i].residues : un premier point aléatoire donne les N candidats (c.f match_sort_point()), les points
+ * suivants éliminent ceux qui ne les annulent pas. Le vrai N annule tous les points, il n'est jamais éliminé.
+ * Renvoie 1 et affecte N à res s'il ne reste qu'un candidat après au plus MATCH_SORT_POINTS points, 0 sinon.
+ */
+int match_sort(fmpz_t res, const fmpz_t t_1, const fmpz_t m_1, const match_sort_cand_struct* cands, const slong num_cands, const ell_curve_t E, const fq_ctx_t ctx) {
+    flint_rand_t state;
+    flint_randinit(state);
+
+    ell_fq_point_t P, R;
+    ell_fq_point_init(P, ctx);
+    ell_fq_point_init(R, ctx);
+
+    fmpz* matches = _fmpz_vec_init(MATCH_SORT_MAX_MATCHES);
+    slong num_matches = -1; // Inconnu tant qu'aucun point n'a permis de conclure
+
+    for (slong i = 0; i < MATCH_SORT_POINTS && num_matches != 1; i++) {
+        ell_fq_point_random(P, E, state, ctx);
+
+        if (num_matches < 0) {
+            num_matches = match_sort_point(matches, MATCH_SORT_MAX_MATCHES, t_1, m_1, cands, num_cands, P, E, ctx);
+        } else {
+            slong num_kept = 0;
+            for (slong j = 0; j < num_matches; j++) {
+                ell_fq_point_mul(R, P, matches + j, E, ctx);
+                if (R->infinity) fmpz_swap(matches + num_kept++, matches + j);
+            }
+            num_matches = num_kept;
+        }
+    }
+
+    int success = (num_matches == 1);
+    if (success) fmpz_set(res, matches);
+
+    _fmpz_vec_clear(matches, MATCH_SORT_MAX_MATCHES);
+    ell_fq_point_clear(P, ctx);
+    ell_fq_point_clear(R, ctx);
+    flint_randclear(state);
+    return success;
+}
\ No newline at end of file
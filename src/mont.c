@@ -0,0 +1,305 @@
+#include "mont.h"
+
+/**************/
+/* PRIMITIVES */
+/**************/
+
+/**
+ * Initialise le contexte de Montgomery de F_p si q = p est premier de 2, 4 ou 8 limbs, sinon ctx->limbs = 0
+ * et aucune fonction de ce fichier ne doit être utilisée.
+ */
+void mont_ctx_init(mont_ctx_t mont, const fq_ctx_t ctx) {
+    const fmpz* p = fq_ctx_prime(ctx);
+    flint_bitcnt_t bits = fmpz_bits(p);
+
+    memset(mont, 0, sizeof(mont_ctx_struct));
+    if (fq_ctx_degree(ctx) != 1 || bits <= FLINT_BITS || bits > MONT_MAX_LIMBS * FLINT_BITS) return;
+
+    mont->limbs = 2;
+    while ((flint_bitcnt_t)(mont->limbs * FLINT_BITS) < bits) mont->limbs *= 2;
+
+    fmpz_get_ui_array(mont->p, mont->limbs, p);
+
+    // Inverse de p modulo 2^FLINT_BITS par Newton, chaque itération double le nombre de bits corrects
+    ulong inv = 1;
+    for (int i = 0; i < 6; i++) inv *= 2 - mont->p[0] * inv;
+    mont->p_inv = -inv;
+
+    fmpz_t r2;
+    fmpz_init(r2);
+    fmpz_one(r2);
+    fmpz_mul_2exp(r2, r2, 2 * FLINT_BITS * mont->limbs);
+    fmpz_mod(r2, r2, p);
+    fmpz_get_ui_array(mont->r2, mont->limbs, r2);
+    fmpz_clear(r2);
+}
+
+/**
+ * op doit être dans [0, p-1].
+ */
+void mont_set_fmpz(ulong* rop, const fmpz_t op, const mont_ctx_t mont) {
+    fmpz_get_ui_array(rop, mont->limbs, op);
+
+    switch (mont->limbs) {
+        case 2: mont2_mul(rop, rop, mont->r2, mont); break;
+        case 4: mont4_mul(rop, rop, mont->r2, mont); break;
+        default: mont8_mul(rop, rop, mont->r2, mont); break;
+    }
+}
+
+void mont_get_fmpz(fmpz_t rop, const ulong* op, const mont_ctx_t mont) {
+    ulong one[MONT_MAX_LIMBS] = {1};
+    ulong res[MONT_MAX_LIMBS];
+
+    switch (mont->limbs) {
+        case 2: mont2_mul(res, op, one, mont); break;
+        case 4: mont4_mul(res, op, one, mont); break;
+        default: mont8_mul(res, op, one, mont); break;
+    }
+
+    fmpz_set_ui_array(rop, res, mont->limbs);
+}
+
+/****************************/
+/* ARITHMETIQUE PAR LARGEUR */
+/****************************/
+
+/**
+ * Les entrées et sorties sont dans [0, p-1] et peuvent se recouvrir. mont##N##_mul() utilise la méthode CIOS
+ * (Coarsely Integrated Operand Scanning) : la réduction de Montgomery est entrelacée avec le produit, limb
+ * par limb, dans un tampon de N+2 limbs.
+ * Les polynômes de _mont##N##_poly_mul() et _mont##N##_poly_sqr() ne doivent pas recouvrir le résultat,
+ * _mont##N##_poly_rem() réduit en place modulo un polynôme unitaire.
+ */
+#define MONT_DEFINE(N) \
+    void mont##N##_add(ulong* rop, const ulong* op1, const ulong* op2, const mont_ctx_t mont) { \
+        ulong res[N], red[N]; \
+        ulong carry = 0, borrow = 0; \
+        _Pragma("GCC unroll 8") \
+        for (slong i = 0; i < N; i++) { \
+            add_ssaaaa(carry, res[i], 0, op1[i], 0, carry); \
+            add_ssaaaa(carry, res[i], carry, res[i], 0, op2[i]); \
+        } \
+        _Pragma("GCC unroll 8") \
+        for (slong i = 0; i < N; i++) { \
+            ulong b1 = (res[i] < mont->p[i]); \
+            red[i] = res[i] - mont->p[i]; \
+            ulong b2 = (red[i] < borrow); \
+            red[i] -= borrow; \
+            borrow = b1 | b2; \
+        } \
+        /* On garde res - p si res >= p, c'est-à-dire s'il y a eu une retenue ou pas d'emprunt */ \
+        ulong mask = -(ulong)(carry | !borrow); \
+        _Pragma("GCC unroll 8") \
+        for (slong i = 0; i < N; i++) rop[i] = (red[i] & mask) | (res[i] & ~mask); \
+    } \
+    \
+    void mont##N##_sub(ulong* rop, const ulong* op1, const ulong* op2, const mont_ctx_t mont) { \
+        ulong res[N]; \
+        ulong borrow = 0, carry = 0; \
+        _Pragma("GCC unroll 8") \
+        for (slong i = 0; i < N; i++) { \
+            ulong b1 = (op1[i] < op2[i]); \
+            res[i] = op1[i] - op2[i]; \
+            ulong b2 = (res[i] < borrow); \
+            res[i] -= borrow; \
+            borrow = b1 | b2; \
+        } \
+        /* En cas d'emprunt, on ajoute p */ \
+        ulong mask = -borrow; \
+        _Pragma("GCC unroll 8") \
+        for (slong i = 0; i < N; i++) { \
+            add_ssaaaa(carry, rop[i], 0, res[i], 0, carry); \
+            add_ssaaaa(carry, rop[i], carry, rop[i], 0, mont->p[i] & mask); \
+        } \
+    } \
+    \
+    void mont##N##_mul(ulong* rop, const ulong* op1, const ulong* op2, const mont_ctx_t mont) { \
+        ulong t[N + 2] = {0}; \
+        ulong hi, lo, carry; \
+        _Pragma("GCC unroll 8") \
+        for (slong i = 0; i < N; i++) { \
+            /* t += op1 * op2[i] */ \
+            carry = 0; \
+            _Pragma("GCC unroll 8") \
+            for (slong j = 0; j < N; j++) { \
+                umul_ppmm(hi, lo, op1[j], op2[i]); \
+                add_ssaaaa(hi, lo, hi, lo, 0, t[j]); \
+                add_ssaaaa(hi, lo, hi, lo, 0, carry); \
+                t[j] = lo; \
+                carry = hi; \
+            } \
+            add_ssaaaa(t[N + 1], t[N], 0, t[N], 0, carry); \
+            \
+            /* t = (t + m*p) / 2^FLINT_BITS, où m annule le limb de poids faible */ \
+            ulong m = t[0] * mont->p_inv; \
+            umul_ppmm(hi, lo, m, mont->p[0]); \
+            add_ssaaaa(hi, lo, hi, lo, 0, t[0]); \
+            carry = hi; \
+            _Pragma("GCC unroll 8") \
+            for (slong j = 1; j < N; j++) { \
+                umul_ppmm(hi, lo, m, mont->p[j]); \
+                add_ssaaaa(hi, lo, hi, lo, 0, t[j]); \
+                add_ssaaaa(hi, lo, hi, lo, 0, carry); \
+                t[j - 1] = lo; \
+                carry = hi; \
+            } \
+            add_ssaaaa(carry, t[N - 1], 0, t[N], 0, carry); \
+            t[N] = t[N + 1] + carry; \
+        } \
+        /* t < 2p, on soustrait p si besoin */ \
+        ulong red[N]; \
+        ulong borrow = 0; \
+        _Pragma("GCC unroll 8") \
+        for (slong i = 0; i < N; i++) { \
+            ulong b1 = (t[i] < mont->p[i]); \
+            red[i] = t[i] - mont->p[i]; \
+            ulong b2 = (red[i] < borrow); \
+            red[i] -= borrow; \
+            borrow = b1 | b2; \
+        } \
+        ulong mask = -(ulong)(t[N] | !borrow); \
+        _Pragma("GCC unroll 8") \
+        for (slong i = 0; i < N; i++) rop[i] = (red[i] & mask) | (t[i] & ~mask); \
+    } \
+    \
+    void _mont##N##_poly_mul(ulong* rop, const ulong* op1, const slong len1, const ulong* op2, const slong len2, const mont_ctx_t mont) { \
+        ulong temp[N]; \
+        memset(rop, 0, (len1 + len2 - 1) * N * sizeof(ulong)); \
+        for (slong i = 0; i < len1; i++) { \
+            for (slong j = 0; j < len2; j++) { \
+                mont##N##_mul(temp, op1 + i*N, op2 + j*N, mont); \
+                mont##N##_add(rop + (i + j)*N, rop + (i + j)*N, temp, mont); \
+            } \
+        } \
+    } \
+    \
+    void _mont##N##_poly_sqr(ulong* rop, const ulong* op, const slong len, const mont_ctx_t mont) { \
+        ulong temp[N]; \
+        memset(rop, 0, (2*len - 1) * N * sizeof(ulong)); \
+        /* Les produits croisés ne sont calculés qu'une fois puis doublés */ \
+        for (slong i = 0; i < len; i++) { \
+            for (slong j = i + 1; j < len; j++) { \
+                mont##N##_mul(temp, op + i*N, op + j*N, mont); \
+                mont##N##_add(rop + (i + j)*N, rop + (i + j)*N, temp, mont); \
+            } \
+        } \
+        for (slong i = 0; i < 2*len - 1; i++) mont##N##_add(rop + i*N, rop + i*N, rop + i*N, mont); \
+        for (slong i = 0; i < len; i++) { \
+            mont##N##_mul(temp, op + i*N, op + i*N, mont); \
+            mont##N##_add(rop + 2*i*N, rop + 2*i*N, temp, mont); \
+        } \
+    } \
+    \
+    void _mont##N##_poly_rem(ulong* op, const slong len, const ulong* psi, const slong len_psi, const mont_ctx_t mont) { \
+        ulong c[N], temp[N]; \
+        for (slong i = len - 1; i >= len_psi - 1; i--) { \
+            /* On retire c*x^(i-deg psi)*psi, psi étant unitaire */ \
+            memcpy(c, op + i*N, N * sizeof(ulong)); \
+            ulong* shift = op + (i - len_psi + 1)*N; \
+            for (slong j = 0; j < len_psi - 1; j++) { \
+                mont##N##_mul(temp, c, psi + j*N, mont); \
+                mont##N##_sub(shift + j*N, shift + j*N, temp, mont); \
+            } \
+        } \
+    }
+
+MONT_DEFINE(2)
+MONT_DEFINE(4)
+MONT_DEFINE(8)
+
+/***************************/
+/* POLYNOMES DE MONTGOMERY */
+/***************************/
+
+/**
+ * Écrit les len premiers coefficients de op (complétés par des zéros) dans rop, en représentation de Montgomery.
+ */
+void mont_poly_set_fq_poly(ulong* rop, const fq_poly_t op, const slong len, const mont_ctx_t mont, const fq_ctx_t ctx) {
+    fmpz_t c;
+    fmpz_init(c);
+
+    slong len_op = FLINT_MIN(len, fq_poly_length(op, ctx));
+    for (slong i = 0; i < len_op; i++) {
+        fq_get_fmpz(c, op->coeffs + i, ctx);
+        mont_set_fmpz(rop + i*mont->limbs, c, mont);
+    }
+    memset(rop + len_op*mont->limbs, 0, (len - len_op) * mont->limbs * sizeof(ulong));
+
+    fmpz_clear(c);
+}
+
+void mont_poly_get_fq_poly(fq_poly_t rop, const ulong* op, const slong len, const mont_ctx_t mont, const fq_ctx_t ctx) {
+    fmpz_t c;
+    fmpz_init(c);
+
+    fq_poly_fit_length(rop, len, ctx);
+    for (slong i = 0; i < len; i++) {
+        mont_get_fmpz(c, op + i*mont->limbs, mont);
+        fq_set_fmpz(rop->coeffs + i, c, ctx);
+    }
+    for (slong i = len; i < fq_poly_length(rop, ctx); i++) fq_zero(rop->coeffs + i, ctx);
+    _fq_poly_set_length(rop, len, ctx);
+    _fq_poly_normalise(rop, ctx);
+
+    fmpz_clear(c);
+}
+
+/**
+ * rop = op1*op2, de longueur len1+len2-1 >= 1, sans recouvrement. Si op1 et op2 sont le même tableau de même
+ * longueur, on utilise l'élévation au carré.
+ */
+void mont_poly_mul(ulong* rop, const ulong* op1, const slong len1, const ulong* op2, const slong len2, const mont_ctx_t mont) {
+    int sqr = (op1 == op2 && len1 == len2);
+
+    switch (mont->limbs) {
+        case 2:
+            if (sqr) _mont2_poly_sqr(rop, op1, len1, mont); else _mont2_poly_mul(rop, op1, len1, op2, len2, mont);
+            break;
+        case 4:
+            if (sqr) _mont4_poly_sqr(rop, op1, len1, mont); else _mont4_poly_mul(rop, op1, len1, op2, len2, mont);
+            break;
+        default:
+            if (sqr) _mont8_poly_sqr(rop, op1, len1, mont); else _mont8_poly_mul(rop, op1, len1, op2, len2, mont);
+            break;
+    }
+}
+
+/**
+ * Réduit en place op, de longueur len, modulo psi unitaire de longueur len_psi : le reste occupe les
+ * len_psi-1 premiers coefficients (les suivants sont sans signification).
+ */
+void mont_poly_rem(ulong* op, const slong len, const ulong* psi, const slong len_psi, const mont_ctx_t mont) {
+    if (len < len_psi) return;
+
+    switch (mont->limbs) {
+        case 2: _mont2_poly_rem(op, len, psi, len_psi, mont); break;
+        case 4: _mont4_poly_rem(op, len, psi, len_psi, mont); break;
+        default: _mont8_poly_rem(op, len, psi, len_psi, mont); break;
+    }
+}
+
+/**
+ * rop = op1*op2 mod psi, où psi est unitaire de longueur len_psi >= 2. rop reçoit len_psi-1 coefficients et peut
+ * recouvrir op1 ou op2.
+ */
+void mont_poly_mulmod(ulong* rop, const ulong* op1, const slong len1, const ulong* op2, const slong len2, const ulong* psi, const slong len_psi, const mont_ctx_t mont) {
+    const slong N = mont->limbs;
+
+    if (len1 == 0 || len2 == 0) {
+        memset(rop, 0, (len_psi - 1) * N * sizeof(ulong));
+        return;
+    }
+
+    slong len = len1 + len2 - 1;
+    ulong* prod = (ulong*)flint_malloc(len * N * sizeof(ulong));
+
+    mont_poly_mul(prod, op1, len1, op2, len2, mont);
+    mont_poly_rem(prod, len, psi, len_psi, mont);
+
+    slong len_res = FLINT_MIN(len, len_psi - 1);
+    memcpy(rop, prod, len_res * N * sizeof(ulong));
+    memset(rop + len_res*N, 0, (len_psi - 1 - len_res) * N * sizeof(ulong));
+
+    flint_free(prod);
+}
\ No newline at end of file
@@ -0,0 +1,103 @@
+#include "prod_tree.h"
+
+/**
+ * Construit l'arbre des produits des n polynômes moduli[0], ..., moduli[n-1] (n >= 1), qui sont copiés.
+ */
+void prod_tree_init(prod_tree_t tree, fq_poly_struct* const* moduli, const slong n, const fq_ctx_t ctx) {
+    // Nombre de niveaux : 1 + ceil(log2(n))
+    slong depth = 1;
+    for (slong m = n; m > 1; m = (m + 1) / 2) depth++;
+
+    tree->depth = depth;
+    tree->levels = (fq_poly_struct**)malloc(depth * sizeof(fq_poly_struct*));
+    tree->len = (slong*)malloc(depth * sizeof(slong));
+
+    tree->len[0] = n;
+    tree->levels[0] = (fq_poly_struct*)malloc(n * sizeof(fq_poly_struct));
+    for (slong i = 0; i < n; i++) {
+        fq_poly_init(tree->levels[0] + i, ctx);
+        fq_poly_set(tree->levels[0] + i, moduli[i], ctx);
+    }
+
+    for (slong k = 1; k < depth; k++) {
+        slong m = tree->len[k-1];
+        tree->len[k] = (m + 1) / 2;
+        tree->levels[k] = (fq_poly_struct*)malloc(tree->len[k] * sizeof(fq_poly_struct));
+
+        for (slong i = 0; i < tree->len[k]; i++) {
+            fq_poly_init(tree->levels[k] + i, ctx);
+
+            if (2*i + 1 < m) {
+                fq_poly_mul(tree->levels[k] + i, tree->levels[k-1] + 2*i, tree->levels[k-1] + 2*i + 1, ctx);
+            } else {
+                fq_poly_set(tree->levels[k] + i, tree->levels[k-1] + 2*i, ctx);
+            }
+        }
+    }
+}
+
+void prod_tree_clear(prod_tree_t tree, const fq_ctx_t ctx) {
+    for (slong k = 0; k < tree->depth; k++) {
+        for (slong i = 0; i < tree->len[k]; i++) fq_poly_clear(tree->levels[k] + i, ctx);
+        free(tree->levels[k]);
+    }
+
+    free(tree->levels);
+    free(tree->len);
+}
+
+/**
+ * Renvoie le produit de tous les polynômes de l'arbre.
+ */
+fq_poly_struct* prod_tree_root(const prod_tree_t tree) {
+    return tree->levels[tree->depth - 1];
+}
+
+/**
+ * Arbre des restes : affecte à res[i] le reste de op modulo le i-ème polynôme de l'arbre, en réduisant op
+ * successivement modulo les noeuds de la racine vers les feuilles. res doit contenir tree->len[0] polynômes
+ * initialisés.
+ * Si stop n'est pas NULL, il est consulté entre deux niveaux : renvoie 0, res étant alors non défini, si une
+ * interruption est constatée (c.f tors_stop_check()), 1 sinon.
+ */
+int prod_tree_rem(fq_poly_struct* res, const fq_poly_t op, const prod_tree_t tree, tors_stop_struct* stop, const fq_ctx_t ctx) {
+    slong n = tree->len[0];
+
+    // Restes du niveau courant et du niveau inférieur
+    fq_poly_struct* cur = (fq_poly_struct*)malloc(n * sizeof(fq_poly_struct));
+    fq_poly_struct* next = (fq_poly_struct*)malloc(n * sizeof(fq_poly_struct));
+    fq_poly_struct* swap;
+
+    for (slong i = 0; i < n; i++) {
+        fq_poly_init(cur + i, ctx);
+        fq_poly_init(next + i, ctx);
+    }
+
+    fq_poly_rem(cur, op, prod_tree_root(tree), ctx);
+
+    int done = 1;
+    for (slong k = tree->depth - 1; k > 0; k--) {
+        if (stop != NULL && tors_stop_check(stop)) {
+            done = 0;
+            break;
+        }
+
+        for (slong i = 0; i < tree->len[k-1]; i++) {
+            fq_poly_rem(next + i, cur + i / 2, tree->levels[k-1] + i, ctx);
+        }
+
+        swap = cur;
+        cur = next;
+        next = swap;
+    }
+
+    for (slong i = 0; i < n; i++) {
+        fq_poly_swap(res + i, cur + i, ctx);
+        fq_poly_clear(cur + i, ctx);
+        fq_poly_clear(next + i, ctx);
+    }
+
+    free(cur);
+    free(next);
+    return done;
+}
\ No newline at end of file
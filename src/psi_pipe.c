@@ -0,0 +1,150 @@
+#include "psi_pipe.h"
+
+/**
+ * Démarre le producteur, qui déposera ψ_l pour les premiers l <= l_max dans une file de depth éléments et
+ * calculera ses ψ_m avec threads threads. Si le thread ne peut pas être créé, la file reste vide (c.f
+ * psi_pipe_pop()).
+ */
+void psi_pipe_init(psi_pipe_t pipe, const ell_curve_t E, const ulong l_max, const slong depth, const slong threads, const fq_ctx_t ctx) {
+    pthread_mutex_init(&pipe->mutex, NULL);
+    pthread_cond_init(&pipe->not_empty, NULL);
+    pthread_cond_init(&pipe->not_full, NULL);
+
+    pipe->depth = FLINT_MAX(depth, 1);
+    pipe->primes = (ulong*)malloc(pipe->depth * sizeof(ulong));
+    pipe->polys = (const fq_poly_struct**)malloc(pipe->depth * sizeof(const fq_poly_struct*));
+    pipe->head = 0;
+    pipe->len = 0;
+    pipe->stop = 0;
+    pipe->done = 0;
+    pipe->l_max = l_max;
+    pipe->l_used = 0;
+    pipe->threads = threads;
+    list_fq_poly_init(pipe->list_psi);
+    pipe->E = E;
+    pipe->ctx = ctx;
+
+    pipe->running = (pthread_create(&pipe->thread, NULL, psi_pipe_producer, pipe) == 0);
+    if (!pipe->running) pipe->done = 1;
+}
+
+void psi_pipe_clear(psi_pipe_t pipe, const fq_ctx_t ctx) {
+    psi_pipe_stop(pipe);
+
+    free(pipe->primes);
+    free(pipe->polys);
+    list_fq_poly_clear(pipe->list_psi, ctx);
+    pthread_mutex_destroy(&pipe->mutex);
+    pthread_cond_destroy(&pipe->not_empty);
+    pthread_cond_destroy(&pipe->not_full);
+}
+
+int psi_pipe_stopped(psi_pipe_t pipe) {
+    pthread_mutex_lock(&pipe->mutex);
+    int stop = pipe->stop;
+    pthread_mutex_unlock(&pipe->mutex);
+    return stop;
+}
+
+/**
+ * Libère les ψ_m du producteur qui ne serviront plus (c.f evict_list_div_poly()) : ceux dont ne dépend aucun
+ * des prochains ψ_m, sauf les ψ_l déposés ou encore utilisés par ell_schoof(), c'est-à-dire avec l >= l_used.
+ */
+void psi_pipe_trim(psi_pipe_t pipe) {
+    pthread_mutex_lock(&pipe->mutex);
+    ulong l_used = pipe->l_used;
+    pthread_mutex_unlock(&pipe->mutex);
+
+    evict_list_div_poly(pipe->list_psi, l_used, pipe->l_max, pipe->ctx);
+}
+
+/**
+ * Complète les ψ_m du producteur jusqu'à ψ_n, en libérant ceux qui ne servent plus (c.f psi_pipe_trim()). Sans
+ * threads supplémentaires, ils sont calculés un par un pour que l'arrêt soit pris en compte entre deux. Renvoie 0
+ * si l'arrêt a été demandé.
+ */
+int psi_pipe_extend(psi_pipe_t pipe, const ulong n) {
+    if (pipe->threads > 1) {
+        update_list_div_poly_threads(pipe->list_psi, pipe->E, n, pipe->threads, pipe->ctx);
+        psi_pipe_trim(pipe);
+    } else {
+        for (ulong m = list_fq_poly_len(pipe->list_psi); m <= n && !psi_pipe_stopped(pipe); m++) {
+            update_list_div_poly(pipe->list_psi, pipe->E, m, pipe->ctx);
+            psi_pipe_trim(pipe);
+        }
+    }
+
+    return !psi_pipe_stopped(pipe);
+}
+
+void* psi_pipe_producer(void* arg) {
+    psi_pipe_struct* pipe = (psi_pipe_struct*)arg;
+
+    for (ulong l = 3; l <= pipe->l_max; l = n_nextprime(l, 1)) {
+        if (fmpz_equal_ui(fq_ctx_prime(pipe->ctx), l)) continue;
+        if (!psi_pipe_extend(pipe, l)) break;
+
+        // Attente d'une place dans la file
+        pthread_mutex_lock(&pipe->mutex);
+        while (!pipe->stop && pipe->len == pipe->depth) pthread_cond_wait(&pipe->not_full, &pipe->mutex);
+        if (pipe->stop) {
+            pthread_mutex_unlock(&pipe->mutex);
+            break;
+        }
+
+        slong slot = (pipe->head + pipe->len) % pipe->depth;
+        pipe->primes[slot] = l;
+        pipe->polys[slot] = list_fq_poly_get(pipe->list_psi, l);
+        pipe->len++;
+        pthread_cond_signal(&pipe->not_empty);
+        pthread_mutex_unlock(&pipe->mutex);
+    }
+
+    pthread_mutex_lock(&pipe->mutex);
+    pipe->done = 1;
+    pthread_cond_signal(&pipe->not_empty);
+    pthread_mutex_unlock(&pipe->mutex);
+
+    flint_cleanup(); // Libère les caches propres au thread
+    return NULL;
+}
+
+/**
+ * Renvoie ψ_l, en attendant au besoin que le producteur l'ait calculé, après avoir retiré de la file les ψ des
+ * premiers plus petits que ell_schoof() a sautés (déjà traités ou relus d'un fichier de reprise). Renvoie NULL si
+ * le producteur a fini sans produire ψ_l : ψ_l doit alors être calculé autrement. Le résultat reste valable
+ * jusqu'au prochain appel ou jusqu'à psi_pipe_clear() : les ψ des premiers plus petits que l sont libérés par le
+ * producteur (c.f psi_pipe_trim()).
+ */
+const fq_poly_struct* psi_pipe_pop(psi_pipe_t pipe, const ulong l) {
+    const fq_poly_struct* res = NULL;
+
+    pthread_mutex_lock(&pipe->mutex);
+    pipe->l_used = l;
+    while (res == NULL) {
+        while (pipe->len == 0 && !pipe->done) pthread_cond_wait(&pipe->not_empty, &pipe->mutex);
+        if (pipe->len == 0 || pipe->primes[pipe->head] > l) break;
+
+        if (pipe->primes[pipe->head] == l) res = pipe->polys[pipe->head];
+        pipe->head = (pipe->head + 1) % pipe->depth;
+        pipe->len--;
+        pthread_cond_signal(&pipe->not_full);
+    }
+    pthread_mutex_unlock(&pipe->mutex);
+
+    return res;
+}
+
+/**
+ * Arrête le producteur (au plus tard après le ψ_m en cours, ou après ψ_l pour le prochain l s'il calcule
+ * avec plusieurs threads) et l'attend. Ses ψ_m restent disponibles jusqu'à psi_pipe_clear().
+ */
+void psi_pipe_stop(psi_pipe_t pipe) {
+    pthread_mutex_lock(&pipe->mutex);
+    pipe->stop = 1;
+    pthread_cond_broadcast(&pipe->not_full);
+    pthread_mutex_unlock(&pipe->mutex);
+
+    if (pipe->running) pthread_join(pipe->thread, NULL);
+    pipe->running = 0;
+}
\ No newline at end of file
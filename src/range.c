@@ -0,0 +1,295 @@
+#include "range.h"
+
+void range_opt_init(range_opt_t ropt) {
+    ropt->threads = 1;
+    ropt->naive_max = RANGE_NAIVE_MAX;
+    ropt->bsgs = 1;
+    ropt->share_psi = 1;
+    ropt->stats = NULL;
+}
+
+/**
+ * Renvoie un majorant des l utilisés par ell_schoof() pour tous les p <= p_max (c.f schoof_max_prime()), en
+ * comptant le premier suivant pour le cas où l = p est sauté.
+ */
+ulong range_max_prime(const ulong p_max) {
+    double A = 1, A_max = 4 * sqrt((double)p_max);
+    ulong l = 3, l_max = 3;
+
+    for (; A <= A_max; l = n_nextprime(l, 1)) {
+        A *= l;
+        l_max = l;
+    }
+
+    return n_nextprime(l_max, 1);
+}
+
+/**
+ * Renvoie les ψ_m sur Z de la courbe, pour 0 <= m < range->psi_len, calculés au premier appel.
+ */
+const fmpz_poly_struct* range_psi(range_t range) {
+    pthread_mutex_lock(&range->psi_mutex);
+
+    if (range->psi == NULL) {
+        ulong n = range_max_prime(range->p_max);
+        fmpz_poly_struct* psi = (fmpz_poly_struct*)malloc((n + 1) * sizeof(fmpz_poly_struct));
+        for (ulong m = 0; m <= n; m++) fmpz_poly_init(psi + m);
+
+        div_poly_fmpz(psi, n, range->a, range->b);
+        range->psi_len = n + 1;
+        range->psi = psi;
+    }
+
+    pthread_mutex_unlock(&range->psi_mutex);
+    return range->psi;
+}
+
+/**
+ * Renvoie a_p = -Σ_x ((x^3 + a*x + b)/p) pour 0 <= a, b < p et p <= RANGE_NAIVE_LIMIT, les symboles de Legendre
+ * étant lus dans la table des carrés modulo p.
+ */
+slong range_naive(const ulong p, const ulong a, const ulong b) {
+    char* square = (char*)calloc(p, sizeof(char));
+    for (ulong x = 1; x <= p / 2; x++) square[x * x % p] = 1;
+
+    slong sum = 0;
+    for (ulong x = 0; x < p; x++) {
+        ulong f = ((x * x % p) * x + a * x + b) % p;
+        if (f != 0) sum += square[f] ? 1 : -1;
+    }
+
+    free(square);
+    return -sum;
+}
+
+/**
+ * Calcule a_p pour la courbe de range par la méthode la moins coûteuse (c.f range.h).
+ * Renvoie la méthode utilisée, RANGE_BAD (et laisse a_p inchangé) si p <= 3 ou si p est de mauvaise réduction.
+ */
+int range_a_p(slong* a_p, const ulong p, range_t range) {
+    if (p <= 3 || fmpz_fdiv_ui(range->disc, p) == 0) return RANGE_BAD;
+
+    ulong a = fmpz_fdiv_ui(range->a, p);
+    ulong b = fmpz_fdiv_ui(range->b, p);
+
+    if (p <= range->ropt->naive_max) {
+        *a_p = range_naive(p, a, b);
+        return RANGE_NAIVE;
+    }
+
+    fmpz_t P, N, N_A, A;
+    fmpz_init_set_ui(P, p);
+    fmpz_init(N);
+    fmpz_init(N_A);
+    fmpz_init_set_ui(A, 1);
+
+    fq_ctx_t ctx;
+    fq_ctx_init(ctx, P, 1, "a");
+
+    fq_t fq_a, fq_b;
+    fq_init(fq_a, ctx);
+    fq_init(fq_b, ctx);
+    fq_set_ui(fq_a, a, ctx);
+    fq_set_ui(fq_b, b, ctx);
+
+    ell_curve_t E;
+    ell_curve_init(E, ctx);
+    ell_curve_set(E, fq_a, fq_b, ctx);
+
+    // Pas de bébé-pas de géant sur les K = 4*sqrt(p) + 1 candidats, s'il coûte moins que tout l'algorithme de Schoof
+    int method = RANGE_SCHOOF;
+    double K = 4 * sqrt((double)p) + 1;
+    if (range->ropt->bsgs && K <= SCHOOF_BSGS_MAX_CANDIDATES) {
+        list_ulong_t list_primes;
+        list_ulong_init(list_primes);
+        if (schoof_bsgs_cost(K, ctx) < schoof_finish_cost(list_primes, 3, K, ctx) && schoof_bsgs(N, N_A, A, E, ctx)) method = RANGE_BSGS;
+        list_ulong_clear(list_primes);
+    }
+
+    if (method == RANGE_SCHOOF) {
+        schoof_opt_t opt;
+        *opt = *range->opt;
+        if (range->ropt->share_psi) {
+            opt->int_psi = range_psi(range);
+            opt->int_psi_len = range->psi_len;
+        }
+        ell_schoof(N, E, opt, ctx);
+    }
+
+    // a_p = p + 1 - N
+    fmpz_sub(N, P, N);
+    fmpz_add_ui(N, N, 1);
+    *a_p = fmpz_get_si(N);
+
+    fq_clear(fq_a, ctx);
+    fq_clear(fq_b, ctx);
+    ell_curve_clear(E, ctx);
+    fq_ctx_clear(ctx);
+    fmpz_clear(P);
+    fmpz_clear(N);
+    fmpz_clear(N_A);
+    fmpz_clear(A);
+    return method;
+}
+
+/**
+ * Range les lignes out du paquet chunk et écrit, dans l'ordre, tous les paquets qui peuvent l'être. Ajoute
+ * stats aux statistiques de range.
+ */
+void range_output(range_t range, const ulong chunk, char* out, const range_stats_struct* stats) {
+    pthread_mutex_lock(&range->mutex);
+
+    range->stats.bad += stats->bad;
+    range->stats.naive += stats->naive;
+    range->stats.bsgs += stats->bsgs;
+    range->stats.schoof += stats->schoof;
+
+    range->slots[chunk % range->window] = out;
+    while (range->slots[range->next_out % range->window] != NULL) {
+        char** slot = range->slots + range->next_out % range->window;
+        fputs(*slot, range->out);
+        free(*slot);
+        *slot = NULL;
+        range->next_out++;
+    }
+    fflush(range->out);
+
+    pthread_cond_broadcast(&range->space_ready);
+    pthread_mutex_unlock(&range->mutex);
+}
+
+/**
+ * Boucle d'un thread : prend le prochain paquet de premiers, calcule leurs a_p et transmet les lignes, jusqu'à
+ * ce que tous les p <= p_max aient été distribués. Un thread attend quand la fenêtre d'écriture est pleine.
+ */
+void range_run(range_t range) {
+    ulong primes[RANGE_CHUNK];
+
+    for (;;) {
+        pthread_mutex_lock(&range->mutex);
+        while (range->next_p <= range->p_max && range->next_chunk >= range->next_out + range->window) {
+            pthread_cond_wait(&range->space_ready, &range->mutex);
+        }
+
+        slong num = 0;
+        ulong chunk = range->next_chunk;
+        if (range->next_p <= range->p_max) {
+            ulong p = (range->next_p <= 2) ? 2 : n_nextprime(range->next_p - 1, 1);
+            for (; num < RANGE_CHUNK && p <= range->p_max; p = n_nextprime(p, 1)) primes[num++] = p;
+            range->next_p = p;
+            if (num > 0) range->next_chunk++;
+        }
+        pthread_mutex_unlock(&range->mutex);
+        if (num == 0) break;
+
+        range_stats_struct stats = {0, 0, 0, 0};
+        char* out = (char*)malloc(num * RANGE_LINE_MAX + 1);
+        size_t len = 0;
+        out[0] = '\0';
+
+        for (slong i = 0; i < num; i++) {
+            slong a_p;
+            switch (range_a_p(&a_p, primes[i], range)) {
+                case RANGE_BAD:
+                    stats.bad++;
+                    continue;
+                case RANGE_NAIVE:
+                    stats.naive++;
+                    break;
+                case RANGE_BSGS:
+                    stats.bsgs++;
+                    break;
+                default:
+                    stats.schoof++;
+            }
+            len += snprintf(out + len, RANGE_LINE_MAX, "%lu,%ld\n", primes[i], a_p);
+        }
+
+        range_output(range, chunk, out, &stats);
+    }
+}
+
+void* range_worker(void* arg) {
+    range_run((range_struct*)arg);
+
+    flint_cleanup(); // Libère les caches propres au thread
+    return NULL;
+}
+
+/**
+ * Écrit dans out une ligne "p,a_p" pour chaque premier p_min <= p <= p_max de bonne réduction de la courbe
+ * y^2 = x^3 + a*x + b sur Q (c.f range.h), dans l'ordre croissant, avec les options ropt et les options opt de
+ * l'algorithme de Schoof (sauf workers, checkpoint, progress, deadline, cancel et partial, ignorées).
+ * p_max doit être inférieur au plus grand nombre premier tenant dans un ulong.
+ */
+void range_traces(FILE* out, const fmpz_t a, const fmpz_t b, const ulong p_min, const ulong p_max, const range_opt_t ropt, const schoof_opt_t opt) {
+    range_opt_t run_ropt;
+    *run_ropt = *ropt;
+    run_ropt->threads = FLINT_MAX(ropt->threads, 1);
+    run_ropt->naive_max = FLINT_MIN(ropt->naive_max, RANGE_NAIVE_LIMIT);
+
+    schoof_opt_t run_opt;
+    *run_opt = *opt;
+    run_opt->workers = 0;
+    run_opt->checkpoint = NULL;
+    run_opt->progress = NULL;
+    run_opt->deadline = 0;
+    run_opt->cancel = NULL;
+    run_opt->partial = NULL;
+    run_opt->stop = NULL;
+
+    range_t range;
+    pthread_mutex_init(&range->mutex, NULL);
+    pthread_cond_init(&range->space_ready, NULL);
+    pthread_mutex_init(&range->psi_mutex, NULL);
+    range->next_p = p_min;
+    range->p_max = p_max;
+    range->next_chunk = 0;
+    range->next_out = 0;
+    range->window = RANGE_WINDOW * run_ropt->threads;
+    range->slots = (char**)calloc(range->window, sizeof(char*));
+    range->out = out;
+    range->stats = (range_stats_struct){0, 0, 0, 0};
+    range->psi = NULL;
+    range->psi_len = 0;
+    range->ropt = run_ropt;
+    range->opt = run_opt;
+
+    fmpz_init_set(range->a, a);
+    fmpz_init_set(range->b, b);
+
+    // 4*a^3 + 27*b^2
+    fmpz_t temp;
+    fmpz_init(temp);
+    fmpz_init(range->disc);
+    fmpz_pow_ui(range->disc, a, 3);
+    fmpz_mul_ui(range->disc, range->disc, 4);
+    fmpz_mul(temp, b, b);
+    fmpz_addmul_ui(range->disc, temp, 27);
+
+    pthread_t* workers = (pthread_t*)malloc((run_ropt->threads - 1) * sizeof(pthread_t));
+    slong num_workers = 0;
+    for (slong i = 0; i < run_ropt->threads - 1; i++) {
+        if (pthread_create(workers + num_workers, NULL, range_worker, range) == 0) num_workers++;
+    }
+
+    range_run(range);
+    for (slong i = 0; i < num_workers; i++) pthread_join(workers[i], NULL);
+
+    if (ropt->stats != NULL) *ropt->stats = range->stats;
+
+    // Libération de la mémoire
+    if (range->psi != NULL) {
+        for (ulong m = 0; m < range->psi_len; m++) fmpz_poly_clear(range->psi + m);
+        free(range->psi);
+    }
+    free(workers);
+    free(range->slots);
+    fmpz_clear(temp);
+    fmpz_clear(range->a);
+    fmpz_clear(range->b);
+    fmpz_clear(range->disc);
+    pthread_mutex_destroy(&range->mutex);
+    pthread_cond_destroy(&range->space_ready);
+    pthread_mutex_destroy(&range->psi_mutex);
+}
\ No newline at end of file
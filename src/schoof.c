@@ -1,7 +1,48 @@
+#include <math.h>
 #include "schoof.h"
+#include "distrib.h"
+#include "div_poly.h"
+#include "psi_pipe.h"
+
+void schoof_opt_init(schoof_opt_t opt) {
+    opt->affine = 0;
+    opt->frob_block = 0;
+    opt->checkpoint = NULL;
+    opt->checkpoint_psi = 0;
+    opt->workers = 0;
+    opt->low_memory = 0;
+    opt->psi_threads = 0;
+    opt->psi_ahead = 0;
+    opt->mul_threads = 0;
+    opt->peak_bytes = NULL;
+    opt->prime_powers = 0;
+    opt->bsgs = 0;
+    opt->match_sort = 0;
+    opt->int_psi = NULL;
+    opt->int_psi_len = 0;
+    opt->arena = 0;
+    opt->arena_log = NULL;
+    opt->progress = NULL;
+    opt->progress_data = NULL;
+    opt->deadline = 0;
+    opt->cancel = NULL;
+    opt->partial = NULL;
+    opt->stop = NULL;
+}
+
+void schoof_partial_init(schoof_partial_t partial) {
+    list_ulong_init(partial->moduli);
+    list_ulong_init(partial->residues);
+    partial->interrupted = 0;
+}
+
+void schoof_partial_clear(schoof_partial_t partial) {
+    list_ulong_clear(partial->moduli);
+    list_ulong_clear(partial->residues);
+}
 
 /**
- * Actualise list_psi en calculant tous les ψ_m encore non-calculés jusqu'à ψ_n.
+ * Actualise list_psi en calculant tous les ψ_m encore non-calculés jusqu'à ψ_n (ne fait rien s'ils le sont déjà).
  * En vérité, list_psi calcule la suite des f_n, qui coïncide avec ψ_n pour n impair.
  * c.f Proposition 3.6 du rapport.
  */
@@ -15,19 +56,19 @@ void update_list_div_poly(list_fq_poly_t list_psi, const ell_curve_t E, const ul
     fq_poly_init(temp_poly, ctx);
 
     // ψ_0 = 0
-    if (n == 0 || (n > 0 && list_psi_len == 0)) { // Si n = 0 ou (n > 0 et ψ_0 n'a pas encore été calculé)
+    if (list_psi_len == 0) { // Si ψ_0 n'a pas encore été calculé
         fq_poly_zero(temp_poly, ctx);
         list_fq_poly_add(list_psi, temp_poly, ctx);
     }
 
     // ψ_1 = 1
-    if (n == 1 || (n > 1 && list_psi_len <= 1)) { // Si n = 1 ou (n > 1 et ψ_1 n'a pas encore été calculé)
+    if (n >= 1 && list_psi_len <= 1) { // Si n >= 1 et ψ_1 n'a pas encore été calculé
         fq_poly_one(temp_poly, ctx);
         list_fq_poly_add(list_psi, temp_poly, ctx);
     }
 
     // ψ_2 = 2*y
-    if (n == 2 || (n > 2 && list_psi_len <= 2)) { // Si n = 2 ou (n > 2 et ψ_2 n'a pas encore été calculé)
+    if (n >= 2 && list_psi_len <= 2) { // Si n >= 2 et ψ_2 n'a pas encore été calculé
         fq_poly_zero(temp_poly, ctx);
         fq_set_ui(temp, 2, ctx);
         fq_poly_set_fq(temp_poly, temp, ctx);
@@ -35,7 +76,7 @@ void update_list_div_poly(list_fq_poly_t list_psi, const ell_curve_t E, const ul
     }
 
     // ψ_3 = 3*x^4 + 6*a*x^2 + 12*b*x - a^2
-    if (n == 3 || (n > 3 && list_psi_len <= 3)) { // Si n = 3 ou (n > 3 et ψ_3 n'a pas encore été calculé)
+    if (n >= 3 && list_psi_len <= 3) { // Si n >= 3 et ψ_3 n'a pas encore été calculé
         fq_poly_zero(temp_poly, ctx);
         
         fq_set_ui(temp, 3, ctx);
@@ -55,7 +96,7 @@ void update_list_div_poly(list_fq_poly_t list_psi, const ell_curve_t E, const ul
     }
 
     // ψ_4 = 4*y*(x^6 + 5*a*x^4 + 20*b*x^3 - 5*a^2*x^2 - 4*a*b*x - 8*b^2 - a^3)
-    if (n == 4 || (n > 4 && list_psi_len <= 4)) { // Si n = 4 ou (n > 4 et ψ_4 n'a pas encore été calculé)
+    if (n >= 4 && list_psi_len <= 4) { // Si n >= 4 et ψ_4 n'a pas encore été calculé
         fq_t temp2;
         fq_init(temp2, ctx);
         fq_poly_zero(temp_poly, ctx);
@@ -108,50 +149,635 @@ void update_list_div_poly(list_fq_poly_t list_psi, const ell_curve_t E, const ul
     fq_poly_set_coeff(Weierstrass_equation_2, 0, E->b, ctx);
     fq_poly_mul(Weierstrass_equation_2, Weierstrass_equation_2, Weierstrass_equation_2, ctx);
 
+    // ψ_m ne dépend que des ψ_k avec j-2 <= k <= j+2 (c.f div_poly_step())
+    fq_poly_struct* near[5];
+
     for (ulong m = list_fq_poly_len(list_psi); m <= n; m++) {
         ulong j = m / 2;
+        for (ulong i = 0; i < 5; i++) near[i] = PSI(j - 2 + i);
+
+        div_poly_step(psi_m, m, near, Weierstrass_equation_2, inv2, ctx);
+        
+        list_fq_poly_add(list_psi, psi_m, ctx);
+    }
+
+    fq_poly_clear(psi_m, ctx);
+    fq_clear(temp, ctx);
+    fq_clear(inv2, ctx);
+    fq_poly_clear(temp_poly, ctx);
+    fq_poly_clear(Weierstrass_equation_2, ctx);
+}
 
-        if (m % 2 == 0) {
-            fq_poly_pow(psi_m, PSI(j-1), 2, ctx);
-            fq_poly_mul(psi_m, PSI(j+2), psi_m, ctx);
+/**
+ * Renvoie le plus grand nombre premier l utilisé par ell_schoof() sur F_q : les premiers impairs différents de
+ * la caractéristique sont pris jusqu'à ce que leur produit dépasse 4*sqrt(q).
+ */
+ulong schoof_max_prime(const fq_ctx_t ctx) {
+    fmpz_t q, A, A_max;
+    fmpz_init(q);
+    fmpz_init_set_ui(A, 1);
+    fmpz_init(A_max);
+    fq_ctx_order(q, ctx);
+    fmpz_sqrt(A_max, q);
+    fmpz_mul_ui(A_max, A_max, 4);
+
+    ulong l, l_max = 3;
+    for (l = 3; fmpz_cmp(A, A_max) <= 0; l = n_nextprime(l, 1)) {
+        if (!fmpz_equal_ui(fq_ctx_prime(ctx), l)) {
+            fmpz_mul_ui(A, A, l);
+            l_max = l;
+        }
+    }
+
+    fmpz_clear(q);
+    fmpz_clear(A);
+    fmpz_clear(A_max);
+    return l_max;
+}
+
+/**
+ * Libère les ψ_k de list_psi qui ne serviront plus, sachant que les prochains ψ_l lus sont ceux des nombres
+ * premiers l >= l_min et que les ψ_m seront calculés au plus jusqu'à m = n_max.
+ * Calculer ψ_m ne fait intervenir que des ψ_k avec m/2 - 2 <= k <= m/2 + 2 (c.f update_list_div_poly()). Avec
+ * n = list_fq_poly_len(list_psi), les prochains ψ_m vérifient n <= m <= n_max, on ne garde donc que les
+ * ψ_k avec n/2 - 2 <= k <= n_max/2 + 2 et les ψ_l avec l >= l_min premier.
+ * Comme n et l_min ne font que croître d'un appel à l'autre (pour n_max fixé), chaque cellule n'est examinée qu'à
+ * son arrivée et quand elle passe sous n/2 - 2 (c.f list_psi->evict_low et list_psi->evict_seen). Seuls les ψ_l
+ * gardés sont revus, et seulement quand l_min change.
+ */
+void evict_list_div_poly(list_fq_poly_t list_psi, const ulong l_min, const ulong n_max, const fq_ctx_t ctx) {
+    ulong n = list_fq_poly_len(list_psi);
+    ulong k_min = (n / 2 > 2) ? n / 2 - 2 : 0;
+    ulong k_max = n_max / 2 + 2;
+
+    // Cellules passées sous k_min
+    cell_fq_poly_t* ptr = (list_psi->evict_low != NULL) ? list_psi->evict_low : list_psi->head;
+    for (; ptr != NULL && ptr->index < k_min; ptr = ptr->next) {
+        if (ptr->index < l_min || !n_is_prime(ptr->index)) list_fq_poly_evict(list_psi, ptr, ctx);
+    }
+    list_psi->evict_low = ptr;
+
+    // Cellules arrivées depuis le dernier appel
+    ptr = (list_psi->evict_seen != NULL) ? list_psi->evict_seen->next : list_psi->head;
+    for (; ptr != NULL; ptr = ptr->next) {
+        if (ptr->index > k_max && (ptr->index < l_min || !n_is_prime(ptr->index))) list_fq_poly_evict(list_psi, ptr, ctx);
+        list_psi->evict_seen = ptr;
+    }
+
+    // ψ_l gardés hors de [k_min, k_max] que l_min a dépassés
+    if (l_min > list_psi->evict_l_min) {
+        for (ptr = list_psi->head; ptr != NULL; ptr = ptr->next) {
+            if (ptr->index >= l_min) break;
+            if (ptr->index < k_min || ptr->index > k_max) list_fq_poly_evict(list_psi, ptr, ctx);
+        }
+        list_psi->evict_l_min = l_min;
+    }
+}
+
+/**
+ * Identique à update_list_div_poly(), mais libère au fur et à mesure les ψ_m inutiles (c.f
+ * evict_list_div_poly()) pour limiter la mémoire utilisée. ψ_n est conservé si n est premier et n >= l_min.
+ */
+void update_list_div_poly_low_memory(list_fq_poly_t list_psi, const ell_curve_t E, const ulong n, const ulong l_min, const ulong n_max, const fq_ctx_t ctx) {
+    for (ulong m = list_fq_poly_len(list_psi); m <= n; m++) {
+        update_list_div_poly(list_psi, E, m, ctx);
+        evict_list_div_poly(list_psi, l_min, n_max, ctx);
+    }
+}
+
+/**
+ * Calcule les Frobenius (x^q, y^q) = (x^q, y*W^{(q-1)/2}) modulo ψ_l pour tous les l de primes à la fois : on
+ * calcule x^q et W^{(q-1)/2} modulo le produit M des ψ_l, puis on les réduit modulo chaque ψ_l avec un arbre
+ * des restes. On remplace ainsi n exponentiations par une seule modulo M, ce qui est rentable dès que la
+ * multiplication de polynômes est sous-quadratique.
+ * Les ψ_l doivent déjà être dans list_psi, frob_x[i] et frob_y[i] reçoivent X et Y (c.f ell_cpoint.h) du
+ * point (x^q, y^q) modulo ψ_{primes[i]}.
+ * Les puissances sont calculées dans l'anneau de torsion de M pour que stop (s'il n'est pas NULL) soit consulté
+ * à chaque bit de l'exposant, puis entre deux niveaux de l'arbre. Renvoie 0, frob_x et frob_y étant alors non
+ * définis, si une interruption est constatée, 1 sinon.
+ */
+int frobenius_block(fq_poly_struct* frob_x, fq_poly_struct* frob_y, const ulong* primes, const slong n, const list_fq_poly_t list_psi, const ell_curve_t E, tors_stop_struct* stop, const fq_ctx_t ctx) {
+    fmpz_t q, q_1_2;
+    fmpz_init(q);
+    fmpz_init(q_1_2);
+    fq_ctx_order(q, ctx);
+    fmpz_sub_ui(q_1_2, q, 1);
+    fmpz_fdiv_q_2exp(q_1_2, q_1_2, 1);
+
+    // Arbre des produits des ψ_l
+    fq_poly_struct** moduli = (fq_poly_struct**)malloc(n * sizeof(fq_poly_struct*));
+    for (slong i = 0; i < n; i++) moduli[i] = PSI(primes[i]);
+
+    prod_tree_t tree;
+    prod_tree_init(tree, moduli, n, ctx);
+
+    // F_q[x,y]/(M, y^2 - W), qui fournit aussi W = x^3 + a*x + b
+    tors_ring_t tors_ring;
+    tors_ring_init(tors_ring, ctx);
+    tors_ring_set(tors_ring, E, prod_tree_root(tree), ctx);
+    tors_ring->stop = stop;
+
+    fq_poly_t temp;
+    fq_poly_init(temp, ctx);
+
+    // x^q modulo M
+    fq_poly_gen(temp, ctx);
+    tors_poly_pow(temp, temp, q, tors_ring, ctx);
+    int done = !tors_ring_stopped(tors_ring) && prod_tree_rem(frob_x, temp, tree, stop, ctx);
+
+    // W^{(q-1)/2} modulo M
+    if (done) {
+        tors_poly_pow(temp, tors_ring->W, q_1_2, tors_ring, ctx);
+        done = !tors_ring_stopped(tors_ring) && prod_tree_rem(frob_y, temp, tree, stop, ctx);
+    }
+
+    tors_ring_clear(tors_ring, ctx);
+    prod_tree_clear(tree, ctx);
+    free(moduli);
+    fq_poly_clear(temp, ctx);
+    fmpz_clear(q);
+    fmpz_clear(q_1_2);
+    return done;
+}
+
+/**
+ * Calcule a_q modulo l, c'est-à-dire l'unique t dans [0, l-1] tel que (x^{q^2}, y^{q^2}) + [q](x,y) = [t](x^q, y^q)
+ * dans E(R_{E,l}), où psi_l = ψ_l. Si frob_x et frob_y ne sont pas NULL, ils contiennent le Frobenius
+ * (x^q, y^q) déjà calculé modulo ψ_l (c.f frobenius_block()) et sont alors modifiés.
+ * Si up_to_sign est non nul, on ne compare que les abscisses : la boucle s'arrête au plus tard en (l-1)/2 et
+ * renvoie t tel que a_q ≡ ±t modulo l (c.f match_sort()).
+ * Renvoie SCHOOF_INTERRUPTED si opt->stop n'est pas NULL et qu'une interruption est constatée pendant le calcul.
+ * c.f Section 5 du rapport.
+ */
+ulong schoof_mod_l(const ulong l, const fq_poly_t psi_l, fq_poly_t frob_x, fq_poly_t frob_y, const int up_to_sign, const ell_curve_t E, const schoof_opt_t opt, const fq_ctx_t ctx) {
+    // Initialisation et définition de q
+    fmpz_t q;
+    fmpz_init(q);
+    fq_ctx_order(q, ctx);
+
+    // Réduction de q modulo l, plus efficace pour calculer [q](x,y) dans E(R_{E,l})
+    fmpz_t q_mod_l;
+    fmpz_init(q_mod_l);
+    fmpz_mod_ui(q_mod_l, q, l);
+
+    // (q-1)/2, car y^q = y*(y^2)^{(q-1)/2} = y*W^{(q-1)/2}
+    fmpz_t q_1_2;
+    fmpz_init(q_1_2);
+    fmpz_sub_ui(q_1_2, q, 1);
+    fmpz_fdiv_q_2exp(q_1_2, q_1_2, 1);
+
+    // Initialisation de l'anneau de torsion
+    tors_ring_t tors_ring;
+    tors_ring_init(tors_ring, ctx);
+    tors_ring_set(tors_ring, E, psi_l, ctx);
+    if (opt->mul_threads > 1) tors_ring_set_threads(tors_ring, opt->mul_threads, ctx);
+    tors_ring->stop = opt->stop;
 
-            fq_poly_pow(temp_poly, PSI(j+1), 2, ctx);
-            fq_poly_mul(temp_poly, PSI(j-2), temp_poly, ctx);
-                
-            fq_poly_sub(psi_m, psi_m, temp_poly, ctx);
-            fq_poly_mul(psi_m, PSI(j), psi_m, ctx);
+    ell_cpoint_t P, Q, x_y, Frob_x_y, Frob2_x_y;
+    ell_cpoint_init(P, ctx);
+    ell_cpoint_init(Q, ctx);
+    ell_cpoint_init(x_y, ctx);
+    ell_cpoint_init(Frob_x_y, ctx);
+    ell_cpoint_init(Frob2_x_y, ctx);
 
-            fq_poly_scalar_mul_fq(psi_m, psi_m, inv2, ctx);
+    // x_y = (x,y)
+    ell_cpoint_set_x_y(x_y, ctx);
+
+    // Frob_x_y et Frob2_x_y seront affines
+    fq_poly_one(Frob_x_y->Z, ctx);
+    fq_poly_one(Frob2_x_y->Z, ctx);
+
+    // Frob_x_y = (x^q, y^q) = (x^q, y*W^{(q-1)/2})
+    if (frob_x != NULL && frob_y != NULL) {
+        fq_poly_swap(Frob_x_y->X, frob_x, ctx);
+        fq_poly_swap(Frob_x_y->Y, frob_y, ctx);
+    } else {
+        tors_poly_pow(Frob_x_y->X, x_y->X, q, tors_ring, ctx);
+        tors_poly_pow(Frob_x_y->Y, tors_ring->W, q_1_2, tors_ring, ctx);
+    }
+
+    // Frob2_x_y = (x^{q^2}, y^{q^2}) où y^{q^2} = (y*W^{(q-1)/2})^q = y*W^{(q-1)/2}*(W^{(q-1)/2})^q
+    tors_poly_pow(Frob2_x_y->X, Frob_x_y->X, q, tors_ring, ctx);
+    tors_poly_pow(Frob2_x_y->Y, Frob_x_y->Y, q, tors_ring, ctx);
+    tors_poly_mul(Frob2_x_y->Y, Frob2_x_y->Y, Frob_x_y->Y, tors_ring, ctx);
+
+    // P = (x^{q^2}, y^{q^2}) + [q](x,y) 
+    if (opt->affine) {
+        ell_cpoint_mul_aff(P, x_y, q_mod_l, tors_ring, ctx);
+        ell_cpoint_add_aff(P, Frob2_x_y, P, tors_ring, ctx);
+    } else {
+        ell_cpoint_mul(P, x_y, q_mod_l, tors_ring, ctx);
+        ell_cpoint_add(P, Frob2_x_y, P, tors_ring, ctx);
+    }
+
+    // En mode affine psi a pu être remplacé par un de ses facteurs, on réduit alors les points conservés
+    slong deg_psi = fq_poly_degree(psi_l, ctx);
+    ulong t;
+
+    ulong t_max = up_to_sign ? (l - 1) / 2 : l - 1;
+
+    // Sinon psi ne change plus : (x^q,y^q) et P sont fixes pendant toute la boucle, on prépare une fois pour toutes
+    // leurs coordonnées pour les produits (c.f tors_pre_t)
+    ell_cpoint_pre_t Frob_pre, P_pre;
+    ell_cpoint_pre_init(Frob_pre, ctx);
+    ell_cpoint_pre_init(P_pre, ctx);
+
+    if (!opt->affine) {
+        ell_cpoint_pre_set(Frob_pre, Frob_x_y, tors_ring, ctx);
+        ell_cpoint_pre_set(P_pre, P, tors_ring, ctx);
+    }
+
+    for (t = 0; t <= t_max; t++) {
+        // Les Frobenius ont pu être interrompus, leur valeur n'a alors pas de sens
+        if (tors_ring_stopped(tors_ring)) {
+            t = SCHOOF_INTERRUPTED;
+            break;
+        }
+
+        if (fq_poly_degree(tors_ring->psi, ctx) < deg_psi) {
+            deg_psi = fq_poly_degree(tors_ring->psi, ctx);
+            ell_cpoint_reduce(Frob_x_y, tors_ring, ctx);
+            ell_cpoint_reduce(P, tors_ring, ctx);
+            if (t > 0) ell_cpoint_reduce(Q, tors_ring, ctx);
+        }
+
+        // Q = [t](x^q,y^q) via [t](x^q,y^q) = [t-1](x^q,y^q) + (x^q,y^q)
+        if (t == 0) {
+            ell_cpoint_set_infinity(Q, ctx);
+        } else if (opt->affine) {
+            ell_cpoint_add_aff(Q, Q, Frob_x_y, tors_ring, ctx);
         } else {
-            fq_poly_pow(psi_m, PSI(j + (j % 2)), 3, ctx);
-            fq_poly_mul(psi_m, PSI(j + 2 - 3*(j % 2)), psi_m, ctx);
-            fq_poly_mul(psi_m, psi_m, Weierstrass_equation_2, ctx);
+            ell_cpoint_add_pre(Q, Q, Frob_pre, tors_ring, ctx);
+        }
+
+        if (opt->affine) {
+            if (up_to_sign ? ell_cpoint_equal_x_aff(P, Q, tors_ring, ctx) : ell_cpoint_equal_aff(P, Q, tors_ring, ctx)) break;
+        } else {
+            if (up_to_sign ? ell_cpoint_equal_x_pre(Q, P_pre, tors_ring, ctx) : ell_cpoint_equal_pre(Q, P_pre, tors_ring, ctx)) break;
+        }
+    }
+
+    ell_cpoint_pre_clear(Frob_pre, ctx);
+    ell_cpoint_pre_clear(P_pre, ctx);
+
+    // Libération de la mémoire
+    fmpz_clear(q);
+    fmpz_clear(q_mod_l);
+    fmpz_clear(q_1_2);
+
+    tors_ring_clear(tors_ring, ctx);
+
+    ell_cpoint_clear(P, ctx);
+    ell_cpoint_clear(Q, ctx);
+    ell_cpoint_clear(x_y, ctx);
+    ell_cpoint_clear(Frob_x_y, ctx);
+    ell_cpoint_clear(Frob2_x_y, ctx);
+
+    return t;
+}
+
+/**
+ * Calcule a_q modulo n = l^k (k >= 2) connaissant t_prev = a_q modulo l^{k-1}. On travaille modulo la partie
+ * primitive ψ_n/ψ_{n/l} de ψ_n, dont les racines sont les abscisses des points d'ordre exactement n : sur ces
+ * points, [t](x^q, y^q) ne dépend que de t modulo n et il suffit de tester les l relevés t_prev + j*n/l.
+ * L'anneau n'est pas intègre, on utilise donc l'arithmétique affine qui remplace le polynôme par un facteur
+ * lorsqu'un dénominateur n'est pas inversible (c.f ell_cpoint_add_aff()) : tout facteur convient puisque ses
+ * racines sont encore des points d'ordre n. ψ_n et ψ_{n/l} doivent déjà être dans list_psi.
+ * Renvoie SCHOOF_INTERRUPTED si stop (qui peut être NULL) est constaté, comme schoof_mod_l().
+ */
+ulong schoof_mod_power(const ulong n, const ulong l, const ulong t_prev, const list_fq_poly_t list_psi, const ell_curve_t E, tors_stop_struct* stop, const fq_ctx_t ctx) {
+    fmpz_t q, q_mod_n, q_1_2, temp;
+    fmpz_init(q);
+    fmpz_init(q_mod_n);
+    fmpz_init(q_1_2);
+    fmpz_init(temp);
+    fq_ctx_order(q, ctx);
+    fmpz_mod_ui(q_mod_n, q, n);
+    fmpz_sub_ui(q_1_2, q, 1);
+    fmpz_fdiv_q_2exp(q_1_2, q_1_2, 1);
+
+    // Partie primitive de ψ_n
+    fq_poly_t psi_prim;
+    fq_poly_init(psi_prim, ctx);
+    fq_poly_div(psi_prim, PSI(n), PSI(n / l), ctx);
+
+    tors_ring_t tors_ring;
+    tors_ring_init(tors_ring, ctx);
+    tors_ring_set(tors_ring, E, psi_prim, ctx);
+    tors_ring->stop = stop;
+
+    ell_cpoint_t P, Q, S, x_y, Frob_x_y, Frob2_x_y;
+    ell_cpoint_init(P, ctx);
+    ell_cpoint_init(Q, ctx);
+    ell_cpoint_init(S, ctx);
+    ell_cpoint_init(x_y, ctx);
+    ell_cpoint_init(Frob_x_y, ctx);
+    ell_cpoint_init(Frob2_x_y, ctx);
+
+    ell_cpoint_set_x_y(x_y, ctx);
+    fq_poly_one(Frob_x_y->Z, ctx);
+    fq_poly_one(Frob2_x_y->Z, ctx);
+
+    // Frobenius et son carré, comme dans schoof_mod_l()
+    tors_poly_pow(Frob_x_y->X, x_y->X, q, tors_ring, ctx);
+    tors_poly_pow(Frob_x_y->Y, tors_ring->W, q_1_2, tors_ring, ctx);
+    tors_poly_pow(Frob2_x_y->X, Frob_x_y->X, q, tors_ring, ctx);
+    tors_poly_pow(Frob2_x_y->Y, Frob_x_y->Y, q, tors_ring, ctx);
+    tors_poly_mul(Frob2_x_y->Y, Frob2_x_y->Y, Frob_x_y->Y, tors_ring, ctx);
+
+    // P = (x^{q^2}, y^{q^2}) + [q](x,y)
+    ell_cpoint_mul_aff(P, x_y, q_mod_n, tors_ring, ctx);
+    ell_cpoint_add_aff(P, Frob2_x_y, P, tors_ring, ctx);
+
+    // Q = [t_prev](x^q, y^q) et S = [n/l](x^q, y^q) le pas entre deux relevés
+    fmpz_set_ui(temp, t_prev);
+    ell_cpoint_mul_aff(Q, Frob_x_y, temp, tors_ring, ctx);
+    fmpz_set_ui(temp, n / l);
+    ell_cpoint_mul_aff(S, Frob_x_y, temp, tors_ring, ctx);
+
+    slong deg_psi = fq_poly_degree(psi_prim, ctx);
+    ulong t = t_prev;
+
+    for (ulong j = 0; j < l; j++, t += n / l) {
+        // Les Frobenius ont pu être interrompus, leur valeur n'a alors pas de sens
+        if (tors_ring_stopped(tors_ring)) {
+            t = SCHOOF_INTERRUPTED;
+            break;
+        }
+
+        if (fq_poly_degree(tors_ring->psi, ctx) < deg_psi) {
+            deg_psi = fq_poly_degree(tors_ring->psi, ctx);
+            ell_cpoint_reduce(P, tors_ring, ctx);
+            ell_cpoint_reduce(Q, tors_ring, ctx);
+            ell_cpoint_reduce(S, tors_ring, ctx);
+        }
+
+        if (ell_cpoint_equal_aff(P, Q, tors_ring, ctx)) break;
+        ell_cpoint_add_aff(Q, Q, S, tors_ring, ctx);
+    }
+
+    // Libération de la mémoire
+    fmpz_clear(q);
+    fmpz_clear(q_mod_n);
+    fmpz_clear(q_1_2);
+    fmpz_clear(temp);
+    fq_poly_clear(psi_prim, ctx);
+    tors_ring_clear(tors_ring, ctx);
+
+    ell_cpoint_clear(P, ctx);
+    ell_cpoint_clear(Q, ctx);
+    ell_cpoint_clear(S, ctx);
+    ell_cpoint_clear(x_y, ctx);
+    ell_cpoint_clear(Frob_x_y, ctx);
+    ell_cpoint_clear(Frob2_x_y, ctx);
+
+    return t;
+}
+
+/**
+ * Renvoie le nombre premier impair l dont le module m = l^k est une puissance.
+ */
+ulong schoof_power_base(const ulong m) {
+    ulong l = 3;
+    while (m % l != 0) l += 2;
+    return l;
+}
+
+/**
+ * Coût estimé du calcul de a_q modulo un module dont les points de torsion utilisés sont les racines d'un
+ * polynôme de degré d, avec n_tests comparaisons de points : les exponentiations du Frobenius font O(log q)
+ * multiplications modulo ce polynôme et la boucle sur t en fait O(n_tests), chacune en O(d log d).
+ */
+double schoof_cost(const double d, const ulong n_tests, const fq_ctx_t ctx) {
+    slong log_q = fmpz_bits(fq_ctx_prime(ctx)) * fq_ctx_degree(ctx);
+    return d * log2(d + 1) * (2 * log_q + n_tests);
+}
+
+/**
+ * Coût estimé pour terminer le calcul avec les seuls nombres premiers : on prend les nombres premiers à partir
+ * de l, en sautant la caractéristique et ceux dont list_primes contient déjà une puissance, jusqu'à ce que leur
+ * produit dépasse remaining = A_max/A.
+ */
+double schoof_finish_cost(const list_ulong_t list_primes, const ulong l, const double remaining, const fq_ctx_t ctx) {
+    double cost = 0, prod = 1;
+
+    for (ulong l_next = l; prod < remaining; l_next = n_nextprime(l_next, 1)) {
+        if (fmpz_equal_ui(fq_ctx_prime(ctx), l_next) || list_ulong_find_multiple(list_primes, l_next) != NULL) continue;
 
-            fq_poly_pow(temp_poly, PSI(j + 1 - (j % 2)), 3, ctx);
-            fq_poly_mul(temp_poly, PSI(j - 1 + 3*(j % 2)), temp_poly, ctx);
+        cost += schoof_cost((l_next*l_next - 1) / 2.0, l_next, ctx);
+        prod *= l_next;
+    }
+
+    return cost;
+}
+
+/**
+ * Choisit entre le prochain nombre premier l_next et les puissances des modules déjà traités : passer de l^k à
+ * l^{k+1} multiplie A par l avec un polynôme de degré (l^{2k+2} - l^{2k})/2 (c.f schoof_mod_power()), alors
+ * que ψ_{l_next} est de degré (l_next^2 - 1)/2. On compare le coût total restant (c.f schoof_cost() et
+ * schoof_finish_cost()) avec et sans ce relèvement, où remaining = A_max/A : un relèvement n'est rentable que
+ * s'il évite le dernier nombre premier, qui apporterait sinon plus de bits que nécessaire.
+ * Renvoie la cellule de list_primes contenant le module l^k à relever, NULL si l_next est préférable.
+ */
+cell_ulong_t* schoof_next_power(const list_ulong_t list_primes, const ulong l_next, const double remaining, const fq_ctx_t ctx) {
+    cell_ulong_t* res = NULL;
+    double best = schoof_finish_cost(list_primes, l_next, remaining, ctx);
+
+    for (cell_ulong_t* ptr = list_primes->head; ptr != NULL; ptr = ptr->next) {
+        ulong l = schoof_power_base(ptr->t);
+        double d = (double)ptr->t * ptr->t * (l*l - 1) / 2.0;
+        double cost = schoof_cost(d, l, ctx) + schoof_finish_cost(list_primes, l_next, remaining / l, ctx);
+
+        if (cost < best) {
+            best = cost;
+            res = ptr;
+        }
+    }
+
+    return res;
+}
+
+/**
+ * Retrouve a_q par le théorème des restes chinois à partir des classes de list_ts modulo les modules de
+ * list_primes (premiers entre eux deux à deux), et affecte à res le nombre de points q + 1 - a_q.
+ */
+void schoof_crt(fmpz_t res, const list_ulong_t list_primes, const list_ulong_t list_ts, const fq_ctx_t ctx) {
+    fmpz_t q;
+    fmpz_init(q);
+    fq_ctx_order(q, ctx);
 
-            if (j % 2 == 0) {
-                fq_poly_sub(psi_m, psi_m, temp_poly, ctx);
+    fmpz_comb_t comb;
+    fmpz_comb_temp_t comb_temp;
+
+    ulong num_primes = list_ulong_len(list_primes);
+    ulong* tab_primes = (ulong*)malloc(num_primes * sizeof(ulong));
+    ulong* tab_ts = (ulong*)malloc(num_primes * sizeof(ulong));
+    list_ulong_get_tab(tab_primes, list_primes, num_primes);
+    list_ulong_get_tab(tab_ts, list_ts, num_primes);
+
+    fmpz_comb_init(comb, tab_primes, num_primes);
+    fmpz_comb_temp_init(comb_temp, comb);
+
+    fmpz_multi_CRT_ui(res, tab_ts, comb, comb_temp, 1); // Le 1 en argument signifie qu'on prend le représentant canonique signé
+
+    // On attribue à res la valeur q + 1 - a_q
+    fmpz_sub(res, q, res);
+    fmpz_add_ui(res, res, 1);
+
+    fmpz_clear(q);
+    free(tab_primes);
+    free(tab_ts);
+    fmpz_comb_clear(comb);
+    fmpz_comb_temp_clear(comb_temp);
+}
+
+/**
+ * Coût estimé de schoof_bsgs() pour K candidats, dans les mêmes unités que schoof_cost() : une opération dans
+ * E(F_q) coûte une inversion, soit O(log q) multiplications dans F_q, et chaque point aléatoire demande
+ * O(sqrt(K) + log q) opérations et K comparaisons. Le tout est pondéré par le bsgs_weight du profil de réglage
+ * (c.f tune.h), mesuré sur la machine par bin/schoof_tune.
+ */
+double schoof_bsgs_cost(const double K, const fq_ctx_t ctx) {
+    slong log_q = fmpz_bits(fq_ctx_prime(ctx)) * fq_ctx_degree(ctx);
+    return tune_get()->bsgs_weight * SCHOOF_BSGS_POINTS * ((2 * sqrt(K) + 2 * log_q) * log_q + K);
+}
+
+/**
+ * Départage les candidats pour le nombre de points N ≡ N_A modulo A dans l'intervalle de Hasse
+ * |q + 1 - N| <= 2*sqrt(q). Avec N = N_min + j*A, on cherche par pas de bébé-pas de géant les j tels que
+ * [j]([A]P) = -[N_min]P pour un point aléatoire P (c.f ell_fq_point_bsgs()), puis on élimine les candidats
+ * restants avec d'autres points. Le vrai N annule tous les points, il n'est donc jamais éliminé.
+ * Renvoie 1 et affecte N à res s'il ne reste qu'un candidat après au plus SCHOOF_BSGS_POINTS points, 0 sinon.
+ */
+int schoof_bsgs(fmpz_t res, const fmpz_t N_A, const fmpz_t A, const ell_curve_t E, const fq_ctx_t ctx) {
+    fmpz_t q, t_max, N_min, N_max, temp;
+    fmpz_init(q);
+    fmpz_init(t_max);
+    fmpz_init(N_min);
+    fmpz_init(N_max);
+    fmpz_init(temp);
+    fq_ctx_order(q, ctx);
+
+    // t_max = floor(2*sqrt(q)) = floor(sqrt(4*q))
+    fmpz_mul_ui(t_max, q, 4);
+    fmpz_sqrt(t_max, t_max);
+
+    // Plus petit et plus grand candidat N ≡ N_A modulo A dans l'intervalle de Hasse
+    fmpz_add_ui(N_min, q, 1);
+    fmpz_sub(N_min, N_min, t_max);
+    fmpz_sub(N_min, N_min, N_A);
+    fmpz_cdiv_q(N_min, N_min, A);
+    fmpz_mul(N_min, N_min, A);
+    fmpz_add(N_min, N_min, N_A);
+
+    fmpz_add_ui(N_max, q, 1);
+    fmpz_add(N_max, N_max, t_max);
+    fmpz_sub(temp, N_max, N_min);
+    fmpz_fdiv_q(temp, temp, A);
+    ulong K = fmpz_get_ui(temp) + 1;
+
+    flint_rand_t state;
+    flint_randinit(state);
+
+    ell_fq_point_t P, G, R;
+    ell_fq_point_init(P, ctx);
+    ell_fq_point_init(G, ctx);
+    ell_fq_point_init(R, ctx);
+
+    ulong candidates[SCHOOF_BSGS_MAX_MATCHES];
+    slong num_candidates = -1; // Inconnu tant qu'aucun point n'a permis de conclure
+
+    for (slong i = 0; i < SCHOOF_BSGS_POINTS && num_candidates != 1; i++) {
+        ell_fq_point_random(P, E, state, ctx);
+
+        if (num_candidates < 0) {
+            // R = -[N_min]P et G = [A]P
+            ell_fq_point_mul(R, P, N_min, E, ctx);
+            ell_fq_point_neg(R, R, ctx);
+            ell_fq_point_mul(G, P, A, E, ctx);
+            num_candidates = ell_fq_point_bsgs(candidates, SCHOOF_BSGS_MAX_MATCHES, R, G, K, E, ctx);
+        } else {
+            // On ne garde que les candidats N = N_min + j*A tels que [N]P = 0
+            slong num_kept = 0;
+            for (slong j = 0; j < num_candidates; j++) {
+                fmpz_mul_ui(temp, A, candidates[j]);
+                fmpz_add(temp, temp, N_min);
+                ell_fq_point_mul(R, P, temp, E, ctx);
+                if (R->infinity) candidates[num_kept++] = candidates[j];
+            }
+            num_candidates = num_kept;
+        }
+    }
+
+    int success = (num_candidates == 1);
+    if (success) {
+        fmpz_mul_ui(res, A, candidates[0]);
+        fmpz_add(res, res, N_min);
+    }
+
+    ell_fq_point_clear(P, ctx);
+    ell_fq_point_clear(G, ctx);
+    ell_fq_point_clear(R, ctx);
+    flint_randclear(state);
+    fmpz_clear(q);
+    fmpz_clear(t_max);
+    fmpz_clear(N_min);
+    fmpz_clear(N_max);
+    fmpz_clear(temp);
+    return success;
+}
+
+/**
+ * Rend tout ce qui a été alloué dans arena pour le module l (c.f arena_end()) et en écrit les statistiques dans
+ * opt->arena_log.
+ */
+void schoof_arena_end(arena_t arena, const ulong l, const schoof_opt_t opt) {
+    arena_end(arena);
+    if (opt->arena_log != NULL) fprintf(opt->arena_log, "arena %lu %zu %zu\n", l, arena->allocated, arena->peak);
+}
+
+/**
+ * Quand match_sort() n'a pas pu départager les classes au signe près de cands (opt->match_sort), calcule a_q
+ * modulo chacun de leurs modules et les ajoute à list_primes et list_ts. Les ψ_l sont recalculés dans une liste
+ * propre, ceux de ell_schoof() ayant pu être libérés (low_memory) ou être restés au producteur (psi_ahead).
+ * Renvoie 0 si le calcul a été interrompu (c.f opt->stop), 1 sinon.
+ */
+int schoof_exact_classes(list_ulong_t list_primes, list_ulong_t list_ts, const match_sort_cand_struct* cands, const slong num_cands, const ell_curve_t E, const schoof_opt_t opt, const fq_ctx_t ctx) {
+    list_fq_poly_t list_psi;
+    list_fq_poly_init(list_psi);
+
+    ulong l_max = cands[num_cands - 1].modulus; // Les modules sont rangés par ordre croissant
+    int done = 1;
+
+    for (slong i = 0; i < num_cands && done; i++) {
+        ulong l = cands[i].modulus;
+        ulong t = cands[i].residues[0]; // Une seule classe : a_q ≡ 0 modulo l, déjà exacte
+
+        if (cands[i].num > 1) {
+            if (opt->low_memory) {
+                update_list_div_poly_low_memory(list_psi, E, l, l, l_max, ctx);
             } else {
-                fq_poly_sub(psi_m, temp_poly, psi_m, ctx);
+                update_list_div_poly_threads(list_psi, E, l, opt->psi_threads, ctx);
             }
+            t = schoof_mod_l(l, PSI(l), NULL, NULL, 0, E, opt, ctx);
+            done = (t != SCHOOF_INTERRUPTED);
+        }
+
+        if (done) {
+            list_ulong_add(list_ts, t);
+            list_ulong_add(list_primes, l);
         }
-        
-        list_fq_poly_add(list_psi, psi_m, ctx);
     }
 
-    fq_poly_clear(psi_m, ctx);
-    fq_clear(temp, ctx);
-    fq_clear(inv2, ctx);
-    fq_poly_clear(temp_poly, ctx);
-    fq_poly_clear(Weierstrass_equation_2, ctx);
+    list_fq_poly_clear(list_psi, ctx);
+    return done;
 }
 
 /**
  * Algorithme de Schoof.
  * c.f Section 5 du rapport.
  */
-void ell_schoof(fmpz_t res, const ell_curve_t E, const fq_ctx_t ctx) {
+void ell_schoof(fmpz_t res, const ell_curve_t E, const schoof_opt_t opt, const fq_ctx_t ctx) {
     // Initialisation de A
     fmpz_t A;
     fmpz_init_set_ui(A, 1);
@@ -161,10 +787,6 @@ void ell_schoof(fmpz_t res, const ell_curve_t E, const fq_ctx_t ctx) {
     fmpz_init(q);
     fq_ctx_order(q, ctx);
 
-    // Réduction de q modulo l, plus efficace pour calculer [q](x,y) dans E(R_{E,l})
-    fmpz_t q_mod_l;
-    fmpz_init(q_mod_l);
-
     // p = car(F_q)
     fmpz_t p;
     fmpz_init(p);
@@ -174,128 +796,285 @@ void ell_schoof(fmpz_t res, const ell_curve_t E, const fq_ctx_t ctx) {
     list_fq_poly_t list_psi;
     list_fq_poly_init(list_psi);
 
-    // Initialisation de l'anneau de torsion
-    tors_ring_t tors_ring;
-    tors_ring_init(tors_ring, ctx);
-
-    ell_point_t P, Q, x_y, Frob_x_y, Frob2_x_y;
-    ell_point_init(P, ctx);
-    ell_point_init(Q, ctx);
-    ell_point_init(x_y, ctx);
-    ell_point_init(Frob_x_y, ctx);
-    ell_point_init(Frob2_x_y, ctx);
-
-    // x_y = (x,y)
-    tors_elem_set_x(x_y->X, ctx);
-    tors_elem_set_y(x_y->Y, ctx);
-    tors_elem_one(x_y->Z, ctx);
-
-    // Frob_x_y et Frob2_x_y seront affines
-    tors_elem_one(Frob_x_y->Z, ctx);
-    tors_elem_one(Frob2_x_y->Z, ctx);
-    
-    // list_primes contiendra la liste des nombres premiers pour lesquels on a calculé la classe de a_q
+    // list_primes contiendra la liste des modules (nombres premiers ou leurs puissances) pour lesquels on a calculé la classe de a_q
     list_ulong_t list_primes;
     list_ulong_init(list_primes);
     ulong l = 3; // Nombre premier qui passera au suivant à la fin de chaque boucle
     
-    // list_ts contiendra la liste des réductions de a_q modulo les nombres_premiers de list_primes
+    // list_ts contiendra la liste des réductions de a_q modulo les modules de list_primes
     list_ulong_t list_ts;
     list_ulong_init(list_ts);
     ulong t;
 
+    // En mode économe en mémoire, les ψ_m sont libérés avant d'avoir pu être écrits dans le fichier de reprise
+    int save_psi = (opt->checkpoint != NULL && opt->checkpoint_psi && !opt->low_memory);
+
+    // Plus grand l utilisé, qui détermine les ψ_m encore utiles en mode économe en mémoire
+    ulong l_max = opt->low_memory ? schoof_max_prime(ctx) : 0;
+
+    // Reprise d'un calcul interrompu : les l déjà traités sont relus et A est leur produit
+    ulong psi_saved = 0; // Nombre de ψ_m déjà présents dans le fichier de reprise des polynômes de division
+    if (opt->checkpoint != NULL && checkpoint_load(list_primes, list_ts, opt->checkpoint, E, ctx) >= 0) {
+        for (cell_ulong_t* ptr = list_primes->head; ptr != NULL; ptr = ptr->next) {
+            fmpz_mul_ui(A, A, ptr->t);
+        }
+
+        if (save_psi) psi_saved = checkpoint_psi_load(list_psi, opt->checkpoint, ctx);
+    }
+
+    // ψ_m déjà connus sur Z (si opt->int_psi) : une réduction modulo p remplace la récurrence jusqu'au dernier l
+    if (opt->int_psi != NULL && opt->int_psi_len > 0 && !opt->low_memory) {
+        update_list_div_poly_reduce(list_psi, opt->int_psi, FLINT_MIN(opt->int_psi_len - 1, schoof_max_prime(ctx)), ctx);
+    }
+
+    // Frobenius calculés à l'avance par blocs de block_len nombres premiers (si opt->frob_block > 1)
+    slong block_size = FLINT_MAX(opt->frob_block, 1);
+    slong block_len = 0, block_pos = 0;
+    ulong* block_primes = (ulong*)malloc(block_size * sizeof(ulong));
+    fq_poly_struct* block_x = (fq_poly_struct*)malloc(block_size * sizeof(fq_poly_struct));
+    fq_poly_struct* block_y = (fq_poly_struct*)malloc(block_size * sizeof(fq_poly_struct));
+    for (slong i = 0; i < block_size; i++) {
+        fq_poly_init(block_x + i, ctx);
+        fq_poly_init(block_y + i, ctx);
+    }
+
+    fmpz_t A_block;
+    fmpz_init(A_block);
+
     // A_max = 4*sqrt(q)
     fmpz_t A_max;
     fmpz_init(A_max);
     fmpz_sqrt(A_max, q);
     fmpz_mul_ui(A_max, A_max, 4);
 
+    // Interruption (si opt->deadline ou opt->cancel), vérifiée avant chaque module et dans schoof_mod_l(), et
+    // partagée avec l'éventuel appel imbriqué
+    double start = tors_stop_now();
+    tors_stop_t stop;
+    tors_stop_init(stop, opt->cancel, (opt->deadline > 0) ? start + opt->deadline : 0);
+    schoof_opt_t run_opt;
+    *run_opt = *opt;
+    if (run_opt->stop == NULL) run_opt->stop = stop;
+
+    // Classes de a_q connues seulement au signe près (si opt->match_sort), combinées par match_sort()
+    match_sort_cand_struct* cands = NULL;
+    slong num_cands = 0;
+
+    // Arrêt anticipé par pas de bébé-pas de géant (si opt->bsgs)
+    int bsgs_done = 0;
+    fmpz_t A_bsgs, N_A;
+    fmpz_init(A_bsgs);
+    fmpz_init(N_A);
+
+    // Arène du module en cours (si opt->arena) : seuls schoof_mod_l() et schoof_mod_power() y allouent, les ψ_m
+    // et les Frobenius calculés par blocs leur survivent
+    arena_t arena;
+    arena_init(arena);
+
+    // ψ_l calculés à l'avance par un thread producteur (si opt->psi_ahead), seulement quand ψ_l est le seul
+    // polynôme de division dont la boucle a besoin
+    int pipelined = (opt->psi_ahead > 0 && !opt->low_memory && !opt->prime_powers && opt->frob_block <= 1 && !save_psi && opt->int_psi == NULL);
+    psi_pipe_t pipe;
+    if (pipelined) psi_pipe_init(pipe, E, schoof_max_prime(ctx), opt->psi_ahead, opt->psi_threads, ctx);
+
     while (fmpz_cmp(A, A_max) <= 0) {
-        if (!fmpz_equal_ui(p, l)) {
-            // Calcul de q modulo l
-            fmpz_mod_ui(q_mod_l, q, l);
-
-            // On calcule ψ_l
-            update_list_div_poly(list_psi, E, l, ctx);
-
-            // Initialisation de l'anneau de torsion
-            tors_ring_set(tors_ring, E, list_psi->tail->poly, ctx);
-
-            // Frob_x_y = (x^q, y^q)
-            tors_elem_pow(Frob_x_y->X, x_y->X, q, tors_ring, ctx);
-            tors_elem_pow(Frob_x_y->Y, x_y->Y, q, tors_ring, ctx);
-
-            // Frob2_x_y = (x^{q^2}, y^{q^2})
-            tors_elem_pow(Frob2_x_y->X, Frob_x_y->X, q, tors_ring, ctx);
-            tors_elem_pow(Frob2_x_y->Y, Frob_x_y->Y, q, tors_ring, ctx);
-
-            // P = (x^{q^2}, y^{q^2}) + [q](x,y) 
-            ell_point_mul(P, x_y, q_mod_l, tors_ring, ctx);
-            ell_point_add(P, Frob2_x_y, P, tors_ring, ctx);
-            
-            for (t = 0; t < l; t++) {
-                // Q = [t](x^q,y^q) via [t](x^q,y^q) = [t-1](x^q,y^q) + (x^q,y^q)
-                if (t == 0) {
-                    ell_point_set_infinity(Q, ctx);
+        if (tors_stop_check(run_opt->stop)) break;
+
+        if (!fmpz_equal_ui(p, l) && list_ulong_find_multiple(list_primes, l) == NULL) {
+            ulong done_l, done_t; // Module traité et a_q modulo celui-ci, pour opt->progress
+
+            // Arrêt anticipé : s'il reste peu de candidats pour a_q, les départager coûte moins cher que ψ_l
+            if (opt->bsgs && num_cands == 0 && !fmpz_equal(A, A_bsgs)) {
+                fmpz_set(A_bsgs, A); // Un seul essai par valeur de A
+                double K = 4 * sqrt(fmpz_get_d(q)) / fmpz_get_d(A) + 1;
+
+                if (K <= SCHOOF_BSGS_MAX_CANDIDATES && schoof_bsgs_cost(K, ctx) < schoof_cost((l*l - 1) / 2.0, l, ctx)) {
+                    if (list_ulong_len(list_primes) > 0) {
+                        schoof_crt(N_A, list_primes, list_ts, ctx);
+                    } else {
+                        fmpz_add_ui(N_A, q, 1);
+                    }
+
+                    if (schoof_bsgs(res, N_A, A, E, ctx)) {
+                        bsgs_done = 1;
+                        break;
+                    }
+                }
+            }
+
+            // Le prochain module peut être une puissance d'un nombre premier déjà traité (c.f schoof_next_power())
+            cell_ulong_t* power = (opt->prime_powers && !opt->low_memory) ? schoof_next_power(list_primes, l, (fmpz_get_d(A_max) + 1) / fmpz_get_d(A), ctx) : NULL;
+
+            if (power != NULL) {
+                // On passe de t modulo l^k à t modulo l^{k+1}
+                cell_ulong_t* power_t = list_ulong_get_cell(list_ts, power->index);
+                ulong l_power = schoof_power_base(power->t);
+
+                update_list_div_poly_threads(list_psi, E, power->t * l_power, opt->psi_threads, ctx);
+                if (opt->arena) arena_begin(arena);
+                t = schoof_mod_power(power->t * l_power, l_power, power_t->t, list_psi, E, run_opt->stop, ctx);
+                if (opt->arena) schoof_arena_end(arena, power->t * l_power, opt);
+                if (t == SCHOOF_INTERRUPTED) break;
+                power_t->t = t;
+                power->t *= l_power;
+                fmpz_mul_ui(A, A, l_power);
+                done_l = power->t;
+                done_t = power_t->t;
+            } else {
+                // Si besoin, on calcule d'un coup les Frobenius des prochains nombres premiers qui seront utilisés
+                if (opt->frob_block > 1 && block_pos == block_len) {
+                    block_len = 0;
+                    block_pos = 0;
+                    fmpz_set(A_block, A);
+
+                    for (ulong l_block = l; block_len < opt->frob_block && fmpz_cmp(A_block, A_max) <= 0; l_block = n_nextprime(l_block, 1)) {
+                        if (!fmpz_equal_ui(p, l_block) && list_ulong_find_multiple(list_primes, l_block) == NULL) {
+                            block_primes[block_len++] = l_block;
+                            fmpz_mul_ui(A_block, A_block, l_block);
+                        }
+                    }
+
+                    if (opt->low_memory) {
+                        update_list_div_poly_low_memory(list_psi, E, block_primes[block_len - 1], l, l_max, ctx);
+                    } else {
+                        update_list_div_poly_threads(list_psi, E, block_primes[block_len - 1], opt->psi_threads, ctx);
+                    }
+                    if (!frobenius_block(block_x, block_y, block_primes, block_len, list_psi, E, run_opt->stop, ctx)) break;
+                }
+
+                // On calcule ψ_l, à moins que le producteur ne l'ait déjà fait
+                const fq_poly_struct* psi_l = pipelined ? psi_pipe_pop(pipe, l) : NULL;
+                if (psi_l == NULL) {
+                    if (opt->low_memory) {
+                        update_list_div_poly_low_memory(list_psi, E, l, l, l_max, ctx);
+                    } else {
+                        update_list_div_poly_threads(list_psi, E, l, opt->psi_threads, ctx);
+                    }
+                    psi_l = PSI(l);
+                }
+
+                if (opt->arena) arena_begin(arena);
+                if (block_pos < block_len && block_primes[block_pos] == l) {
+                    t = schoof_mod_l(l, psi_l, block_x + block_pos, block_y + block_pos, opt->match_sort, E, run_opt, ctx);
+                    block_pos++;
+                } else {
+                    t = schoof_mod_l(l, psi_l, NULL, NULL, opt->match_sort, E, run_opt, ctx);
+                }
+                if (opt->arena) schoof_arena_end(arena, l, opt);
+                if (t == SCHOOF_INTERRUPTED) break;
+
+                if (opt->match_sort) {
+                    // a_q ≡ ±t modulo l
+                    ulong residues[2] = {t, l - t};
+                    cands = (match_sort_cand_struct*)realloc(cands, (num_cands + 1) * sizeof(match_sort_cand_struct));
+                    match_sort_cand_init(cands + num_cands, l, residues, (t == 0) ? 1 : 2);
+                    num_cands++;
                 } else {
-                    ell_point_add(Q, Q, Frob_x_y, tors_ring, ctx);
+                    list_ulong_add(list_ts, t);
+                    list_ulong_add(list_primes, l);
                 }
+                fmpz_mul_ui(A, A, l);
+                done_l = l;
+                done_t = t;
+            }
 
-                if (ell_point_equal(P, Q, tors_ring, ctx)) break;
+            if (opt->progress != NULL) {
+                schoof_progress_struct progress = {done_l, done_t, A, A_max, tors_stop_now() - start};
+                opt->progress(&progress, opt->progress_data);
             }
 
-            list_ulong_add(list_ts, t);
-            list_ulong_add(list_primes, l);
-            fmpz_mul_ui(A, A, l);
+            // Point de reprise, un échec d'écriture n'interrompt pas le calcul
+            if (opt->checkpoint != NULL) {
+                if (save_psi && checkpoint_psi_append(opt->checkpoint, list_psi, psi_saved, ctx) == 0) {
+                    psi_saved = list_fq_poly_len(list_psi);
+                }
+                checkpoint_save(opt->checkpoint, E, list_primes, list_ts, ctx);
+            }
+
+            if (opt->low_memory) evict_list_div_poly(list_psi, l + 1, l_max, ctx);
+
+            // l n'a pas encore été traité
+            if (power != NULL) continue;
         }
 
         l = n_nextprime(l, 1); // Le 1 en argument signifie que le test de primalité n'est pas probabiliste
     }
 
+    // Le producteur n'a plus rien à faire, ses ψ_m ne servent plus qu'à la mesure de la mémoire
+    if (pipelined) psi_pipe_stop(pipe);
+
     // On utilise le théorème des restes chinois pour retrouver a_q
-    fmpz_comb_t comb;
-    fmpz_comb_temp_t comb_temp;
+    int interrupted = run_opt->stop->stopped;
+    if (interrupted) {
+        fmpz_zero(res);
+    } else if (!bsgs_done && num_cands == 0) {
+        schoof_crt(res, list_primes, list_ts, ctx);
+    } else if (!bsgs_done) {
+        // Partie exacte : a_q ≡ t_1 modulo m_1
+        fmpz_t t_1, m_1;
+        fmpz_init(t_1);
+        fmpz_init_set_ui(m_1, 1);
+
+        if (list_ulong_len(list_primes) > 0) {
+            schoof_crt(t_1, list_primes, list_ts, ctx);
+            fmpz_sub(t_1, q, t_1);
+            fmpz_add_ui(t_1, t_1, 1);
+            for (cell_ulong_t* ptr = list_primes->head; ptr != NULL; ptr = ptr->next) fmpz_mul_ui(m_1, m_1, ptr->t);
+        }
 
-    ulong num_primes = list_ulong_len(list_primes);
-    ulong* tab_primes = (ulong*)malloc(num_primes * sizeof(ulong));
-    ulong* tab_ts = (ulong*)malloc(num_primes * sizeof(ulong));
-    list_ulong_get_tab(tab_primes, list_primes, num_primes);
-    list_ulong_get_tab(tab_ts, list_ts, num_primes);
+        // Si les points tirés ne suffisent pas à conclure (exposant de E(F_q) trop petit), on calcule les classes
+        // exactes modulo les mêmes l
+        if (!match_sort(res, t_1, m_1, cands, num_cands, E, ctx)) {
+            interrupted = !schoof_exact_classes(list_primes, list_ts, cands, num_cands, E, run_opt, ctx);
+            if (interrupted) {
+                fmpz_zero(res);
+            } else {
+                schoof_crt(res, list_primes, list_ts, ctx);
+            }
+        }
 
-    fmpz_comb_init(comb, tab_primes, num_primes);
-    fmpz_comb_temp_init(comb_temp, comb);
+        fmpz_clear(t_1);
+        fmpz_clear(m_1);
+    }
 
-    fmpz_multi_CRT_ui(res, tab_ts, comb, comb_temp, 1); // Le 1 en argument signifie qu'on prend le représentant canonique signé
+    // Classes exactes obtenues
+    if (opt->partial != NULL) {
+        list_ulong_clear(opt->partial->moduli);
+        list_ulong_clear(opt->partial->residues);
+        for (cell_ulong_t* ptr = list_primes->head; ptr != NULL; ptr = ptr->next) list_ulong_add(opt->partial->moduli, ptr->t);
+        for (cell_ulong_t* ptr = list_ts->head; ptr != NULL; ptr = ptr->next) list_ulong_add(opt->partial->residues, ptr->t);
+        opt->partial->interrupted = interrupted;
+    }
 
-    // On attribue à res la valeur q + 1 - a_q
-    fmpz_sub(res, q, res);
-    fmpz_add_ui(res, res, 1);
+    if (opt->peak_bytes != NULL) *opt->peak_bytes = pipelined ? pipe->list_psi->peak_bytes : list_psi->peak_bytes;
 
     // Libération de la mémoire
     fmpz_clear(A);
     fmpz_clear(q);
+    fmpz_clear(p);
     fmpz_clear(A_max);
+    fmpz_clear(A_block);
+    fmpz_clear(A_bsgs);
 
-    tors_ring_clear(tors_ring, ctx);
+    for (slong i = 0; i < num_cands; i++) match_sort_cand_clear(cands + i);
+    free(cands);
+    fmpz_clear(N_A);
 
-    ell_point_clear(P, ctx);
-    ell_point_clear(Q, ctx);
-    ell_point_clear(x_y, ctx);
-    ell_point_clear(Frob_x_y, ctx);
-    ell_point_clear(Frob2_x_y, ctx);
+    for (slong i = 0; i < block_size; i++) {
+        fq_poly_clear(block_x + i, ctx);
+        fq_poly_clear(block_y + i, ctx);
+    }
+    free(block_primes);
+    free(block_x);
+    free(block_y);
 
     list_ulong_clear(list_primes);
     list_ulong_clear(list_ts);
     list_fq_poly_clear(list_psi, ctx);
-
-    free(tab_primes);
-    free(tab_ts);
-
-    fmpz_comb_clear(comb);
-    fmpz_comb_temp_clear(comb_temp);
+    if (pipelined) psi_pipe_clear(pipe, ctx);
+    arena_clear(arena);
 }
 
-
 /**
  * Exécute l'algorithme de Schoof avec seulement les paramètres de la courbe en entrée.
  * C'est cette fonction à laquelle il faut faire appel si on importe cette bibliothèque.
@@ -304,6 +1083,17 @@ void ell_schoof(fmpz_t res, const ell_curve_t E, const fq_ctx_t ctx) {
  * de base de caractéristique différente de 2 et 3), laisse inchangée la sortie et renvoie EXIT_FAILURE sinon.
  */
 int schoof(fmpz_t res, const fq_t a, const fq_t b, const fq_ctx_t ctx) {
+    schoof_opt_t opt;
+    schoof_opt_init(opt);
+    return schoof_with_opt(res, a, b, opt, ctx);
+}
+
+/**
+ * Identique à schoof() mais avec des options choisies par l'utilisateur (c.f schoof_opt_struct). Si opt->workers
+ * est non nul, renvoie aussi EXIT_FAILURE quand le calcul réparti échoue ou ne prend pas en charge les autres
+ * options (c.f ell_schoof_distrib()).
+ */
+int schoof_with_opt(fmpz_t res, const fq_t a, const fq_t b, const schoof_opt_t opt, const fq_ctx_t ctx) {
     ell_curve_t E;
     ell_curve_init(E, ctx);
 
@@ -317,7 +1107,11 @@ int schoof(fmpz_t res, const fq_t a, const fq_t b, const fq_ctx_t ctx) {
         success = EXIT_FAILURE;
     } else {
         if (ell_curve_set(E, a, b, ctx) == EXIT_SUCCESS) {
-            ell_schoof(res, E, ctx);
+            if (opt->workers > 0) {
+                success = ell_schoof_distrib(res, E, opt, ctx);
+            } else {
+                ell_schoof(res, E, opt, ctx);
+            }
         } else {
             success = EXIT_FAILURE;
         }
@@ -326,4 +1120,66 @@ int schoof(fmpz_t res, const fq_t a, const fq_t b, const fq_ctx_t ctx) {
     fmpz_clear(p);
     ell_curve_clear(E, ctx);
     return success;
+}
+
+/**
+ * Identique à schoof_with_opt(), en rendant les classes de a_q calculées dans partial, en particulier quand le
+ * calcul est interrompu par opt->deadline ou opt->cancel (c.f schoof_partial_struct).
+ *
+ * Renvoie EXIT_SUCCESS si res est le nombre de points, EXIT_FAILURE si la courbe n'est pas valide ou si le calcul
+ * a été interrompu (partial->interrupted est alors non nul).
+ */
+int schoof_interruptible(fmpz_t res, schoof_partial_t partial, const fq_t a, const fq_t b, const schoof_opt_t opt, const fq_ctx_t ctx) {
+    schoof_opt_t partial_opt;
+    *partial_opt = *opt;
+    partial_opt->partial = partial;
+
+    list_ulong_clear(partial->moduli);
+    list_ulong_clear(partial->residues);
+    partial->interrupted = 0;
+
+    int success = schoof_with_opt(res, a, b, partial_opt, ctx);
+    return (success == EXIT_SUCCESS && !partial->interrupted) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/**
+ * Reprend le calcul décrit par le fichier de reprise path (c.f checkpoint.h) : la courbe et le corps sont relus
+ * dans le fichier et seuls les nombres premiers l pas encore traités sont calculés. Les autres options sont
+ * celles de opt.
+ *
+ * Renvoie EXIT_FAILURE si le fichier est illisible ou si la courbe n'est pas valide, EXIT_SUCCESS sinon.
+ */
+int schoof_resume(fmpz_t res, const char* path, const schoof_opt_t opt) {
+    fmpz_t p, a, b;
+    fmpz_init(p);
+    fmpz_init(a);
+    fmpz_init(b);
+
+    int success = EXIT_FAILURE;
+
+    if (checkpoint_read_curve(p, a, b, path) == 0 && fmpz_is_probabprime(p)) {
+        fq_ctx_t ctx;
+        fq_ctx_init(ctx, p, 1, "a");
+
+        fq_t fq_a, fq_b;
+        fq_init(fq_a, ctx);
+        fq_init(fq_b, ctx);
+        fq_set_fmpz(fq_a, a, ctx);
+        fq_set_fmpz(fq_b, b, ctx);
+
+        schoof_opt_t resume_opt;
+        *resume_opt = *opt;
+        resume_opt->checkpoint = path;
+
+        success = schoof_with_opt(res, fq_a, fq_b, resume_opt, ctx);
+
+        fq_clear(fq_a, ctx);
+        fq_clear(fq_b, ctx);
+        fq_ctx_clear(ctx);
+    }
+
+    fmpz_clear(p);
+    fmpz_clear(a);
+    fmpz_clear(b);
+    return success;
 }
\ No newline at end of file
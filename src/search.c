@@ -0,0 +1,337 @@
+#include "search.h"
+
+void search_opt_init(search_opt_t sopt) {
+    sopt->threads = 1;
+    sopt->max_cofactor = 1;
+    sopt->max_candidates = 0;
+    sopt->seed = 0;
+    sopt->tried = NULL;
+    sopt->filtered = NULL;
+}
+
+void search_curve_init(search_curve_t curve, const fq_ctx_t ctx) {
+    fq_init(curve->a, ctx);
+    fq_init(curve->b, ctx);
+    fmpz_init(curve->order);
+    fmpz_init(curve->cofactor);
+    fmpz_init(curve->twist_order);
+}
+
+void search_curve_clear(search_curve_t curve, const fq_ctx_t ctx) {
+    fq_clear(curve->a, ctx);
+    fq_clear(curve->b, ctx);
+    fmpz_clear(curve->order);
+    fmpz_clear(curve->cofactor);
+    fmpz_clear(curve->twist_order);
+}
+
+/**
+ * Renvoie 1 si E a un point d'ordre 2, c'est-à-dire si W = x^3 + a*x + b a une racine dans F_q, soit
+ * pgcd(x^q - x, W) != 1. Dans ce cas 2 divise N.
+ */
+int search_two_torsion(const ell_curve_t E, const fq_ctx_t ctx) {
+    fmpz_t q;
+    fmpz_init(q);
+    fq_ctx_order(q, ctx);
+
+    fq_t one;
+    fq_init(one, ctx);
+    fq_one(one, ctx);
+
+    fq_poly_t W, X, g;
+    fq_poly_init(W, ctx);
+    fq_poly_init(X, ctx);
+    fq_poly_init(g, ctx);
+
+    fq_poly_set_coeff(W, 3, one, ctx);
+    fq_poly_set_coeff(W, 1, E->a, ctx);
+    fq_poly_set_coeff(W, 0, E->b, ctx);
+    fq_poly_set_coeff(X, 1, one, ctx);
+
+    fq_poly_powmod_fmpz_binexp(g, X, q, W, ctx);
+    fq_poly_sub(g, g, X, ctx);
+    fq_poly_gcd(g, g, W, ctx);
+    int res = (fq_poly_degree(g, ctx) > 0);
+
+    fmpz_clear(q);
+    fq_clear(one, ctx);
+    fq_poly_clear(W, ctx);
+    fq_poly_clear(X, ctx);
+    fq_poly_clear(g, ctx);
+    return res;
+}
+
+/**
+ * Renvoie 1 si l est plus petit que tout nombre de points possible sur F_q, c'est-à-dire l < (sqrt(q) - 1)^2
+ * (borne de Hasse) : un N divisible par l est alors composé, 0 sinon (N = l reste possible).
+ */
+int search_below_hasse(const fmpz_t q, const ulong l) {
+    fmpz_t s;
+    fmpz_init(s);
+    fmpz_sqrt(s, q);
+
+    // (floor(sqrt(q)) - 1)^2 <= (sqrt(q) - 1)^2
+    int res = !fmpz_is_zero(s);
+    if (res) {
+        fmpz_sub_ui(s, s, 1);
+        fmpz_mul(s, s, s);
+        res = (fmpz_cmp_ui(s, l) > 0);
+    }
+
+    fmpz_clear(s);
+    return res;
+}
+
+/**
+ * Appelée par ell_schoof() après chaque l (c.f schoof_progress_func) : N = q + 1 - a_q est divisible par l si
+ * et seulement si a_q ≡ q + 1 modulo l. Dès que le produit des l qui divisent N dépasse le cofacteur maximal,
+ * la candidate est écartée et son calcul interrompu. Un l qui pourrait être N lui-même (c.f search_below_hasse())
+ * n'est pas compté : N = l est premier.
+ */
+void search_filter(const schoof_progress_struct* progress, void* data) {
+    search_filter_struct* filter = (search_filter_struct*)data;
+    ulong l = progress->l;
+
+    if ((fmpz_fdiv_ui(filter->q, l) + 1) % l != progress->t % l || !search_below_hasse(filter->q, l)) return;
+
+    filter->known *= l;
+    if (filter->known > filter->max_cofactor) {
+        filter->rejected = 1;
+        __atomic_store_n(filter->cancel, 1, __ATOMIC_RELAXED);
+    }
+}
+
+/**
+ * Vérifie que N = h*r avec h <= max_cofactor, r premier (au sens de fmpz_is_probabprime()) et r > 4*sqrt(q), et
+ * qu'un point aléatoire P de E vérifie [N]P = 0 et [h]P != 0 : [h]P est alors d'ordre r, qui divise donc
+ * #E(F_q), et N est le seul multiple de r dans l'intervalle de Hasse. Affecte le plus petit tel h à cofactor et
+ * renvoie 1, ou renvoie 0.
+ */
+int search_verify(fmpz_t cofactor, const fmpz_t N, const ell_curve_t E, const ulong max_cofactor, flint_rand_t state, const fq_ctx_t ctx) {
+    fmpz_t r, r2, q16;
+    fmpz_init(r);
+    fmpz_init(r2);
+    fmpz_init(q16);
+
+    // r > 4*sqrt(q) si et seulement si r^2 > 16*q
+    fq_ctx_order(q16, ctx);
+    fmpz_mul_ui(q16, q16, 16);
+
+    int prime = 0;
+    for (ulong h = 1; h <= max_cofactor && !prime; h++) {
+        if (fmpz_fdiv_ui(N, h) != 0) continue;
+
+        fmpz_divexact_ui(r, N, h);
+        fmpz_mul(r2, r, r);
+        if (fmpz_cmp(r2, q16) > 0 && fmpz_is_probabprime(r)) {
+            fmpz_set_ui(cofactor, h);
+            prime = 1;
+        }
+    }
+
+    int verified = 0;
+    if (prime) {
+        ell_fq_point_t P, R;
+        ell_fq_point_init(P, ctx);
+        ell_fq_point_init(R, ctx);
+
+        // Un point tel que [h]P = 0 ne dit rien, on en tire un autre
+        for (slong i = 0; i < SEARCH_POINT_TRIES && verified == 0; i++) {
+            ell_fq_point_random(P, E, state, ctx);
+            ell_fq_point_mul(R, P, cofactor, E, ctx);
+            if (R->infinity) continue;
+
+            ell_fq_point_mul(R, R, r, E, ctx);
+            verified = R->infinity ? 1 : -1;
+        }
+
+        ell_fq_point_clear(P, ctx);
+        ell_fq_point_clear(R, ctx);
+    }
+
+    fmpz_clear(r);
+    fmpz_clear(r2);
+    fmpz_clear(q16);
+    return verified == 1;
+}
+
+/**
+ * Compte la courbe y^2 = x^3 + a*x + b et la garde dans res si elle convient (c.f search.h), auquel cas renvoie 1.
+ * Le calcul est interrompu dès que *cancel devient non nul, par search_filter() ou par un autre thread.
+ */
+int search_candidate(search_curve_t res, const fq_t a, const fq_t b, int* cancel, search_t search, flint_rand_t state) {
+    const fq_ctx_struct* ctx = search->ctx;
+
+    ell_curve_t E;
+    ell_curve_init(E, ctx);
+    if (ell_curve_set(E, a, b, ctx) != EXIT_SUCCESS) {
+        ell_curve_clear(E, ctx);
+        return 0;
+    }
+
+    fmpz_t q;
+    fmpz_init(q);
+    fq_ctx_order(q, ctx);
+
+    search_filter_struct filter = {q, search->sopt->max_cofactor, 1, 0, cancel};
+    int accepted = 0;
+
+    // Un point d'ordre 2 suffit à écarter la courbe sans passer par l'algorithme de Schoof
+    if (search_below_hasse(q, 2) && search_two_torsion(E, ctx)) filter.known = 2;
+
+    if (filter.known > filter.max_cofactor) {
+        filter.rejected = 1;
+    } else {
+        // Les classes au signe près, les puissances de l, les processus et les fichiers de reprise sont incompatibles
+        // avec le filtre ou avec plusieurs candidates en même temps
+        schoof_opt_t opt;
+        *opt = *search->opt;
+        opt->progress = search_filter;
+        opt->progress_data = &filter;
+        opt->cancel = cancel;
+        opt->match_sort = 0;
+        opt->prime_powers = 0;
+        opt->workers = 0;
+        opt->checkpoint = NULL;
+
+        schoof_partial_t partial;
+        schoof_partial_init(partial);
+
+        if (schoof_interruptible(res->order, partial, a, b, opt, ctx) == EXIT_SUCCESS && !filter.rejected
+            && search_verify(res->cofactor, res->order, E, filter.max_cofactor, state, ctx)) {
+            fq_set(res->a, a, ctx);
+            fq_set(res->b, b, ctx);
+
+            // La tordue quadratique a 2*q + 2 - N points
+            fmpz_add_ui(res->twist_order, q, 1);
+            fmpz_mul_ui(res->twist_order, res->twist_order, 2);
+            fmpz_sub(res->twist_order, res->twist_order, res->order);
+            accepted = 1;
+        }
+
+        schoof_partial_clear(partial);
+    }
+
+    if (filter.rejected) {
+        pthread_mutex_lock(&search->mutex);
+        search->filtered++;
+        pthread_mutex_unlock(&search->mutex);
+    }
+
+    fmpz_clear(q);
+    ell_curve_clear(E, ctx);
+    return accepted;
+}
+
+/**
+ * Tire et essaie des courbes jusqu'à ce que le nombre de courbes demandé soit atteint (par ce thread ou un autre)
+ * ou que le nombre maximal de courbes essayées soit dépassé. La dernière courbe trouvée interrompt les candidates
+ * des autres threads.
+ */
+void search_run(search_t search) {
+    const fq_ctx_struct* ctx = search->ctx;
+
+    pthread_mutex_lock(&search->mutex);
+    int* cancel = search->cancel + search->next_thread++;
+    pthread_mutex_unlock(&search->mutex);
+
+    fq_t a, b;
+    fq_init(a, ctx);
+    fq_init(b, ctx);
+
+    search_curve_t candidate;
+    search_curve_init(candidate, ctx);
+
+    // Points aléatoires de search_verify(), propres au thread
+    flint_rand_t state;
+    flint_randinit(state);
+
+    for (;;) {
+        pthread_mutex_lock(&search->mutex);
+        int stop = (search->num_found >= search->wanted || (search->sopt->max_candidates > 0 && search->tried >= search->sopt->max_candidates));
+        if (!stop) {
+            search->tried++;
+            __atomic_store_n(cancel, 0, __ATOMIC_RELAXED);
+            fq_rand(a, search->state, ctx);
+            fq_rand(b, search->state, ctx);
+        }
+        pthread_mutex_unlock(&search->mutex);
+        if (stop) break;
+
+        if (!search_candidate(candidate, a, b, cancel, search, state)) continue;
+
+        pthread_mutex_lock(&search->mutex);
+        if (search->num_found < search->wanted) {
+            search_curve_struct* found = search->found + search->num_found++;
+            fq_set(found->a, candidate->a, ctx);
+            fq_set(found->b, candidate->b, ctx);
+            fmpz_set(found->order, candidate->order);
+            fmpz_set(found->cofactor, candidate->cofactor);
+            fmpz_set(found->twist_order, candidate->twist_order);
+
+            if (search->num_found == search->wanted) {
+                for (slong i = 0; i < search->sopt->threads; i++) __atomic_store_n(search->cancel + i, 1, __ATOMIC_RELAXED);
+            }
+        }
+        pthread_mutex_unlock(&search->mutex);
+    }
+
+    fq_clear(a, ctx);
+    fq_clear(b, ctx);
+    search_curve_clear(candidate, ctx);
+    flint_randclear(state);
+}
+
+void* search_worker(void* arg) {
+    search_run((search_struct*)arg);
+
+    flint_cleanup(); // Libère les caches propres au thread
+    return NULL;
+}
+
+/**
+ * Cherche wanted courbes y^2 = x^3 + a*x + b sur F_q d'ordre N = h*r, r premier et h <= sopt->max_cofactor, avec
+ * sopt->threads candidates comptées en même temps (c.f search.h) et les options opt de l'algorithme de Schoof
+ * (sauf match_sort, prime_powers, workers et checkpoint, ignorées). Les courbes sont écrites dans res, tableau de
+ * wanted éléments initialisés, dans l'ordre où elles sont trouvées.
+ * Renvoie le nombre de courbes trouvées, moins de wanted seulement si sopt->max_candidates a été atteint.
+ */
+slong search_curves(search_curve_struct* res, const slong wanted, const search_opt_t sopt, const schoof_opt_t opt, const fq_ctx_t ctx) {
+    search_opt_t run_sopt;
+    *run_sopt = *sopt;
+    run_sopt->threads = FLINT_MAX(sopt->threads, 1);
+
+    search_t search;
+    pthread_mutex_init(&search->mutex, NULL);
+    search->found = res;
+    search->wanted = wanted;
+    search->num_found = 0;
+    search->cancel = (int*)calloc(run_sopt->threads, sizeof(int));
+    search->next_thread = 0;
+    search->tried = 0;
+    search->filtered = 0;
+    flint_randinit(search->state);
+    if (sopt->seed != 0) flint_randseed(search->state, sopt->seed, sopt->seed + 1);
+    search->sopt = run_sopt;
+    search->opt = opt;
+    search->ctx = ctx;
+
+    pthread_t* workers = (pthread_t*)malloc((run_sopt->threads - 1) * sizeof(pthread_t));
+    slong num_workers = 0;
+    for (slong i = 0; i < run_sopt->threads - 1; i++) {
+        if (pthread_create(workers + num_workers, NULL, search_worker, search) == 0) num_workers++;
+    }
+
+    search_run(search);
+    for (slong i = 0; i < num_workers; i++) pthread_join(workers[i], NULL);
+
+    if (sopt->tried != NULL) *sopt->tried = search->tried;
+    if (sopt->filtered != NULL) *sopt->filtered = search->filtered;
+    slong num_found = search->num_found;
+
+    free(workers);
+    free(search->cancel);
+    flint_randclear(search->state);
+    pthread_mutex_destroy(&search->mutex);
+    return num_found;
+}
\ No newline at end of file
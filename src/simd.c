@@ -0,0 +1,462 @@
+#include "simd.h"
+
+// Les noyaux vectorisés ne sont compilés que pour x86-64, avec les attributs target de GCC et Clang
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define SIMD_X86 1
+#include <immintrin.h>
+#else
+#define SIMD_X86 0
+#endif
+
+/**************/
+/* PRIMITIVES */
+/**************/
+
+/**
+ * Choisit le meilleur jeu d'instructions disponible si q = p est premier de moins de SIMD_MAX_BITS bits, sinon
+ * simd->level = SIMD_NONE et aucune fonction de ce fichier ne doit être utilisée.
+ */
+void simd_ctx_init(simd_ctx_t simd, const fq_ctx_t ctx) {
+    const fmpz* p = fq_ctx_prime(ctx);
+
+    simd->level = SIMD_NONE;
+    simd->p = 0;
+    simd->p_inv = 0;
+    if (fq_ctx_degree(ctx) != 1 || fmpz_bits(p) > SIMD_MAX_BITS) return;
+
+    simd->p = (double)fmpz_get_ui(p);
+    simd->p_inv = 1.0 / simd->p;
+    simd->level = SIMD_SCALAR;
+
+#if SIMD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) simd->level = SIMD_AVX2;
+    if (__builtin_cpu_supports("avx512f")) simd->level = SIMD_AVX512;
+#endif
+}
+
+double simd_addmod(const double a, const double b, const simd_ctx_t simd) {
+    double r = a + b;
+    return (r >= simd->p) ? r - simd->p : r;
+}
+
+double simd_submod(const double a, const double b, const simd_ctx_t simd) {
+    double r = a - b;
+    return (r < 0) ? r + simd->p : r;
+}
+
+/**
+ * Produit modulaire exact par FMA (c.f simd.h). -std=c11 interdit au compilateur de fusionner a*b avec une
+ * autre opération, h est donc bien le produit arrondi.
+ */
+double simd_mulmod(const double a, const double b, const simd_ctx_t simd) {
+    double h = a * b;
+    double l = fma(a, b, -h);
+    double k = floor(h * simd->p_inv);
+    double r = fma(-k, simd->p, h) + l;
+
+    if (r >= simd->p) r -= simd->p;
+    if (r < 0) r += simd->p;
+    return r;
+}
+
+/***************************/
+/* NOYAUX PAR INSTRUCTIONS */
+/***************************/
+
+/**
+ * rop = op1*op2 (rop de longueur len1+len2-1, sans recouvrement), et réduction en place de op modulo psi unitaire
+ * de longueur len_psi. Les trois familles de noyaux font exactement les mêmes opérations, seul le nombre de
+ * coefficients traités à la fois change.
+ */
+void _simd_poly_mul_scalar(double* rop, const double* op1, const slong len1, const double* op2, const slong len2, const simd_ctx_t simd) {
+    memset(rop, 0, (len1 + len2 - 1) * sizeof(double));
+    for (slong i = 0; i < len1; i++) {
+        for (slong j = 0; j < len2; j++) rop[i + j] = simd_addmod(rop[i + j], simd_mulmod(op1[i], op2[j], simd), simd);
+    }
+}
+
+void _simd_poly_rem_scalar(double* op, const slong len, const double* psi, const slong len_psi, const simd_ctx_t simd) {
+    for (slong i = len - 1; i >= len_psi - 1; i--) {
+        double c = op[i];
+        double* shift = op + i - len_psi + 1;
+        for (slong j = 0; j < len_psi - 1; j++) shift[j] = simd_submod(shift[j], simd_mulmod(c, psi[j], simd), simd);
+    }
+}
+
+/**
+ * Mêmes opérations sur lanes polynômes entrelacés (c.f simd_lanes_mul()), psi étant lui aussi entrelacé : chaque
+ * polynôme est réduit modulo le sien.
+ */
+void _simd_lanes_mul_scalar(double* rop, const double* op1, const slong len1, const double* op2, const slong len2, const slong lanes, const simd_ctx_t simd) {
+    memset(rop, 0, (len1 + len2 - 1) * lanes * sizeof(double));
+    for (slong i = 0; i < len1; i++) {
+        for (slong j = 0; j < len2; j++) {
+            double* acc = rop + (i + j) * lanes;
+            for (slong k = 0; k < lanes; k++) acc[k] = simd_addmod(acc[k], simd_mulmod(op1[i * lanes + k], op2[j * lanes + k], simd), simd);
+        }
+    }
+}
+
+void _simd_lanes_rem_scalar(double* op, const slong len, const double* psi, const slong len_psi, const slong lanes, const simd_ctx_t simd) {
+    for (slong i = len - 1; i >= len_psi - 1; i--) {
+        const double* c = op + i * lanes;
+        double* shift = op + (i - len_psi + 1) * lanes;
+        for (slong j = 0; j < len_psi - 1; j++) {
+            for (slong k = 0; k < lanes; k++) shift[j * lanes + k] = simd_submod(shift[j * lanes + k], simd_mulmod(c[k], psi[j * lanes + k], simd), simd);
+        }
+    }
+}
+
+#if SIMD_X86
+
+// r = a*b mod p sur 4 coefficients, avec p_v = p et p_inv_v = 1/p diffusés
+#define SIMD_MULMOD_AVX2(r, a, b, p_v, p_inv_v) do { \
+        __m256d _h = _mm256_mul_pd(a, b); \
+        __m256d _l = _mm256_fmsub_pd(a, b, _h); \
+        __m256d _k = _mm256_floor_pd(_mm256_mul_pd(_h, p_inv_v)); \
+        r = _mm256_add_pd(_mm256_fnmadd_pd(_k, p_v, _h), _l); \
+        r = _mm256_sub_pd(r, _mm256_and_pd(_mm256_cmp_pd(r, p_v, _CMP_GE_OQ), p_v)); \
+        r = _mm256_add_pd(r, _mm256_and_pd(_mm256_cmp_pd(r, _mm256_setzero_pd(), _CMP_LT_OQ), p_v)); \
+    } while (0)
+
+// Même calcul sur 8 coefficients, les comparaisons donnant des masques de bits
+#define SIMD_MULMOD_AVX512(r, a, b, p_v, p_inv_v) do { \
+        __m512d _h = _mm512_mul_pd(a, b); \
+        __m512d _l = _mm512_fmsub_pd(a, b, _h); \
+        __m512d _k = _mm512_roundscale_pd(_mm512_mul_pd(_h, p_inv_v), _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC); \
+        r = _mm512_add_pd(_mm512_fnmadd_pd(_k, p_v, _h), _l); \
+        r = _mm512_mask_sub_pd(r, _mm512_cmp_pd_mask(r, p_v, _CMP_GE_OQ), r, p_v); \
+        r = _mm512_mask_add_pd(r, _mm512_cmp_pd_mask(r, _mm512_setzero_pd(), _CMP_LT_OQ), r, p_v); \
+    } while (0)
+
+__attribute__((target("avx2,fma")))
+void _simd_poly_mul_avx2(double* rop, const double* op1, const slong len1, const double* op2, const slong len2, const simd_ctx_t simd) {
+    const __m256d p_v = _mm256_set1_pd(simd->p);
+    const __m256d p_inv_v = _mm256_set1_pd(simd->p_inv);
+
+    memset(rop, 0, (len1 + len2 - 1) * sizeof(double));
+    for (slong i = 0; i < len1; i++) {
+        const __m256d a = _mm256_set1_pd(op1[i]);
+        double* acc = rop + i;
+
+        slong j = 0;
+        for (; j + 4 <= len2; j += 4) {
+            __m256d r;
+            SIMD_MULMOD_AVX2(r, a, _mm256_loadu_pd(op2 + j), p_v, p_inv_v);
+            r = _mm256_add_pd(r, _mm256_loadu_pd(acc + j));
+            r = _mm256_sub_pd(r, _mm256_and_pd(_mm256_cmp_pd(r, p_v, _CMP_GE_OQ), p_v));
+            _mm256_storeu_pd(acc + j, r);
+        }
+        for (; j < len2; j++) acc[j] = simd_addmod(acc[j], simd_mulmod(op1[i], op2[j], simd), simd);
+    }
+}
+
+__attribute__((target("avx2,fma")))
+void _simd_poly_rem_avx2(double* op, const slong len, const double* psi, const slong len_psi, const simd_ctx_t simd) {
+    const __m256d p_v = _mm256_set1_pd(simd->p);
+    const __m256d p_inv_v = _mm256_set1_pd(simd->p_inv);
+
+    for (slong i = len - 1; i >= len_psi - 1; i--) {
+        const __m256d c = _mm256_set1_pd(op[i]);
+        double* shift = op + i - len_psi + 1;
+
+        slong j = 0;
+        for (; j + 4 <= len_psi - 1; j += 4) {
+            __m256d r;
+            SIMD_MULMOD_AVX2(r, c, _mm256_loadu_pd(psi + j), p_v, p_inv_v);
+            r = _mm256_sub_pd(_mm256_loadu_pd(shift + j), r);
+            r = _mm256_add_pd(r, _mm256_and_pd(_mm256_cmp_pd(r, _mm256_setzero_pd(), _CMP_LT_OQ), p_v));
+            _mm256_storeu_pd(shift + j, r);
+        }
+        for (; j < len_psi - 1; j++) shift[j] = simd_submod(shift[j], simd_mulmod(op[i], psi[j], simd), simd);
+    }
+}
+
+__attribute__((target("avx512f")))
+void _simd_poly_mul_avx512(double* rop, const double* op1, const slong len1, const double* op2, const slong len2, const simd_ctx_t simd) {
+    const __m512d p_v = _mm512_set1_pd(simd->p);
+    const __m512d p_inv_v = _mm512_set1_pd(simd->p_inv);
+
+    memset(rop, 0, (len1 + len2 - 1) * sizeof(double));
+    for (slong i = 0; i < len1; i++) {
+        const __m512d a = _mm512_set1_pd(op1[i]);
+        double* acc = rop + i;
+
+        // Les derniers coefficients sont traités par des chargements masqués
+        for (slong j = 0; j < len2; j += 8) {
+            __mmask8 mask = (len2 - j >= 8) ? 0xFF : (__mmask8)((1U << (len2 - j)) - 1);
+            __m512d r;
+            SIMD_MULMOD_AVX512(r, a, _mm512_maskz_loadu_pd(mask, op2 + j), p_v, p_inv_v);
+            r = _mm512_add_pd(r, _mm512_maskz_loadu_pd(mask, acc + j));
+            r = _mm512_mask_sub_pd(r, _mm512_cmp_pd_mask(r, p_v, _CMP_GE_OQ), r, p_v);
+            _mm512_mask_storeu_pd(acc + j, mask, r);
+        }
+    }
+}
+
+__attribute__((target("avx512f")))
+void _simd_poly_rem_avx512(double* op, const slong len, const double* psi, const slong len_psi, const simd_ctx_t simd) {
+    const __m512d p_v = _mm512_set1_pd(simd->p);
+    const __m512d p_inv_v = _mm512_set1_pd(simd->p_inv);
+
+    for (slong i = len - 1; i >= len_psi - 1; i--) {
+        const __m512d c = _mm512_set1_pd(op[i]);
+        double* shift = op + i - len_psi + 1;
+
+        for (slong j = 0; j < len_psi - 1; j += 8) {
+            __mmask8 mask = (len_psi - 1 - j >= 8) ? 0xFF : (__mmask8)((1U << (len_psi - 1 - j)) - 1);
+            __m512d r;
+            SIMD_MULMOD_AVX512(r, c, _mm512_maskz_loadu_pd(mask, psi + j), p_v, p_inv_v);
+            r = _mm512_sub_pd(_mm512_maskz_loadu_pd(mask, shift + j), r);
+            r = _mm512_mask_add_pd(r, _mm512_cmp_pd_mask(r, _mm512_setzero_pd(), _CMP_LT_OQ), r, p_v);
+            _mm512_mask_storeu_pd(shift + j, mask, r);
+        }
+    }
+}
+
+__attribute__((target("avx2,fma")))
+void _simd_lanes_mul_avx2(double* rop, const double* op1, const slong len1, const double* op2, const slong len2, const slong lanes, const simd_ctx_t simd) {
+    const __m256d p_v = _mm256_set1_pd(simd->p);
+    const __m256d p_inv_v = _mm256_set1_pd(simd->p_inv);
+
+    memset(rop, 0, (len1 + len2 - 1) * lanes * sizeof(double));
+    for (slong i = 0; i < len1; i++) {
+        for (slong j = 0; j < len2; j++) {
+            double* acc = rop + (i + j) * lanes;
+
+            for (slong k = 0; k < lanes; k += 4) {
+                __m256d r;
+                SIMD_MULMOD_AVX2(r, _mm256_loadu_pd(op1 + i * lanes + k), _mm256_loadu_pd(op2 + j * lanes + k), p_v, p_inv_v);
+                r = _mm256_add_pd(r, _mm256_loadu_pd(acc + k));
+                r = _mm256_sub_pd(r, _mm256_and_pd(_mm256_cmp_pd(r, p_v, _CMP_GE_OQ), p_v));
+                _mm256_storeu_pd(acc + k, r);
+            }
+        }
+    }
+}
+
+__attribute__((target("avx2,fma")))
+void _simd_lanes_rem_avx2(double* op, const slong len, const double* psi, const slong len_psi, const slong lanes, const simd_ctx_t simd) {
+    const __m256d p_v = _mm256_set1_pd(simd->p);
+    const __m256d p_inv_v = _mm256_set1_pd(simd->p_inv);
+
+    for (slong i = len - 1; i >= len_psi - 1; i--) {
+        const double* c = op + i * lanes;
+        double* shift = op + (i - len_psi + 1) * lanes;
+
+        for (slong j = 0; j < len_psi - 1; j++) {
+            for (slong k = 0; k < lanes; k += 4) {
+                __m256d r;
+                SIMD_MULMOD_AVX2(r, _mm256_loadu_pd(c + k), _mm256_loadu_pd(psi + j * lanes + k), p_v, p_inv_v);
+                r = _mm256_sub_pd(_mm256_loadu_pd(shift + j * lanes + k), r);
+                r = _mm256_add_pd(r, _mm256_and_pd(_mm256_cmp_pd(r, _mm256_setzero_pd(), _CMP_LT_OQ), p_v));
+                _mm256_storeu_pd(shift + j * lanes + k, r);
+            }
+        }
+    }
+}
+
+__attribute__((target("avx512f")))
+void _simd_lanes_mul_avx512(double* rop, const double* op1, const slong len1, const double* op2, const slong len2, const slong lanes, const simd_ctx_t simd) {
+    const __m512d p_v = _mm512_set1_pd(simd->p);
+    const __m512d p_inv_v = _mm512_set1_pd(simd->p_inv);
+
+    memset(rop, 0, (len1 + len2 - 1) * lanes * sizeof(double));
+    for (slong i = 0; i < len1; i++) {
+        for (slong j = 0; j < len2; j++) {
+            double* acc = rop + (i + j) * lanes;
+
+            for (slong k = 0; k < lanes; k += 8) {
+                __m512d r;
+                SIMD_MULMOD_AVX512(r, _mm512_loadu_pd(op1 + i * lanes + k), _mm512_loadu_pd(op2 + j * lanes + k), p_v, p_inv_v);
+                r = _mm512_add_pd(r, _mm512_loadu_pd(acc + k));
+                r = _mm512_mask_sub_pd(r, _mm512_cmp_pd_mask(r, p_v, _CMP_GE_OQ), r, p_v);
+                _mm512_storeu_pd(acc + k, r);
+            }
+        }
+    }
+}
+
+__attribute__((target("avx512f")))
+void _simd_lanes_rem_avx512(double* op, const slong len, const double* psi, const slong len_psi, const slong lanes, const simd_ctx_t simd) {
+    const __m512d p_v = _mm512_set1_pd(simd->p);
+    const __m512d p_inv_v = _mm512_set1_pd(simd->p_inv);
+
+    for (slong i = len - 1; i >= len_psi - 1; i--) {
+        const double* c = op + i * lanes;
+        double* shift = op + (i - len_psi + 1) * lanes;
+
+        for (slong j = 0; j < len_psi - 1; j++) {
+            for (slong k = 0; k < lanes; k += 8) {
+                __m512d r;
+                SIMD_MULMOD_AVX512(r, _mm512_loadu_pd(c + k), _mm512_loadu_pd(psi + j * lanes + k), p_v, p_inv_v);
+                r = _mm512_sub_pd(_mm512_loadu_pd(shift + j * lanes + k), r);
+                r = _mm512_mask_add_pd(r, _mm512_cmp_pd_mask(r, _mm512_setzero_pd(), _CMP_LT_OQ), r, p_v);
+                _mm512_storeu_pd(shift + j * lanes + k, r);
+            }
+        }
+    }
+}
+
+#else
+
+// Sans x86-64, simd_ctx_init() ne choisit jamais ces noyaux
+void _simd_lanes_mul_avx2(double* rop, const double* op1, const slong len1, const double* op2, const slong len2, const slong lanes, const simd_ctx_t simd) {
+    _simd_lanes_mul_scalar(rop, op1, len1, op2, len2, lanes, simd);
+}
+
+void _simd_lanes_rem_avx2(double* op, const slong len, const double* psi, const slong len_psi, const slong lanes, const simd_ctx_t simd) {
+    _simd_lanes_rem_scalar(op, len, psi, len_psi, lanes, simd);
+}
+
+void _simd_lanes_mul_avx512(double* rop, const double* op1, const slong len1, const double* op2, const slong len2, const slong lanes, const simd_ctx_t simd) {
+    _simd_lanes_mul_scalar(rop, op1, len1, op2, len2, lanes, simd);
+}
+
+void _simd_lanes_rem_avx512(double* op, const slong len, const double* psi, const slong len_psi, const slong lanes, const simd_ctx_t simd) {
+    _simd_lanes_rem_scalar(op, len, psi, len_psi, lanes, simd);
+}
+
+void _simd_poly_mul_avx2(double* rop, const double* op1, const slong len1, const double* op2, const slong len2, const simd_ctx_t simd) {
+    _simd_poly_mul_scalar(rop, op1, len1, op2, len2, simd);
+}
+
+void _simd_poly_rem_avx2(double* op, const slong len, const double* psi, const slong len_psi, const simd_ctx_t simd) {
+    _simd_poly_rem_scalar(op, len, psi, len_psi, simd);
+}
+
+void _simd_poly_mul_avx512(double* rop, const double* op1, const slong len1, const double* op2, const slong len2, const simd_ctx_t simd) {
+    _simd_poly_mul_scalar(rop, op1, len1, op2, len2, simd);
+}
+
+void _simd_poly_rem_avx512(double* op, const slong len, const double* psi, const slong len_psi, const simd_ctx_t simd) {
+    _simd_poly_rem_scalar(op, len, psi, len_psi, simd);
+}
+
+#endif
+
+/************************/
+/* POLYNOMES VECTORISES */
+/************************/
+
+/**
+ * Écrit les len premiers coefficients de op (complétés par des zéros) dans rop.
+ */
+void simd_poly_set_fq_poly(double* rop, const fq_poly_t op, const slong len, const fq_ctx_t ctx) {
+    fmpz_t c;
+    fmpz_init(c);
+
+    slong len_op = FLINT_MIN(len, fq_poly_length(op, ctx));
+    for (slong i = 0; i < len_op; i++) {
+        fq_get_fmpz(c, op->coeffs + i, ctx);
+        rop[i] = (double)fmpz_get_ui(c);
+    }
+    for (slong i = len_op; i < len; i++) rop[i] = 0;
+
+    fmpz_clear(c);
+}
+
+void simd_poly_get_fq_poly(fq_poly_t rop, const double* op, const slong len, const fq_ctx_t ctx) {
+    fmpz_t c;
+    fmpz_init(c);
+
+    fq_poly_fit_length(rop, len, ctx);
+    for (slong i = 0; i < len; i++) {
+        fmpz_set_ui(c, (ulong)op[i]);
+        fq_set_fmpz(rop->coeffs + i, c, ctx);
+    }
+    for (slong i = len; i < fq_poly_length(rop, ctx); i++) fq_zero(rop->coeffs + i, ctx);
+    _fq_poly_set_length(rop, len, ctx);
+    _fq_poly_normalise(rop, ctx);
+
+    fmpz_clear(c);
+}
+
+/**
+ * rop = op1*op2, de longueur len1+len2-1 >= 1, sans recouvrement.
+ */
+void simd_poly_mul(double* rop, const double* op1, const slong len1, const double* op2, const slong len2, const simd_ctx_t simd) {
+    switch (simd->level) {
+        case SIMD_AVX512: _simd_poly_mul_avx512(rop, op1, len1, op2, len2, simd); break;
+        case SIMD_AVX2: _simd_poly_mul_avx2(rop, op1, len1, op2, len2, simd); break;
+        default: _simd_poly_mul_scalar(rop, op1, len1, op2, len2, simd); break;
+    }
+}
+
+/**
+ * Réduit en place op, de longueur len, modulo psi unitaire de longueur len_psi : le reste occupe les
+ * len_psi-1 premiers coefficients (les suivants sont sans signification).
+ */
+void simd_poly_rem(double* op, const slong len, const double* psi, const slong len_psi, const simd_ctx_t simd) {
+    if (len < len_psi) return;
+
+    switch (simd->level) {
+        case SIMD_AVX512: _simd_poly_rem_avx512(op, len, psi, len_psi, simd); break;
+        case SIMD_AVX2: _simd_poly_rem_avx2(op, len, psi, len_psi, simd); break;
+        default: _simd_poly_rem_scalar(op, len, psi, len_psi, simd); break;
+    }
+}
+
+/**
+ * rop = op1*op2 mod psi, où psi est unitaire de longueur len_psi >= 2. rop reçoit len_psi-1 coefficients et peut
+ * recouvrir op1 ou op2.
+ */
+void simd_poly_mulmod(double* rop, const double* op1, const slong len1, const double* op2, const slong len2, const double* psi, const slong len_psi, const simd_ctx_t simd) {
+    if (len1 == 0 || len2 == 0) {
+        memset(rop, 0, (len_psi - 1) * sizeof(double));
+        return;
+    }
+
+    slong len = len1 + len2 - 1;
+    double* prod = (double*)flint_malloc(len * sizeof(double));
+
+    simd_poly_mul(prod, op1, len1, op2, len2, simd);
+    simd_poly_rem(prod, len, psi, len_psi, simd);
+
+    slong len_res = FLINT_MIN(len, len_psi - 1);
+    memcpy(rop, prod, len_res * sizeof(double));
+    memset(rop + len_res, 0, (len_psi - 1 - len_res) * sizeof(double));
+
+    flint_free(prod);
+}
+
+/************************/
+/* POLYNOMES ENTRELACES */
+/************************/
+
+/**
+ * Nombre de doubles d'un vecteur du jeu d'instructions choisi, dont le nombre de polynômes entrelacés doit être un
+ * multiple.
+ */
+slong simd_lanes(const simd_ctx_t simd) {
+    switch (simd->level) {
+        case SIMD_AVX512: return 8;
+        case SIMD_AVX2: return 4;
+        default: return 1;
+    }
+}
+
+/**
+ * rop = op1*op2 polynôme par polynôme, rop de longueur len1+len2-1 >= 1 et sans recouvrement.
+ */
+void simd_lanes_mul(double* rop, const double* op1, const slong len1, const double* op2, const slong len2, const slong lanes, const simd_ctx_t simd) {
+    switch (simd->level) {
+        case SIMD_AVX512: _simd_lanes_mul_avx512(rop, op1, len1, op2, len2, lanes, simd); break;
+        case SIMD_AVX2: _simd_lanes_mul_avx2(rop, op1, len1, op2, len2, lanes, simd); break;
+        default: _simd_lanes_mul_scalar(rop, op1, len1, op2, len2, lanes, simd); break;
+    }
+}
+
+/**
+ * Réduit en place chaque polynôme de op modulo le polynôme unitaire correspondant de psi (c.f simd_poly_rem()).
+ */
+void simd_lanes_rem(double* op, const slong len, const double* psi, const slong len_psi, const slong lanes, const simd_ctx_t simd) {
+    if (len < len_psi) return;
+
+    switch (simd->level) {
+        case SIMD_AVX512: _simd_lanes_rem_avx512(op, len, psi, len_psi, lanes, simd); break;
+        case SIMD_AVX2: _simd_lanes_rem_avx2(op, len, psi, len_psi, lanes, simd); break;
+        default: _simd_lanes_rem_scalar(op, len, psi, len_psi, lanes, simd); break;
+    }
+}
\ No newline at end of file
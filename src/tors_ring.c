@@ -1,3 +1,6 @@
+#define _POSIX_C_SOURCE 200809L // clock_gettime()
+
+#include <time.h>
 #include "tors_ring.h"
 
 /*********************************/
@@ -7,16 +10,183 @@
 void tors_ring_init(tors_ring_t tors_ring, const fq_ctx_t ctx) {
     ell_curve_init(tors_ring->curve, ctx);
     fq_poly_init(tors_ring->psi, ctx);
+    fq_poly_init(tors_ring->W, ctx);
+    mont_ctx_init(tors_ring->mont, ctx);
+    simd_ctx_init(tors_ring->simd, ctx);
+    tors_ring->mont_psi = NULL;
+    tors_ring->simd_psi = NULL;
+    tors_ring->psi_len = 0;
+    tors_ring->mont_max_len = 0;
+    tors_ring->simd_max_len = 0;
+    tors_ring->threads = 1;
+    tors_ring->pool = NULL;
+    fq_poly_init(tors_ring->psi_inv, ctx);
+    tors_ring->stop = NULL;
+    tors_ring->tune = tune_get();
 }
 
 void tors_ring_clear(tors_ring_t tors_ring, const fq_ctx_t ctx) {
     ell_curve_clear(tors_ring->curve, ctx);
     fq_poly_clear(tors_ring->psi, ctx);
+    fq_poly_clear(tors_ring->W, ctx);
+    flint_free(tors_ring->mont_psi);
+    flint_free(tors_ring->simd_psi);
+    fq_poly_clear(tors_ring->psi_inv, ctx);
+    if (tors_ring->pool != NULL) {
+        tors_pool_clear(tors_ring->pool);
+        free(tors_ring->pool);
+    }
 }
 
 void tors_ring_set(tors_ring_t tors_ring, const ell_curve_t E, const fq_poly_t psi, const fq_ctx_t ctx) {
     ell_curve_set(tors_ring->curve, E->a, E->b, ctx);
     fq_poly_set(tors_ring->psi, psi, ctx);
+
+    // Définition de W = x^3 + a*x + b
+    fq_t one;
+    fq_init(one, ctx);
+    fq_one(one, ctx);
+
+    fq_poly_zero(tors_ring->W, ctx);
+    fq_poly_set_coeff(tors_ring->W, 3, one, ctx);
+    fq_poly_set_coeff(tors_ring->W, 1, E->a, ctx);
+    fq_poly_set_coeff(tors_ring->W, 0, E->b, ctx);
+
+    fq_clear(one, ctx);
+
+    tors_ring_set_kernels(tors_ring, ctx);
+}
+
+/**
+ * Si op est un diviseur de zéro non-nul de F_q[x]/(psi), g = pgcd(op, psi) est un facteur non-trivial de psi.
+ * Tout calcul dans R_{E,l} reste valable dans le quotient par g ou par psi/g (ce sont encore des abscisses de
+ * points de l-torsion non-nuls), on remplace donc psi par celui des deux facteurs de plus petit degré.
+ * Les éléments déjà calculés modulo l'ancien psi restent des représentants valides, simplement non réduits.
+ */
+void tors_ring_split(tors_ring_t tors_ring, const fq_poly_t op, const fq_ctx_t ctx) {
+    fq_poly_t g, cofactor;
+    fq_poly_init(g, ctx);
+    fq_poly_init(cofactor, ctx);
+
+    fq_poly_gcd(g, op, tors_ring->psi, ctx);
+
+    if (fq_poly_degree(g, ctx) > 0 && fq_poly_degree(g, ctx) < fq_poly_degree(tors_ring->psi, ctx)) {
+        fq_poly_div(cofactor, tors_ring->psi, g, ctx);
+
+        if (fq_poly_degree(g, ctx) <= fq_poly_degree(cofactor, ctx)) {
+            fq_poly_swap(tors_ring->psi, g, ctx);
+        } else {
+            fq_poly_swap(tors_ring->psi, cofactor, ctx);
+        }
+
+        tors_ring_set_kernels(tors_ring, ctx);
+    }
+
+    fq_poly_clear(g, ctx);
+    fq_poly_clear(cofactor, ctx);
+}
+
+/**
+ * Met à jour les images de psi utilisées par tors_poly_mul() et tors_poly_sqr() : en représentation de Montgomery
+ * si q est premier de 2, 4 ou 8 limbs (c.f mont.h), en doubles pour les noyaux vectorisés si q est premier de moins
+ * de SIMD_MAX_BITS bits (c.f simd.h). Chaque image n'est construite que tant que psi est assez petit pour que la
+ * multiplication naïve correspondante batte celle de FLINT.
+ */
+void tors_ring_set_kernels(tors_ring_t tors_ring, const fq_ctx_t ctx) {
+    flint_free(tors_ring->mont_psi);
+    flint_free(tors_ring->simd_psi);
+    tors_ring->mont_psi = NULL;
+    tors_ring->simd_psi = NULL;
+    tors_ring->psi_len = fq_poly_length(tors_ring->psi, ctx);
+
+    // Inverse de psi renversé, pour les réductions sur plusieurs threads (c.f tors_poly_rem_threads())
+    fq_poly_zero(tors_ring->psi_inv, ctx);
+    if (tors_ring->threads > 1 && tors_ring->psi_len >= tors_ring->tune->threads_min_len) {
+        fq_poly_t rev;
+        fq_poly_init(rev, ctx);
+        fq_poly_reverse(rev, tors_ring->psi, tors_ring->psi_len, ctx);
+        fq_poly_inv_series_newton(tors_ring->psi_inv, rev, tors_ring->psi_len, ctx);
+        fq_poly_clear(rev, ctx);
+    }
+
+    // Seuils mesurés pour cette taille de q (c.f tune.h)
+    tors_ring->mont_max_len = tune_mont_max_len(tors_ring->tune, tors_ring->mont->limbs);
+    tors_ring->simd_max_len = tune_simd_max_len(tors_ring->tune, fmpz_bits(fq_ctx_prime(ctx)));
+
+    int use_mont = (tors_ring->mont->limbs != 0 && tors_ring->psi_len <= tors_ring->mont_max_len);
+    int use_simd = (tors_ring->simd->level != SIMD_NONE && tors_ring->psi_len <= tors_ring->simd_max_len);
+    if (tors_ring->psi_len < 2 || (!use_mont && !use_simd)) return;
+
+    // Le reste modulo psi est aussi le reste modulo psi rendu unitaire
+    fq_poly_t monic;
+    fq_poly_init(monic, ctx);
+    fq_poly_make_monic(monic, tors_ring->psi, ctx);
+
+    if (use_mont) {
+        tors_ring->mont_psi = (ulong*)flint_malloc(tors_ring->psi_len * tors_ring->mont->limbs * sizeof(ulong));
+        mont_poly_set_fq_poly(tors_ring->mont_psi, monic, tors_ring->psi_len, tors_ring->mont, ctx);
+    }
+    if (use_simd) {
+        tors_ring->simd_psi = (double*)flint_malloc(tors_ring->psi_len * sizeof(double));
+        simd_poly_set_fq_poly(tors_ring->simd_psi, monic, tors_ring->psi_len, ctx);
+    }
+
+    fq_poly_clear(monic, ctx);
+}
+
+/**
+ * Fixe le nombre de threads des produits et réductions dont les opérandes ont au moins threads_min_len
+ * coefficients (c.f tune.h et tors_poly_mul_threads()), et crée la réserve des threads - 1 threads qui les
+ * exécuteront avec le thread appelant. Doit être appelée après tors_ring_set().
+ */
+void tors_ring_set_threads(tors_ring_t tors_ring, const slong threads, const fq_ctx_t ctx) {
+    if (tors_ring->pool != NULL && FLINT_MAX(threads, 1) != tors_ring->threads) {
+        tors_pool_clear(tors_ring->pool);
+        free(tors_ring->pool);
+        tors_ring->pool = NULL;
+    }
+
+    tors_ring->threads = FLINT_MAX(threads, 1);
+    if (tors_ring->threads > 1 && tors_ring->pool == NULL) {
+        tors_ring->pool = (tors_pool_struct*)malloc(sizeof(tors_pool_struct));
+        tors_pool_init(tors_ring->pool, tors_ring->threads - 1);
+    }
+    tors_ring_set_kernels(tors_ring, ctx);
+}
+
+/**
+ * Renvoie 1 si une interruption a été demandée (c.f tors_stop_check()), 0 sinon ou si tors_ring->stop est NULL.
+ */
+int tors_ring_stopped(const tors_ring_t tors_ring) {
+    return tors_ring->stop != NULL && tors_stop_check(tors_ring->stop);
+}
+
+/****************/
+/* INTERRUPTION */
+/****************/
+
+// Horloge monotone, en secondes
+double tors_stop_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/**
+ * Interruption quand *cancel devient non nul (si cancel n'est pas NULL) ou à l'instant deadline (s'il est > 0).
+ * *cancel est écrit par un autre thread, il n'est lu que par des lectures atomiques.
+ */
+void tors_stop_init(tors_stop_t stop, const int* cancel, const double deadline) {
+    stop->cancel = cancel;
+    stop->deadline = deadline;
+    stop->stopped = 0;
+}
+
+int tors_stop_check(tors_stop_t stop) {
+    if (!stop->stopped) {
+        stop->stopped = (stop->cancel != NULL && __atomic_load_n(stop->cancel, __ATOMIC_RELAXED)) || (stop->deadline > 0 && tors_stop_now() >= stop->deadline);
+    }
+    return stop->stopped;
 }
 
 /**********************************************/
@@ -151,47 +321,58 @@ void tors_elem_sub(tors_elem_t rop, const tors_elem_t op1, const tors_elem_t op2
 }
 
 /**
- * c.f Proposition 4.1 du rapport.
+ * Le produit n'est réduit qu'une fois par coordonnée, après la somme des produits (c.f tors_elem_mul_unreduced()).
  */
 void tors_elem_mul(tors_elem_t rop, const tors_elem_t op1, const tors_elem_t op2, const tors_ring_t tors_ring, const fq_ctx_t ctx) {
+    tors_elem_mul_unreduced(rop, op1, op2, tors_ring, ctx);
+    tors_elem_reduce(rop, rop, tors_ring, ctx);
+}
+
+/**
+ * Même calcul que tors_elem_mul() sans la réduction modulo psi : les coordonnées sont de degré au plus
+ * 2*deg psi + 1 et peuvent être combinées avec d'autres produits avant un unique tors_elem_reduce().
+ * Les opérandes doivent être réduits. c.f Proposition 4.1 du rapport.
+ */
+void tors_elem_mul_unreduced(tors_elem_t rop, const tors_elem_t op1, const tors_elem_t op2, const tors_ring_t tors_ring, const fq_ctx_t ctx) {
+    if (tors_ring->threads > 1 && tors_ring->psi_len >= tors_ring->tune->threads_min_len) {
+        tors_elem_mul_unreduced_threads(rop, op1, op2, tors_ring, ctx);
+        return;
+    }
+
     tors_elem_t res;
     tors_elem_init(res, ctx);
     
     fq_poly_t temp;
-    fq_t temp_coeff;
-    fq_init(temp_coeff, ctx);
-
-    // Définition de temp = x^3 + a*x + b
-    fq_poly_init2(temp, 4, ctx); // fq_poly_init2() initialise les coefficients à 0
-    fq_one(temp_coeff, ctx);
-    fq_poly_set_coeff(temp, 3, temp_coeff, ctx);
-    fq_poly_set_coeff(temp, 1, tors_ring->curve->a, ctx);
-    fq_poly_set_coeff(temp, 0, tors_ring->curve->b, ctx);
+    fq_poly_init(temp, ctx);
 
     // Calcul du coefficient constant en y
-    fq_poly_mul(temp, temp, op1->B, ctx);
-    fq_poly_mul(temp, temp, op2->B, ctx);
+    tors_poly_mul_unreduced(temp, op1->B, op2->B, tors_ring, ctx);
+    fq_poly_mul(temp, temp, tors_ring->W, ctx);
 
-    fq_poly_mul(res->A, op1->A, op2->A,  ctx);
+    tors_poly_mul_unreduced(res->A, op1->A, op2->A, tors_ring, ctx);
     fq_poly_add(res->A, res->A, temp, ctx);
 
     // Calcul du coefficient devant y
-    fq_poly_mul(res->B, op1->A, op2->B, ctx);
-    fq_poly_mul(temp, op1->B, op2->A, ctx);
+    tors_poly_mul_unreduced(res->B, op1->A, op2->B, tors_ring, ctx);
+    tors_poly_mul_unreduced(temp, op1->B, op2->A, tors_ring, ctx);
     fq_poly_add(res->B, res->B, temp, ctx);
 
-    if (!fq_poly_is_zero(tors_ring->psi, ctx)) {
-        fq_poly_rem(res->A, res->A, tors_ring->psi, ctx);
-        fq_poly_rem(res->B, res->B, tors_ring->psi, ctx);
-    }
-
     tors_elem_swap(res, rop, ctx);
 
     fq_poly_clear(temp, ctx);
-    fq_clear(temp_coeff, ctx);
     tors_elem_clear(res, ctx);
 }
 
+void tors_elem_reduce(tors_elem_t rop, const tors_elem_t op, const tors_ring_t tors_ring, const fq_ctx_t ctx) {
+    if (tors_ring->threads > 1 && tors_ring->psi_len >= tors_ring->tune->threads_min_len) {
+        tors_elem_reduce_threads(rop, op, tors_ring, ctx);
+        return;
+    }
+
+    tors_poly_reduce(rop->A, op->A, tors_ring, ctx);
+    tors_poly_reduce(rop->B, op->B, tors_ring, ctx);
+}
+
 void tors_elem_mul_fq(tors_elem_t rop, const tors_elem_t op, const fq_t a, const fq_ctx_t ctx) {
     fq_poly_scalar_mul_fq(rop->A, op->A, a, ctx);
     fq_poly_scalar_mul_fq(rop->B, op->B, a, ctx);
@@ -206,14 +387,14 @@ void tors_elem_mul_sl(tors_elem_t rop, const tors_elem_t op, const slong n, cons
 }
 
 /**
- * Algorithme Square & Double en lisant les bits de l'exposant de gauche à droite.
+ * Algorithme Square & Double en lisant les bits de l'exposant de gauche à droite, interrompu comme tors_poly_pow().
  */
 void tors_elem_pow(tors_elem_t rop, const tors_elem_t op, const fmpz_t n, const tors_ring_t tors_ring, const fq_ctx_t ctx) {
     tors_elem_t res;
     tors_elem_init(res, ctx);
     tors_elem_one(res, ctx);
 
-    for (slong i = fmpz_bits(n) - 1; i >= 0; i--) {
+    for (slong i = fmpz_bits(n) - 1; i >= 0 && !tors_ring_stopped(tors_ring); i--) {
         tors_elem_mul(res, res, res, tors_ring, ctx);
         if (fmpz_tstbit(n, i)) tors_elem_mul(res, res, op, tors_ring, ctx);
     }
@@ -231,11 +412,674 @@ void tors_elem_pow_ul(tors_elem_t rop, const tors_elem_t op, const ulong n, cons
     tors_elem_init(res, ctx);
     tors_elem_one(res, ctx);
 
-    for (slong i = FLINT_BIT_COUNT(n) - 1; i >= 0; i--) {
+    for (slong i = FLINT_BIT_COUNT(n) - 1; i >= 0 && !tors_ring_stopped(tors_ring); i--) {
         tors_elem_mul(res, res, res, tors_ring, ctx);
         if (n & (1UL << i)) tors_elem_mul(res, res, op, tors_ring, ctx);
     }
 
     tors_elem_swap(res, rop, ctx);
     tors_elem_clear(res, ctx);
+}
+
+/**********************************/
+/* ARITHMETIQUE DANS F_q[x]/(psi) */
+/**********************************/
+
+/**
+ * Les éléments de R_{E,l} qui n'ont pas de partie en y (ou dont on connaît la parité en y, c.f ell_cpoint.h)
+ * sont simplement des éléments de F_q[x]/(psi) : une seule multiplication de polynômes suffit.
+ */
+void tors_poly_mul(fq_poly_t rop, const fq_poly_t op1, const fq_poly_t op2, const tors_ring_t tors_ring, const fq_ctx_t ctx) {
+    if (tors_ring->simd_psi != NULL && fq_poly_length(op1, ctx) <= tors_ring->simd_max_len && fq_poly_length(op2, ctx) <= tors_ring->simd_max_len) {
+        tors_poly_mul_simd(rop, op1, op2, 1, tors_ring, ctx);
+        return;
+    }
+    if (tors_ring->mont_psi != NULL && fq_poly_length(op1, ctx) <= tors_ring->mont_max_len && fq_poly_length(op2, ctx) <= tors_ring->mont_max_len) {
+        tors_poly_mul_mont(rop, op1, op2, 1, tors_ring, ctx);
+        return;
+    }
+
+    tors_poly_mul_threads(rop, op1, op2, tors_ring->threads, tors_ring->pool, tors_ring->tune, ctx);
+    if (!fq_poly_is_zero(tors_ring->psi, ctx)) tors_poly_rem_threads(rop, rop, tors_ring->threads, tors_ring, ctx);
+}
+
+void tors_poly_sqr(fq_poly_t rop, const fq_poly_t op, const tors_ring_t tors_ring, const fq_ctx_t ctx) {
+    if (tors_ring->simd_psi != NULL && fq_poly_length(op, ctx) <= tors_ring->simd_max_len) {
+        tors_poly_mul_simd(rop, op, op, 1, tors_ring, ctx);
+        return;
+    }
+    if (tors_ring->mont_psi != NULL && fq_poly_length(op, ctx) <= tors_ring->mont_max_len) {
+        tors_poly_mul_mont(rop, op, op, 1, tors_ring, ctx);
+        return;
+    }
+
+    tors_poly_mul_threads(rop, op, op, tors_ring->threads, tors_ring->pool, tors_ring->tune, ctx);
+    if (!fq_poly_is_zero(tors_ring->psi, ctx)) tors_poly_rem_threads(rop, rop, tors_ring->threads, tors_ring, ctx);
+}
+
+/**
+ * Produits sans réduction modulo psi, pour la réduction paresseuse : une combinaison de plusieurs produits n'est
+ * réduite qu'une fois par tors_poly_reduce(). Les opérandes doivent être réduits.
+ */
+void tors_poly_mul_unreduced(fq_poly_t rop, const fq_poly_t op1, const fq_poly_t op2, const tors_ring_t tors_ring, const fq_ctx_t ctx) {
+    if (tors_ring->simd_psi != NULL && fq_poly_length(op1, ctx) <= tors_ring->simd_max_len && fq_poly_length(op2, ctx) <= tors_ring->simd_max_len) {
+        tors_poly_mul_simd(rop, op1, op2, 0, tors_ring, ctx);
+        return;
+    }
+    if (tors_ring->mont_psi != NULL && fq_poly_length(op1, ctx) <= tors_ring->mont_max_len && fq_poly_length(op2, ctx) <= tors_ring->mont_max_len) {
+        tors_poly_mul_mont(rop, op1, op2, 0, tors_ring, ctx);
+        return;
+    }
+
+    tors_poly_mul_threads(rop, op1, op2, tors_ring->threads, tors_ring->pool, tors_ring->tune, ctx);
+}
+
+void tors_poly_sqr_unreduced(fq_poly_t rop, const fq_poly_t op, const tors_ring_t tors_ring, const fq_ctx_t ctx) {
+    if (tors_ring->simd_psi != NULL && fq_poly_length(op, ctx) <= tors_ring->simd_max_len) {
+        tors_poly_mul_simd(rop, op, op, 0, tors_ring, ctx);
+        return;
+    }
+    if (tors_ring->mont_psi != NULL && fq_poly_length(op, ctx) <= tors_ring->mont_max_len) {
+        tors_poly_mul_mont(rop, op, op, 0, tors_ring, ctx);
+        return;
+    }
+
+    tors_poly_mul_threads(rop, op, op, tors_ring->threads, tors_ring->pool, tors_ring->tune, ctx);
+}
+
+void tors_poly_reduce(fq_poly_t rop, const fq_poly_t op, const tors_ring_t tors_ring, const fq_ctx_t ctx) {
+    tors_poly_reduce_threads(rop, op, tors_ring->threads, tors_ring, ctx);
+}
+
+/**
+ * Même calcul que tors_poly_reduce(), avec threads threads pour les restes qui ne passent pas par les noyaux.
+ */
+void tors_poly_reduce_threads(fq_poly_t rop, const fq_poly_t op, const slong threads, const tors_ring_t tors_ring, const fq_ctx_t ctx) {
+    slong len = fq_poly_length(op, ctx);
+
+    if (fq_poly_is_zero(tors_ring->psi, ctx) || len < tors_ring->psi_len) {
+        fq_poly_set(rop, op, ctx);
+        return;
+    }
+    if (tors_ring->simd_psi != NULL && len <= 2*tors_ring->simd_max_len + 2) {
+        tors_poly_rem_simd(rop, op, tors_ring, ctx);
+        return;
+    }
+    if (tors_ring->mont_psi != NULL && len <= 2*tors_ring->mont_max_len + 2) {
+        tors_poly_rem_mont(rop, op, tors_ring, ctx);
+        return;
+    }
+
+    tors_poly_rem_threads(rop, op, threads, tors_ring, ctx);
+}
+
+/**
+ * Même calcul que tors_poly_mul() (ou tors_poly_mul_unreduced() si reduce est nul) en représentation de Montgomery
+ * à largeur fixe (c.f mont.h) : les coefficients sont convertis une fois, et le produit comme la réduction
+ * n'allouent plus rien par coefficient. tors_ring->mont_psi ne doit pas être NULL.
+ */
+void tors_poly_mul_mont(fq_poly_t rop, const fq_poly_t op1, const fq_poly_t op2, const int reduce, const tors_ring_t tors_ring, const fq_ctx_t ctx) {
+    const slong N = tors_ring->mont->limbs;
+    slong len1 = fq_poly_length(op1, ctx);
+    slong len2 = fq_poly_length(op2, ctx);
+
+    if (!reduce && (len1 == 0 || len2 == 0)) {
+        fq_poly_zero(rop, ctx);
+        return;
+    }
+
+    slong len_res = reduce ? tors_ring->psi_len - 1 : len1 + len2 - 1;
+
+    ulong* buffer = (ulong*)flint_malloc((len1 + len2 + len_res) * N * sizeof(ulong));
+    ulong* mont1 = buffer;
+    ulong* mont2 = buffer + len1*N;
+    ulong* res = buffer + (len1 + len2)*N;
+
+    mont_poly_set_fq_poly(mont1, op1, len1, tors_ring->mont, ctx);
+    if (op1 == op2) {
+        mont2 = mont1; // mont_poly_mul() passe alors par l'élévation au carré
+    } else {
+        mont_poly_set_fq_poly(mont2, op2, len2, tors_ring->mont, ctx);
+    }
+
+    if (reduce) {
+        mont_poly_mulmod(res, mont1, len1, mont2, len2, tors_ring->mont_psi, tors_ring->psi_len, tors_ring->mont);
+    } else {
+        mont_poly_mul(res, mont1, len1, mont2, len2, tors_ring->mont);
+    }
+    mont_poly_get_fq_poly(rop, res, len_res, tors_ring->mont, ctx);
+
+    flint_free(buffer);
+}
+
+/**
+ * Même calcul que tors_poly_reduce() en représentation de Montgomery, op étant de longueur au moins celle de psi.
+ */
+void tors_poly_rem_mont(fq_poly_t rop, const fq_poly_t op, const tors_ring_t tors_ring, const fq_ctx_t ctx) {
+    slong len = fq_poly_length(op, ctx);
+    ulong* buffer = (ulong*)flint_malloc(len * tors_ring->mont->limbs * sizeof(ulong));
+
+    mont_poly_set_fq_poly(buffer, op, len, tors_ring->mont, ctx);
+    mont_poly_rem(buffer, len, tors_ring->mont_psi, tors_ring->psi_len, tors_ring->mont);
+    mont_poly_get_fq_poly(rop, buffer, tors_ring->psi_len - 1, tors_ring->mont, ctx);
+
+    flint_free(buffer);
+}
+
+void tors_poly_mul_sl(fq_poly_t rop, const fq_poly_t op, const slong n, const fq_ctx_t ctx) {
+    fq_t n_fq;
+    fq_init(n_fq, ctx);
+    fq_set_si(n_fq, n, ctx);
+    fq_poly_scalar_mul_fq(rop, op, n_fq, ctx);
+    fq_clear(n_fq, ctx);
+}
+
+/**
+ * Multiplie op par W = x^3 + a*x + b = y^2. Comme deg W = 3, le produit et sa réduction modulo psi
+ * sont de coût linéaire en deg psi.
+ */
+void tors_poly_mul_W(fq_poly_t rop, const fq_poly_t op, const tors_ring_t tors_ring, const fq_ctx_t ctx) {
+    tors_poly_mul(rop, op, tors_ring->W, tors_ring, ctx);
+}
+
+/**
+ * Algorithme Square & Multiply en lisant les bits de l'exposant de gauche à droite. S'arrête, avec un résultat
+ * non défini, si une interruption est demandée (c.f tors_ring_stopped()).
+ */
+void tors_poly_pow(fq_poly_t rop, const fq_poly_t op, const fmpz_t n, const tors_ring_t tors_ring, const fq_ctx_t ctx) {
+    fq_poly_t res;
+    fq_poly_init(res, ctx);
+    fq_poly_one(res, ctx);
+
+    for (slong i = fmpz_bits(n) - 1; i >= 0 && !tors_ring_stopped(tors_ring); i--) {
+        tors_poly_sqr(res, res, tors_ring, ctx);
+        if (fmpz_tstbit(n, i)) tors_poly_mul(res, res, op, tors_ring, ctx);
+    }
+
+    fq_poly_swap(res, rop, ctx);
+    fq_poly_clear(res, ctx);
+}
+
+/**
+ * Tente d'inverser op dans F_q[x]/(psi). Si op est un diviseur de zéro non-nul, on réduit l'anneau avec
+ * tors_ring_split() et on recommence dans le nouveau quotient.
+ * Renvoie 1 si op est inversible (et affecte son inverse à rop), 0 si op est nul dans l'anneau final.
+ */
+int tors_poly_inv(fq_poly_t rop, const fq_poly_t op, tors_ring_t tors_ring, const fq_ctx_t ctx) {
+    fq_poly_t op_red, inv;
+    fq_poly_init(op_red, ctx);
+    fq_poly_init(inv, ctx);
+
+    int success;
+
+    // Le nouveau psi divise l'ancien, on peut donc réduire op_red à chaque tour de boucle
+    fq_poly_set(op_red, op, ctx);
+
+    while (1) {
+        fq_poly_rem(op_red, op_red, tors_ring->psi, ctx);
+
+        if (fq_poly_is_zero(op_red, ctx)) {
+            success = 0;
+            break;
+        }
+
+        if (fq_poly_invmod(inv, op_red, tors_ring->psi, ctx)) {
+            fq_poly_swap(rop, inv, ctx);
+            success = 1;
+            break;
+        }
+
+        tors_ring_split(tors_ring, op_red, ctx);
+    }
+
+    fq_poly_clear(op_red, ctx);
+    fq_poly_clear(inv, ctx);
+    return success;
+}
+
+/**
+ * Même calcul que tors_poly_mul() (ou tors_poly_mul_unreduced() si reduce est nul) avec les noyaux vectorisés de
+ * simd.h, qui donnent exactement le même résultat. tors_ring->simd_psi ne doit pas être NULL.
+ */
+void tors_poly_mul_simd(fq_poly_t rop, const fq_poly_t op1, const fq_poly_t op2, const int reduce, const tors_ring_t tors_ring, const fq_ctx_t ctx) {
+    slong len1 = fq_poly_length(op1, ctx);
+    slong len2 = fq_poly_length(op2, ctx);
+
+    if (!reduce && (len1 == 0 || len2 == 0)) {
+        fq_poly_zero(rop, ctx);
+        return;
+    }
+
+    slong len_res = reduce ? tors_ring->psi_len - 1 : len1 + len2 - 1;
+
+    double* buffer = (double*)flint_malloc((len1 + len2 + len_res) * sizeof(double));
+    double* vec1 = buffer;
+    double* vec2 = buffer + len1;
+    double* res = buffer + len1 + len2;
+
+    simd_poly_set_fq_poly(vec1, op1, len1, ctx);
+    if (op1 == op2) {
+        vec2 = vec1;
+    } else {
+        simd_poly_set_fq_poly(vec2, op2, len2, ctx);
+    }
+
+    if (reduce) {
+        simd_poly_mulmod(res, vec1, len1, vec2, len2, tors_ring->simd_psi, tors_ring->psi_len, tors_ring->simd);
+    } else {
+        simd_poly_mul(res, vec1, len1, vec2, len2, tors_ring->simd);
+    }
+    simd_poly_get_fq_poly(rop, res, len_res, ctx);
+
+    flint_free(buffer);
+}
+
+/**
+ * Même calcul que tors_poly_reduce() avec les noyaux vectorisés, op étant de longueur au moins celle de psi.
+ */
+void tors_poly_rem_simd(fq_poly_t rop, const fq_poly_t op, const tors_ring_t tors_ring, const fq_ctx_t ctx) {
+    slong len = fq_poly_length(op, ctx);
+    double* buffer = (double*)flint_malloc(len * sizeof(double));
+
+    simd_poly_set_fq_poly(buffer, op, len, ctx);
+    simd_poly_rem(buffer, len, tors_ring->simd_psi, tors_ring->psi_len, tors_ring->simd);
+    simd_poly_get_fq_poly(rop, buffer, tors_ring->psi_len - 1, ctx);
+
+    flint_free(buffer);
+}
+
+/*******************/
+/* OPERANDES FIXES */
+/*******************/
+
+void tors_pre_init(tors_pre_t pre, const fq_ctx_t ctx) {
+    fq_poly_init(pre->poly, ctx);
+    pre->simd = NULL;
+    pre->mont = NULL;
+    pre->has_fft = 0;
+}
+
+void tors_pre_clear(tors_pre_t pre, const fq_ctx_t ctx) {
+    fq_poly_clear(pre->poly, ctx);
+    flint_free(pre->simd);
+    flint_free(pre->mont);
+    if (pre->has_fft) fmpz_poly_mul_precache_clear(pre->fft);
+}
+
+/**
+ * Prépare op (réduit modulo psi) pour tors_poly_mul_pre(), selon le chemin que prendrait tors_poly_mul() pour des
+ * opérandes réduits. La transformée n'est précalculée que lorsque FLINT choisirait lui-même Schönhage-Strassen
+ * (coefficients d'au moins pre_fft_min_limbs limbs, c.f tune.h) : pour des coefficients plus petits, la
+ * substitution de Kronecker ne laisse rien à mettre de côté.
+ */
+void tors_pre_set(tors_pre_t pre, const fq_poly_t op, const tors_ring_t tors_ring, const fq_ctx_t ctx) {
+    flint_free(pre->simd);
+    flint_free(pre->mont);
+    if (pre->has_fft) fmpz_poly_mul_precache_clear(pre->fft);
+    pre->simd = NULL;
+    pre->mont = NULL;
+    pre->has_fft = 0;
+
+    fq_poly_set(pre->poly, op, ctx);
+
+    slong len = fq_poly_length(op, ctx);
+    const fmpz* p = fq_ctx_prime(ctx);
+
+    if (len == 0 || len >= tors_ring->psi_len) return;
+
+    if (tors_ring->simd_psi != NULL) {
+        pre->simd = (double*)flint_malloc(len * sizeof(double));
+        simd_poly_set_fq_poly(pre->simd, op, len, ctx);
+    } else if (tors_ring->mont_psi != NULL) {
+        pre->mont = (ulong*)flint_malloc(len * tors_ring->mont->limbs * sizeof(ulong));
+        mont_poly_set_fq_poly(pre->mont, op, len, tors_ring->mont, ctx);
+    } else if (fq_ctx_degree(ctx) == 1 && (slong)fmpz_size(p) >= tors_ring->tune->pre_fft_min_limbs && tors_ring->psi_len >= tors_ring->tune->pre_fft_min_len) {
+        fmpz_poly_t lift;
+        fmpz_poly_init(lift);
+        fmpz_poly_fit_length(lift, len);
+        for (slong i = 0; i < len; i++) fq_get_fmpz(lift->coeffs + i, op->coeffs + i, ctx);
+        _fmpz_poly_set_length(lift, len);
+
+        // Les autres opérandes sont réduits, donc de longueur au plus psi_len-1 et à coefficients dans [0, p-1]
+        fmpz_poly_mul_SS_precache_init(pre->fft, tors_ring->psi_len - 1, fmpz_bits(p), lift);
+        pre->has_fft = 1;
+
+        fmpz_poly_clear(lift);
+    }
+}
+
+/**
+ * rop = op*pre modulo psi, op étant réduit. Même résultat que tors_poly_mul() avec pre->poly, mais seul op est
+ * converti (ou transformé).
+ */
+void tors_poly_mul_pre(fq_poly_t rop, const fq_poly_t op, const tors_pre_t pre, const tors_ring_t tors_ring, const fq_ctx_t ctx) {
+    slong len1 = fq_poly_length(op, ctx);
+    slong len2 = fq_poly_length(pre->poly, ctx);
+    slong len_res = tors_ring->psi_len - 1;
+
+    if (len1 == 0 || len2 == 0) {
+        fq_poly_zero(rop, ctx);
+        return;
+    }
+    if (len1 > len_res || (pre->simd == NULL && pre->mont == NULL && !pre->has_fft)) {
+        tors_poly_mul(rop, op, pre->poly, tors_ring, ctx);
+        return;
+    }
+
+    if (pre->simd != NULL) {
+        double* buffer = (double*)flint_malloc((len1 + len_res) * sizeof(double));
+
+        simd_poly_set_fq_poly(buffer, op, len1, ctx);
+        simd_poly_mulmod(buffer + len1, buffer, len1, pre->simd, len2, tors_ring->simd_psi, tors_ring->psi_len, tors_ring->simd);
+        simd_poly_get_fq_poly(rop, buffer + len1, len_res, ctx);
+
+        flint_free(buffer);
+    } else if (pre->mont != NULL) {
+        const slong N = tors_ring->mont->limbs;
+        ulong* buffer = (ulong*)flint_malloc((len1 + len_res) * N * sizeof(ulong));
+
+        mont_poly_set_fq_poly(buffer, op, len1, tors_ring->mont, ctx);
+        mont_poly_mulmod(buffer + len1*N, buffer, len1, pre->mont, len2, tors_ring->mont_psi, tors_ring->psi_len, tors_ring->mont);
+        mont_poly_get_fq_poly(rop, buffer + len1*N, len_res, tors_ring->mont, ctx);
+
+        flint_free(buffer);
+    } else {
+        const fmpz* p = fq_ctx_prime(ctx);
+        fmpz_poly_t lift, prod;
+        fmpz_poly_init(lift);
+        fmpz_poly_init(prod);
+
+        fmpz_poly_fit_length(lift, len1);
+        for (slong i = 0; i < len1; i++) fq_get_fmpz(lift->coeffs + i, op->coeffs + i, ctx);
+        _fmpz_poly_set_length(lift, len1);
+
+        // Le précalcul n'est pas modifié par le produit, seule sa signature FLINT n'est pas constante
+        fmpz_poly_mul_SS_precache(prod, lift, (fmpz_poly_mul_precache_struct*)pre->fft);
+
+        slong len = fmpz_poly_length(prod);
+        _fmpz_vec_scalar_mod_fmpz(prod->coeffs, prod->coeffs, len, p);
+
+        fq_poly_fit_length(rop, len, ctx);
+        for (slong i = 0; i < len; i++) fq_set_fmpz(rop->coeffs + i, prod->coeffs + i, ctx);
+        for (slong i = len; i < fq_poly_length(rop, ctx); i++) fq_zero(rop->coeffs + i, ctx);
+        _fq_poly_set_length(rop, len, ctx);
+        _fq_poly_normalise(rop, ctx);
+        tors_poly_reduce(rop, rop, tors_ring, ctx);
+
+        fmpz_poly_clear(lift);
+        fmpz_poly_clear(prod);
+    }
+}
+
+/**********************************/
+/* PRODUITS SUR PLUSIEURS THREADS */
+/**********************************/
+
+/**
+ * Démarre num_workers threads (moins si certains ne peuvent pas être créés), qui attendent des tâches.
+ */
+void tors_pool_init(tors_pool_t pool, const slong num_workers) {
+    pthread_mutex_init(&pool->mutex, NULL);
+    pthread_cond_init(&pool->cond, NULL);
+    pool->queue = NULL;
+    pool->stop = 0;
+    pool->num_workers = 0;
+    pool->workers = (pthread_t*)malloc(FLINT_MAX(num_workers, 1) * sizeof(pthread_t));
+
+    for (slong i = 0; i < num_workers; i++) {
+        if (pthread_create(pool->workers + pool->num_workers, NULL, tors_pool_worker, pool) == 0) pool->num_workers++;
+    }
+}
+
+/**
+ * Arrête les threads de la réserve, qui ne doit plus avoir d'appel en cours.
+ */
+void tors_pool_clear(tors_pool_t pool) {
+    pthread_mutex_lock(&pool->mutex);
+    pool->stop = 1;
+    pthread_cond_broadcast(&pool->cond);
+    pthread_mutex_unlock(&pool->mutex);
+
+    for (slong i = 0; i < pool->num_workers; i++) pthread_join(pool->workers[i], NULL);
+
+    free(pool->workers);
+    pthread_cond_destroy(&pool->cond);
+    pthread_mutex_destroy(&pool->mutex);
+}
+
+/**
+ * Retire queue, dont toutes les tâches ont été prises, de la chaîne de pool. Le mutex de pool doit être pris.
+ */
+void tors_pool_unlink(tors_pool_t pool, tors_tasks_t queue) {
+    tors_tasks_struct** ptr = &pool->queue;
+    while (*ptr != NULL && *ptr != queue) ptr = &(*ptr)->link;
+    if (*ptr != NULL) *ptr = queue->link;
+}
+
+void* tors_pool_worker(void* arg) {
+    tors_pool_struct* pool = (tors_pool_struct*)arg;
+
+    pthread_mutex_lock(&pool->mutex);
+    while (1) {
+        while (pool->queue == NULL && !pool->stop) pthread_cond_wait(&pool->cond, &pool->mutex);
+        if (pool->queue == NULL) break;
+
+        tors_tasks_struct* queue = pool->queue;
+        tors_task_struct* task = queue->tasks + queue->next++;
+        if (queue->next == queue->num) tors_pool_unlink(pool, queue);
+        pthread_mutex_unlock(&pool->mutex);
+
+        tors_task_exec(task);
+
+        pthread_mutex_lock(&pool->mutex);
+        if (++queue->done == queue->num) pthread_cond_broadcast(&pool->cond);
+    }
+    pthread_mutex_unlock(&pool->mutex);
+
+    flint_cleanup(); // Libère les caches propres au thread
+    return NULL;
+}
+
+void tors_task_exec(tors_task_struct* task) {
+    if (task->op2 == NULL) {
+        tors_poly_reduce_threads(task->rop, task->op1, task->threads, task->tors_ring, task->ctx);
+    } else {
+        tors_poly_mul_threads(task->rop, task->op1, task->op2, task->threads, task->pool, task->tune, task->ctx);
+    }
+}
+
+/**
+ * Exécute les num tâches de tasks sur threads threads (dont le thread appelant) : chacune reçoit une part des
+ * threads pour ses propres produits. Les tâches sont confiées à pool, le thread appelant prenant celles qui restent
+ * jusqu'à ce qu'elles soient toutes terminées. Si pool est NULL, elles sont exécutées par le thread appelant.
+ */
+void tors_tasks_run(tors_pool_struct* pool, tors_task_struct* tasks, const slong num, const slong threads) {
+    for (slong i = 0; i < num; i++) {
+        tasks[i].threads = FLINT_MAX(1, threads / num + (i < threads % num));
+        tasks[i].pool = pool;
+    }
+
+    if (pool == NULL || pool->num_workers == 0) {
+        for (slong i = 0; i < num; i++) tors_task_exec(tasks + i);
+        return;
+    }
+
+    tors_tasks_t queue;
+    queue->tasks = tasks;
+    queue->num = num;
+    queue->next = 0;
+    queue->done = 0;
+
+    pthread_mutex_lock(&pool->mutex);
+    queue->link = pool->queue;
+    pool->queue = queue;
+    pthread_cond_broadcast(&pool->cond);
+
+    while (queue->done < queue->num) {
+        if (queue->next < queue->num) {
+            tors_task_struct* task = queue->tasks + queue->next++;
+            if (queue->next == queue->num) tors_pool_unlink(pool, queue);
+            pthread_mutex_unlock(&pool->mutex);
+
+            tors_task_exec(task);
+
+            pthread_mutex_lock(&pool->mutex);
+            queue->done++;
+        } else {
+            pthread_cond_wait(&pool->cond, &pool->mutex);
+        }
+    }
+    pthread_mutex_unlock(&pool->mutex);
+}
+
+/**
+ * Produit de op1 par op2 dans F_q[x] sur threads threads (le thread appelant et ceux de pool, c.f
+ * tors_tasks_run()). Si les deux opérandes ont au moins tune->threads_min_len coefficients (tune est celui de
+ * l'anneau appelant, c.f tune.h), ils sont coupés en op = lo + x^h*hi et les trois produits de Karatsuba lo1*lo2,
+ * hi1*hi2 et (lo1+hi1)*(lo2+hi2), indépendants, sont calculés en même temps (et eux-mêmes sur plusieurs threads
+ * s'il en reste). Si op1 == op2, ce sont trois carrés.
+ */
+void tors_poly_mul_threads(fq_poly_t rop, const fq_poly_t op1, const fq_poly_t op2, const slong threads, tors_pool_struct* pool, const tune_struct* tune, const fq_ctx_t ctx) {
+    slong len1 = fq_poly_length(op1, ctx);
+    slong len2 = fq_poly_length(op2, ctx);
+    int sqr = (op1 == op2);
+
+    if (threads < 2 || FLINT_MIN(len1, len2) < tune->threads_min_len) {
+        if (sqr) {
+            fq_poly_sqr(rop, op1, ctx);
+        } else {
+            fq_poly_mul(rop, op1, op2, ctx);
+        }
+        return;
+    }
+
+    slong h = (FLINT_MAX(len1, len2) + 1) / 2;
+
+    // half[0..2] = lo1, hi1, lo1+hi1 et half[3..5] = lo2, hi2, lo2+hi2
+    fq_poly_struct half[6];
+    fq_poly_struct prod[3];
+    for (slong i = 0; i < 6; i++) fq_poly_init(half + i, ctx);
+    for (slong i = 0; i < 3; i++) fq_poly_init(prod + i, ctx);
+
+    fq_poly_set(half + 0, op1, ctx);
+    fq_poly_truncate(half + 0, h, ctx);
+    fq_poly_shift_right(half + 1, op1, h, ctx);
+    fq_poly_add(half + 2, half + 0, half + 1, ctx);
+    if (!sqr) {
+        fq_poly_set(half + 3, op2, ctx);
+        fq_poly_truncate(half + 3, h, ctx);
+        fq_poly_shift_right(half + 4, op2, h, ctx);
+        fq_poly_add(half + 5, half + 3, half + 4, ctx);
+    }
+
+    tors_task_struct tasks[3];
+    for (slong i = 0; i < 3; i++) {
+        tasks[i].rop = prod + i;
+        tasks[i].op1 = half + i;
+        tasks[i].op2 = half + (sqr ? i : i + 3);
+        tasks[i].tors_ring = NULL;
+        tasks[i].tune = tune;
+        tasks[i].ctx = ctx;
+    }
+    tors_tasks_run(pool, tasks, 3, threads);
+
+    // rop = P0 + x^h*(P2 - P0 - P1) + x^{2h}*P1
+    fq_poly_sub(prod + 2, prod + 2, prod + 0, ctx);
+    fq_poly_sub(prod + 2, prod + 2, prod + 1, ctx);
+    fq_poly_shift_left(prod + 2, prod + 2, h, ctx);
+    fq_poly_shift_left(prod + 1, prod + 1, 2 * h, ctx);
+    fq_poly_add(prod + 0, prod + 0, prod + 1, ctx);
+    fq_poly_add(rop, prod + 0, prod + 2, ctx);
+
+    for (slong i = 0; i < 6; i++) fq_poly_clear(half + i, ctx);
+    for (slong i = 0; i < 3; i++) fq_poly_clear(prod + i, ctx);
+}
+
+/**
+ * Reste de op modulo psi par division de Newton : le quotient est formé des n premiers coefficients du produit
+ * de op renversé par tors_ring->psi_inv, le reste vaut op - quotient*psi, et les deux produits passent par
+ * tors_poly_mul_threads(). Se ramène à fq_poly_rem() si threads <= 1, si psi_inv n'a pas été calculé (c.f
+ * tors_ring_set_threads()) ou si le quotient a plus de psi_len coefficients. psi ne doit pas être nul.
+ */
+void tors_poly_rem_threads(fq_poly_t rop, const fq_poly_t op, const slong threads, const tors_ring_t tors_ring, const fq_ctx_t ctx) {
+    slong len = fq_poly_length(op, ctx);
+    slong n = len - tors_ring->psi_len + 1; // Longueur du quotient
+
+    if (n <= 0) {
+        fq_poly_set(rop, op, ctx);
+        return;
+    }
+    if (threads < 2 || fq_poly_is_zero(tors_ring->psi_inv, ctx) || n > tors_ring->psi_len) {
+        fq_poly_rem(rop, op, tors_ring->psi, ctx);
+        return;
+    }
+
+    fq_poly_t quo, rem;
+    fq_poly_init(quo, ctx);
+    fq_poly_init(rem, ctx);
+
+    fq_poly_reverse(quo, op, len, ctx);
+    fq_poly_truncate(quo, n, ctx);
+    tors_poly_mul_threads(quo, quo, tors_ring->psi_inv, threads, tors_ring->pool, tors_ring->tune, ctx);
+    fq_poly_truncate(quo, n, ctx);
+    fq_poly_reverse(quo, quo, n, ctx);
+
+    tors_poly_mul_threads(rem, quo, tors_ring->psi, threads, tors_ring->pool, tors_ring->tune, ctx);
+    fq_poly_sub(rem, op, rem, ctx);
+    fq_poly_truncate(rem, tors_ring->psi_len - 1, ctx);
+    fq_poly_swap(rop, rem, ctx);
+
+    fq_poly_clear(quo, ctx);
+    fq_poly_clear(rem, ctx);
+}
+
+/**
+ * Même calcul que tors_elem_mul_unreduced() sur tors_ring->threads threads : les produits A1*A2, B1*B2, A1*B2 et
+ * B1*A2 sont indépendants et calculés en même temps. Pour un carré, A1*B2 = B1*A2 n'est calculé qu'une fois.
+ */
+void tors_elem_mul_unreduced_threads(tors_elem_t rop, const tors_elem_t op1, const tors_elem_t op2, const tors_ring_t tors_ring, const fq_ctx_t ctx) {
+    int sqr = (op1 == op2);
+    const fq_poly_struct* ops[4][2] = {{op1->A, op2->A}, {op1->B, op2->B}, {op1->A, op2->B}, {op1->B, op2->A}};
+
+    fq_poly_struct prod[4];
+    tors_task_struct tasks[4];
+    for (slong i = 0; i < 4; i++) {
+        fq_poly_init(prod + i, ctx);
+        tasks[i].rop = prod + i;
+        tasks[i].op1 = ops[i][0];
+        tasks[i].op2 = ops[i][1];
+        tasks[i].tors_ring = tors_ring;
+        tasks[i].tune = tors_ring->tune;
+        tasks[i].ctx = ctx;
+    }
+    tors_tasks_run(tors_ring->pool, tasks, sqr ? 3 : 4, tors_ring->threads);
+
+    fq_poly_mul(prod + 1, prod + 1, tors_ring->W, ctx);
+    fq_poly_add(rop->A, prod + 0, prod + 1, ctx);
+    fq_poly_add(rop->B, prod + 2, prod + (sqr ? 2 : 3), ctx);
+
+    for (slong i = 0; i < 4; i++) fq_poly_clear(prod + i, ctx);
+}
+
+/**
+ * Même calcul que tors_elem_reduce(), les deux coordonnées étant réduites en même temps.
+ */
+void tors_elem_reduce_threads(tors_elem_t rop, const tors_elem_t op, const tors_ring_t tors_ring, const fq_ctx_t ctx) {
+    fq_poly_struct rem[2];
+    tors_task_struct tasks[2];
+    for (slong i = 0; i < 2; i++) {
+        fq_poly_init(rem + i, ctx);
+        tasks[i].rop = rem + i;
+        tasks[i].op1 = (i == 0) ? op->A : op->B;
+        tasks[i].op2 = NULL;
+        tasks[i].tors_ring = tors_ring;
+        tasks[i].tune = tors_ring->tune;
+        tasks[i].ctx = ctx;
+    }
+    tors_tasks_run(tors_ring->pool, tasks, 2, tors_ring->threads);
+
+    fq_poly_swap(rop->A, rem + 0, ctx);
+    fq_poly_swap(rop->B, rem + 1, ctx);
+
+    for (slong i = 0; i < 2; i++) fq_poly_clear(rem + i, ctx);
 }
\ No newline at end of file
@@ -0,0 +1,120 @@
+#include "tune.h"
+#include "tors_ring.h"
+
+tune_struct tune_profile;
+pthread_once_t tune_once = PTHREAD_ONCE_INIT;
+
+const slong tune_mont_limbs[TUNE_MONT_SIZES] = {2, 4, 8};
+const slong tune_simd_bits[TUNE_SIMD_SIZES] = {32, SIMD_MAX_BITS};
+
+void tune_set_default(tune_t tune) {
+    for (slong i = 0; i < TUNE_MONT_SIZES; i++) tune->mont_max_len[i] = TORS_MONT_MAX_LEN;
+    for (slong i = 0; i < TUNE_SIMD_SIZES; i++) tune->simd_max_len[i] = TORS_SIMD_MAX_LEN;
+    tune->pre_fft_min_len = TORS_PRE_FFT_MIN_LEN;
+    tune->pre_fft_min_limbs = TORS_PRE_FFT_MIN_LIMBS;
+    tune->threads_min_len = TORS_THREADS_MIN_LEN;
+    tune->bsgs_weight = 1.0;
+}
+
+/**
+ * Lit le profil path dans tune (c.f tune.h). Renvoie 0, ou -1 si le fichier ne peut pas être ouvert (tune est
+ * alors inchangé).
+ */
+int tune_load(tune_t tune, const char* path) {
+    FILE* file = fopen(path, "r");
+    if (file == NULL) return -1;
+
+    char line[256];
+    char key[TUNE_MAX_KEY];
+    char name[TUNE_MAX_KEY];
+    double value;
+
+    while (fgets(line, sizeof(line), file) != NULL) {
+        if (sscanf(line, " %63s %lf", key, &value) != 2 || key[0] == '#') continue;
+
+        // Tables par taille de q, entièrement remplies par les clés sans suffixe
+        for (slong i = 0; i < TUNE_MONT_SIZES; i++) {
+            snprintf(name, sizeof(name), "mont_max_len_%ld", tune_mont_limbs[i]);
+            if (strcmp(key, "mont_max_len") == 0 || strcmp(key, name) == 0) tune->mont_max_len[i] = (slong)value;
+        }
+        for (slong i = 0; i < TUNE_SIMD_SIZES; i++) {
+            snprintf(name, sizeof(name), "simd_max_len_%ld", tune_simd_bits[i]);
+            if (strcmp(key, "simd_max_len") == 0 || strcmp(key, name) == 0) tune->simd_max_len[i] = (slong)value;
+        }
+
+        if (strcmp(key, "pre_fft_min_len") == 0) {
+            tune->pre_fft_min_len = (slong)value;
+        } else if (strcmp(key, "pre_fft_min_limbs") == 0) {
+            tune->pre_fft_min_limbs = (slong)value;
+        } else if (strcmp(key, "threads_min_len") == 0) {
+            tune->threads_min_len = (slong)value;
+        } else if (strcmp(key, "bsgs_weight") == 0) {
+            tune->bsgs_weight = value;
+        }
+    }
+
+    fclose(file);
+    return 0;
+}
+
+/**
+ * Écrit tune dans le fichier path, au format lu par tune_load(). Renvoie 0, ou -1 en cas d'erreur.
+ */
+int tune_save(const tune_t tune, const char* path) {
+    FILE* file = fopen(path, "w");
+    if (file == NULL) return -1;
+
+    fprintf(file, "# Profil de réglage écrit par schoof_tune (c.f tune.h)\n");
+    for (slong i = 0; i < TUNE_MONT_SIZES; i++) {
+        fprintf(file, "mont_max_len_%ld %ld\n", tune_mont_limbs[i], tune->mont_max_len[i]);
+    }
+    for (slong i = 0; i < TUNE_SIMD_SIZES; i++) {
+        fprintf(file, "simd_max_len_%ld %ld\n", tune_simd_bits[i], tune->simd_max_len[i]);
+    }
+    fprintf(file, "pre_fft_min_len %ld\n", tune->pre_fft_min_len);
+    fprintf(file, "pre_fft_min_limbs %ld\n", tune->pre_fft_min_limbs);
+    fprintf(file, "threads_min_len %ld\n", tune->threads_min_len);
+    fprintf(file, "bsgs_weight %.6g\n", tune->bsgs_weight);
+
+    return (fclose(file) == 0) ? 0 : -1;
+}
+
+/**
+ * Renvoie le profil en vigueur : les valeurs par défaut, remplacées au premier appel par celles du fichier
+ * désigné par la variable d'environnement TUNE_ENV si elle est définie.
+ */
+const tune_struct* tune_get(void) {
+    pthread_once(&tune_once, tune_load_once);
+    return &tune_profile;
+}
+
+void tune_load_once(void) {
+    tune_set_default(&tune_profile);
+
+    const char* path = getenv(TUNE_ENV);
+    if (path != NULL && path[0] != '\0' && tune_load(&tune_profile, path) != 0) {
+        fprintf(stderr, "Impossible de lire le profil de réglage %s, seuils par défaut\n", path);
+    }
+}
+
+/**
+ * Seuil mont_max_len de tune pour q de limbs limbs, 0 si les noyaux de Montgomery ne prennent pas cette taille en
+ * charge (c.f mont.h).
+ */
+slong tune_mont_max_len(const tune_struct* tune, const slong limbs) {
+    for (slong i = 0; i < TUNE_MONT_SIZES; i++) {
+        if (tune_mont_limbs[i] == limbs) return tune->mont_max_len[i];
+    }
+    return 0;
+}
+
+/**
+ * Seuil simd_max_len de tune pour q de bits bits : celui de la plus petite taille de la table qui le contient,
+ * 0 si q est trop grand pour les noyaux vectorisés (c.f simd.h).
+ */
+slong tune_simd_max_len(const tune_struct* tune, const flint_bitcnt_t bits) {
+    for (slong i = 0; i < TUNE_SIMD_SIZES; i++) {
+        if ((slong)bits <= tune_simd_bits[i]) return tune->simd_max_len[i];
+    }
+    return 0;
+}
\ No newline at end of file
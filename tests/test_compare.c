@@ -38,11 +38,754 @@ void naive_num_of_points(fmpz_t res, const fq_t a, const fq_t b, const fq_ctx_t
     fq_clear(temp2, ctx);
 }
 
+/**
+ * Vérifie que les classes de partial sont celles de a_q = q + 1 - N.
+ */
+int test_residues(const schoof_partial_t partial, const fmpz_t q, const fmpz_t N) {
+    fmpz_t a_q;
+    fmpz_init(a_q);
+    fmpz_add_ui(a_q, q, 1);
+    fmpz_sub(a_q, a_q, N);
+
+    int ok = (list_ulong_len(partial->moduli) == list_ulong_len(partial->residues));
+    cell_ulong_t* residue = partial->residues->head;
+    for (cell_ulong_t* ptr = partial->moduli->head; ok && ptr != NULL; ptr = ptr->next, residue = residue->next) {
+        ok = (fmpz_fdiv_ui(a_q, ptr->t) == residue->t);
+    }
+
+    fmpz_clear(a_q);
+    return ok;
+}
+
+// Interrompt le calcul dès le premier module traité
+void test_cancel_progress(const schoof_progress_struct* progress, void* data) {
+    (void)progress;
+    __atomic_store_n((int*)data, 1, __ATOMIC_RELAXED);
+}
+
+/**
+ * Interruptions de la courbe y^2 = x^3 + a*x + b, qui a N points : schoof_mod_l() renvoie SCHOOF_INTERRUPTED
+ * si opt->cancel est déjà levé, un calcul annulé après le premier module rend des classes justes et sa reprise
+ * (c.f schoof_resume()) donne N, un calcul dont opt->deadline est dépassé ne rend aucune classe.
+ */
+int test_interrupt(const fq_t a, const fq_t b, const fmpz_t N, const fq_ctx_t ctx) {
+    fmpz_t q, res;
+    fmpz_init(q);
+    fmpz_init(res);
+    fq_ctx_order(q, ctx);
+
+    ell_curve_t E;
+    ell_curve_init(E, ctx);
+    ell_curve_set(E, a, b, ctx);
+
+    list_fq_poly_t list_psi;
+    list_fq_poly_init(list_psi);
+    update_list_div_poly(list_psi, E, 3, ctx);
+
+    schoof_partial_t partial;
+    schoof_partial_init(partial);
+
+    // Annulation déjà demandée
+    int cancel = 1;
+    tors_stop_t stop;
+    tors_stop_init(stop, &cancel, 0);
+
+    schoof_opt_t opt;
+    schoof_opt_init(opt);
+    opt->stop = stop;
+    int ok = (schoof_mod_l(3, list_fq_poly_get(list_psi, 3), NULL, NULL, 0, E, opt, ctx) == SCHOOF_INTERRUPTED);
+
+    // Annulation après le premier module, puis reprise
+    __atomic_store_n(&cancel, 0, __ATOMIC_RELAXED);
+    schoof_opt_init(opt);
+    opt->cancel = &cancel;
+    opt->progress = test_cancel_progress;
+    opt->progress_data = &cancel;
+    opt->checkpoint = TEST_CHECKPOINT;
+    remove(TEST_CHECKPOINT);
+
+    ok = ok && schoof_interruptible(res, partial, a, b, opt, ctx) == EXIT_FAILURE && partial->interrupted;
+    ok = ok && list_ulong_len(partial->moduli) == 1 && test_residues(partial, q, N);
+
+    schoof_opt_init(opt);
+    ok = ok && schoof_resume(res, TEST_CHECKPOINT, opt) == EXIT_SUCCESS && fmpz_equal(res, N);
+    remove(TEST_CHECKPOINT);
+
+    // Délai dépassé avant le premier module
+    schoof_opt_init(opt);
+    opt->deadline = 1e-9;
+    ok = ok && schoof_interruptible(res, partial, a, b, opt, ctx) == EXIT_FAILURE && partial->interrupted;
+    ok = ok && list_ulong_len(partial->moduli) == 0;
+
+    // Frobenius par blocs : interrompus par un délai dépassé, sinon égaux à x^q et W^{(q-1)/2} modulo chaque ψ_l
+    ulong primes[2] = {3, 5};
+    fq_poly_struct frob_x[2], frob_y[2];
+    fq_poly_t x_q, W;
+    fq_poly_init(x_q, ctx);
+    fq_poly_init(W, ctx);
+    for (slong i = 0; i < 2; i++) {
+        fq_poly_init(frob_x + i, ctx);
+        fq_poly_init(frob_y + i, ctx);
+    }
+    update_list_div_poly(list_psi, E, 5, ctx);
+
+    tors_stop_init(stop, NULL, tors_stop_now() - 1);
+    ok = ok && frobenius_block(frob_x, frob_y, primes, 2, list_psi, E, stop, ctx) == 0;
+
+    tors_stop_init(stop, NULL, tors_stop_now() + 3600);
+    ok = ok && frobenius_block(frob_x, frob_y, primes, 2, list_psi, E, stop, ctx) == 1;
+
+    fmpz_t q_1_2;
+    fmpz_init(q_1_2);
+    fmpz_sub_ui(q_1_2, q, 1);
+    fmpz_fdiv_q_2exp(q_1_2, q_1_2, 1);
+    fq_t one;
+    fq_init(one, ctx);
+    fq_one(one, ctx);
+    fq_poly_set_coeff(W, 3, one, ctx);
+    fq_poly_set_coeff(W, 1, a, ctx);
+    fq_poly_set_coeff(W, 0, b, ctx);
+    for (slong i = 0; ok && i < 2; i++) {
+        const fq_poly_struct* psi_l = list_fq_poly_get(list_psi, primes[i]);
+        fq_poly_gen(x_q, ctx);
+        fq_poly_powmod_fmpz_binexp(x_q, x_q, q, psi_l, ctx);
+        ok = fq_poly_equal(frob_x + i, x_q, ctx);
+        fq_poly_powmod_fmpz_binexp(x_q, W, q_1_2, psi_l, ctx);
+        ok = ok && fq_poly_equal(frob_y + i, x_q, ctx);
+    }
+
+    // Et dans ell_schoof() : délai dépassé avant le premier bloc
+    schoof_opt_init(opt);
+    opt->frob_block = 4;
+    opt->deadline = 1e-9;
+    ok = ok && schoof_interruptible(res, partial, a, b, opt, ctx) == EXIT_FAILURE && partial->interrupted;
+
+    for (slong i = 0; i < 2; i++) {
+        fq_poly_clear(frob_x + i, ctx);
+        fq_poly_clear(frob_y + i, ctx);
+    }
+    fq_poly_clear(x_q, ctx);
+    fq_poly_clear(W, ctx);
+    fq_clear(one, ctx);
+    fmpz_clear(q_1_2);
+
+    schoof_partial_clear(partial);
+    list_fq_poly_clear(list_psi, ctx);
+    ell_curve_clear(E, ctx);
+    fmpz_clear(q);
+    fmpz_clear(res);
+    return ok;
+}
+
+/**
+ * Taille en octets du fichier path, -1 s'il est absent.
+ */
+long test_file_size(const char* path) {
+    FILE* file = fopen(path, "r");
+    if (file == NULL) return -1;
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fclose(file);
+    return size;
+}
+
+/**
+ * Fichiers de reprise de la courbe y^2 = x^3 + a*x + b, qui a N points (c.f checkpoint.h) : un calcul annulé
+ * après le premier module laisse un couple (l, a_q mod l) juste et des ψ_m égaux à ceux de la récurrence, un
+ * enregistrement de ψ_m incomplet à la fin est coupé à la relecture, la reprise donne N, et un fichier de reprise
+ * dont la fin est abîmée est refusé.
+ */
+int test_checkpoint(const fq_t a, const fq_t b, const fmpz_t N, const fq_ctx_t ctx) {
+    const char* psi_path = TEST_CHECKPOINT CHECKPOINT_PSI_SUFFIX;
+    remove(TEST_CHECKPOINT);
+    remove(psi_path);
+
+    fmpz_t q, res;
+    fmpz_init(q);
+    fmpz_init(res);
+    fq_ctx_order(q, ctx);
+
+    ell_curve_t E;
+    ell_curve_init(E, ctx);
+    ell_curve_set(E, a, b, ctx);
+
+    schoof_partial_t partial;
+    schoof_partial_init(partial);
+
+    // Annulation après le premier module
+    int cancel = 0;
+    schoof_opt_t opt;
+    schoof_opt_init(opt);
+    opt->cancel = &cancel;
+    opt->progress = test_cancel_progress;
+    opt->progress_data = &cancel;
+    opt->checkpoint = TEST_CHECKPOINT;
+    opt->checkpoint_psi = 1;
+    int ok = (schoof_interruptible(res, partial, a, b, opt, ctx) == EXIT_FAILURE);
+
+    // Couple enregistré
+    list_ulong_t list_primes, list_ts;
+    list_ulong_init(list_primes);
+    list_ulong_init(list_ts);
+    ok = ok && checkpoint_load(list_primes, list_ts, TEST_CHECKPOINT, E, ctx) == 1;
+    if (ok) {
+        fmpz_add_ui(res, q, 1);
+        fmpz_sub(res, res, N);
+        ok = (fmpz_fdiv_ui(res, list_primes->head->t) == list_ts->head->t);
+    }
+
+    // ψ_m enregistrés, puis relus après l'ajout d'un enregistrement incomplet
+    list_fq_poly_t list_psi, list_saved;
+    list_fq_poly_init(list_psi);
+    list_fq_poly_init(list_saved);
+    long size = test_file_size(psi_path);
+    FILE* file = fopen(psi_path, "a");
+    ok = ok && size > 0 && file != NULL;
+    if (file != NULL) {
+        fprintf(file, "psi 1000 3\n1 2");
+        fclose(file);
+    }
+
+    ulong len = (ulong)checkpoint_psi_load(list_saved, TEST_CHECKPOINT, ctx);
+    ok = ok && len > list_primes->head->t && test_file_size(psi_path) <= size;
+    if (ok) {
+        update_list_div_poly(list_psi, E, len - 1, ctx);
+        for (ulong m = 0; ok && m < len; m++) ok = fq_poly_equal(list_fq_poly_get(list_psi, m), list_fq_poly_get(list_saved, m), ctx);
+    }
+
+    // Reprise
+    schoof_opt_init(opt);
+    opt->checkpoint_psi = 1;
+    ok = ok && schoof_resume(res, TEST_CHECKPOINT, opt) == EXIT_SUCCESS && fmpz_equal(res, N);
+
+    // Fin abîmée : le marqueur "end" est remplacé
+    file = fopen(TEST_CHECKPOINT, "r+");
+    ok = ok && file != NULL;
+    if (file != NULL) {
+        fseek(file, -4, SEEK_END);
+        fprintf(file, "xyz\n");
+        fclose(file);
+    }
+    list_ulong_clear(list_primes);
+    list_ulong_clear(list_ts);
+    list_ulong_init(list_primes);
+    list_ulong_init(list_ts);
+    ok = ok && checkpoint_load(list_primes, list_ts, TEST_CHECKPOINT, E, ctx) == -1 && list_ulong_len(list_primes) == 0;
+
+    // Nombre de couples hors de portée : un de plus que checkpoint_max_pairs()
+    for (ulong i = 0; i <= checkpoint_max_pairs(ctx); i++) {
+        list_ulong_add(list_primes, 3);
+        list_ulong_add(list_ts, 0);
+    }
+    ok = ok && checkpoint_save(TEST_CHECKPOINT, E, list_primes, list_ts, ctx) == 0;
+    list_ulong_clear(list_primes);
+    list_ulong_clear(list_ts);
+    list_ulong_init(list_primes);
+    list_ulong_init(list_ts);
+    ok = ok && checkpoint_load(list_primes, list_ts, TEST_CHECKPOINT, E, ctx) == -1 && list_ulong_len(list_primes) == 0;
+
+    remove(TEST_CHECKPOINT);
+    remove(psi_path);
+    list_ulong_clear(list_primes);
+    list_ulong_clear(list_ts);
+    list_fq_poly_clear(list_psi, ctx);
+    list_fq_poly_clear(list_saved, ctx);
+    schoof_partial_clear(partial);
+    ell_curve_clear(E, ctx);
+    fmpz_clear(q);
+    fmpz_clear(res);
+    return ok;
+}
+
+/**
+ * Calcul réparti (c.f distrib_supported()) : avec une option que les processus de calcul ne prennent pas en
+ * charge, ou avec un fichier de reprise qui contient une puissance l^k, schoof_with_opt() échoue sans réécrire le
+ * fichier.
+ */
+int test_distrib_options(const fq_t a, const fq_t b, const fq_ctx_t ctx) {
+    fmpz_t res;
+    fmpz_init(res);
+
+    schoof_opt_t opt;
+    schoof_opt_init(opt);
+    opt->workers = 2;
+    opt->bsgs = 1;
+    int ok = (schoof_with_opt(res, a, b, opt, ctx) == EXIT_FAILURE);
+
+    ell_curve_t E;
+    ell_curve_init(E, ctx);
+    ell_curve_set(E, a, b, ctx);
+
+    list_ulong_t list_primes, list_ts;
+    list_ulong_init(list_primes);
+    list_ulong_init(list_ts);
+    list_ulong_add(list_primes, 9);
+    list_ulong_add(list_ts, 0);
+    remove(TEST_CHECKPOINT);
+    ok = ok && checkpoint_save(TEST_CHECKPOINT, E, list_primes, list_ts, ctx) == 0;
+    list_ulong_clear(list_primes);
+    list_ulong_clear(list_ts);
+    list_ulong_init(list_primes);
+    list_ulong_init(list_ts);
+
+    schoof_opt_init(opt);
+    opt->workers = 2;
+    opt->checkpoint = TEST_CHECKPOINT;
+    ok = ok && schoof_with_opt(res, a, b, opt, ctx) == EXIT_FAILURE;
+    ok = ok && checkpoint_load(list_primes, list_ts, TEST_CHECKPOINT, E, ctx) == 1 && list_primes->head->t == 9;
+
+    remove(TEST_CHECKPOINT);
+    list_ulong_clear(list_primes);
+    list_ulong_clear(list_ts);
+    ell_curve_clear(E, ctx);
+    fmpz_clear(res);
+    return ok;
+}
+
+/**
+ * Classe d'isomorphisme de y^2 = x^3 + a*x + b dans cache (c.f curve_cache.h) : après l'insertion de son nombre
+ * de points compté naïvement, y^2 = x^3 + u^4*a*x + u^6*b (u non nul) le retrouve et le twist quadratique
+ * y^2 = x^3 + d^2*a*x + d^3*b (d non carré) trouve 2*q + 2 - #E(F_q).
+ */
+int test_cache_class(curve_cache_t cache, const fq_t a, const fq_t b, flint_rand_t state, const fq_ctx_t ctx) {
+    fmpz_t n, n_twist, res;
+    fmpz_init(n);
+    fmpz_init(n_twist);
+    fmpz_init(res);
+
+    fq_t u, ua, ub;
+    fq_init(u, ctx);
+    fq_init(ua, ctx);
+    fq_init(ub, ctx);
+
+    naive_num_of_points(n, a, b, ctx);
+    fq_ctx_order(n_twist, ctx);
+    fmpz_add_ui(n_twist, n_twist, 1);
+    fmpz_mul_ui(n_twist, n_twist, 2);
+    fmpz_sub(n_twist, n_twist, n);
+    int ok = (curve_cache_insert(cache, a, b, n, ctx) >= 0);
+
+    // u^4*a et u^6*b
+    do {
+        fq_rand(u, state, ctx);
+    } while (fq_is_zero(u, ctx));
+    fq_sqr(u, u, ctx);
+    fq_sqr(ua, u, ctx);
+    fq_mul(ua, ua, a, ctx);
+    fq_pow_ui(ub, u, 3, ctx);
+    fq_mul(ub, ub, b, ctx);
+    ok = ok && curve_cache_lookup(res, cache, ua, ub, ctx) && fmpz_equal(res, n);
+
+    // d^2*a et d^3*b
+    ulong d = 2;
+    do {
+        fq_set_ui(u, d++, ctx);
+    } while (fq_is_square(u, ctx));
+    fq_sqr(ua, u, ctx);
+    fq_mul(ua, ua, a, ctx);
+    fq_pow_ui(ub, u, 3, ctx);
+    fq_mul(ub, ub, b, ctx);
+    ok = ok && curve_cache_lookup(res, cache, ua, ub, ctx) && fmpz_equal(res, n_twist);
+
+    fq_clear(u, ctx);
+    fq_clear(ua, ctx);
+    fq_clear(ub, ctx);
+    fmpz_clear(n);
+    fmpz_clear(n_twist);
+    fmpz_clear(res);
+    return ok;
+}
+
+/**
+ * Cache des nombres de points (c.f curve_cache.h) : une capacité nulle ou dont la taille déborde est refusée, et
+ * la clé (p, j, w) est vérifiée par test_cache_class() pour y^2 = x^3 + a*x + b, pour une courbe de j-invariant
+ * 0 et pour une courbe de j-invariant 1728.
+ */
+int test_cache(const fq_t a, const fq_t b, flint_rand_t state, const fq_ctx_t ctx) {
+    curve_cache_t cache;
+    remove(TEST_CACHE);
+    int ok = (curve_cache_open(cache, TEST_CACHE, 0) != 0);
+    remove(TEST_CACHE);
+    ok = ok && curve_cache_open(cache, TEST_CACHE, UWORD_MAX) != 0;
+    remove(TEST_CACHE);
+    ok = ok && curve_cache_open(cache, TEST_CACHE, 64) == 0;
+    if (!ok) return 0;
+
+    fq_t zero, c;
+    fq_init(zero, ctx);
+    fq_init(c, ctx);
+    do {
+        fq_rand(c, state, ctx);
+    } while (fq_is_zero(c, ctx));
+
+    ok = test_cache_class(cache, a, b, state, ctx) && test_cache_class(cache, zero, c, state, ctx)
+        && test_cache_class(cache, c, zero, state, ctx);
+
+    fq_clear(zero, ctx);
+    fq_clear(c, ctx);
+    curve_cache_close(cache);
+    remove(TEST_CACHE);
+    return ok;
+}
+
+/**
+ * Pas de bébé, pas de géant (c.f ell_fq_point_bsgs()) : pour R = [j]P avec j tiré dans [0, K-1], j doit être
+ * parmi les solutions trouvées, qui vérifient toutes [i]P = R et sont rangées par ordre croissant.
+ */
+int test_bsgs(const ell_curve_t E, flint_rand_t state, const fq_ctx_t ctx) {
+    const ulong K = 1000;
+    ulong matches[16];
+
+    ell_fq_point_t P, R, Q;
+    ell_fq_point_init(P, ctx);
+    ell_fq_point_init(R, ctx);
+    ell_fq_point_init(Q, ctx);
+
+    fmpz_t n;
+    fmpz_init(n);
+
+    ell_fq_point_random(P, E, state, ctx);
+    ulong j = n_randint(state, K);
+    fmpz_set_ui(n, j);
+    ell_fq_point_mul(R, P, n, E, ctx);
+
+    slong num = ell_fq_point_bsgs(matches, 16, R, P, K, E, ctx);
+    int ok = (num != 0);
+    int found = (num < 0); // Trop de solutions si P est d'ordre petit
+    for (slong i = 0; ok && i < num; i++) {
+        fmpz_set_ui(n, matches[i]);
+        ell_fq_point_mul(Q, P, n, E, ctx);
+        ok = ell_fq_point_equal(Q, R, ctx) && (i == 0 || matches[i - 1] < matches[i]);
+        found |= (matches[i] == j);
+    }
+
+    ell_fq_point_clear(P, ctx);
+    ell_fq_point_clear(R, ctx);
+    ell_fq_point_clear(Q, ctx);
+    fmpz_clear(n);
+    return ok && found;
+}
+
+/**
+ * Produits et réductions sur plusieurs threads (c.f tors_poly_mul_threads() et tors_poly_rem_threads()) : le
+ * profil de réglage est abaissé pour que le Karatsuba parallèle et la division de Newton servent dès quelques
+ * coefficients, et les résultats sont comparés à fq_poly_mul() et fq_poly_rem().
+ */
+int test_threads(const ell_curve_t E, flint_rand_t state, const fq_ctx_t ctx) {
+    tune_struct saved = *tune_get();
+    for (slong i = 0; i < TUNE_MONT_SIZES; i++) tune_profile.mont_max_len[i] = 0;
+    for (slong i = 0; i < TUNE_SIMD_SIZES; i++) tune_profile.simd_max_len[i] = 0;
+    tune_profile.threads_min_len = 4;
+
+    fq_poly_t psi, op1, op2, res, expected;
+    fq_poly_init(psi, ctx);
+    fq_poly_init(op1, ctx);
+    fq_poly_init(op2, ctx);
+    fq_poly_init(res, ctx);
+    fq_poly_init(expected, ctx);
+
+    tors_ring_t tors_ring;
+    tors_ring_init(tors_ring, ctx);
+
+    int ok = 1;
+    for (slong len = 8; ok && len <= 64; len *= 2) {
+        fq_poly_randtest_monic(psi, state, len, ctx);
+        tors_ring_set(tors_ring, E, psi, ctx);
+        tors_ring_set_threads(tors_ring, 4, ctx);
+        ok = !fq_poly_is_zero(tors_ring->psi_inv, ctx) && tors_ring->pool != NULL && tors_ring->pool->num_workers == 3;
+
+        fq_poly_randtest(op1, state, len - 1, ctx);
+        fq_poly_randtest(op2, state, len - 1, ctx);
+
+        // Produit sans réduction
+        fq_poly_mul(expected, op1, op2, ctx);
+        tors_poly_mul_unreduced(res, op1, op2, tors_ring, ctx);
+        ok = ok && fq_poly_equal(res, expected, ctx);
+
+        // Reste par division de Newton
+        fq_poly_rem(expected, expected, psi, ctx);
+        tors_poly_mul(res, op1, op2, tors_ring, ctx);
+        ok = ok && fq_poly_equal(res, expected, ctx);
+
+        fq_poly_sqr(expected, op1, ctx);
+        fq_poly_rem(expected, expected, psi, ctx);
+        tors_poly_sqr(res, op1, tors_ring, ctx);
+        ok = ok && fq_poly_equal(res, expected, ctx);
+    }
+
+    // Réserve rendue avec le retour à un seul thread
+    tors_ring_set_threads(tors_ring, 1, ctx);
+    ok = ok && tors_ring->pool == NULL;
+
+    tors_ring_clear(tors_ring, ctx);
+    fq_poly_clear(psi, ctx);
+    fq_poly_clear(op1, ctx);
+    fq_poly_clear(op2, ctx);
+    fq_poly_clear(res, ctx);
+    fq_poly_clear(expected, ctx);
+
+    tune_profile = saved;
+    return ok;
+}
+
+/**
+ * Libération des ψ_m en mode économe en mémoire (c.f evict_list_div_poly()) : en suivant les l comme
+ * ell_schoof(), les ψ_k encore présents sont exactement ceux avec n/2 - 2 <= k <= n_max/2 + 2 ou k >= l_min
+ * premier.
+ */
+int test_evict(const ell_curve_t E, const fq_ctx_t ctx) {
+    const ulong n_max = 61;
+    list_fq_poly_t list_psi;
+    list_fq_poly_init(list_psi);
+
+    int ok = 1;
+    for (ulong l = 3; ok && l <= n_max; l = n_nextprime(l, 1)) {
+        for (int step = 0; ok && step < 2; step++) {
+            ulong l_min = l + step;
+            if (step == 0) {
+                update_list_div_poly_low_memory(list_psi, E, l, l_min, n_max, ctx);
+            } else {
+                evict_list_div_poly(list_psi, l_min, n_max, ctx);
+            }
+
+            ulong n = list_fq_poly_len(list_psi);
+            ulong k_min = (n / 2 > 2) ? n / 2 - 2 : 0;
+            for (cell_fq_poly_t* ptr = list_psi->head; ok && ptr != NULL; ptr = ptr->next) {
+                int kept = (ptr->index >= k_min && ptr->index <= n_max / 2 + 2) || (ptr->index >= l_min && n_is_prime(ptr->index));
+                ok = (ptr->evicted == !kept);
+            }
+        }
+    }
+
+    list_fq_poly_clear(list_psi, ctx);
+    return ok;
+}
+
+/**
+ * Production des ψ_l à l'avance (c.f psi_pipe.h) avec une file d'un élément : chaque ψ_l retiré est celui de
+ * update_list_div_poly(), et le producteur libère en route ses ψ_m inutiles. Après ψ_31, il ne garde que les ψ_k
+ * avec 14 <= k <= 17 et les ψ_l que ell_schoof() pouvait encore utiliser, au plus 23, 29 et 31.
+ */
+int test_pipe(const ell_curve_t E, const fq_ctx_t ctx) {
+    const ulong l_max = 31;
+    list_fq_poly_t list_psi;
+    list_fq_poly_init(list_psi);
+    update_list_div_poly(list_psi, E, l_max, ctx);
+
+    psi_pipe_t pipe;
+    psi_pipe_init(pipe, E, l_max, 1, 1, ctx);
+
+    int ok = 1;
+    for (ulong l = 3; l <= l_max; l = n_nextprime(l, 1)) {
+        const fq_poly_struct* psi_l = psi_pipe_pop(pipe, l);
+        ok = ok && psi_l != NULL && fq_poly_equal(psi_l, list_fq_poly_get(list_psi, l), ctx);
+    }
+    psi_pipe_stop(pipe);
+
+    slong live = 0;
+    for (cell_fq_poly_t* ptr = pipe->list_psi->head; ptr != NULL; ptr = ptr->next) live += !ptr->evicted;
+    ok = ok && list_fq_poly_len(pipe->list_psi) == l_max + 1 && live <= 7;
+
+    psi_pipe_clear(pipe, ctx);
+    list_fq_poly_clear(list_psi, ctx);
+    return ok;
+}
+
+/**
+ * Arènes (c.f arena.h) : les fonctions mémoire de FLINT et de GMP ne sont remplacées que tant qu'une arène est
+ * ouverte, y compris imbriquée, et les allocations de l'arène sont comptées jusqu'à leur libération. Un bloc
+ * alloué avant reste libérable après la fermeture.
+ */
+int test_arena(void) {
+    arena_hooks_struct before, during, after;
+    __flint_get_memory_functions(&before.alloc_func, &before.calloc_func, &before.realloc_func, &before.free_func);
+    mp_get_memory_functions(&before.gmp_alloc_func, &before.gmp_realloc_func, &before.gmp_free_func);
+    void* outside = flint_malloc(64);
+
+    arena_t outer, inner;
+    arena_init(outer);
+    arena_init(inner);
+
+    arena_begin(outer);
+    __flint_get_memory_functions(&during.alloc_func, &during.calloc_func, &during.realloc_func, &during.free_func);
+    mp_get_memory_functions(&during.gmp_alloc_func, &during.gmp_realloc_func, &during.gmp_free_func);
+    int ok = (before.alloc_func != arena_malloc && before.gmp_alloc_func != arena_gmp_alloc);
+    ok = ok && during.alloc_func == arena_malloc && during.gmp_alloc_func == arena_gmp_alloc;
+
+    void* ptr = flint_malloc(100);
+    ptr = flint_realloc(ptr, 200);
+    void* ptr2 = flint_malloc(10);
+    ok = ok && arena_owns(outer, ptr) && arena_owns(outer, ptr2) && !arena_owns(outer, outside) && outer->live == 2;
+    flint_free(ptr);
+    flint_free(ptr2);
+    ok = ok && outer->live == 0;
+
+    // Arène imbriquée : les fonctions restent en place jusqu'à la fermeture de la dernière
+    arena_begin(inner);
+    ptr = flint_malloc(32);
+    ok = ok && arena_owns(inner, ptr) && !arena_owns(outer, ptr);
+    flint_free(ptr);
+    arena_end(inner);
+    __flint_get_memory_functions(&during.alloc_func, &during.calloc_func, &during.realloc_func, &during.free_func);
+    ok = ok && during.alloc_func == arena_malloc;
+    arena_end(outer);
+
+    __flint_get_memory_functions(&after.alloc_func, &after.calloc_func, &after.realloc_func, &after.free_func);
+    mp_get_memory_functions(&after.gmp_alloc_func, &after.gmp_realloc_func, &after.gmp_free_func);
+    ok = ok && after.alloc_func == before.alloc_func && after.realloc_func == before.realloc_func && after.free_func == before.free_func;
+    ok = ok && after.gmp_alloc_func == before.gmp_alloc_func && after.gmp_free_func == before.gmp_free_func;
+
+    flint_free(outside);
+    arena_clear(inner);
+    arena_clear(outer);
+    return ok;
+}
+
+/**
+ * Tables de seuils par taille de q (c.f tune.h) : relues telles qu'écrites par tune_save(), remplies par une clé
+ * sans suffixe, et un anneau sur un q de 4 limbs prend le seuil de 4 limbs et non celui des autres tailles.
+ */
+int test_tune(flint_rand_t state) {
+    tune_t tune, loaded;
+    tune_set_default(tune);
+    tune_set_default(loaded);
+    for (slong i = 0; i < TUNE_MONT_SIZES; i++) tune->mont_max_len[i] = 10 + i;
+    for (slong i = 0; i < TUNE_SIMD_SIZES; i++) tune->simd_max_len[i] = 20 + i;
+
+    int ok = (tune_save(tune, TEST_TUNE) == 0 && tune_load(loaded, TEST_TUNE) == 0);
+    for (slong i = 0; i < TUNE_MONT_SIZES; i++) ok = ok && loaded->mont_max_len[i] == 10 + i;
+    for (slong i = 0; i < TUNE_SIMD_SIZES; i++) ok = ok && loaded->simd_max_len[i] == 20 + i;
+    ok = ok && tune_mont_max_len(loaded, 4) == 11 && tune_mont_max_len(loaded, 3) == 0;
+    ok = ok && tune_simd_max_len(loaded, 30) == 20 && tune_simd_max_len(loaded, 40) == 21 && tune_simd_max_len(loaded, 64) == 0;
+
+    FILE* file = fopen(TEST_TUNE, "w");
+    ok = ok && file != NULL;
+    if (file != NULL) {
+        fprintf(file, "mont_max_len 7\n");
+        fclose(file);
+    }
+    ok = ok && tune_load(loaded, TEST_TUNE) == 0;
+    for (slong i = 0; i < TUNE_MONT_SIZES; i++) ok = ok && loaded->mont_max_len[i] == 7;
+    remove(TEST_TUNE);
+
+    // Seul le seuil de 4 limbs autorise les noyaux de Montgomery
+    tune_struct saved = *tune_get();
+    for (slong i = 0; i < TUNE_MONT_SIZES; i++) tune_profile.mont_max_len[i] = (tune_mont_limbs[i] == 4) ? 16 : 0;
+
+    fmpz_t p;
+    fmpz_init(p);
+    for (slong limbs = 2; ok && limbs <= 4; limbs += 2) {
+        fmpz_randprime(p, state, limbs * FLINT_BITS, 1);
+
+        fq_ctx_t ctx;
+        fq_ctx_init(ctx, p, 1, "a");
+
+        ell_curve_t E;
+        ell_curve_init(E, ctx);
+        fq_rand(E->a, state, ctx);
+        fq_rand(E->b, state, ctx);
+
+        fq_poly_t psi;
+        fq_poly_init(psi, ctx);
+        fq_poly_randtest_monic(psi, state, 8, ctx);
+
+        tors_ring_t tors_ring;
+        tors_ring_init(tors_ring, ctx);
+        tors_ring_set(tors_ring, E, psi, ctx);
+        if (limbs == 4) {
+            ok = (tors_ring->mont_max_len == 16 && tors_ring->mont_psi != NULL);
+        } else {
+            ok = (tors_ring->mont_max_len == 0 && tors_ring->mont_psi == NULL);
+        }
+
+        tors_ring_clear(tors_ring, ctx);
+        fq_poly_clear(psi, ctx);
+        ell_curve_clear(E, ctx);
+        fq_ctx_clear(ctx);
+    }
+    fmpz_clear(p);
+
+    tune_profile = saved;
+    return ok;
+}
+
+/**
+ * Noyaux de Montgomery à 2, 4 et 8 limbs (c.f mont.h) : pour un p premier tiré au hasard de chaque largeur (au
+ * plus petit ou au plus grand nombre de bits de la largeur), les produits, carrés et restes de tors_ring sont
+ * comparés à fq_poly_mul() et fq_poly_rem().
+ */
+int test_mont(flint_rand_t state) {
+    fmpz_t p;
+    fmpz_init(p);
+
+    int ok = 1;
+    for (slong limbs = 2; ok && limbs <= MONT_MAX_LIMBS; limbs *= 2) {
+        slong bits = n_randint(state, 2) ? limbs * FLINT_BITS : (limbs / 2) * FLINT_BITS + 1;
+        fmpz_randprime(p, state, bits, 1);
+
+        fq_ctx_t ctx;
+        fq_ctx_init(ctx, p, 1, "a");
+
+        ell_curve_t E;
+        ell_curve_init(E, ctx);
+        fq_rand(E->a, state, ctx);
+        fq_rand(E->b, state, ctx);
+
+        fq_poly_t psi, op1, op2, res, expected;
+        fq_poly_init(psi, ctx);
+        fq_poly_init(op1, ctx);
+        fq_poly_init(op2, ctx);
+        fq_poly_init(res, ctx);
+        fq_poly_init(expected, ctx);
+
+        slong len = 2 + n_randint(state, 30);
+        fq_poly_randtest_monic(psi, state, len, ctx);
+        fq_poly_randtest(op1, state, len - 1, ctx);
+        fq_poly_randtest(op2, state, len - 1, ctx);
+
+        tors_ring_t tors_ring;
+        tors_ring_init(tors_ring, ctx);
+        tors_ring_set(tors_ring, E, psi, ctx);
+        ok = (tors_ring->mont->limbs == limbs && tors_ring->mont_psi != NULL);
+
+        fq_poly_mul(expected, op1, op2, ctx);
+        tors_poly_mul_unreduced(res, op1, op2, tors_ring, ctx);
+        ok = ok && fq_poly_equal(res, expected, ctx);
+
+        tors_poly_reduce(res, res, tors_ring, ctx);
+        fq_poly_rem(expected, expected, psi, ctx);
+        ok = ok && fq_poly_equal(res, expected, ctx);
+
+        tors_poly_mul(res, op1, op2, tors_ring, ctx);
+        ok = ok && fq_poly_equal(res, expected, ctx);
+
+        fq_poly_sqr(expected, op1, ctx);
+        tors_poly_sqr_unreduced(res, op1, tors_ring, ctx);
+        ok = ok && fq_poly_equal(res, expected, ctx);
+
+        fq_poly_rem(expected, expected, psi, ctx);
+        tors_poly_sqr(res, op1, tors_ring, ctx);
+        ok = ok && fq_poly_equal(res, expected, ctx);
+
+        tors_ring_clear(tors_ring, ctx);
+        fq_poly_clear(psi, ctx);
+        fq_poly_clear(op1, ctx);
+        fq_poly_clear(op2, ctx);
+        fq_poly_clear(res, ctx);
+        fq_poly_clear(expected, ctx);
+        ell_curve_clear(E, ctx);
+        fq_ctx_clear(ctx);
+    }
+
+    fmpz_clear(p);
+    return ok;
+}
+
 int main() {    
     FILE* file = fopen("./results/results_compare.csv", "w");
     fprintf(file, "NUM_TRIALS,MIN_BITS,MAX_BITS\n");
     fprintf(file, "%i,%i,%i\n", NUM_TRIALS, MIN_BITS, MAX_BITS);
-    fprintf(file, "q,a,b,naive,schoof\n"); // Format du fichier .csv
+    fprintf(file, "q,a,b,naive,schoof,schoof_affine,schoof_distrib,schoof_powers,schoof_pipe,schoof_batch\n"); // Format du fichier .csv
 
     flint_rand_t state;
     flint_randinit(state);
@@ -50,9 +793,76 @@ int main() {
     fmpz_t q;
     fmpz_init(q);
 
-    fmpz_t res_schoof, res_naive;
+    fmpz_t res_schoof, res_naive, res_affine, res_distrib, res_powers, res_pipe;
     fmpz_init(res_schoof);
     fmpz_init(res_naive);
+    fmpz_init(res_affine);
+    fmpz_init(res_distrib);
+    fmpz_init(res_powers);
+    fmpz_init(res_pipe);
+
+    // Traitement par lots de la courbe et de sa tordue quadratique y^2 = x^3 + a*d^2*x + b*d^3 (d non carré), qui a
+    // 2*q + 2 - #E(F_q) points : les deux voies suivent des courbes différentes
+    fmpz* res_batch = _fmpz_vec_init(2);
+    fmpz_t res_twist;
+    fmpz_init(res_twist);
+    fq_struct batch_a[2], batch_b[2];
+
+    // Options pour tester le mode affine, avec libération des polynômes de division inutiles et arrêt anticipé
+    schoof_opt_t opt_affine;
+    schoof_opt_init(opt_affine);
+    opt_affine->affine = 1;
+    opt_affine->low_memory = 1;
+    opt_affine->bsgs = 1;
+
+    // Options pour tester la répartition sur plusieurs processus, chacun allouant dans une arène
+    schoof_opt_t opt_distrib;
+    schoof_opt_init(opt_distrib);
+    opt_distrib->workers = 2;
+    opt_distrib->low_memory = 1;
+    opt_distrib->arena = 1;
+
+    // Options pour tester les modules l^k et les classes au signe près, avec les Frobenius calculés par blocs,
+    // les allocations dans une arène, les polynômes de division et les grands produits calculés par deux threads
+    schoof_opt_t opt_powers;
+    schoof_opt_init(opt_powers);
+    opt_powers->prime_powers = 1;
+    opt_powers->match_sort = 1;
+    opt_powers->frob_block = 2;
+    opt_powers->arena = 1;
+    opt_powers->psi_threads = 2;
+    opt_powers->mul_threads = 2;
+
+    // Options pour tester les ψ_l calculés à l'avance par un thread producteur (sur deux threads) pendant la
+    // recherche de a_q modulo l
+    schoof_opt_t opt_pipe;
+    schoof_opt_init(opt_pipe);
+    opt_pipe->psi_ahead = 2;
+    opt_pipe->psi_threads = 2;
+
+    // Recherche d'une courbe d'ordre premier avec deux candidates en même temps, une fois par taille
+    schoof_opt_t opt_search;
+    schoof_opt_init(opt_search);
+    search_opt_t sopt;
+    search_opt_init(sopt);
+    sopt->threads = 2;
+    sopt->max_candidates = 1000;
+    fmpz_t res_search;
+    fmpz_init(res_search);
+
+    // Traces de y^2 = x^3 - 7*x + 10 sur Q pour les premiers qui suivent q, une fois par taille, sans somme de
+    // caractères (pas de bébé-pas de géant ou Schoof avec les ψ_m réduits depuis Z) et sur deux threads
+    schoof_opt_t opt_range;
+    schoof_opt_init(opt_range);
+    range_opt_t ropt;
+    range_opt_init(ropt);
+    ropt->threads = 2;
+    ropt->naive_max = 0;
+    fmpz_t range_a, range_b;
+    fmpz_init(range_a);
+    fmpz_init(range_b);
+    fmpz_set_si(range_a, -7);
+    fmpz_set_si(range_b, 10);
     
     int num_of_success = 0;
 
@@ -85,14 +895,132 @@ int main() {
             fprintf(file, ",");
             
             naive_num_of_points(res_naive, a, b, ctx);
-            num_of_success += fmpz_equal(res_schoof, res_naive);
+            schoof_with_opt(res_affine, a, b, opt_affine, ctx);
+            schoof_with_opt(res_distrib, a, b, opt_distrib, ctx);
+            schoof_with_opt(res_powers, a, b, opt_powers, ctx);
+            schoof_with_opt(res_pipe, a, b, opt_pipe, ctx);
+
+            fq_init(batch_a + 0, ctx);
+            fq_init(batch_a + 1, ctx);
+            fq_init(batch_b + 0, ctx);
+            fq_init(batch_b + 1, ctx);
+            fq_set(batch_a + 0, a, ctx);
+            fq_set(batch_b + 0, b, ctx);
+
+            ulong d = 2;
+            do {
+                fq_set_ui(batch_a + 1, d++, ctx);
+            } while (fq_is_square(batch_a + 1, ctx));
+            fq_pow_ui(batch_b + 1, batch_a + 1, 3, ctx);
+            fq_mul(batch_b + 1, batch_b + 1, b, ctx);
+            fq_sqr(batch_a + 1, batch_a + 1, ctx);
+            fq_mul(batch_a + 1, batch_a + 1, a, ctx);
+            batch_schoof(res_batch, batch_a, batch_b, 2, ctx);
+
+            // Ordre de la courbe trouvée, premier et égal au comptage naïf
+            int search_ok = 1;
+            if (j == 0) {
+                search_curve_t found;
+                search_curve_init(found, ctx);
+                search_ok = (search_curves(found, 1, sopt, opt_search, ctx) == 1);
+                if (search_ok) {
+                    naive_num_of_points(res_search, found->a, found->b, ctx);
+                    search_ok = fmpz_equal(res_search, found->order) && fmpz_is_probabprime(found->order);
+                }
+                search_curve_clear(found, ctx);
+            }
+
+            // a_p de chaque ligne "p,a_p" égal à p + 1 - #E(F_p) compté naïvement
+            int range_ok = 1;
+            if (j == 0) {
+                FILE* range_file = tmpfile();
+                range_traces(range_file, range_a, range_b, fmpz_get_ui(q), fmpz_get_ui(q) + 32, ropt, opt_range);
+                rewind(range_file);
+
+                ulong p;
+                slong a_p;
+                while (range_ok && fscanf(range_file, "%lu,%ld", &p, &a_p) == 2) {
+                    fmpz_t P;
+                    fmpz_init_set_ui(P, p);
+                    fq_ctx_t range_ctx;
+                    fq_ctx_init(range_ctx, P, 1, "a");
+                    fq_t fq_a, fq_b;
+                    fq_init(fq_a, range_ctx);
+                    fq_init(fq_b, range_ctx);
+                    fq_set_fmpz(fq_a, range_a, range_ctx);
+                    fq_set_fmpz(fq_b, range_b, range_ctx);
+
+                    naive_num_of_points(res_search, fq_a, fq_b, range_ctx);
+                    fmpz_add_ui(P, P, 1);
+                    fmpz_sub(P, P, res_search);
+                    range_ok = fmpz_equal_si(P, a_p);
+
+                    fq_clear(fq_a, range_ctx);
+                    fq_clear(fq_b, range_ctx);
+                    fq_ctx_clear(range_ctx);
+                    fmpz_clear(P);
+                }
+                fclose(range_file);
+            }
+
+            // Interruptions par opt->cancel et opt->deadline, classes rendues et reprise
+            int interrupt_ok = (j != 0) || test_interrupt(a, b, res_naive, ctx);
+
+            // Fichiers de reprise enregistrés, abîmés puis relus
+            int checkpoint_ok = (j != 0) || test_checkpoint(a, b, res_naive, ctx);
 
-            // Ecriture de res_naive et res_schoof
+            // Options refusées par le calcul réparti
+            int distrib_ok = (j != 0) || test_distrib_options(a, b, ctx);
+
+            // Classes d'isomorphisme et twists retrouvés dans le cache
+            int cache_ok = (j != 0) || test_cache(a, b, state, ctx);
+
+            // Produits et réductions sur plusieurs threads comparés à FLINT, ψ_l produits à l'avance ou libérés au
+            // plus tôt, pas de bébé-pas de géant
+            int threads_ok = 1, bsgs_ok = 1;
+            if (j == 0) {
+                ell_curve_t E;
+                ell_curve_init(E, ctx);
+                ell_curve_set(E, a, b, ctx);
+                threads_ok = test_threads(E, state, ctx) && test_pipe(E, ctx) && test_evict(E, ctx);
+                bsgs_ok = test_bsgs(E, state, ctx);
+                ell_curve_clear(E, ctx);
+            }
+
+            // Noyaux de Montgomery de chaque largeur, comparés à FLINT, et seuils de chaque taille de q
+            int mont_ok = (j != 0) || (test_mont(state) && test_tune(state));
+
+            // Fonctions mémoire remplacées seulement tant qu'une arène est ouverte
+            int arena_ok = (j != 0) || test_arena();
+
+            // res_twist = 2*q + 2 - #E(F_q)
+            fmpz_add_ui(res_twist, q, 1);
+            fmpz_mul_ui(res_twist, res_twist, 2);
+            fmpz_sub(res_twist, res_twist, res_naive);
+
+            num_of_success += fmpz_equal(res_schoof, res_naive) && fmpz_equal(res_affine, res_naive) && fmpz_equal(res_distrib, res_naive)
+                && fmpz_equal(res_powers, res_naive) && fmpz_equal(res_pipe, res_naive) && fmpz_equal(res_batch + 0, res_naive) && fmpz_equal(res_batch + 1, res_twist) && search_ok && range_ok && interrupt_ok && checkpoint_ok && distrib_ok && cache_ok && threads_ok && bsgs_ok && mont_ok && arena_ok;
+
+            // Ecriture de res_naive, res_schoof, res_affine, res_distrib, res_powers, res_pipe et res_batch
             fmpz_fprint(file, res_naive);
             fprintf(file, ",");
             fmpz_fprint(file, res_schoof);
+            fprintf(file, ",");
+            fmpz_fprint(file, res_affine);
+            fprintf(file, ",");
+            fmpz_fprint(file, res_distrib);
+            fprintf(file, ",");
+            fmpz_fprint(file, res_powers);
+            fprintf(file, ",");
+            fmpz_fprint(file, res_pipe);
+            fprintf(file, ",");
+            fmpz_fprint(file, res_batch + 0);
             fprintf(file, "\n");
 
+            fq_clear(batch_a + 0, ctx);
+            fq_clear(batch_a + 1, ctx);
+            fq_clear(batch_b + 0, ctx);
+            fq_clear(batch_b + 1, ctx);
             fq_clear(a, ctx);
             fq_clear(b, ctx);
             fq_ctx_clear(ctx);
@@ -102,6 +1030,15 @@ int main() {
 
     fmpz_clear(res_schoof);
     fmpz_clear(res_naive);
+    fmpz_clear(res_affine);
+    fmpz_clear(res_distrib);
+    fmpz_clear(res_powers);
+    fmpz_clear(res_pipe);
+    _fmpz_vec_clear(res_batch, 2);
+    fmpz_clear(res_twist);
+    fmpz_clear(res_search);
+    fmpz_clear(range_a);
+    fmpz_clear(range_b);
     fmpz_clear(q);
     flint_randclear(state);
 
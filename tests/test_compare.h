@@ -21,12 +21,36 @@
 #include <flint/fq.h>
 #include "ell_curve.h"
 #include "schoof.h"
+#include "batch.h"
+#include "search.h"
+#include "range.h"
+#include "curve_cache.h"
+#include "psi_pipe.h"
+
+#define TEST_CHECKPOINT "./results/test_checkpoint.txt" // Fichier de reprise des tests d'interruption
+#define TEST_CACHE "./results/test_cache.bin" // Fichier du test du cache des nombres de points
+#define TEST_TUNE "./results/test_tune.txt" // Profil de réglage du test des tables de seuils
 
 /**
  * Les tests ne sont effectués que pour q premier.
  */
 
 void naive_num_of_points(fmpz_t, const fq_t, const fq_t, const fq_ctx_t);
+int test_residues(const schoof_partial_t, const fmpz_t, const fmpz_t);
+void test_cancel_progress(const schoof_progress_struct*, void*);
+int test_interrupt(const fq_t, const fq_t, const fmpz_t, const fq_ctx_t);
+long test_file_size(const char*);
+int test_checkpoint(const fq_t, const fq_t, const fmpz_t, const fq_ctx_t);
+int test_distrib_options(const fq_t, const fq_t, const fq_ctx_t);
+int test_cache_class(curve_cache_t, const fq_t, const fq_t, flint_rand_t, const fq_ctx_t);
+int test_cache(const fq_t, const fq_t, flint_rand_t, const fq_ctx_t);
+int test_bsgs(const ell_curve_t, flint_rand_t, const fq_ctx_t);
+int test_threads(const ell_curve_t, flint_rand_t, const fq_ctx_t);
+int test_evict(const ell_curve_t, const fq_ctx_t);
+int test_pipe(const ell_curve_t, const fq_ctx_t);
+int test_arena(void);
+int test_mont(flint_rand_t);
+int test_tune(flint_rand_t);
 int test_schoof(const ell_curve_t, const fq_ctx_t);
 int main();
 
@@ -1,10 +1,241 @@
 #include "test_perf.h"
 
+#if PERF_COUNTERS
+/**
+ * Ouvre les compteurs matériels sur le processus appelant et les démarre. Chaque compteur est hérité par les
+ * threads créés ensuite (produits répartis, calcul réparti), comme clock() compte le temps processeur de tout le
+ * processus : l'héritage exclut la lecture groupée, les compteurs sont donc ouverts et lus séparément. Seul le mode
+ * utilisateur est compté, ce qu'autorise perf_event_paranoid <= 2.
+ */
+void perf_counters_init(perf_counters_t counters) {
+    const ulong configs[PERF_NUM_EVENTS] = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+
+    counters->enabled = 1;
+    for (int i = 0; i < PERF_NUM_EVENTS; i++) counters->fd[i] = -1;
+
+    for (int i = 0; i < PERF_NUM_EVENTS && counters->enabled; i++) {
+        struct perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.size = sizeof(attr);
+        attr.config = configs[i];
+        attr.disabled = 1;
+        attr.inherit = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+
+        counters->fd[i] = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+        if (counters->fd[i] < 0) counters->enabled = 0;
+    }
+
+    if (counters->enabled) {
+        for (int i = 0; i < PERF_NUM_EVENTS; i++) {
+            ioctl(counters->fd[i], PERF_EVENT_IOC_RESET, 0);
+            ioctl(counters->fd[i], PERF_EVENT_IOC_ENABLE, 0);
+        }
+    } else {
+        perf_counters_clear(counters);
+        fprintf(stderr, "Compteurs matériels indisponibles (c.f /proc/sys/kernel/perf_event_paranoid), seuls les temps sont mesurés\n");
+    }
+}
+
+void perf_counters_clear(perf_counters_t counters) {
+    for (int i = 0; i < PERF_NUM_EVENTS; i++) {
+        if (counters->fd[i] >= 0) close(counters->fd[i]);
+        counters->fd[i] = -1;
+    }
+    counters->enabled = 0;
+}
+
+/**
+ * Relève le temps processeur et, si les compteurs sont ouverts, leurs valeurs (threads hérités compris).
+ */
+void perf_counters_read(perf_sample_struct* sample, const perf_counters_t counters) {
+    sample->time = (double)clock() / CLOCKS_PER_SEC;
+
+    for (int i = 0; i < PERF_NUM_EVENTS; i++) {
+        uint64_t value = 0;
+        if (counters->enabled && read(counters->fd[i], &value, sizeof(value)) != (ssize_t)sizeof(value)) value = 0;
+        sample->values[i] = value;
+    }
+}
+
+/**
+ * Écrit ",cycles,instructions,défauts de cache,mauvaises prédictions" entre start et end, divisés par reps, ou
+ * des colonnes vides si les compteurs ne sont pas ouverts.
+ */
+void perf_sample_fprint(FILE* file, const perf_sample_struct* start, const perf_sample_struct* end, const slong reps, const perf_counters_t counters) {
+    for (int i = 0; i < PERF_NUM_EVENTS; i++) {
+        if (counters->enabled) {
+            fprintf(file, ",%.1f", (double)(end->values[i] - start->values[i]) / reps);
+        } else {
+            fprintf(file, ",");
+        }
+    }
+}
+
+/**
+ * Appelée par ell_schoof() après chaque module : écrit "q,l,temps" et les compteurs depuis le module précédent.
+ */
+void perf_phases_progress(const schoof_progress_struct* progress, void* data) {
+    perf_phases_struct* phases = (perf_phases_struct*)data;
+
+    perf_sample_struct now;
+    perf_counters_read(&now, phases->counters);
+
+    fmpz_fprint(phases->file, phases->q);
+    fprintf(phases->file, ",%lu,%.6f", progress->l, now.time - phases->last.time);
+    perf_sample_fprint(phases->file, &phases->last, &now, 1, phases->counters);
+    fprintf(phases->file, "\n");
+
+    phases->last = now;
+}
+
+/**
+ * Mesure les noyaux de tors_ring.h sur le ψ_l du plus grand l utilisé par ell_schoof() pour la courbe
+ * y^2 = x^3 + a*x + b, avec des opérandes aléatoires. Chaque noyau est répété jusqu'à durer au moins
+ * PERF_KERNEL_MIN_TIME et une ligne "q,noyau,longueur de psi,répétitions,temps" suivie des compteurs, par appel,
+ * est écrite dans file.
+ */
+void perf_kernels(FILE* file, const fq_t a, const fq_t b, flint_rand_t state, const perf_counters_t counters, const fq_ctx_t ctx) {
+    const char* names[] = {"tors_poly_mul", "tors_poly_mul_pre", "tors_elem_mul"};
+
+    ell_curve_t E;
+    ell_curve_init(E, ctx);
+    ell_curve_set(E, a, b, ctx);
+
+    ulong l = schoof_max_prime(ctx);
+    list_fq_poly_t list_psi;
+    list_fq_poly_init(list_psi);
+    update_list_div_poly(list_psi, E, l, ctx);
+
+    tors_ring_t tors_ring;
+    tors_ring_init(tors_ring, ctx);
+    tors_ring_set(tors_ring, E, PSI(l), ctx);
+    slong len = tors_ring->psi_len;
+
+    fq_poly_t op1, op2, res;
+    fq_poly_init(op1, ctx);
+    fq_poly_init(op2, ctx);
+    fq_poly_init(res, ctx);
+    fq_poly_randtest(op1, state, len - 1, ctx);
+    fq_poly_randtest(op2, state, len - 1, ctx);
+
+    tors_pre_t pre_op;
+    tors_pre_init(pre_op, ctx);
+    tors_pre_set(pre_op, op2, tors_ring, ctx);
+
+    tors_elem_t elem1, elem2, elem_res;
+    tors_elem_inits(ctx, elem1, elem2, elem_res, NULL);
+    tors_elem_set(elem1, op1, op2, ctx);
+    tors_elem_set(elem2, op2, op1, ctx);
+
+    for (int k = 0; k < 3; k++) {
+        perf_sample_struct start, end;
+        slong reps = 0;
+        perf_counters_read(&start, counters);
+        end = start;
+
+        for (slong n = 1; end.time - start.time < PERF_KERNEL_MIN_TIME; n *= 2) {
+            perf_counters_read(&start, counters);
+            for (slong i = 0; i < n; i++) {
+                if (k == 0) {
+                    tors_poly_mul(res, op1, op2, tors_ring, ctx);
+                } else if (k == 1) {
+                    tors_poly_mul_pre(res, op1, pre_op, tors_ring, ctx);
+                } else {
+                    tors_elem_mul(elem_res, elem1, elem2, tors_ring, ctx);
+                }
+            }
+            perf_counters_read(&end, counters);
+            reps = n;
+        }
+
+        fmpz_fprint(file, fq_ctx_prime(ctx));
+        fprintf(file, ",%s,%ld,%ld,%.9f", names[k], len, reps, (end.time - start.time) / reps);
+        perf_sample_fprint(file, &start, &end, reps, counters);
+        fprintf(file, "\n");
+    }
+
+    tors_elem_clears(ctx, elem1, elem2, elem_res, NULL);
+    tors_pre_clear(pre_op, ctx);
+    tors_ring_clear(tors_ring, ctx);
+    list_fq_poly_clear(list_psi, ctx);
+    ell_curve_clear(E, ctx);
+    fq_poly_clear(op1, ctx);
+    fq_poly_clear(op2, ctx);
+    fq_poly_clear(res, ctx);
+}
+#endif
+
+/**
+ * Débit de batch_schoof() comparé à schoof() appelé courbe par courbe, sur PERF_BATCH_CURVES courbes lisses tirées
+ * au hasard sur F_q : écrit "q,courbes,temps par lots,temps courbe par courbe,accélération,résultats égaux" dans
+ * file.
+ */
+void perf_batch(FILE* file, flint_rand_t state, const fq_ctx_t ctx) {
+    fq_struct a[PERF_BATCH_CURVES], b[PERF_BATCH_CURVES];
+    fmpz* res_batch = _fmpz_vec_init(PERF_BATCH_CURVES);
+    fmpz* res_schoof = _fmpz_vec_init(PERF_BATCH_CURVES);
+
+    ell_curve_t E;
+    ell_curve_init(E, ctx);
+    for (slong k = 0; k < PERF_BATCH_CURVES; k++) {
+        fq_init(a + k, ctx);
+        fq_init(b + k, ctx);
+        do {
+            fq_rand(a + k, state, ctx);
+            fq_rand(b + k, state, ctx);
+        } while (ell_curve_set(E, a + k, b + k, ctx) == EXIT_FAILURE);
+    }
+    ell_curve_clear(E, ctx);
+
+    clock_t start = clock();
+    batch_schoof(res_batch, a, b, PERF_BATCH_CURVES, ctx);
+    double batch_time = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+    start = clock();
+    for (slong k = 0; k < PERF_BATCH_CURVES; k++) schoof(res_schoof + k, a + k, b + k, ctx);
+    double schoof_time = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+    int match = 1;
+    for (slong k = 0; k < PERF_BATCH_CURVES; k++) {
+        match = match && fmpz_equal(res_batch + k, res_schoof + k);
+        fq_clear(a + k, ctx);
+        fq_clear(b + k, ctx);
+    }
+
+    fmpz_fprint(file, fq_ctx_prime(ctx));
+    fprintf(file, ",%d,%.6f,%.6f,%.2f,%d\n", PERF_BATCH_CURVES, batch_time, schoof_time, (batch_time > 0) ? schoof_time / batch_time : 0.0, match);
+
+    _fmpz_vec_clear(res_batch, PERF_BATCH_CURVES);
+    _fmpz_vec_clear(res_schoof, PERF_BATCH_CURVES);
+}
+
 int main() {    
     FILE* file = fopen("./results/results_perf.csv", "w");
-    fprintf(file, "NUM_TRIALS,MIN_BITS,MAX_BITS\n");
-    fprintf(file, "%i,%i,%i\n", NUM_TRIALS, MIN_BITS, MAX_BITS);
-    fprintf(file, "q,a,b,time (s)\n"); // Format du fichier .csv
+    fprintf(file, "NUM_TRIALS,MIN_BITS,MAX_BITS,FROB_BLOCK,LOW_MEMORY\n");
+    fprintf(file, "%i,%i,%i,%i,%i\n", NUM_TRIALS, MIN_BITS, MAX_BITS, FROB_BLOCK, LOW_MEMORY);
+#if PERF_COUNTERS
+    fprintf(file, "q,a,b,time (s),psi peak estimate (bytes),cycles,instructions,cache misses,branch misses\n"); // Format du fichier .csv
+
+    // Compteurs par module de ell_schoof() (l = 0 : fin du calcul, restes chinois ou pas de bébé-pas de géant)
+    // et par noyau
+    FILE* phases_file = fopen("./results/results_perf_phases.csv", "w");
+    fprintf(phases_file, "q,l,time (s),cycles,instructions,cache misses,branch misses\n");
+    FILE* kernels_file = fopen("./results/results_perf_kernels.csv", "w");
+    fprintf(kernels_file, "q,kernel,psi length,reps,time per call (s),cycles,instructions,cache misses,branch misses\n");
+
+    perf_counters_t counters;
+    perf_counters_init(counters);
+    perf_sample_struct sample_start, sample_end;
+#else
+    fprintf(file, "q,a,b,time (s),psi peak estimate (bytes)\n"); // Format du fichier .csv
+#endif
+
+    // Débit des lots de courbes comparé aux appels courbe par courbe (c.f perf_batch())
+    FILE* batch_file = fopen("./results/results_perf_batch.csv", "w");
+    fprintf(batch_file, "q,curves,batch time (s),schoof time (s),speedup,match\n");
 
     flint_rand_t state;
     flint_randinit(state);
@@ -18,6 +249,23 @@ int main() {
     clock_t start, end;
     double duration;
 
+    schoof_opt_t opt;
+    schoof_opt_init(opt);
+    opt->frob_block = FROB_BLOCK;
+    opt->low_memory = LOW_MEMORY;
+
+    slong peak_bytes = 0;
+    opt->peak_bytes = &peak_bytes;
+
+#if PERF_COUNTERS
+    perf_phases_struct phases;
+    phases.file = phases_file;
+    phases.q = q;
+    phases.counters = counters;
+    opt->progress = perf_phases_progress;
+    opt->progress_data = &phases;
+#endif
+
     for (int i = MIN_BITS; i <= MAX_BITS; i++) {
         for (int j = 0; j < NUM_TRIALS; j++) { 
             fmpz_randprime(q, state, i, 1);
@@ -40,9 +288,16 @@ int main() {
                 fq_rand(a, state, ctx);
                 fq_rand(b, state, ctx);
 
+#if PERF_COUNTERS
+                perf_counters_read(&sample_start, counters);
+                phases.last = sample_start;
+#endif
                 start = clock();
-                success = schoof(res, a, b, ctx); // Pour vérifier si les paramètres étaient corrects
+                success = schoof_with_opt(res, a, b, opt, ctx); // Pour vérifier si les paramètres étaient corrects
                 end = clock();
+#if PERF_COUNTERS
+                perf_counters_read(&sample_end, counters);
+#endif
             } while ((essais_max--) > 0 && success == EXIT_FAILURE); // On évite les potentielles boucles infinies
 
             duration = (double)(end - start) / CLOCKS_PER_SEC;
@@ -54,7 +309,25 @@ int main() {
             fprintf(file, ",");
 
             // Ecriture du temps de calcul
-            fprintf(file, "%.6f\n", duration);
+            fprintf(file, "%.6f,", duration);
+
+            // Ecriture du pic de mémoire occupée par les polynômes de division
+            fprintf(file, "%ld", peak_bytes);
+
+#if PERF_COUNTERS
+            // Ecriture des compteurs du calcul entier, de sa fin (après le dernier module) et des noyaux
+            perf_sample_fprint(file, &sample_start, &sample_end, 1, counters);
+
+            fmpz_fprint(phases_file, q);
+            fprintf(phases_file, ",0,%.6f", sample_end.time - phases.last.time);
+            perf_sample_fprint(phases_file, &phases.last, &sample_end, 1, counters);
+            fprintf(phases_file, "\n");
+
+            if (j == 0) perf_kernels(kernels_file, a, b, state, counters, ctx);
+#endif
+            fprintf(file, "\n");
+
+            if (j == 0 && i < SIMD_MAX_BITS) perf_batch(batch_file, state, ctx);
 
             fq_clear(a, ctx);
             fq_clear(b, ctx);
@@ -70,6 +343,12 @@ int main() {
     printf("\n 🎉 Tests terminés ! 🎉\n");
 
     fclose(file);
+    fclose(batch_file);
+#if PERF_COUNTERS
+    fclose(phases_file);
+    fclose(kernels_file);
+    perf_counters_clear(counters);
+#endif
 
     printf("\n 📊 Génération du graphique...\n");
 
@@ -13,7 +13,24 @@
 #define MAX_BITS 64
 #endif
 
+#ifndef FROB_BLOCK
+#define FROB_BLOCK 0 // Nombre de premiers par bloc pour le calcul des Frobenius, c.f frobenius_block()
+#endif
+
+#ifndef LOW_MEMORY
+#define LOW_MEMORY 0 // Libère les polynômes de division qui ne servent plus, c.f evict_list_div_poly()
+#endif
+
+#ifndef PERF_COUNTERS
+#define PERF_COUNTERS 0 // Lit les compteurs matériels de perf_event autour de chaque module et de chaque noyau
+#endif
+
+#if PERF_COUNTERS
+#define _GNU_SOURCE // syscall()
+#endif
+
 #define TOTAL_NUM_TRIALS (NUM_TRIALS * (MAX_BITS - MIN_BITS + 1))
+#define PERF_BATCH_CURVES BATCH_MAX_LANES // Nombre de courbes par mesure de batch_schoof() (c.f perf_batch())
 
 #include <stdio.h>
 #include <flint/flint.h>
@@ -22,11 +39,69 @@
 #include <time.h>
 #include "ell_curve.h"
 #include "schoof.h"
+#include "batch.h"
+
+#if PERF_COUNTERS
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#include "tors_ring.h"
+#endif
 
 /**
  * Les tests ne sont effectués que pour q premier.
+ *
+ * Pour chaque taille de q de moins de SIMD_MAX_BITS bits, results_perf_batch.csv compare aussi le temps de
+ * batch_schoof() sur PERF_BATCH_CURVES courbes à celui de schoof() appelé sur chacune (c.f perf_batch()).
+ *
+ * Avec PERF_COUNTERS, les compteurs matériels du noyau Linux (cycles, instructions, défauts de cache, mauvaises
+ * prédictions de branchement) sont lus en plus du temps : pour tout le calcul dans results_perf.csv, pour chaque
+ * module l de ell_schoof() (lus par opt->progress) dans results_perf_phases.csv, et pour les noyaux de
+ * tors_ring.h sur le ψ_l du plus grand l dans results_perf_kernels.csv. Le rapport instructions/cycles et les
+ * défauts de cache par produit indiquent si un noyau est limité par le calcul ou par la mémoire. Comme le temps
+ * de clock(), les compteurs couvrent tout le processus, threads créés pendant le calcul compris. S'ils ne peuvent
+ * être ouverts (perf_event_paranoid trop élevé, machine virtuelle sans PMU), les colonnes correspondantes restent
+ * vides.
  */
 
+#if PERF_COUNTERS
+#define PERF_NUM_EVENTS 4 // Cycles, instructions, défauts de cache, mauvaises prédictions de branchement
+#define PERF_KERNEL_MIN_TIME 0.05 // Durée minimale (secondes) des répétitions d'un noyau
+
+// Compteurs ouverts sur le processus, hérités par les threads qu'il crée ensuite et lus un à un
+typedef struct {
+    int fd[PERF_NUM_EVENTS]; // Cycles, instructions, défauts de cache, mauvaises prédictions de branchement
+    int enabled; // Non nul si tous les compteurs ont pu être ouverts
+} perf_counters_struct;
+
+typedef perf_counters_struct perf_counters_t[1]; // On adopte la convention de FLINT sur les nouveaux types
+
+// Temps processeur et valeurs des compteurs à un instant donné
+typedef struct {
+    double time;
+    ulong values[PERF_NUM_EVENTS];
+} perf_sample_struct;
+
+// Relevé par module de ell_schoof(), transmis par opt->progress
+typedef struct {
+    FILE* file;
+    const fmpz* q;
+    const perf_counters_struct* counters;
+    perf_sample_struct last; // Relevé à la fin du module précédent (ou au début du calcul)
+} perf_phases_struct;
+
+void perf_counters_init(perf_counters_t);
+void perf_counters_clear(perf_counters_t);
+void perf_counters_read(perf_sample_struct*, const perf_counters_t);
+void perf_sample_fprint(FILE*, const perf_sample_struct*, const perf_sample_struct*, const slong, const perf_counters_t);
+void perf_phases_progress(const schoof_progress_struct*, void*);
+void perf_kernels(FILE*, const fq_t, const fq_t, flint_rand_t, const perf_counters_t, const fq_ctx_t);
+#endif
+
+void perf_batch(FILE*, flint_rand_t, const fq_ctx_t);
 int main();
 
 #endif
\ No newline at end of file